@@ -7,6 +7,7 @@
 #include "Common.hpp"
 #include "Main.hpp"
 #include "Colony.hpp"
+#include "PathGeneratorBenchmark.hpp"
 #include "ThreadSafeStructures.hpp"
 
 
@@ -43,6 +44,13 @@ void PreGameStartup( const StartupInfo& info ) // Server provides player/match i
 	g_threadSafe_turnStatus.Set( TURN_STATUS_WAITING_FOR_NEXT_UPDATE );
 	g_debug = info.debugInterface;
 
+	if ( info.RegisterEvent != nullptr )
+	{
+		info.RegisterEvent( "path_benchmark", &PathGeneratorBenchmarkCommand );
+		info.RegisterEvent( "path_replay", &PathRequestReplayCommand );
+		info.RegisterEvent( "hpa_benchmark", &HierarchicalPathBenchmarkCommand );
+	}
+
 	g_debug->SetMoodText( "Commencing Antageddon!" );
 }
 
@@ -37,6 +37,7 @@ void Colony::Update()
 		g_threadSafe_turnStatus.Set( TURN_STATUS_WORKING_ON_ORDERS );
 		g_colony->AssignBasicOrdersToAnts();
 		g_threadSafe_turnStatus.Set( TURN_STATUS_ORDERS_READY );
+		g_colony->FlushPathRequests();
 		//g_colony->AssignAdvancedOrdersToAnts();
 	}
 }
@@ -197,7 +198,12 @@ void Colony::ProcessVisibleTilesAndFood()
 			continue;
 		}
 
-		m_observedTileTypes[tileIdx] = m_turnInfo.observedTiles[tileIdx];
+		if ( m_observedTileTypes[tileIdx] != m_turnInfo.observedTiles[tileIdx] )
+		{
+			m_observedTileTypes[tileIdx] = m_turnInfo.observedTiles[tileIdx];
+			m_isObservedMapSnapshotStale = true;
+			m_pathClusterGraphCache.MarkTileChanged( tileIdx, m_startupInfo.matchInfo.mapWidth );
+		}
 
 		m_observedTiles[tileIdx].type = m_turnInfo.observedTiles[tileIdx];
 		m_observedTiles[tileIdx].hasFood = m_turnInfo.tilesThatHaveFood[tileIdx];
@@ -1489,8 +1495,6 @@ void Colony::RequestPathToGoalForAnt( Ant& ant )
 	requestData.id = ant.m_id;
 	requestData.startTile = ant.m_pos;
 	requestData.endTile = ant.m_goalPos;
-	memcpy( requestData.observedTileTypes, m_observedTileTypes, MAX_ARENA_TILES * sizeof(eTileType) );
-	requestData.mapWidth = m_startupInfo.matchInfo.mapWidth;
 
 	requestData.tileTypeCosts[TILE_TYPE_AIR] = 0;
 	requestData.tileTypeCosts[TILE_TYPE_CORPSE_BRIDGE] = 0;
@@ -1524,7 +1528,8 @@ void Colony::RequestPathToGoalForAnt( Ant& ant )
 		break;
 	}
 
-	g_generatePathRequests.Push( requestData );
+	m_pendingPathRequests.push_back( requestData );
+
 	ant.m_nextPathStep = ant.m_pos;
 	ant.m_waitingOnPath = true;
 	/*ant.m_pathToGoal = GeneratePath( ant.m_pos, ant.m_goalPos, &tileTypeCosts[0] );
@@ -1533,3 +1538,75 @@ void Colony::RequestPathToGoalForAnt( Ant& ant )
 		ant.m_nextPathStep = ant.m_pathToGoal[ant.m_pathToGoal.size() - 1];
 	}*/
 }
+
+
+//-----------------------------------------------------------------------------------------------
+void Colony::FlushPathRequests()
+{
+	if ( m_pendingPathRequests.empty() )
+	{
+		return;
+	}
+
+	const ObservedMapSnapshotPtr& mapSnapshot = GetObservedMapSnapshot();
+
+	// Long paths search the cluster graph, brought up to date with the same map the snapshot was taken from
+	for ( GeneratePathRequestData& request : m_pendingPathRequests )
+	{
+		if ( ( request.endTile - request.startTile ).GetTaxicabLength() >= MIN_HIERARCHICAL_PATH_DISTANCE )
+		{
+			request.clusterGraph = m_pathClusterGraphCache.GetGraph( request.tileTypeCosts, m_observedTileTypes, m_startupInfo.matchInfo.mapWidth );
+		}
+	}
+
+	for ( int firstRequestIdx = 0; firstRequestIdx < (int)m_pendingPathRequests.size(); firstRequestIdx += MAX_PATH_REQUESTS_PER_BATCH )
+	{
+		int endRequestIdx = firstRequestIdx + MAX_PATH_REQUESTS_PER_BATCH;
+		if ( endRequestIdx > (int)m_pendingPathRequests.size() )
+		{
+			endRequestIdx = (int)m_pendingPathRequests.size();
+		}
+
+		GeneratePathBatch batch;
+		batch.mapSnapshot = mapSnapshot;
+		batch.requests.assign( m_pendingPathRequests.begin() + firstRequestIdx, m_pendingPathRequests.begin() + endRequestIdx );
+		if ( g_generatePathBatches.Push( batch ) )
+		{
+			continue;
+		}
+
+		// Queue is full, these ants keep their goals and ask again next turn
+		for ( int requestIdx = firstRequestIdx; requestIdx < (int)m_pendingPathRequests.size(); ++requestIdx )
+		{
+			auto mapIter = m_myAntsByID.find( m_pendingPathRequests[requestIdx].id );
+			if ( mapIter != m_myAntsByID.end() )
+			{
+				mapIter->second->m_waitingOnPath = false;
+			}
+		}
+		break;
+	}
+
+	m_pendingPathRequests.clear();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+const ObservedMapSnapshotPtr& Colony::GetObservedMapSnapshot()
+{
+	if ( !m_isObservedMapSnapshotStale
+		 && m_observedMapSnapshot != nullptr )
+	{
+		return m_observedMapSnapshot;
+	}
+
+	// Workers may still be reading the old snapshot, so publish a new one rather than writing over it
+	std::shared_ptr<ObservedMapSnapshot> newSnapshot = std::make_shared<ObservedMapSnapshot>();
+	newSnapshot->version = m_observedMapSnapshot != nullptr ? m_observedMapSnapshot->version + 1 : 1;
+	newSnapshot->mapWidth = m_startupInfo.matchInfo.mapWidth;
+	memcpy( newSnapshot->observedTileTypes, m_observedTileTypes, MAX_ARENA_TILES * sizeof( eTileType ) );
+
+	m_observedMapSnapshot = newSnapshot;
+	m_isObservedMapSnapshotStale = false;
+	return m_observedMapSnapshot;
+}
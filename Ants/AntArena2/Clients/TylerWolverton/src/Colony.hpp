@@ -1,6 +1,7 @@
 #pragma once
 #include "Common.hpp"
 #include "Ant.hpp"
+#include "HierarchicalPathGenerator.hpp"
 
 #include <vector>
 
@@ -91,6 +92,8 @@ private:
 	bool		IsTileSafeForAnt( const TileCoords& tileCoords, const Ant& ant ) const;
 
 	void		RequestPathToGoalForAnt( Ant& ant );
+	void		FlushPathRequests();
+	const ObservedMapSnapshotPtr& GetObservedMapSnapshot();
 
 private:
 	// Note ALL Colony data (unless otherwise specified) is used (read and written) only by the primary DLL thread (#0).
@@ -113,6 +116,10 @@ private:
 
 
 	eTileType					m_observedTileTypes[MAX_ARENA_TILES];
+	ObservedMapSnapshotPtr		m_observedMapSnapshot;				// Latest published copy of m_observedTileTypes, shared with workers
+	bool						m_isObservedMapSnapshotStale = true;
+	PathClusterGraphCache		m_pathClusterGraphCache;
+	std::vector<GeneratePathRequestData> m_pendingPathRequests;		// Made this turn, handed to workers in batches by FlushPathRequests
 	Tile						m_observedTiles[MAX_ARENA_TILES];
 	ObservedAgent				m_observedAgents[MAX_AGENTS_TOTAL];
 	StartupInfo					m_startupInfo;
@@ -8,7 +8,8 @@
 #include <thread>
 #include <mutex>
 #include <atomic>
-#include "SynchronizedNonBlockingQueue.hpp"
+#include <memory>
+#include "MPMCRingQueue.hpp"
 
 
 //------------------------------------------------------------------------------------------------
@@ -76,6 +77,23 @@ int		GetAdjacentTileIdx(			const TileCoords& tileCoords, eCardinalDirections dir
 
 //------------------------------------------------------------------------------------------------
 // A* 
+// Colony's observed map as of one turn, published at most once per turn and shared read-only by
+// every path request made against it. Freed when the last request holding it is done.
+struct ObservedMapSnapshot
+{
+public:
+	int			version = 0;		// Bumped each time Colony publishes a changed map
+	int			mapWidth = 0;
+	eTileType	observedTileTypes[MAX_ARENA_TILES];
+};
+
+typedef std::shared_ptr<const ObservedMapSnapshot> ObservedMapSnapshotPtr;
+
+class PathClusterGraph;
+typedef std::shared_ptr<const PathClusterGraph> PathClusterGraphPtr;
+
+
+//------------------------------------------------------------------------------------------------
 struct GeneratePathRequestData
 {
 public:
@@ -83,8 +101,16 @@ public:
 	TileCoords	startTile = TILE_COORDS_INVALID;
 	TileCoords	endTile = TILE_COORDS_INVALID;
 	int			tileTypeCosts[NUM_TILE_TYPES];
-	eTileType	observedTileTypes[MAX_ARENA_TILES];
-	int		mapWidth = 0;
+	PathClusterGraphPtr	clusterGraph;		// Set for long paths, built from the same map as the batch's snapshot
+};
+
+
+// Requests a worker runs back to back, all against the same snapshot
+struct GeneratePathBatch
+{
+public:
+	ObservedMapSnapshotPtr					mapSnapshot;
+	std::vector<GeneratePathRequestData>	requests;
 };
 
 
@@ -94,5 +120,9 @@ struct PathCompleteData
 	Path	pathToGoal;
 };
 
-extern SynchronizedNonBlockingQueue<GeneratePathRequestData> g_generatePathRequests;
-extern SynchronizedNonBlockingQueue<PathCompleteData> g_completedPaths;
\ No newline at end of file
+// Colony splits each turn's requests into batches of at most this many so several workers can share a turn
+constexpr int MAX_PATH_REQUESTS_PER_BATCH = 16;
+
+// One request in flight per ant at most, so neither queue can fill up in practice
+extern MPMCRingQueue<GeneratePathBatch> g_generatePathBatches;
+extern MPMCRingQueue<PathCompleteData> g_completedPaths;
\ No newline at end of file
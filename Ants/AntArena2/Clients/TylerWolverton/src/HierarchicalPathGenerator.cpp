@@ -0,0 +1,528 @@
+#include "HierarchicalPathGenerator.hpp"
+#include "PathGenerator.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <queue>
+
+
+//-----------------------------------------------------------------------------------------------
+// Open stretches of border at least this long get an entrance at each end instead of one in the middle
+constexpr int MIN_BORDER_RUN_FOR_TWO_ENTRANCES = 6;
+
+
+//-----------------------------------------------------------------------------------------------
+static bool IsTilePassable( const eTileType* observedTileTypes, const int* tileTypeCosts, int tileIdx )
+{
+	eTileType tileType = observedTileTypes[tileIdx];
+	return tileType != TILE_TYPE_UNSEEN
+		&& tileTypeCosts[tileType] != -1;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static int GetLocalTileIdx( const TileCoords& tileCoords, const TileCoords& clusterMins )
+{
+	return ( tileCoords.y - clusterMins.y ) * PATH_CLUSTER_WIDTH + ( tileCoords.x - clusterMins.x );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static bool IsTileInBounds( const TileCoords& tileCoords, const TileCoords& mins, const TileCoords& maxs )
+{
+	return tileCoords.x >= mins.x && tileCoords.x <= maxs.x
+		&& tileCoords.y >= mins.y && tileCoords.y <= maxs.y;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Dijkstra that never leaves the cluster. Forward fills in the cost from sourceTile to every tile,
+// reverse fills in the cost from every tile to sourceTile. Both arrays are PATH_CLUSTER_TILES long and
+// indexed by local tile, costs are -1 where unreachable.
+static void SearchWithinCluster( const TileCoords& sourceTile, bool isReverse, const TileCoords& clusterMins, const TileCoords& clusterMaxs,
+								 const eTileType* observedTileTypes, int mapWidth, const int* tileTypeCosts, int* out_costs, int* out_parentLocalTileIndices )
+{
+	for ( int localTileIdx = 0; localTileIdx < PATH_CLUSTER_TILES; ++localTileIdx )
+	{
+		out_costs[localTileIdx] = -1;
+		out_parentLocalTileIndices[localTileIdx] = -1;
+	}
+
+	typedef std::pair<int, int> CostAndLocalTileIdx;
+	std::priority_queue<CostAndLocalTileIdx, std::vector<CostAndLocalTileIdx>, std::greater<CostAndLocalTileIdx>> openTiles;
+
+	int sourceLocalTileIdx = GetLocalTileIdx( sourceTile, clusterMins );
+	out_costs[sourceLocalTileIdx] = 0;
+	openTiles.push( CostAndLocalTileIdx( 0, sourceLocalTileIdx ) );
+
+	while ( !openTiles.empty() )
+	{
+		CostAndLocalTileIdx best = openTiles.top();
+		openTiles.pop();
+		if ( best.first != out_costs[best.second] )
+		{
+			continue;
+		}
+
+		TileCoords curTileCoords( clusterMins.x + best.second % PATH_CLUSTER_WIDTH, clusterMins.y + best.second / PATH_CLUSTER_WIDTH );
+		int curTileIdx = GetTileIdxFromTileCoords( curTileCoords, mapWidth );
+
+		for ( int directionIdx = 0; directionIdx < NUM_DIRECTIONS; ++directionIdx )
+		{
+			TileCoords adjacentTileCoords = GetAdjacentTile( curTileCoords, (eCardinalDirections)directionIdx, mapWidth );
+			if ( !IsTileInBounds( adjacentTileCoords, clusterMins, clusterMaxs ) )
+			{
+				continue;
+			}
+
+			int adjacentTileIdx = GetTileIdxFromTileCoords( adjacentTileCoords, mapWidth );
+			if ( !IsTilePassable( observedTileTypes, tileTypeCosts, adjacentTileIdx ) )
+			{
+				continue;
+			}
+
+			// Walking backwards from the source, the step into the current tile is the one being paid for
+			int enteredTileIdx = isReverse ? curTileIdx : adjacentTileIdx;
+			int cost = best.first + tileTypeCosts[observedTileTypes[enteredTileIdx]] + 1;
+
+			int adjacentLocalTileIdx = GetLocalTileIdx( adjacentTileCoords, clusterMins );
+			if ( out_costs[adjacentLocalTileIdx] != -1
+				 && out_costs[adjacentLocalTileIdx] <= cost )
+			{
+				continue;
+			}
+
+			out_costs[adjacentLocalTileIdx] = cost;
+			out_parentLocalTileIndices[adjacentLocalTileIdx] = best.second;
+			openTiles.push( CostAndLocalTileIdx( cost, adjacentLocalTileIdx ) );
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static void AddEntrance( PathCluster& cluster, int tileIdx, int crossingTileIdx )
+{
+	int entranceIdx = cluster.GetEntranceIdxForTile( tileIdx );
+	if ( entranceIdx == -1 )
+	{
+		entranceIdx = cluster.GetNumEntrances();
+		cluster.entranceTileIndices.push_back( tileIdx );
+	}
+
+	cluster.crossingEntranceIndices.push_back( entranceIdx );
+	cluster.crossingTileIndices.push_back( crossingTileIdx );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Both clusters sharing a border walk the same tile pairs in the same order, so they always agree
+// on where the entrances are
+static void AddBorderEntrances( PathCluster& cluster, const TileCoords& firstBorderTile, const TileCoords& alongBorder, const TileCoords& acrossBorder,
+								int borderLength, const eTileType* observedTileTypes, int mapWidth, const int* tileTypeCosts )
+{
+	if ( GetTileIdxFromTileCoords( firstBorderTile + acrossBorder, mapWidth ) == -1 )
+	{
+		// Edge of the arena
+		return;
+	}
+
+	int runStart = -1;
+	for ( int borderIdx = 0; borderIdx <= borderLength; ++borderIdx )
+	{
+		bool isOpen = false;
+		if ( borderIdx < borderLength )
+		{
+			TileCoords borderTile( firstBorderTile.x + alongBorder.x * borderIdx, firstBorderTile.y + alongBorder.y * borderIdx );
+			isOpen = IsTilePassable( observedTileTypes, tileTypeCosts, GetTileIdxFromTileCoords( borderTile, mapWidth ) )
+				  && IsTilePassable( observedTileTypes, tileTypeCosts, GetTileIdxFromTileCoords( borderTile + acrossBorder, mapWidth ) );
+		}
+
+		if ( isOpen )
+		{
+			if ( runStart == -1 )
+			{
+				runStart = borderIdx;
+			}
+			continue;
+		}
+
+		if ( runStart == -1 )
+		{
+			continue;
+		}
+
+		int runLength = borderIdx - runStart;
+		int entranceBorderIndices[2] = { runStart + ( runLength - 1 ) / 2, -1 };
+		if ( runLength >= MIN_BORDER_RUN_FOR_TWO_ENTRANCES )
+		{
+			entranceBorderIndices[0] = runStart;
+			entranceBorderIndices[1] = borderIdx - 1;
+		}
+
+		for ( int entranceBorderIdx : entranceBorderIndices )
+		{
+			if ( entranceBorderIdx == -1 )
+			{
+				continue;
+			}
+
+			TileCoords entranceTile( firstBorderTile.x + alongBorder.x * entranceBorderIdx, firstBorderTile.y + alongBorder.y * entranceBorderIdx );
+			AddEntrance( cluster, GetTileIdxFromTileCoords( entranceTile, mapWidth ), GetTileIdxFromTileCoords( entranceTile + acrossBorder, mapWidth ) );
+		}
+
+		runStart = -1;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static std::shared_ptr<const PathCluster> BuildCluster( const TileCoords& clusterMins, const TileCoords& clusterMaxs,
+														const eTileType* observedTileTypes, int mapWidth, const int* tileTypeCosts )
+{
+	std::shared_ptr<PathCluster> cluster = std::make_shared<PathCluster>();
+
+	int width = clusterMaxs.x - clusterMins.x + 1;
+	int height = clusterMaxs.y - clusterMins.y + 1;
+	AddBorderEntrances( *cluster, TileCoords( clusterMaxs.x, clusterMins.y ), TileCoords( 0, 1 ), TileCoords( 1, 0 ), height, observedTileTypes, mapWidth, tileTypeCosts );
+	AddBorderEntrances( *cluster, TileCoords( clusterMins.x, clusterMins.y ), TileCoords( 0, 1 ), TileCoords( -1, 0 ), height, observedTileTypes, mapWidth, tileTypeCosts );
+	AddBorderEntrances( *cluster, TileCoords( clusterMins.x, clusterMaxs.y ), TileCoords( 1, 0 ), TileCoords( 0, 1 ), width, observedTileTypes, mapWidth, tileTypeCosts );
+	AddBorderEntrances( *cluster, TileCoords( clusterMins.x, clusterMins.y ), TileCoords( 1, 0 ), TileCoords( 0, -1 ), width, observedTileTypes, mapWidth, tileTypeCosts );
+
+	int numEntrances = cluster->GetNumEntrances();
+	cluster->intraClusterCosts.resize( numEntrances * numEntrances, -1 );
+
+	int costs[PATH_CLUSTER_TILES];
+	int parentLocalTileIndices[PATH_CLUSTER_TILES];
+	for ( int fromEntranceIdx = 0; fromEntranceIdx < numEntrances; ++fromEntranceIdx )
+	{
+		TileCoords fromTile = GetTileCoordsFromTileIdx( cluster->entranceTileIndices[fromEntranceIdx], mapWidth );
+		SearchWithinCluster( fromTile, false, clusterMins, clusterMaxs, observedTileTypes, mapWidth, tileTypeCosts, costs, parentLocalTileIndices );
+
+		for ( int toEntranceIdx = 0; toEntranceIdx < numEntrances; ++toEntranceIdx )
+		{
+			TileCoords toTile = GetTileCoordsFromTileIdx( cluster->entranceTileIndices[toEntranceIdx], mapWidth );
+			cluster->intraClusterCosts[fromEntranceIdx * numEntrances + toEntranceIdx] = costs[GetLocalTileIdx( toTile, clusterMins )];
+		}
+	}
+
+	return cluster;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int PathCluster::GetEntranceIdxForTile( int tileIdx ) const
+{
+	for ( int entranceIdx = 0; entranceIdx < (int)entranceTileIndices.size(); ++entranceIdx )
+	{
+		if ( entranceTileIndices[entranceIdx] == tileIdx )
+		{
+			return entranceIdx;
+		}
+	}
+
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+PathClusterGraph::PathClusterGraph( const eTileType* observedTileTypes, int mapWidth, const int* tileTypeCosts,
+									const PathClusterGraph* previousGraph, const std::vector<bool>& dirtyClusters )
+	: m_mapWidth( mapWidth )
+{
+	memcpy( m_tileTypeCosts, tileTypeCosts, sizeof( m_tileTypeCosts ) );
+	m_numClustersWide = ( mapWidth + PATH_CLUSTER_WIDTH - 1 ) / PATH_CLUSTER_WIDTH;
+
+	int numClusters = m_numClustersWide * m_numClustersWide;
+	bool canReuseClusters = previousGraph != nullptr
+		&& previousGraph->GetMapWidth() == mapWidth
+		&& (int)dirtyClusters.size() == numClusters;
+
+	m_clusters.resize( numClusters );
+	for ( int clusterIdx = 0; clusterIdx < numClusters; ++clusterIdx )
+	{
+		if ( canReuseClusters
+			 && !dirtyClusters[clusterIdx] )
+		{
+			m_clusters[clusterIdx] = previousGraph->m_clusters[clusterIdx];
+			continue;
+		}
+
+		TileCoords clusterMins;
+		TileCoords clusterMaxs;
+		GetClusterBounds( clusterIdx, clusterMins, clusterMaxs );
+		m_clusters[clusterIdx] = BuildCluster( clusterMins, clusterMaxs, observedTileTypes, mapWidth, tileTypeCosts );
+		++m_numRebuiltClusters;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int PathClusterGraph::GetClusterIdxForTile( int tileIdx ) const
+{
+	TileCoords tileCoords = GetTileCoordsFromTileIdx( tileIdx, m_mapWidth );
+	return ( tileCoords.y / PATH_CLUSTER_WIDTH ) * m_numClustersWide + ( tileCoords.x / PATH_CLUSTER_WIDTH );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void PathClusterGraph::GetClusterBounds( int clusterIdx, TileCoords& out_mins, TileCoords& out_maxs ) const
+{
+	out_mins = TileCoords( ( clusterIdx % m_numClustersWide ) * PATH_CLUSTER_WIDTH, ( clusterIdx / m_numClustersWide ) * PATH_CLUSTER_WIDTH );
+	out_maxs = TileCoords( std::min( out_mins.x + PATH_CLUSTER_WIDTH, m_mapWidth ) - 1, std::min( out_mins.y + PATH_CLUSTER_WIDTH, m_mapWidth ) - 1 );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void PathClusterGraphCache::MarkTileChanged( int tileIdx, int mapWidth )
+{
+	TileCoords tileCoords = GetTileCoordsFromTileIdx( tileIdx, mapWidth );
+	int numClustersWide = ( mapWidth + PATH_CLUSTER_WIDTH - 1 ) / PATH_CLUSTER_WIDTH;
+	int clusterX = tileCoords.x / PATH_CLUSTER_WIDTH;
+	int clusterY = tileCoords.y / PATH_CLUSTER_WIDTH;
+
+	// A border tile also moves the entrances of the cluster across that border
+	int localX = tileCoords.x % PATH_CLUSTER_WIDTH;
+	int localY = tileCoords.y % PATH_CLUSTER_WIDTH;
+	int clusterIndices[5] = { clusterY * numClustersWide + clusterX, -1, -1, -1, -1 };
+	if ( localX == 0 && clusterX > 0 )										clusterIndices[1] = clusterIndices[0] - 1;
+	if ( localX == PATH_CLUSTER_WIDTH - 1 && clusterX < numClustersWide - 1 )	clusterIndices[2] = clusterIndices[0] + 1;
+	if ( localY == 0 && clusterY > 0 )										clusterIndices[3] = clusterIndices[0] - numClustersWide;
+	if ( localY == PATH_CLUSTER_WIDTH - 1 && clusterY < numClustersWide - 1 )	clusterIndices[4] = clusterIndices[0] + numClustersWide;
+
+	for ( CachedGraph& cachedGraph : m_cachedGraphs )
+	{
+		for ( int clusterIdx : clusterIndices )
+		{
+			if ( clusterIdx != -1
+				 && clusterIdx < (int)cachedGraph.dirtyClusters.size() )
+			{
+				cachedGraph.dirtyClusters[clusterIdx] = true;
+			}
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+PathClusterGraphPtr PathClusterGraphCache::GetGraph( const int* tileTypeCosts, const eTileType* observedTileTypes, int mapWidth )
+{
+	CachedGraph* cachedGraph = nullptr;
+	for ( CachedGraph& existingGraph : m_cachedGraphs )
+	{
+		if ( memcmp( existingGraph.tileTypeCosts, tileTypeCosts, sizeof( existingGraph.tileTypeCosts ) ) == 0 )
+		{
+			cachedGraph = &existingGraph;
+			break;
+		}
+	}
+
+	if ( cachedGraph == nullptr )
+	{
+		m_cachedGraphs.emplace_back();
+		cachedGraph = &m_cachedGraphs.back();
+		memcpy( cachedGraph->tileTypeCosts, tileTypeCosts, sizeof( cachedGraph->tileTypeCosts ) );
+	}
+
+	bool isDirty = cachedGraph->graph == nullptr
+		|| cachedGraph->graph->GetMapWidth() != mapWidth;
+	for ( int clusterIdx = 0; !isDirty && clusterIdx < (int)cachedGraph->dirtyClusters.size(); ++clusterIdx )
+	{
+		isDirty = cachedGraph->dirtyClusters[clusterIdx];
+	}
+
+	if ( !isDirty )
+	{
+		return cachedGraph->graph;
+	}
+
+	// Workers may still be searching the old graph, so build a new one that shares its clean clusters
+	cachedGraph->graph = std::make_shared<PathClusterGraph>( observedTileTypes, mapWidth, tileTypeCosts, cachedGraph->graph.get(), cachedGraph->dirtyClusters );
+	cachedGraph->dirtyClusters.assign( cachedGraph->graph->GetNumClusters(), false );
+	return cachedGraph->graph;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Appends the tiles from toTile back to fromTile, excluding toTile and including fromTile, both in the same cluster
+static void AppendPathWithinCluster( Path& pathToGoal, int fromTileIdx, int toTileIdx, const PathClusterGraph& graph, const eTileType* observedTileTypes )
+{
+	int mapWidth = graph.GetMapWidth();
+	TileCoords clusterMins;
+	TileCoords clusterMaxs;
+	graph.GetClusterBounds( graph.GetClusterIdxForTile( fromTileIdx ), clusterMins, clusterMaxs );
+
+	int costs[PATH_CLUSTER_TILES];
+	int parentLocalTileIndices[PATH_CLUSTER_TILES];
+	SearchWithinCluster( GetTileCoordsFromTileIdx( fromTileIdx, mapWidth ), false, clusterMins, clusterMaxs, observedTileTypes, mapWidth, graph.GetTileTypeCosts(), costs, parentLocalTileIndices );
+
+	int localTileIdx = parentLocalTileIndices[GetLocalTileIdx( GetTileCoordsFromTileIdx( toTileIdx, mapWidth ), clusterMins )];
+	while ( localTileIdx != -1 )
+	{
+		pathToGoal.push_back( TileCoords( clusterMins.x + localTileIdx % PATH_CLUSTER_WIDTH, clusterMins.y + localTileIdx / PATH_CLUSTER_WIDTH ) );
+		localTileIdx = parentLocalTileIndices[localTileIdx];
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+Path HierarchicalPathGenerator::GeneratePath( const TileCoords& startTile, const TileCoords& endTile, const PathClusterGraph& graph, const eTileType* observedTileTypes )
+{
+	Path pathToGoal;
+
+	int mapWidth = graph.GetMapWidth();
+	const int* tileTypeCosts = graph.GetTileTypeCosts();
+	int startTileIdx = GetTileIdxFromTileCoords( startTile, mapWidth );
+	int endTileIdx = GetTileIdxFromTileCoords( endTile, mapWidth );
+	if ( startTileIdx == -1
+		 || endTileIdx == -1 )
+	{
+		return pathToGoal;
+	}
+
+	if ( startTileIdx == endTileIdx )
+	{
+		pathToGoal.push_back( endTile );
+		return pathToGoal;
+	}
+
+	if ( !IsTilePassable( observedTileTypes, tileTypeCosts, endTileIdx ) )
+	{
+		return pathToGoal;
+	}
+
+	if ( !IsTilePassable( observedTileTypes, tileTypeCosts, startTileIdx ) )
+	{
+		// Flat A* lets the first step leave the start tile in any direction, but an impassable tile is never
+		// an entrance, so a start on a cluster border could be cut off from the cluster next door
+		return PathGenerator::GeneratePath( startTile, endTile, tileTypeCosts, observedTileTypes, mapWidth );
+	}
+
+	// Connect the start and end tiles to the entrances of their own clusters
+	int startClusterIdx = graph.GetClusterIdxForTile( startTileIdx );
+	int endClusterIdx = graph.GetClusterIdxForTile( endTileIdx );
+	TileCoords startClusterMins, startClusterMaxs, endClusterMins, endClusterMaxs;
+	graph.GetClusterBounds( startClusterIdx, startClusterMins, startClusterMaxs );
+	graph.GetClusterBounds( endClusterIdx, endClusterMins, endClusterMaxs );
+
+	int costsFromStart[PATH_CLUSTER_TILES];
+	int costsToEnd[PATH_CLUSTER_TILES];
+	int unusedParents[PATH_CLUSTER_TILES];
+	SearchWithinCluster( startTile, false, startClusterMins, startClusterMaxs, observedTileTypes, mapWidth, tileTypeCosts, costsFromStart, unusedParents );
+	SearchWithinCluster( endTile, true, endClusterMins, endClusterMaxs, observedTileTypes, mapWidth, tileTypeCosts, costsToEnd, unusedParents );
+
+	const PathCluster& startCluster = graph.GetCluster( startClusterIdx );
+	bool isStartAnEntrance = startCluster.GetEntranceIdxForTile( startTileIdx ) != -1;
+
+	// A* over entrance tiles, reusing the flat search's per tile scratch
+	PathSearchScratch& scratch = PathGenerator::GetThreadScratch();
+	scratch.BeginSearch();
+	scratch.OpenOrImproveTile( startTileIdx, 0, ( endTile - startTile ).GetTaxicabLength(), -1 );
+
+	auto openTile = [&]( int tileIdx, int gScore, int parentTileIdx )
+	{
+		if ( !scratch.IsClosed( tileIdx ) )
+		{
+			int h = ( endTile - GetTileCoordsFromTileIdx( tileIdx, mapWidth ) ).GetTaxicabLength();
+			scratch.OpenOrImproveTile( tileIdx, gScore, h, parentTileIdx );
+		}
+	};
+
+	bool foundGoal = false;
+	while ( !scratch.IsOpenSetEmpty() )
+	{
+		int curTileIdx = scratch.CloseBestOpenTile();
+		if ( curTileIdx == endTileIdx )
+		{
+			foundGoal = true;
+			break;
+		}
+
+		int curGScore = scratch.GetGScore( curTileIdx );
+		int curClusterIdx = graph.GetClusterIdxForTile( curTileIdx );
+		const PathCluster& curCluster = graph.GetCluster( curClusterIdx );
+
+		if ( curTileIdx == startTileIdx
+			 && !isStartAnEntrance )
+		{
+			for ( int entranceIdx = 0; entranceIdx < curCluster.GetNumEntrances(); ++entranceIdx )
+			{
+				int entranceTileIdx = curCluster.entranceTileIndices[entranceIdx];
+				int cost = costsFromStart[GetLocalTileIdx( GetTileCoordsFromTileIdx( entranceTileIdx, mapWidth ), startClusterMins )];
+				if ( cost != -1 )
+				{
+					openTile( entranceTileIdx, curGScore + cost, curTileIdx );
+				}
+			}
+
+			if ( curClusterIdx == endClusterIdx )
+			{
+				int cost = costsFromStart[GetLocalTileIdx( endTile, startClusterMins )];
+				if ( cost != -1 )
+				{
+					openTile( endTileIdx, curGScore + cost, curTileIdx );
+				}
+			}
+			continue;
+		}
+
+		int curEntranceIdx = curCluster.GetEntranceIdxForTile( curTileIdx );
+		for ( int entranceIdx = 0; entranceIdx < curCluster.GetNumEntrances(); ++entranceIdx )
+		{
+			int cost = curCluster.GetIntraClusterCost( curEntranceIdx, entranceIdx );
+			if ( entranceIdx != curEntranceIdx
+				 && cost != -1 )
+			{
+				openTile( curCluster.entranceTileIndices[entranceIdx], curGScore + cost, curTileIdx );
+			}
+		}
+
+		for ( int crossingIdx = 0; crossingIdx < (int)curCluster.crossingTileIndices.size(); ++crossingIdx )
+		{
+			if ( curCluster.crossingEntranceIndices[crossingIdx] == curEntranceIdx )
+			{
+				int crossingTileIdx = curCluster.crossingTileIndices[crossingIdx];
+				openTile( crossingTileIdx, curGScore + tileTypeCosts[observedTileTypes[crossingTileIdx]] + 1, curTileIdx );
+			}
+		}
+
+		if ( curClusterIdx == endClusterIdx )
+		{
+			int cost = costsToEnd[GetLocalTileIdx( GetTileCoordsFromTileIdx( curTileIdx, mapWidth ), endClusterMins )];
+			if ( cost != -1 )
+			{
+				openTile( endTileIdx, curGScore + cost, curTileIdx );
+			}
+		}
+	}
+
+	if ( !foundGoal )
+	{
+		return pathToGoal;
+	}
+
+	// Walk the entrances back from the end, filling in the tiles between each pair
+	std::vector<int> abstractPath;
+	for ( int tileIdx = endTileIdx; tileIdx != -1; tileIdx = scratch.GetParentTileIdx( tileIdx ) )
+	{
+		abstractPath.push_back( tileIdx );
+	}
+
+	pathToGoal.push_back( endTile );
+	for ( int pathIdx = 0; pathIdx < (int)abstractPath.size() - 1; ++pathIdx )
+	{
+		int toTileIdx = abstractPath[pathIdx];
+		int fromTileIdx = abstractPath[pathIdx + 1];
+		if ( graph.GetClusterIdxForTile( fromTileIdx ) != graph.GetClusterIdxForTile( toTileIdx ) )
+		{
+			// Crossing a border is a single step
+			pathToGoal.push_back( GetTileCoordsFromTileIdx( fromTileIdx, mapWidth ) );
+			continue;
+		}
+
+		AppendPathWithinCluster( pathToGoal, fromTileIdx, toTileIdx, graph, observedTileTypes );
+	}
+
+	return pathToGoal;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "Common.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr int PATH_CLUSTER_WIDTH = 16;
+constexpr int PATH_CLUSTER_TILES = PATH_CLUSTER_WIDTH * PATH_CLUSTER_WIDTH;
+
+// Shorter requests go straight to flat A*, the abstract graph only pays off once a path spans a few clusters
+constexpr int MIN_HIERARCHICAL_PATH_DISTANCE = 2 * PATH_CLUSTER_WIDTH;
+
+
+//-----------------------------------------------------------------------------------------------
+// One square of the arena in the abstract graph. Entrances are tiles on the cluster's edge that step
+// straight into a passable tile of the neighboring cluster, one in the middle of each open stretch of
+// border or one at each end of a long stretch.
+struct PathCluster
+{
+public:
+	int		GetEntranceIdxForTile( int tileIdx ) const;
+	int		GetNumEntrances() const											{ return (int)entranceTileIndices.size(); }
+	int		GetIntraClusterCost( int fromEntranceIdx, int toEntranceIdx ) const	{ return intraClusterCosts[fromEntranceIdx * GetNumEntrances() + toEntranceIdx]; }
+
+public:
+	std::vector<int>	entranceTileIndices;
+	std::vector<int>	crossingEntranceIndices;	// Parallel with crossingTileIndices, a corner entrance can cross two borders
+	std::vector<int>	crossingTileIndices;		// Tile across the border, always an entrance of the neighboring cluster
+	std::vector<int>	intraClusterCosts;			// Cheapest cost between each pair of entrances without leaving the cluster, -1 if none
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Abstract graph over the whole arena for one set of tile type costs. Never changes once built, so
+// workers can share it the same way they share an ObservedMapSnapshot. Clusters that didn't change are
+// shared with the previous graph instead of being rebuilt.
+class PathClusterGraph
+{
+public:
+	// dirtyClusters is indexed by cluster and ignored if there is no previous graph for the same map width
+	PathClusterGraph( const eTileType* observedTileTypes, int mapWidth, const int* tileTypeCosts,
+					  const PathClusterGraph* previousGraph, const std::vector<bool>& dirtyClusters );
+
+	int					GetMapWidth() const							{ return m_mapWidth; }
+	int					GetNumClustersWide() const					{ return m_numClustersWide; }
+	int					GetNumClusters() const						{ return (int)m_clusters.size(); }
+	int					GetNumRebuiltClusters() const				{ return m_numRebuiltClusters; }
+	const int*			GetTileTypeCosts() const					{ return m_tileTypeCosts; }
+	const PathCluster&	GetCluster( int clusterIdx ) const			{ return *m_clusters[clusterIdx]; }
+	int					GetClusterIdxForTile( int tileIdx ) const;
+	void				GetClusterBounds( int clusterIdx, TileCoords& out_mins, TileCoords& out_maxs ) const;
+
+private:
+	int m_mapWidth = 0;
+	int m_numClustersWide = 0;
+	int m_numRebuiltClusters = 0;
+	int m_tileTypeCosts[NUM_TILE_TYPES];
+	std::vector<std::shared_ptr<const PathCluster>> m_clusters;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Keeps the latest graph for each set of tile type costs Colony asks for and which clusters have changed
+// since. Used (read and written) only by the primary DLL thread.
+class PathClusterGraphCache
+{
+public:
+	void				MarkTileChanged( int tileIdx, int mapWidth );
+
+	// Rebuilds only the clusters marked since the last call for the same costs
+	PathClusterGraphPtr	GetGraph( const int* tileTypeCosts, const eTileType* observedTileTypes, int mapWidth );
+
+private:
+	struct CachedGraph
+	{
+		int					tileTypeCosts[NUM_TILE_TYPES];
+		PathClusterGraphPtr	graph;
+		std::vector<bool>	dirtyClusters;
+	};
+
+	std::vector<CachedGraph> m_cachedGraphs;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+class HierarchicalPathGenerator
+{
+public:
+	// Searches the entrances of the graph, then walks each step between entrances tile by tile inside its
+	// cluster. Same path format as PathGenerator::GeneratePath. It finds a path whenever flat A* does, but
+	// the path can cost a little more since it has to pass through entrance tiles.
+	static Path		GeneratePath( const TileCoords& startTile, const TileCoords& endTile, const PathClusterGraph& graph, const eTileType* observedTileTypes );
+};
@@ -0,0 +1,130 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+
+//-----------------------------------------------------------------------------------------------
+// Trimmed copy of the engine's bounded lock free queue (Vyukov's bounded queue), any number of
+// threads can push and pop. Capacity is rounded up to a power of two and slots are allocated up front.
+template<typename T>
+class MPMCRingQueue
+{
+public:
+	explicit MPMCRingQueue( int capacity );
+	~MPMCRingQueue();
+
+	MPMCRingQueue( MPMCRingQueue const& ) = delete;
+	MPMCRingQueue& operator=( MPMCRingQueue const& ) = delete;
+
+	// Returns false when the queue is full
+	bool Push( const T& value );
+	bool Pop( T& out_value );
+
+private:
+	struct Slot
+	{
+		std::atomic<size_t> sequence;
+		T value;
+	};
+
+	Slot* m_slots = nullptr;
+	size_t m_indexMask = 0;
+
+	// Keeps producers and consumers off each other's cache line
+	char m_producerPadding[64];
+	std::atomic<size_t> m_writeIdx{ 0 };
+	char m_consumerPadding[64];
+	std::atomic<size_t> m_readIdx{ 0 };
+};
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+MPMCRingQueue<T>::MPMCRingQueue( int capacity )
+{
+	size_t numSlots = 1;
+	while ( numSlots < (size_t)capacity )
+	{
+		numSlots <<= 1;
+	}
+
+	m_slots = new Slot[numSlots];
+	m_indexMask = numSlots - 1;
+
+	for ( size_t slotIdx = 0; slotIdx < numSlots; ++slotIdx )
+	{
+		m_slots[slotIdx].sequence.store( slotIdx, std::memory_order_relaxed );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+MPMCRingQueue<T>::~MPMCRingQueue()
+{
+	delete[] m_slots;
+	m_slots = nullptr;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+bool MPMCRingQueue<T>::Push( const T& value )
+{
+	size_t writeIdx = m_writeIdx.load( std::memory_order_relaxed );
+	while ( true )
+	{
+		Slot& slot = m_slots[writeIdx & m_indexMask];
+		ptrdiff_t turnOffset = (ptrdiff_t)slot.sequence.load( std::memory_order_acquire ) - (ptrdiff_t)writeIdx;
+
+		if ( turnOffset == 0 )
+		{
+			if ( m_writeIdx.compare_exchange_weak( writeIdx, writeIdx + 1, std::memory_order_relaxed ) )
+			{
+				slot.value = value;
+				slot.sequence.store( writeIdx + 1, std::memory_order_release );
+				return true;
+			}
+		}
+		else if ( turnOffset < 0 )
+		{
+			return false;
+		}
+		else
+		{
+			writeIdx = m_writeIdx.load( std::memory_order_relaxed );
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+bool MPMCRingQueue<T>::Pop( T& out_value )
+{
+	size_t readIdx = m_readIdx.load( std::memory_order_relaxed );
+	while ( true )
+	{
+		Slot& slot = m_slots[readIdx & m_indexMask];
+		ptrdiff_t turnOffset = (ptrdiff_t)slot.sequence.load( std::memory_order_acquire ) - (ptrdiff_t)( readIdx + 1 );
+
+		if ( turnOffset == 0 )
+		{
+			if ( m_readIdx.compare_exchange_weak( readIdx, readIdx + 1, std::memory_order_relaxed ) )
+			{
+				out_value = std::move( slot.value );
+				slot.sequence.store( readIdx + m_indexMask + 1, std::memory_order_release );
+				return true;
+			}
+		}
+		else if ( turnOffset < 0 )
+		{
+			return false;
+		}
+		else
+		{
+			readIdx = m_readIdx.load( std::memory_order_relaxed );
+		}
+	}
+}
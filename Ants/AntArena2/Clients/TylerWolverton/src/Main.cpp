@@ -2,7 +2,7 @@
 #include "Common.hpp"
 #include "Colony.hpp"
 #include "ThreadSafeStructures.hpp"
-#include "SynchronizedNonBlockingQueue.hpp"
+#include "MPMCRingQueue.hpp"
 #include "PathGenerator.hpp"
 
 
@@ -13,8 +13,8 @@ DebugInterface*		g_debug = nullptr;				// Server function interface, use from an
 std::atomic<bool>	g_isExiting = false;			// Set to true only once; signals all threads to exit
 std::atomic<int>	g_threadSafe_threadCount = 0;	// How many threads this DLL was given by the Arena
 
-SynchronizedNonBlockingQueue<GeneratePathRequestData> g_generatePathRequests;
-SynchronizedNonBlockingQueue<PathCompleteData> g_completedPaths;
+MPMCRingQueue<GeneratePathBatch> g_generatePathBatches( MAX_AGENTS_PER_PLAYER );
+MPMCRingQueue<PathCompleteData> g_completedPaths( MAX_AGENTS_PER_PLAYER );
 
 
 //------------------------------------------------------------------------------------------------
@@ -48,17 +48,24 @@ void ThreadMain( bool isPrimaryThread )
 void DoAsyncWork()
 {
 	// Calculate paths and such here
-	GeneratePathRequestData requestData;
-	if ( g_generatePathRequests.Pop( requestData ) )
+	// The batch holds a reference to its map snapshot until it goes out of scope
+	GeneratePathBatch batch;
+	if ( g_generatePathBatches.Pop( batch ) )
 	{
-		// TODO: Just pass request object
-		Path newPath = PathGenerator::GeneratePath( requestData.startTile, requestData.endTile, requestData.tileTypeCosts, requestData.observedTileTypes, requestData.mapWidth );
+		const ObservedMapSnapshot& mapSnapshot = *batch.mapSnapshot;
+		for ( int requestIdx = 0; requestIdx < (int)batch.requests.size(); ++requestIdx )
+		{
+			const GeneratePathRequestData& requestData = batch.requests[requestIdx];
 
-		PathCompleteData completeData;
-		completeData.id = requestData.id;
-		completeData.pathToGoal = newPath;
-		g_completedPaths.Push( completeData );
-		
+			PathCompleteData completeData;
+			completeData.id = requestData.id;
+			completeData.pathToGoal = PathGenerator::GeneratePath( requestData, mapSnapshot );
+			// The ant is waiting on this path, so it can't be dropped
+			while ( !g_completedPaths.Push( completeData ) && !g_isExiting )
+			{
+				std::this_thread::yield();
+			}
+		}
 	}
 
 	std::this_thread::yield();
@@ -1,165 +1,266 @@
 #include "PathGenerator.hpp"
+#include "HierarchicalPathGenerator.hpp"
+
+#include <algorithm>
 
 
 //-----------------------------------------------------------------------------------------------
-Path PathGenerator::GeneratePath( const TileCoords& startTile, const TileCoords& endTile, const int* tileTypeCosts, const eTileType* observedTileTypes, int mapWidth )
+PathSearchScratch::PathSearchScratch()
 {
-	Path pathToGoal;
+	m_visitedGenerations.resize( MAX_ARENA_TILES, 0 );
+	m_closedGenerations.resize( MAX_ARENA_TILES, 0 );
+	m_gScores.resize( MAX_ARENA_TILES, 0 );
+	m_hCosts.resize( MAX_ARENA_TILES, 0 );
+	m_parentTileIndices.resize( MAX_ARENA_TILES, -1 );
+	m_heapPositions.resize( MAX_ARENA_TILES, -1 );
+	m_openHeap.reserve( MAX_ARENA_TILES );
+}
 
-	TileCoords tileCoordsDiff = endTile - startTile;
 
-	// Heuristic for how far away the goal may be
-	int totalH = tileCoordsDiff.GetTaxicabLength();
+//-----------------------------------------------------------------------------------------------
+void PathSearchScratch::BeginSearch()
+{
+	m_openHeap.clear();
 
-	// TODO: Turn this into a map by total cost
-	std::vector<PathNode> openTiles;
-	openTiles.reserve( totalH * 4 );
-	openTiles.emplace_back( startTile, 0, 0, totalH, 0, -1 );
+	++m_generation;
+	if ( m_generation == 0 )
+	{
+		// Wrapped around, old generations could match again so start fresh
+		std::fill( m_visitedGenerations.begin(), m_visitedGenerations.end(), 0 );
+		std::fill( m_closedGenerations.begin(), m_closedGenerations.end(), 0 );
+		m_generation = 1;
+	}
+}
 
-	bool foundGoal = false;
-	PathNode endNode = openTiles[0];
-	while ( !foundGoal 
-			|| openTiles.size() > mapWidth * mapWidth * .5f )
+
+//-----------------------------------------------------------------------------------------------
+void PathSearchScratch::OpenOrImproveTile( int tileIdx, int gScore, int h, int parentTileIdx )
+{
+	if ( !IsVisited( tileIdx ) )
 	{
-		int bestNodeIdx = GetBestOpenNode( openTiles );
-		if ( bestNodeIdx == -1
-			 || bestNodeIdx > openTiles.size() - 1 )
-		{
-			return pathToGoal;
-		}
+		m_visitedGenerations[tileIdx] = m_generation;
+		m_gScores[tileIdx] = gScore;
+		m_hCosts[tileIdx] = h;
+		m_parentTileIndices[tileIdx] = parentTileIdx;
+
+		m_openHeap.push_back( tileIdx );
+		m_heapPositions[tileIdx] = (int)m_openHeap.size() - 1;
+		SiftUp( (int)m_openHeap.size() - 1 );
+		return;
+	}
+
+	if ( IsClosed( tileIdx )
+		 || gScore >= m_gScores[tileIdx] )
+	{
+		return;
+	}
+
+	// Decrease key, h doesn't change so a lower g can only move the tile up
+	m_gScores[tileIdx] = gScore;
+	m_parentTileIndices[tileIdx] = parentTileIdx;
+	SiftUp( m_heapPositions[tileIdx] );
+}
 
-		PathNode& nodeToProcess = openTiles[bestNodeIdx];
 
-		if ( OpenAdjacentTile( openTiles, eCardinalDirections::EAST,  nodeToProcess, endTile, tileTypeCosts, observedTileTypes, mapWidth ) ) { endNode = openTiles[openTiles.size() - 1]; break; }
-		if ( OpenAdjacentTile( openTiles, eCardinalDirections::WEST,  nodeToProcess, endTile, tileTypeCosts, observedTileTypes, mapWidth ) ) { endNode = openTiles[openTiles.size() - 1]; break; }
-		if ( OpenAdjacentTile( openTiles, eCardinalDirections::NORTH, nodeToProcess, endTile, tileTypeCosts, observedTileTypes, mapWidth ) ) { endNode = openTiles[openTiles.size() - 1]; break; }
-		if ( OpenAdjacentTile( openTiles, eCardinalDirections::SOUTH, nodeToProcess, endTile, tileTypeCosts, observedTileTypes, mapWidth ) ) { endNode = openTiles[openTiles.size() - 1]; break; }
+//-----------------------------------------------------------------------------------------------
+int PathSearchScratch::CloseBestOpenTile()
+{
+	int bestTileIdx = m_openHeap[0];
 
-		nodeToProcess.hasBeenProcessed = true;
+	int lastTileIdx = m_openHeap.back();
+	m_openHeap.pop_back();
+	if ( !m_openHeap.empty() )
+	{
+		SetHeapEntry( 0, lastTileIdx );
+		SiftDown( 0 );
 	}
 
-	int nextNodeIdx = endNode.idx;
-	while ( nextNodeIdx != -1 
-			&& nextNodeIdx < openTiles.size() )
+	m_heapPositions[bestTileIdx] = -1;
+	m_closedGenerations[bestTileIdx] = m_generation;
+	return bestTileIdx;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool PathSearchScratch::IsBetterOpenTile( int tileIdxA, int tileIdxB ) const
+{
+	int fCostA = m_gScores[tileIdxA] + m_hCosts[tileIdxA];
+	int fCostB = m_gScores[tileIdxB] + m_hCosts[tileIdxB];
+	if ( fCostA != fCostB )
 	{
-		PathNode const& nextNode = openTiles[nextNodeIdx];
-		pathToGoal.push_back( nextNode.tileCoords );
-		nextNodeIdx = nextNode.fromNodeIdx;
+		return fCostA < fCostB;
 	}
 
-	return pathToGoal;
+	return m_hCosts[tileIdxA] < m_hCosts[tileIdxB];
 }
 
 
 //-----------------------------------------------------------------------------------------------
-int PathGenerator::GetBestOpenNode( std::vector<PathNode>& openTiles )
+void PathSearchScratch::SetHeapEntry( int heapPos, int tileIdx )
 {
-	// Don't call this with an empty list
+	m_openHeap[heapPos] = tileIdx;
+	m_heapPositions[tileIdx] = heapPos;
+}
 
-	if ( openTiles.size() == 1 )
+
+//-----------------------------------------------------------------------------------------------
+void PathSearchScratch::SiftUp( int heapPos )
+{
+	int tileIdx = m_openHeap[heapPos];
+	while ( heapPos > 0 )
 	{
-		return 0;
+		int parentHeapPos = ( heapPos - 1 ) / 2;
+		if ( !IsBetterOpenTile( tileIdx, m_openHeap[parentHeapPos] ) )
+		{
+			break;
+		}
+
+		SetHeapEntry( heapPos, m_openHeap[parentHeapPos] );
+		heapPos = parentHeapPos;
 	}
 
-	// TODO: What if last node has been processed?
-	int bestTileIdx = 0;
-	int lowestFCost = 9999999;
-	int lowestHCost = 9999999;
+	SetHeapEntry( heapPos, tileIdx );
+}
+
 
-	for ( int tileIdx = 0; tileIdx < (int)openTiles.size(); ++tileIdx )
+//-----------------------------------------------------------------------------------------------
+void PathSearchScratch::SiftDown( int heapPos )
+{
+	int tileIdx = m_openHeap[heapPos];
+	int heapSize = (int)m_openHeap.size();
+	while ( true )
 	{
-		if ( openTiles[tileIdx].hasBeenProcessed )
+		int childHeapPos = heapPos * 2 + 1;
+		if ( childHeapPos >= heapSize )
 		{
-			continue;
+			break;
 		}
 
-		if ( openTiles[tileIdx].GetFCost() < lowestFCost )
+		if ( childHeapPos + 1 < heapSize
+			 && IsBetterOpenTile( m_openHeap[childHeapPos + 1], m_openHeap[childHeapPos] ) )
 		{
-			bestTileIdx = tileIdx;
-			lowestFCost = openTiles[tileIdx].GetFCost();
-			lowestHCost = openTiles[tileIdx].h;
+			++childHeapPos;
 		}
-		else if ( openTiles[tileIdx].GetFCost() == lowestFCost
-				  && openTiles[tileIdx].h < lowestHCost )
+
+		if ( !IsBetterOpenTile( m_openHeap[childHeapPos], tileIdx ) )
 		{
-			bestTileIdx = tileIdx;
-			lowestFCost = openTiles[tileIdx].GetFCost();
-			lowestHCost = openTiles[tileIdx].h;
+			break;
 		}
-	}
 
-	// TODO: Make sure it's never valid to process starting node again
-	if ( bestTileIdx == 0 )
-	{
-		bestTileIdx = -1;
+		SetHeapEntry( heapPos, m_openHeap[childHeapPos] );
+		heapPos = childHeapPos;
 	}
 
-	return bestTileIdx;
+	SetHeapEntry( heapPos, tileIdx );
 }
 
 
 //-----------------------------------------------------------------------------------------------
-bool PathGenerator::OpenAdjacentTile( std::vector<PathNode>& openTiles, eCardinalDirections direction,
-							   const PathNode& curTile, const TileCoords& endTileCoords,
-							   const int* tileTypeCosts, const eTileType* observedTileTypes, int mapWidth )
+Path PathGenerator::GeneratePath( const TileCoords& startTile, const TileCoords& endTile, const int* tileTypeCosts, const eTileType* observedTileTypes, int mapWidth )
 {
-	int tileIdx = GetAdjacentTileIdx( curTile.tileCoords, direction, mapWidth );
-	// Check for tile outside map
-	if ( tileIdx == -1 )
+	Path pathToGoal;
+
+	int startTileIdx = GetTileIdxFromTileCoords( startTile, mapWidth );
+	int endTileIdx = GetTileIdxFromTileCoords( endTile, mapWidth );
+	if ( startTileIdx == -1
+		 || endTileIdx == -1 )
 	{
-		return false;
+		return pathToGoal;
 	}
 
-	TileCoords adjacentTileCoords = GetTileCoordsFromTileIdx( tileIdx, mapWidth );
-	TileCoords tileCoordsDiff = endTileCoords - adjacentTileCoords;
+	PathSearchScratch& scratch = GetThreadScratch();
+	scratch.BeginSearch();
+	scratch.OpenOrImproveTile( startTileIdx, 0, ( endTile - startTile ).GetTaxicabLength(), -1 );
+
+	bool foundGoal = false;
+	while ( !scratch.IsOpenSetEmpty() )
+	{
+		int curTileIdx = scratch.CloseBestOpenTile();
+		if ( curTileIdx == endTileIdx )
+		{
+			foundGoal = true;
+			break;
+		}
+
+		TileCoords curTileCoords = GetTileCoordsFromTileIdx( curTileIdx, mapWidth );
+		int curGScore = scratch.GetGScore( curTileIdx );
 
-	int h = tileCoordsDiff.GetTaxicabLength();
+		for ( int directionIdx = 0; directionIdx < NUM_DIRECTIONS; ++directionIdx )
+		{
+			int adjacentTileIdx = GetAdjacentTileIdx( curTileCoords, (eCardinalDirections)directionIdx, mapWidth );
+			if ( adjacentTileIdx == -1
+				 || scratch.IsClosed( adjacentTileIdx ) )
+			{
+				continue;
+			}
 
-	if ( observedTileTypes[tileIdx] == TILE_TYPE_UNSEEN )
+			eTileType tileType = observedTileTypes[adjacentTileIdx];
+			if ( tileType == TILE_TYPE_UNSEEN )
+			{
+				continue;
+			}
+
+			int gPenalty = tileTypeCosts[tileType];
+			if ( gPenalty == -1 )
+			{
+				continue;
+			}
+
+			int h = ( endTile - GetTileCoordsFromTileIdx( adjacentTileIdx, mapWidth ) ).GetTaxicabLength();
+			scratch.OpenOrImproveTile( adjacentTileIdx, curGScore + gPenalty + 1, h, curTileIdx );
+		}
+	}
+
+	if ( !foundGoal )
 	{
-		return false;
+		return pathToGoal;
 	}
 
-	int gPenalty = tileTypeCosts[observedTileTypes[tileIdx]];
-	if ( gPenalty == -1 )
+	for ( int tileIdx = endTileIdx; tileIdx != -1; tileIdx = scratch.GetParentTileIdx( tileIdx ) )
 	{
-		return false;
+		pathToGoal.push_back( GetTileCoordsFromTileIdx( tileIdx, mapWidth ) );
 	}
 
+	return pathToGoal;
+}
+
 
-	eCardinalDirections fromDirection = NONE;
-	switch ( direction )
+//-----------------------------------------------------------------------------------------------
+Path PathGenerator::GeneratePath( const GeneratePathRequestData& request, const ObservedMapSnapshot& mapSnapshot )
+{
+	if ( request.clusterGraph != nullptr )
 	{
-		case NORTH: fromDirection = SOUTH; break;
-		case SOUTH: fromDirection = NORTH; break;
-		case EAST:	fromDirection = WEST; break;
-		case WEST:	fromDirection = EAST; break;
+		return HierarchicalPathGenerator::GeneratePath( request.startTile, request.endTile, *request.clusterGraph, mapSnapshot.observedTileTypes );
 	}
 
-	// Check if we found end
-	if ( tileCoordsDiff == TileCoords( 0, 0 ) )
+	return GeneratePath( request.startTile, request.endTile, request.tileTypeCosts, mapSnapshot.observedTileTypes, mapSnapshot.mapWidth );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int PathGenerator::GetPathCost( const Path& path, const int* tileTypeCosts, const eTileType* observedTileTypes, int mapWidth )
+{
+	if ( path.empty() )
 	{
-		openTiles.emplace_back( adjacentTileCoords, gPenalty, curTile.gTotal, 0, (int)openTiles.size(), curTile.idx );
-		return true;
+		return -1;
 	}
 
-	// See if we've found this node and update if a shorter path
-	for ( int tileIdx = 0; tileIdx < (int)openTiles.size(); ++tileIdx )
+	// The start tile is last and isn't entered
+	int totalCost = 0;
+	for ( int pathIdx = 0; pathIdx < (int)path.size() - 1; ++pathIdx )
 	{
-		if ( openTiles[tileIdx].tileCoords == adjacentTileCoords )
-		{
-			if ( gPenalty + curTile.gTotal + h < openTiles[tileIdx].GetFCost() )
-			{
-				openTiles[tileIdx].gTotal = curTile.gTotal + h;
-				if ( curTile.fromNodeIdx != openTiles[tileIdx].idx )
-				{
-					openTiles[tileIdx].fromNodeIdx = curTile.fromNodeIdx;
-				}
-			}
-			return false;
-		}
+		int tileIdx = GetTileIdxFromTileCoords( path[pathIdx], mapWidth );
+		totalCost += tileTypeCosts[observedTileTypes[tileIdx]] + 1;
 	}
 
-	openTiles.emplace_back( adjacentTileCoords, gPenalty, curTile.gTotal, h, (int)openTiles.size(), curTile.idx );
-	return false;
+	return totalCost;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+PathSearchScratch& PathGenerator::GetThreadScratch()
+{
+	// Each worker thread searches independently, so each gets its own scratch
+	static thread_local PathSearchScratch s_scratch;
+	return s_scratch;
 }
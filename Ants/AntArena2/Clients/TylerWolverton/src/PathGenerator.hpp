@@ -3,34 +3,43 @@
 
 
 //-----------------------------------------------------------------------------------------------
-struct PathNode
+// A* state indexed by tile, sized to MAX_ARENA_TILES once per thread and reused by every search.
+// A tile's entries only count when its generation matches the current search, so starting a new
+// search is just bumping the generation instead of clearing or reallocating anything.
+class PathSearchScratch
 {
 public:
-	PathNode() = default;
-	PathNode( const TileCoords& tileCoords, int gPenalty, int gLast, int h, int idx, int fromNodeIdx )
-		: tileCoords( tileCoords )
-		, gHere( gPenalty + 1 )
-		, h( h )
-		, idx( idx )
-		, fromNodeIdx( fromNodeIdx )
-	{
-		gTotal = gHere + gLast;
-	}
-
-	TileCoords tileCoords = TILE_COORDS_INVALID;
-	int idx = -1;
-	int fromNodeIdx = -1;
-
-	int gHere = 1;
-	int gTotal = 9999999;
-	int h = 999999;
-
-	// TODO: Turn these into flags?
-	bool hasBeenProcessed = false;
-	//bool isOpen = true;
-
-public:
-	int GetFCost() const { return gTotal + h; }
+	PathSearchScratch();
+
+	void	BeginSearch();
+
+	bool	IsVisited( int tileIdx ) const						{ return m_visitedGenerations[tileIdx] == m_generation; }
+	bool	IsClosed( int tileIdx ) const						{ return m_closedGenerations[tileIdx] == m_generation; }
+	int		GetGScore( int tileIdx ) const						{ return m_gScores[tileIdx]; }
+	int		GetParentTileIdx( int tileIdx ) const				{ return m_parentTileIndices[tileIdx]; }
+
+	// Open set, an indexed binary min heap on f cost with ties going to the lower h.
+	// Opening a tile that is already open only moves it up the heap if the new g score is lower.
+	void	OpenOrImproveTile( int tileIdx, int gScore, int h, int parentTileIdx );
+	// Pops the best open tile and closes it
+	int		CloseBestOpenTile();
+	bool	IsOpenSetEmpty() const								{ return m_openHeap.empty(); }
+
+private:
+	bool	IsBetterOpenTile( int tileIdxA, int tileIdxB ) const;
+	void	SetHeapEntry( int heapPos, int tileIdx );
+	void	SiftUp( int heapPos );
+	void	SiftDown( int heapPos );
+
+private:
+	unsigned int m_generation = 0;
+	std::vector<unsigned int> m_visitedGenerations;
+	std::vector<unsigned int> m_closedGenerations;
+	std::vector<int> m_gScores;
+	std::vector<int> m_hCosts;
+	std::vector<int> m_parentTileIndices;
+	std::vector<int> m_heapPositions;
+	std::vector<int> m_openHeap;
 };
 
 
@@ -38,9 +47,15 @@ public:
 class PathGenerator
 {
 public:
+	// Path runs from endTile back to startTile, both included, and is empty if there is no path.
+	// Entering a tile costs 1 plus its tileTypeCosts entry, -1 marks a tile as impassable.
 	static Path		GeneratePath( const TileCoords& startTile, const TileCoords& endTile, const int* tileTypeCosts, const eTileType* observedTileTypes, int mapWidth );
-	static int		GetBestOpenNode( std::vector<PathNode>& openTiles );
-	static bool		OpenAdjacentTile( std::vector<PathNode>& openTiles, eCardinalDirections direction,
-								  const PathNode& curTile, const TileCoords& endTileCoords,
-								  const int* tileTypeCosts, const eTileType* observedTileTypes, int mapWidth );
+	// Goes through HierarchicalPathGenerator when the request carries a cluster graph
+	static Path		GeneratePath( const GeneratePathRequestData& request, const ObservedMapSnapshot& mapSnapshot );
+
+	// Total cost of walking a path returned by GeneratePath, -1 for an empty path
+	static int		GetPathCost( const Path& path, const int* tileTypeCosts, const eTileType* observedTileTypes, int mapWidth );
+
+	// Shared by every search on the calling thread, only one search can use it at a time
+	static PathSearchScratch& GetThreadScratch();
 };
@@ -0,0 +1,932 @@
+#include "PathGeneratorBenchmark.hpp"
+#include "PathGenerator.hpp"
+#include "HierarchicalPathGenerator.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <random>
+#include <thread>
+
+
+//-----------------------------------------------------------------------------------------------
+// The search PathGenerator used before the binary heap open set, kept to benchmark against.
+// The open list is a vector scanned in full for the best node and again for duplicates.
+//-----------------------------------------------------------------------------------------------
+struct LegacyPathNode
+{
+public:
+	LegacyPathNode() = default;
+	LegacyPathNode( const TileCoords& tileCoords, int gPenalty, int gLast, int h, int idx, int fromNodeIdx )
+		: tileCoords( tileCoords )
+		, idx( idx )
+		, fromNodeIdx( fromNodeIdx )
+		, gHere( gPenalty + 1 )
+		, h( h )
+	{
+		gTotal = gHere + gLast;
+	}
+
+	TileCoords tileCoords = TILE_COORDS_INVALID;
+	int idx = -1;
+	int fromNodeIdx = -1;
+
+	int gHere = 1;
+	int gTotal = 9999999;
+	int h = 999999;
+
+	bool hasBeenProcessed = false;
+
+public:
+	int GetFCost() const { return gTotal + h; }
+};
+
+
+//-----------------------------------------------------------------------------------------------
+static int GetLegacyBestOpenNode( std::vector<LegacyPathNode>& openTiles )
+{
+	if ( openTiles.size() == 1 )
+	{
+		return 0;
+	}
+
+	int bestTileIdx = 0;
+	int lowestFCost = 9999999;
+	int lowestHCost = 9999999;
+
+	for ( int tileIdx = 0; tileIdx < (int)openTiles.size(); ++tileIdx )
+	{
+		if ( openTiles[tileIdx].hasBeenProcessed )
+		{
+			continue;
+		}
+
+		if ( openTiles[tileIdx].GetFCost() < lowestFCost
+			 || ( openTiles[tileIdx].GetFCost() == lowestFCost && openTiles[tileIdx].h < lowestHCost ) )
+		{
+			bestTileIdx = tileIdx;
+			lowestFCost = openTiles[tileIdx].GetFCost();
+			lowestHCost = openTiles[tileIdx].h;
+		}
+	}
+
+	if ( bestTileIdx == 0 )
+	{
+		bestTileIdx = -1;
+	}
+
+	return bestTileIdx;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static bool OpenLegacyAdjacentTile( std::vector<LegacyPathNode>& openTiles, eCardinalDirections direction,
+									const LegacyPathNode& curTile, const TileCoords& endTileCoords,
+									const int* tileTypeCosts, const eTileType* observedTileTypes, int mapWidth )
+{
+	int tileIdx = GetAdjacentTileIdx( curTile.tileCoords, direction, mapWidth );
+	if ( tileIdx == -1 )
+	{
+		return false;
+	}
+
+	TileCoords adjacentTileCoords = GetTileCoordsFromTileIdx( tileIdx, mapWidth );
+	TileCoords tileCoordsDiff = endTileCoords - adjacentTileCoords;
+
+	int h = tileCoordsDiff.GetTaxicabLength();
+
+	if ( observedTileTypes[tileIdx] == TILE_TYPE_UNSEEN )
+	{
+		return false;
+	}
+
+	int gPenalty = tileTypeCosts[observedTileTypes[tileIdx]];
+	if ( gPenalty == -1 )
+	{
+		return false;
+	}
+
+	if ( tileCoordsDiff == TileCoords( 0, 0 ) )
+	{
+		openTiles.emplace_back( adjacentTileCoords, gPenalty, curTile.gTotal, 0, (int)openTiles.size(), curTile.idx );
+		return true;
+	}
+
+	for ( int openTileIdx = 0; openTileIdx < (int)openTiles.size(); ++openTileIdx )
+	{
+		if ( openTiles[openTileIdx].tileCoords == adjacentTileCoords )
+		{
+			if ( gPenalty + curTile.gTotal + h < openTiles[openTileIdx].GetFCost() )
+			{
+				openTiles[openTileIdx].gTotal = curTile.gTotal + h;
+				if ( curTile.fromNodeIdx != openTiles[openTileIdx].idx )
+				{
+					openTiles[openTileIdx].fromNodeIdx = curTile.fromNodeIdx;
+				}
+			}
+			return false;
+		}
+	}
+
+	openTiles.emplace_back( adjacentTileCoords, gPenalty, curTile.gTotal, h, (int)openTiles.size(), curTile.idx );
+	return false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static Path GenerateLegacyPath( const TileCoords& startTile, const TileCoords& endTile, const int* tileTypeCosts, const eTileType* observedTileTypes, int mapWidth )
+{
+	Path pathToGoal;
+
+	int totalH = ( endTile - startTile ).GetTaxicabLength();
+
+	std::vector<LegacyPathNode> openTiles;
+	openTiles.reserve( totalH * 4 );
+	openTiles.emplace_back( startTile, 0, 0, totalH, 0, -1 );
+
+	LegacyPathNode endNode = openTiles[0];
+	while ( true )
+	{
+		int bestNodeIdx = GetLegacyBestOpenNode( openTiles );
+		if ( bestNodeIdx == -1 )
+		{
+			return pathToGoal;
+		}
+
+		// Copied since opening tiles can grow the vector out from under a reference
+		LegacyPathNode nodeToProcess = openTiles[bestNodeIdx];
+
+		bool foundGoal = false;
+		for ( int directionIdx = 0; directionIdx < NUM_DIRECTIONS && !foundGoal; ++directionIdx )
+		{
+			foundGoal = OpenLegacyAdjacentTile( openTiles, (eCardinalDirections)directionIdx, nodeToProcess, endTile, tileTypeCosts, observedTileTypes, mapWidth );
+		}
+
+		if ( foundGoal )
+		{
+			endNode = openTiles[openTiles.size() - 1];
+			break;
+		}
+
+		openTiles[bestNodeIdx].hasBeenProcessed = true;
+	}
+
+	int nextNodeIdx = endNode.idx;
+	while ( nextNodeIdx != -1 )
+	{
+		const LegacyPathNode& nextNode = openTiles[nextNodeIdx];
+		pathToGoal.push_back( nextNode.tileCoords );
+		nextNodeIdx = nextNode.fromNodeIdx;
+	}
+
+	return pathToGoal;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Plain Dijkstra over the whole map, slow but obviously optimal. Returns -1 if the end can't be reached.
+//-----------------------------------------------------------------------------------------------
+static int GetOptimalPathCost( const TileCoords& startTile, const TileCoords& endTile, const int* tileTypeCosts, const eTileType* observedTileTypes, int mapWidth )
+{
+	typedef std::pair<int, int> CostAndTileIdx;
+
+	std::vector<int> bestCosts( mapWidth * mapWidth, INT_MAX );
+	std::priority_queue<CostAndTileIdx, std::vector<CostAndTileIdx>, std::greater<CostAndTileIdx>> openTiles;
+
+	int startTileIdx = GetTileIdxFromTileCoords( startTile, mapWidth );
+	int endTileIdx = GetTileIdxFromTileCoords( endTile, mapWidth );
+	bestCosts[startTileIdx] = 0;
+	openTiles.push( CostAndTileIdx( 0, startTileIdx ) );
+
+	while ( !openTiles.empty() )
+	{
+		CostAndTileIdx cur = openTiles.top();
+		openTiles.pop();
+		if ( cur.second == endTileIdx )
+		{
+			return cur.first;
+		}
+
+		if ( cur.first > bestCosts[cur.second] )
+		{
+			continue;
+		}
+
+		TileCoords curTileCoords = GetTileCoordsFromTileIdx( cur.second, mapWidth );
+		for ( int directionIdx = 0; directionIdx < NUM_DIRECTIONS; ++directionIdx )
+		{
+			int adjacentTileIdx = GetAdjacentTileIdx( curTileCoords, (eCardinalDirections)directionIdx, mapWidth );
+			if ( adjacentTileIdx == -1
+				 || observedTileTypes[adjacentTileIdx] == TILE_TYPE_UNSEEN
+				 || tileTypeCosts[observedTileTypes[adjacentTileIdx]] == -1 )
+			{
+				continue;
+			}
+
+			int cost = cur.first + tileTypeCosts[observedTileTypes[adjacentTileIdx]] + 1;
+			if ( cost < bestCosts[adjacentTileIdx] )
+			{
+				bestCosts[adjacentTileIdx] = cost;
+				openTiles.push( CostAndTileIdx( cost, adjacentTileIdx ) );
+			}
+		}
+	}
+
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static eTileType RollRandomTileType( std::mt19937& rng )
+{
+	// Roughly an underground arena, mostly open air and dirt with some walls, water and fog
+	int roll = (int)( rng() % 100 );
+	if ( roll < 45 )	return TILE_TYPE_AIR;
+	if ( roll < 75 )	return TILE_TYPE_DIRT;
+	if ( roll < 87 )	return TILE_TYPE_STONE;
+	if ( roll < 92 )	return TILE_TYPE_WATER;
+	if ( roll < 95 )	return TILE_TYPE_CORPSE_BRIDGE;
+	return TILE_TYPE_UNSEEN;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// What Colony used to queue for each path, a full copy of the observed map rides along with every request
+//-----------------------------------------------------------------------------------------------
+struct LegacyPathRequest
+{
+public:
+	AgentID		id = INVALID_AGENT_ID;
+	TileCoords	startTile = TILE_COORDS_INVALID;
+	TileCoords	endTile = TILE_COORDS_INVALID;
+	int			tileTypeCosts[NUM_TILE_TYPES];
+	eTileType	observedTileTypes[MAX_ARENA_TILES];
+	int			mapWidth = 0;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// One recorded turn, tile changes are applied before any of the turn's requests are made
+struct ReplayTurn
+{
+public:
+	std::vector<int>						changedTileIndices;
+	std::vector<eTileType>					changedTileTypes;
+	std::vector<GeneratePathRequestData>	requests;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+struct ReplayRunResults
+{
+public:
+	std::vector<int>	pathCosts;			// Indexed by request id
+	std::vector<double>	latenciesMs;		// Indexed by request id
+	size_t				numBytesCopied = 0;
+	int					numSnapshotsPublished = 0;
+};
+
+
+typedef std::chrono::high_resolution_clock ReplayClock;
+
+
+//-----------------------------------------------------------------------------------------------
+static std::vector<ReplayTurn> RecordReplayTurns( int numTurns, int numRequestsPerTurn, int mapWidth, std::mt19937& rng )
+{
+	std::vector<ReplayTurn> turns( numTurns );
+
+	AgentID nextRequestID = 0;
+	for ( int turnIdx = 0; turnIdx < numTurns; ++turnIdx )
+	{
+		ReplayTurn& turn = turns[turnIdx];
+
+		// The first turn reveals the whole arena, after that about half the turns see some digging or new tiles
+		int numChangedTiles = mapWidth * mapWidth;
+		if ( turnIdx > 0 )
+		{
+			numChangedTiles = ( rng() % 2 == 0 ) ? 0 : 1 + (int)( rng() % mapWidth );
+		}
+
+		for ( int changeIdx = 0; changeIdx < numChangedTiles; ++changeIdx )
+		{
+			turn.changedTileIndices.push_back( turnIdx == 0 ? changeIdx : (int)( rng() % ( mapWidth * mapWidth ) ) );
+			turn.changedTileTypes.push_back( RollRandomTileType( rng ) );
+		}
+
+		for ( int requestIdx = 0; requestIdx < numRequestsPerTurn; ++requestIdx )
+		{
+			GeneratePathRequestData request;
+			request.id = nextRequestID++;
+			request.startTile = TileCoords( (int)( rng() % mapWidth ), (int)( rng() % mapWidth ) );
+			request.endTile = TileCoords( (int)( rng() % mapWidth ), (int)( rng() % mapWidth ) );
+
+			// Same costs Colony uses, workers and scouts dig while the rest go around dirt
+			request.tileTypeCosts[TILE_TYPE_AIR] = 0;
+			request.tileTypeCosts[TILE_TYPE_CORPSE_BRIDGE] = 0;
+			request.tileTypeCosts[TILE_TYPE_STONE] = -1;
+			request.tileTypeCosts[TILE_TYPE_WATER] = -1;
+			int antTypeRoll = (int)( rng() % 4 );
+			request.tileTypeCosts[TILE_TYPE_DIRT] = antTypeRoll == 0 ? 1 : ( antTypeRoll == 1 ? 0 : -1 );
+
+			turn.requests.push_back( request );
+		}
+	}
+
+	return turns;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Pops completed paths until every request up to endRequestID is back, recording costs and latencies
+static void DrainReplayCompletions( MPMCRingQueue<PathCompleteData>& completedPaths, AgentID endRequestID, AgentID& nextRequestID,
+									const std::vector<ReplayClock::time_point>& requestTimes, const std::vector<eTileType>& observedTileTypes,
+									const std::vector<ReplayTurn>& turns, int numRequestsPerTurn, int mapWidth, ReplayRunResults& out_results )
+{
+	PathCompleteData completeData;
+	while ( nextRequestID < endRequestID )
+	{
+		if ( !completedPaths.Pop( completeData ) )
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		ReplayClock::time_point completeTime = ReplayClock::now();
+		out_results.latenciesMs[completeData.id] = std::chrono::duration<double, std::milli>( completeTime - requestTimes[completeData.id] ).count();
+
+		const GeneratePathRequestData& request = turns[completeData.id / numRequestsPerTurn].requests[completeData.id % numRequestsPerTurn];
+		out_results.pathCosts[completeData.id] = PathGenerator::GetPathCost( completeData.pathToGoal, request.tileTypeCosts, observedTileTypes.data(), mapWidth );
+		++nextRequestID;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static ReplayRunResults ReplayWithPerRequestCopies( const std::vector<ReplayTurn>& turns, int numRequestsPerTurn, int mapWidth, int numWorkers )
+{
+	int numRequests = (int)turns.size() * numRequestsPerTurn;
+
+	ReplayRunResults results;
+	results.pathCosts.resize( numRequests, -1 );
+	results.latenciesMs.resize( numRequests, 0.0 );
+
+	MPMCRingQueue<LegacyPathRequest> requestQueue( MAX_AGENTS_PER_PLAYER );
+	MPMCRingQueue<PathCompleteData> completedPaths( MAX_AGENTS_PER_PLAYER );
+	std::atomic<bool> isDone( false );
+
+	std::vector<std::thread> workers;
+	for ( int workerIdx = 0; workerIdx < numWorkers; ++workerIdx )
+	{
+		workers.emplace_back( [&]()
+		{
+			std::unique_ptr<LegacyPathRequest> request( new LegacyPathRequest() );
+			while ( !isDone )
+			{
+				if ( !requestQueue.Pop( *request ) )
+				{
+					std::this_thread::yield();
+					continue;
+				}
+
+				PathCompleteData completeData;
+				completeData.id = request->id;
+				completeData.pathToGoal = PathGenerator::GeneratePath( request->startTile, request->endTile, request->tileTypeCosts, request->observedTileTypes, request->mapWidth );
+				while ( !completedPaths.Push( completeData ) && !isDone )
+				{
+					std::this_thread::yield();
+				}
+			}
+		} );
+	}
+
+	std::vector<eTileType> observedTileTypes( MAX_ARENA_TILES, TILE_TYPE_UNSEEN );
+	std::vector<ReplayClock::time_point> requestTimes( numRequests );
+	std::unique_ptr<LegacyPathRequest> request( new LegacyPathRequest() );
+	AgentID nextCompletedRequestID = 0;
+	for ( int turnIdx = 0; turnIdx < (int)turns.size(); ++turnIdx )
+	{
+		const ReplayTurn& turn = turns[turnIdx];
+		for ( int changeIdx = 0; changeIdx < (int)turn.changedTileIndices.size(); ++changeIdx )
+		{
+			observedTileTypes[turn.changedTileIndices[changeIdx]] = turn.changedTileTypes[changeIdx];
+		}
+
+		for ( int requestIdx = 0; requestIdx < (int)turn.requests.size(); ++requestIdx )
+		{
+			const GeneratePathRequestData& turnRequest = turn.requests[requestIdx];
+			requestTimes[turnRequest.id] = ReplayClock::now();
+
+			request->id = turnRequest.id;
+			request->startTile = turnRequest.startTile;
+			request->endTile = turnRequest.endTile;
+			memcpy( request->tileTypeCosts, turnRequest.tileTypeCosts, sizeof( request->tileTypeCosts ) );
+			memcpy( request->observedTileTypes, observedTileTypes.data(), MAX_ARENA_TILES * sizeof( eTileType ) );
+			request->mapWidth = mapWidth;
+
+			while ( !requestQueue.Push( *request ) )
+			{
+				std::this_thread::yield();
+			}
+
+			// Built here, copied into the queue slot, then copied out again by the worker
+			results.numBytesCopied += 3 * sizeof( LegacyPathRequest );
+		}
+
+		DrainReplayCompletions( completedPaths, ( turnIdx + 1 ) * numRequestsPerTurn, nextCompletedRequestID, requestTimes, observedTileTypes, turns, numRequestsPerTurn, mapWidth, results );
+	}
+
+	isDone = true;
+	for ( int workerIdx = 0; workerIdx < (int)workers.size(); ++workerIdx )
+	{
+		workers[workerIdx].join();
+	}
+
+	return results;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static ReplayRunResults ReplayWithSharedSnapshots( const std::vector<ReplayTurn>& turns, int numRequestsPerTurn, int mapWidth, int numWorkers )
+{
+	int numRequests = (int)turns.size() * numRequestsPerTurn;
+
+	ReplayRunResults results;
+	results.pathCosts.resize( numRequests, -1 );
+	results.latenciesMs.resize( numRequests, 0.0 );
+
+	MPMCRingQueue<GeneratePathBatch> batchQueue( MAX_AGENTS_PER_PLAYER );
+	MPMCRingQueue<PathCompleteData> completedPaths( MAX_AGENTS_PER_PLAYER );
+	std::atomic<bool> isDone( false );
+
+	// Same loop as DoAsyncWork
+	std::vector<std::thread> workers;
+	for ( int workerIdx = 0; workerIdx < numWorkers; ++workerIdx )
+	{
+		workers.emplace_back( [&]()
+		{
+			while ( !isDone )
+			{
+				GeneratePathBatch batch;
+				if ( !batchQueue.Pop( batch ) )
+				{
+					std::this_thread::yield();
+					continue;
+				}
+
+				for ( int requestIdx = 0; requestIdx < (int)batch.requests.size(); ++requestIdx )
+				{
+					PathCompleteData completeData;
+					completeData.id = batch.requests[requestIdx].id;
+					completeData.pathToGoal = PathGenerator::GeneratePath( batch.requests[requestIdx], *batch.mapSnapshot );
+					while ( !completedPaths.Push( completeData ) && !isDone )
+					{
+						std::this_thread::yield();
+					}
+				}
+			}
+		} );
+	}
+
+	// Same publish and flush steps as Colony::GetObservedMapSnapshot and Colony::FlushPathRequests
+	std::vector<eTileType> observedTileTypes( MAX_ARENA_TILES, TILE_TYPE_UNSEEN );
+	std::vector<ReplayClock::time_point> requestTimes( numRequests );
+	std::vector<GeneratePathRequestData> pendingRequests;
+	ObservedMapSnapshotPtr mapSnapshot;
+	bool isMapSnapshotStale = true;
+	AgentID nextCompletedRequestID = 0;
+	for ( int turnIdx = 0; turnIdx < (int)turns.size(); ++turnIdx )
+	{
+		const ReplayTurn& turn = turns[turnIdx];
+		for ( int changeIdx = 0; changeIdx < (int)turn.changedTileIndices.size(); ++changeIdx )
+		{
+			int tileIdx = turn.changedTileIndices[changeIdx];
+			if ( observedTileTypes[tileIdx] != turn.changedTileTypes[changeIdx] )
+			{
+				observedTileTypes[tileIdx] = turn.changedTileTypes[changeIdx];
+				isMapSnapshotStale = true;
+			}
+		}
+
+		for ( int requestIdx = 0; requestIdx < (int)turn.requests.size(); ++requestIdx )
+		{
+			requestTimes[turn.requests[requestIdx].id] = ReplayClock::now();
+			pendingRequests.push_back( turn.requests[requestIdx] );
+		}
+
+		if ( isMapSnapshotStale
+			 || mapSnapshot == nullptr )
+		{
+			std::shared_ptr<ObservedMapSnapshot> newSnapshot = std::make_shared<ObservedMapSnapshot>();
+			newSnapshot->version = mapSnapshot != nullptr ? mapSnapshot->version + 1 : 1;
+			newSnapshot->mapWidth = mapWidth;
+			memcpy( newSnapshot->observedTileTypes, observedTileTypes.data(), MAX_ARENA_TILES * sizeof( eTileType ) );
+
+			mapSnapshot = newSnapshot;
+			isMapSnapshotStale = false;
+			results.numBytesCopied += sizeof( ObservedMapSnapshot );
+			++results.numSnapshotsPublished;
+		}
+
+		for ( int firstRequestIdx = 0; firstRequestIdx < (int)pendingRequests.size(); firstRequestIdx += MAX_PATH_REQUESTS_PER_BATCH )
+		{
+			int endRequestIdx = std::min( firstRequestIdx + MAX_PATH_REQUESTS_PER_BATCH, (int)pendingRequests.size() );
+
+			GeneratePathBatch batch;
+			batch.mapSnapshot = mapSnapshot;
+			batch.requests.assign( pendingRequests.begin() + firstRequestIdx, pendingRequests.begin() + endRequestIdx );
+			while ( !batchQueue.Push( batch ) )
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		// Each request is copied into the pending list, into its batch and into the queue slot, the worker moves it out
+		results.numBytesCopied += 3 * sizeof( GeneratePathRequestData ) * pendingRequests.size();
+		pendingRequests.clear();
+
+		DrainReplayCompletions( completedPaths, ( turnIdx + 1 ) * numRequestsPerTurn, nextCompletedRequestID, requestTimes, observedTileTypes, turns, numRequestsPerTurn, mapWidth, results );
+	}
+
+	isDone = true;
+	for ( int workerIdx = 0; workerIdx < (int)workers.size(); ++workerIdx )
+	{
+		workers[workerIdx].join();
+	}
+
+	return results;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static bool IsPathValid( const Path& path, const TileCoords& startTile, const TileCoords& endTile, const int* tileTypeCosts, const eTileType* observedTileTypes, int mapWidth )
+{
+	if ( path.empty()
+		 || path.front() != endTile
+		 || path.back() != startTile )
+	{
+		return false;
+	}
+
+	// The start tile is last and isn't entered
+	for ( int pathIdx = 0; pathIdx < (int)path.size() - 1; ++pathIdx )
+	{
+		if ( ( path[pathIdx] - path[pathIdx + 1] ).GetTaxicabLength() != 1 )
+		{
+			return false;
+		}
+
+		int tileIdx = GetTileIdxFromTileCoords( path[pathIdx], mapWidth );
+		if ( tileIdx == -1
+			 || observedTileTypes[tileIdx] == TILE_TYPE_UNSEEN
+			 || tileTypeCosts[observedTileTypes[tileIdx]] == -1 )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+PathGeneratorBenchmarkResults RunPathGeneratorBenchmark( int numArenas, int numPathsPerArena, int mapWidth, unsigned int seed )
+{
+	PathGeneratorBenchmarkResults results;
+	if ( mapWidth <= 0
+		 || mapWidth > MAX_ARENA_WIDTH )
+	{
+		return results;
+	}
+
+	std::mt19937 rng( seed );
+	std::vector<eTileType> observedTileTypes( mapWidth * mapWidth );
+
+	// Same costs a worker uses
+	int tileTypeCosts[NUM_TILE_TYPES];
+	tileTypeCosts[TILE_TYPE_AIR] = 0;
+	tileTypeCosts[TILE_TYPE_DIRT] = 1;
+	tileTypeCosts[TILE_TYPE_STONE] = -1;
+	tileTypeCosts[TILE_TYPE_WATER] = -1;
+	tileTypeCosts[TILE_TYPE_CORPSE_BRIDGE] = 0;
+
+	for ( int arenaIdx = 0; arenaIdx < numArenas; ++arenaIdx )
+	{
+		for ( int tileIdx = 0; tileIdx < (int)observedTileTypes.size(); ++tileIdx )
+		{
+			observedTileTypes[tileIdx] = RollRandomTileType( rng );
+		}
+
+		for ( int pathIdx = 0; pathIdx < numPathsPerArena; ++pathIdx )
+		{
+			TileCoords startTile( (int)( rng() % mapWidth ), (int)( rng() % mapWidth ) );
+			TileCoords endTile( (int)( rng() % mapWidth ), (int)( rng() % mapWidth ) );
+
+			auto startTime = std::chrono::high_resolution_clock::now();
+			Path path = PathGenerator::GeneratePath( startTile, endTile, tileTypeCosts, observedTileTypes.data(), mapWidth );
+			auto endTime = std::chrono::high_resolution_clock::now();
+			Path legacyPath = GenerateLegacyPath( startTile, endTile, tileTypeCosts, observedTileTypes.data(), mapWidth );
+			auto legacyEndTime = std::chrono::high_resolution_clock::now();
+
+			results.seconds += std::chrono::duration<double>( endTime - startTime ).count();
+			results.legacySeconds += std::chrono::duration<double>( legacyEndTime - endTime ).count();
+			++results.numPaths;
+
+			int cost = PathGenerator::GetPathCost( path, tileTypeCosts, observedTileTypes.data(), mapWidth );
+			int legacyCost = PathGenerator::GetPathCost( legacyPath, tileTypeCosts, observedTileTypes.data(), mapWidth );
+			int optimalCost = GetOptimalPathCost( startTile, endTile, tileTypeCosts, observedTileTypes.data(), mapWidth );
+
+			if ( cost != optimalCost )
+			{
+				++results.numCostMismatches;
+			}
+
+			if ( cost != -1 )
+			{
+				++results.numPathsFound;
+			}
+
+			if ( legacyCost != -1 )
+			{
+				++results.numLegacyPathsFound;
+				if ( legacyCost > cost )
+				{
+					++results.numLegacyPathsCostlier;
+				}
+			}
+		}
+	}
+
+	return results;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void PathGeneratorBenchmarkCommand( const char* line )
+{
+	// The linear scan search takes over a second per path on big arenas, so keep the defaults small
+	int numArenas = 5;
+	int numPathsPerArena = 20;
+	int mapWidth = 64;
+	unsigned int seed = 1;
+	if ( line != nullptr )
+	{
+		// Skip the command name if it was passed along with the arguments
+		while ( *line != '\0' && !isdigit( (unsigned char)*line ) )
+		{
+			++line;
+		}
+
+		sscanf_s( line, "%d %d %d %u", &numArenas, &numPathsPerArena, &mapWidth, &seed );
+	}
+
+	PathGeneratorBenchmarkResults results = RunPathGeneratorBenchmark( numArenas, numPathsPerArena, mapWidth, seed );
+
+	g_debug->LogText( "path_benchmark: %d paths on %dx%d arenas, %d found\n", results.numPaths, mapWidth, mapWidth, results.numPathsFound );
+	g_debug->LogText( "  A*: %.3f ms total, %d cost mismatches vs Dijkstra %s\n", results.seconds * 1000.0, results.numCostMismatches, results.numCostMismatches == 0 ? "(PASS)" : "(FAIL)" );
+	g_debug->LogText( "  Linear scan: %.3f ms total, %d found, %d costlier than A*\n", results.legacySeconds * 1000.0, results.numLegacyPathsFound, results.numLegacyPathsCostlier );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+PathRequestReplayResults RunPathRequestReplay( int numTurns, int numRequestsPerTurn, int mapWidth, int numWorkers, unsigned int seed )
+{
+	PathRequestReplayResults results;
+	if ( numTurns <= 0
+		 || numRequestsPerTurn <= 0
+		 || numWorkers <= 0
+		 || mapWidth <= 0
+		 || mapWidth > MAX_ARENA_WIDTH )
+	{
+		return results;
+	}
+
+	// At most one request in flight per ant
+	if ( numRequestsPerTurn > MAX_AGENTS_PER_PLAYER )
+	{
+		numRequestsPerTurn = MAX_AGENTS_PER_PLAYER;
+	}
+
+	std::mt19937 rng( seed );
+	std::vector<ReplayTurn> turns = RecordReplayTurns( numTurns, numRequestsPerTurn, mapWidth, rng );
+
+	ReplayRunResults legacyRun = ReplayWithPerRequestCopies( turns, numRequestsPerTurn, mapWidth, numWorkers );
+	ReplayRunResults snapshotRun = ReplayWithSharedSnapshots( turns, numRequestsPerTurn, mapWidth, numWorkers );
+
+	results.numTurns = numTurns;
+	results.numRequests = numTurns * numRequestsPerTurn;
+	results.numSnapshotsPublished = snapshotRun.numSnapshotsPublished;
+	results.bytesCopiedPerTurn = (double)snapshotRun.numBytesCopied / (double)numTurns;
+	results.legacyBytesCopiedPerTurn = (double)legacyRun.numBytesCopied / (double)numTurns;
+
+	for ( int requestIdx = 0; requestIdx < results.numRequests; ++requestIdx )
+	{
+		if ( snapshotRun.pathCosts[requestIdx] != legacyRun.pathCosts[requestIdx] )
+		{
+			++results.numPathMismatches;
+		}
+
+		results.averageLatencyMs += snapshotRun.latenciesMs[requestIdx];
+		results.maxLatencyMs = std::max( results.maxLatencyMs, snapshotRun.latenciesMs[requestIdx] );
+		results.legacyAverageLatencyMs += legacyRun.latenciesMs[requestIdx];
+		results.legacyMaxLatencyMs = std::max( results.legacyMaxLatencyMs, legacyRun.latenciesMs[requestIdx] );
+	}
+
+	results.averageLatencyMs /= (double)results.numRequests;
+	results.legacyAverageLatencyMs /= (double)results.numRequests;
+	return results;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void PathRequestReplayCommand( const char* line )
+{
+	int numTurns = 50;
+	int numRequestsPerTurn = 64;
+	int mapWidth = 128;
+	int numWorkers = 3;
+	unsigned int seed = 1;
+	if ( line != nullptr )
+	{
+		// Skip the command name if it was passed along with the arguments
+		while ( *line != '\0' && !isdigit( (unsigned char)*line ) )
+		{
+			++line;
+		}
+
+		sscanf_s( line, "%d %d %d %d %u", &numTurns, &numRequestsPerTurn, &mapWidth, &numWorkers, &seed );
+	}
+
+	PathRequestReplayResults results = RunPathRequestReplay( numTurns, numRequestsPerTurn, mapWidth, numWorkers, seed );
+
+	g_debug->LogText( "path_replay: %d turns, %d requests on a %dx%d arena, %d workers\n", results.numTurns, results.numRequests, mapWidth, mapWidth, numWorkers );
+	g_debug->LogText( "  Per request copies: %.0f bytes copied per turn, latency %.3f ms avg %.3f ms max\n", results.legacyBytesCopiedPerTurn, results.legacyAverageLatencyMs, results.legacyMaxLatencyMs );
+	g_debug->LogText( "  Shared snapshots: %.0f bytes copied per turn, latency %.3f ms avg %.3f ms max, %d snapshots published\n", results.bytesCopiedPerTurn, results.averageLatencyMs, results.maxLatencyMs, results.numSnapshotsPublished );
+	g_debug->LogText( "  %d path cost mismatches %s\n", results.numPathMismatches, results.numPathMismatches == 0 ? "(PASS)" : "(FAIL)" );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+HierarchicalPathBenchmarkResults RunHierarchicalPathBenchmark( int numTurns, int numAgents, int mapWidth, unsigned int seed )
+{
+	HierarchicalPathBenchmarkResults results;
+	if ( mapWidth <= MIN_HIERARCHICAL_PATH_DISTANCE
+		 || mapWidth > MAX_ARENA_WIDTH )
+	{
+		return results;
+	}
+
+	std::mt19937 rng( seed );
+	std::vector<eTileType> observedTileTypes( MAX_ARENA_TILES, TILE_TYPE_UNSEEN );
+	for ( int tileIdx = 0; tileIdx < mapWidth * mapWidth; ++tileIdx )
+	{
+		observedTileTypes[tileIdx] = RollRandomTileType( rng );
+	}
+
+	// Same costs Colony uses for each ant type, dirt is dug, walked around, or free to scouts
+	constexpr int NUM_COST_SETS = 3;
+	int tileTypeCostSets[NUM_COST_SETS][NUM_TILE_TYPES];
+	for ( int costSetIdx = 0; costSetIdx < NUM_COST_SETS; ++costSetIdx )
+	{
+		tileTypeCostSets[costSetIdx][TILE_TYPE_AIR] = 0;
+		tileTypeCostSets[costSetIdx][TILE_TYPE_DIRT] = costSetIdx - 1;
+		tileTypeCostSets[costSetIdx][TILE_TYPE_STONE] = -1;
+		tileTypeCostSets[costSetIdx][TILE_TYPE_WATER] = -1;
+		tileTypeCostSets[costSetIdx][TILE_TYPE_CORPSE_BRIDGE] = 0;
+	}
+
+	PathClusterGraphCache graphCache;
+	PathClusterGraphPtr graphs[NUM_COST_SETS];
+
+	auto buildStartTime = std::chrono::high_resolution_clock::now();
+	for ( int costSetIdx = 0; costSetIdx < NUM_COST_SETS; ++costSetIdx )
+	{
+		graphs[costSetIdx] = graphCache.GetGraph( tileTypeCostSets[costSetIdx], observedTileTypes.data(), mapWidth );
+	}
+	results.fullBuildSeconds = std::chrono::duration<double>( std::chrono::high_resolution_clock::now() - buildStartTime ).count();
+
+	for ( int turnIdx = 0; turnIdx < numTurns; ++turnIdx )
+	{
+		// Ants dig and new tiles come into view around a few spots, only the clusters there should be rebuilt
+		int numChangeSites = 1 + (int)( rng() % 8 );
+		for ( int siteIdx = 0; siteIdx < numChangeSites; ++siteIdx )
+		{
+			TileCoords siteTile( (int)( rng() % mapWidth ), (int)( rng() % mapWidth ) );
+			for ( int changeIdx = 0; changeIdx < 8; ++changeIdx )
+			{
+				TileCoords changedTile( siteTile.x + (int)( rng() % 5 ) - 2, siteTile.y + (int)( rng() % 5 ) - 2 );
+				int tileIdx = GetTileIdxFromTileCoords( changedTile, mapWidth );
+				if ( tileIdx != -1 )
+				{
+					observedTileTypes[tileIdx] = RollRandomTileType( rng );
+					graphCache.MarkTileChanged( tileIdx, mapWidth );
+				}
+			}
+		}
+
+		auto rebuildStartTime = std::chrono::high_resolution_clock::now();
+		for ( int costSetIdx = 0; costSetIdx < NUM_COST_SETS; ++costSetIdx )
+		{
+			graphs[costSetIdx] = graphCache.GetGraph( tileTypeCostSets[costSetIdx], observedTileTypes.data(), mapWidth );
+			results.numClustersRebuilt += graphs[costSetIdx]->GetNumRebuiltClusters();
+		}
+		results.rebuildSeconds += std::chrono::duration<double>( std::chrono::high_resolution_clock::now() - rebuildStartTime ).count();
+
+		for ( int agentIdx = 0; agentIdx < numAgents; ++agentIdx )
+		{
+			TileCoords startTile;
+			TileCoords endTile;
+			do
+			{
+				startTile = TileCoords( (int)( rng() % mapWidth ), (int)( rng() % mapWidth ) );
+				endTile = TileCoords( (int)( rng() % mapWidth ), (int)( rng() % mapWidth ) );
+			} while ( ( endTile - startTile ).GetTaxicabLength() < MIN_HIERARCHICAL_PATH_DISTANCE );
+
+			int costSetIdx = (int)( rng() % NUM_COST_SETS );
+			const int* tileTypeCosts = tileTypeCostSets[costSetIdx];
+
+			auto startTime = std::chrono::high_resolution_clock::now();
+			Path path = HierarchicalPathGenerator::GeneratePath( startTile, endTile, *graphs[costSetIdx], observedTileTypes.data() );
+			auto endTime = std::chrono::high_resolution_clock::now();
+			Path flatPath = PathGenerator::GeneratePath( startTile, endTile, tileTypeCosts, observedTileTypes.data(), mapWidth );
+			auto flatEndTime = std::chrono::high_resolution_clock::now();
+
+			results.seconds += std::chrono::duration<double>( endTime - startTime ).count();
+			results.flatSeconds += std::chrono::duration<double>( flatEndTime - endTime ).count();
+			++results.numPaths;
+
+			int cost = PathGenerator::GetPathCost( path, tileTypeCosts, observedTileTypes.data(), mapWidth );
+			int flatCost = PathGenerator::GetPathCost( flatPath, tileTypeCosts, observedTileTypes.data(), mapWidth );
+			if ( ( cost == -1 ) != ( flatCost == -1 ) )
+			{
+				++results.numFoundMismatches;
+				continue;
+			}
+
+			if ( cost == -1 )
+			{
+				continue;
+			}
+
+			++results.numPathsFound;
+			if ( !IsPathValid( path, startTile, endTile, tileTypeCosts, observedTileTypes.data(), mapWidth ) )
+			{
+				++results.numInvalidPaths;
+			}
+
+			if ( cost < flatCost )
+			{
+				++results.numCheaperThanFlat;
+			}
+			else if ( cost == flatCost )
+			{
+				++results.numOptimalPaths;
+			}
+
+			double extraCostPercent = 100.0 * (double)( cost - flatCost ) / (double)flatCost;
+			results.averageExtraCostPercent += extraCostPercent;
+			results.maxExtraCostPercent = std::max( results.maxExtraCostPercent, extraCostPercent );
+		}
+	}
+
+	if ( results.numPathsFound > 0 )
+	{
+		results.averageExtraCostPercent /= (double)results.numPathsFound;
+	}
+
+	return results;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void HierarchicalPathBenchmarkCommand( const char* line )
+{
+	// Largest arena at a full colony's worth of requests every turn
+	int numTurns = 5;
+	int numAgents = MAX_AGENTS_PER_PLAYER;
+	int mapWidth = MAX_ARENA_WIDTH;
+	unsigned int seed = 1;
+	if ( line != nullptr )
+	{
+		// Skip the command name if it was passed along with the arguments
+		while ( *line != '\0' && !isdigit( (unsigned char)*line ) )
+		{
+			++line;
+		}
+
+		sscanf_s( line, "%d %d %d %u", &numTurns, &numAgents, &mapWidth, &seed );
+	}
+
+	HierarchicalPathBenchmarkResults results = RunHierarchicalPathBenchmark( numTurns, numAgents, mapWidth, seed );
+
+	bool isPassing = results.numFoundMismatches == 0 && results.numInvalidPaths == 0 && results.numCheaperThanFlat == 0;
+	g_debug->LogText( "hpa_benchmark: %d paths on a %dx%d arena, %d found %s\n", results.numPaths, mapWidth, mapWidth, results.numPathsFound, isPassing ? "(PASS)" : "(FAIL)" );
+	g_debug->LogText( "  %d found mismatches, %d invalid paths, %d cheaper than flat A*\n", results.numFoundMismatches, results.numInvalidPaths, results.numCheaperThanFlat );
+	g_debug->LogText( "  %d optimal, %.2f%% avg %.2f%% max extra cost vs flat A*\n", results.numOptimalPaths, results.averageExtraCostPercent, results.maxExtraCostPercent );
+	g_debug->LogText( "  HPA*: %.3f ms total, flat A*: %.3f ms total\n", results.seconds * 1000.0, results.flatSeconds * 1000.0 );
+	g_debug->LogText( "  Graphs: %.3f ms full build, %.3f ms rebuilding %d clusters over %d turns\n", results.fullBuildSeconds * 1000.0, results.rebuildSeconds * 1000.0, results.numClustersRebuilt, numTurns );
+}
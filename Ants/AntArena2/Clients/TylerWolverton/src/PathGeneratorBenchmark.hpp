@@ -0,0 +1,82 @@
+#pragma once
+#include "Common.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+struct PathGeneratorBenchmarkResults
+{
+public:
+	int numPaths = 0;
+	int numPathsFound = 0;
+	int numCostMismatches = 0;			// A* cost differs from a plain Dijkstra search, should always be 0
+	int numLegacyPathsFound = 0;
+	int numLegacyPathsCostlier = 0;		// Old linear scan search settled for a more expensive path
+	double seconds = 0.0;
+	double legacySeconds = 0.0;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Runs PathGenerator and the old linear scan open list search on seeded random arenas, no Arena needed.
+// Every A* path is checked against a Dijkstra search for the same optimal cost.
+PathGeneratorBenchmarkResults RunPathGeneratorBenchmark( int numArenas, int numPathsPerArena, int mapWidth, unsigned int seed );
+
+// Console command, "path_benchmark [numArenas] [numPathsPerArena] [mapWidth] [seed]"
+void PathGeneratorBenchmarkCommand( const char* line );
+
+
+//-----------------------------------------------------------------------------------------------
+struct PathRequestReplayResults
+{
+public:
+	int numTurns = 0;
+	int numRequests = 0;
+	int numPathMismatches = 0;			// Snapshot and per request copy paths cost differently, should always be 0
+	int numSnapshotsPublished = 0;
+	double bytesCopiedPerTurn = 0.0;
+	double legacyBytesCopiedPerTurn = 0.0;
+	double averageLatencyMs = 0.0;		// From making a request to popping its completed path
+	double maxLatencyMs = 0.0;
+	double legacyAverageLatencyMs = 0.0;
+	double legacyMaxLatencyMs = 0.0;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Records a run of turns on a seeded random arena, with a few tiles changing each turn and a burst of
+// path requests, then replays it on worker threads twice: once copying the map into every request like
+// Colony used to, and once with batches sharing a per turn ObservedMapSnapshot. No Arena needed.
+PathRequestReplayResults RunPathRequestReplay( int numTurns, int numRequestsPerTurn, int mapWidth, int numWorkers, unsigned int seed );
+
+// Console command, "path_replay [numTurns] [numRequestsPerTurn] [mapWidth] [numWorkers] [seed]"
+void PathRequestReplayCommand( const char* line );
+
+
+//-----------------------------------------------------------------------------------------------
+struct HierarchicalPathBenchmarkResults
+{
+public:
+	int numPaths = 0;
+	int numPathsFound = 0;
+	int numFoundMismatches = 0;			// Only one of HPA* and flat A* found a path, should always be 0
+	int numInvalidPaths = 0;			// Steps aren't adjacent or go through impassable tiles, should always be 0
+	int numCheaperThanFlat = 0;			// Flat A* is optimal, so should always be 0
+	int numOptimalPaths = 0;
+	double averageExtraCostPercent = 0.0;
+	double maxExtraCostPercent = 0.0;
+	int numClustersRebuilt = 0;
+	double fullBuildSeconds = 0.0;		// Every cost set's graph from scratch
+	double rebuildSeconds = 0.0;		// Every turn's incremental rebuilds added up
+	double seconds = 0.0;
+	double flatSeconds = 0.0;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Plays turns on a seeded random arena, each one changing a few tiles and then pathing every agent between
+// two random tiles at least MIN_HIERARCHICAL_PATH_DISTANCE apart, with HierarchicalPathGenerator and flat
+// PathGenerator. Costs are compared for optimality, no Arena needed.
+HierarchicalPathBenchmarkResults RunHierarchicalPathBenchmark( int numTurns, int numAgents, int mapWidth, unsigned int seed );
+
+// Console command, "hpa_benchmark [numTurns] [numAgents] [mapWidth] [seed]"
+void HierarchicalPathBenchmarkCommand( const char* line );
@@ -68,6 +68,9 @@ void App::Startup()
 	g_window->SetEventSystem( g_eventSystem );
 
 	g_jobSystem->Startup();
+	// Idle workers poll for jobs, so they're opt in. Without them raycast batches run on the main thread
+	int numJobWorkerThreads = g_gameConfigBlackboard.GetValue( "numJobWorkerThreads", 0 );
+	g_jobSystem->CreateWorkerThreads( Max( numJobWorkerThreads, 0 ) );
 
 	g_inputSystem->Startup( g_window );
 	g_window->SetInputSystem( g_inputSystem );
@@ -233,6 +236,7 @@ void App::EndFrame()
 	g_audioSystem->EndFrame();
 	g_inputSystem->EndFrame();
 	g_devConsole->EndFrame();
+	g_jobSystem->ClaimAndDeleteAllCompletedJobs();
 	g_jobSystem->EndFrame();
 	g_eventSystem->EndFrame();
 	g_window->EndFrame();
@@ -40,6 +40,7 @@ public:
 	std::string		GetName() const																{ return m_type; }
 	eEntityClass	GetClass() const															{ return m_class; }
 	float			GetWalkSpeed() const														{ return m_walkSpeed; }
+	float			GetPhysicsRadius() const													{ return m_physicsRadius; }
 	Vec2			GetVisualSize() const														{ return m_visualSize; }
 
 	SpriteAnimationSetDefinition* GetDefaultSpriteAnimSetDef() const							{ return m_defaultSpriteAnimSetDef; }
@@ -0,0 +1,156 @@
+#include "Game/EntitySpatialHash.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include "Game/GameCommon.hpp"
+
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------------------------
+EntitySpatialHash::EntitySpatialHash()
+{
+	m_buckets.resize( MIN_SPATIAL_HASH_BUCKETS );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialHash::Clear()
+{
+	m_buckets.clear();
+	m_buckets.resize( MIN_SPATIAL_HASH_BUCKETS );
+	m_entityCells.clear();
+	m_isEntityInHash.clear();
+	m_numEntities = 0;
+	m_maxPhysicsRadius = 0.f;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialHash::AddEntity( int entityIdx, const Vec2& position, float physicsRadius )
+{
+	if ( IsEntityInHash( entityIdx ) )
+	{
+		UpdateEntity( entityIdx, position );
+		return;
+	}
+
+	if ( entityIdx >= (int)m_entityCells.size() )
+	{
+		m_entityCells.resize( (size_t)entityIdx + 1 );
+		m_isEntityInHash.resize( (size_t)entityIdx + 1, false );
+	}
+
+	// Keep buckets at least twice the entity count so most hold a cell or two
+	++m_numEntities;
+	if ( m_numEntities * 2 > (int)m_buckets.size() )
+	{
+		int numBuckets = (int)m_buckets.size();
+		while ( numBuckets < m_numEntities * 2 )
+		{
+			numBuckets *= 2;
+		}
+
+		Rehash( numBuckets );
+	}
+
+	IntVec2 cell = GetCellForPosition( position );
+	m_entityCells[entityIdx] = cell;
+	m_isEntityInHash[entityIdx] = true;
+	m_buckets[GetBucketIdx( cell )].push_back( entityIdx );
+
+	m_maxPhysicsRadius = Max( m_maxPhysicsRadius, physicsRadius );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialHash::RemoveEntity( int entityIdx )
+{
+	if ( !IsEntityInHash( entityIdx ) )
+	{
+		return;
+	}
+
+	RemoveEntityFromBucket( entityIdx, GetBucketIdx( m_entityCells[entityIdx] ) );
+	m_isEntityInHash[entityIdx] = false;
+	--m_numEntities;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialHash::UpdateEntity( int entityIdx, const Vec2& position )
+{
+	IntVec2 cell = GetCellForPosition( position );
+	IntVec2& oldCell = m_entityCells[entityIdx];
+	if ( cell == oldCell )
+	{
+		return;
+	}
+
+	int oldBucketIdx = GetBucketIdx( oldCell );
+	int bucketIdx = GetBucketIdx( cell );
+	oldCell = cell;
+
+	if ( bucketIdx == oldBucketIdx )
+	{
+		return;
+	}
+
+	RemoveEntityFromBucket( entityIdx, oldBucketIdx );
+	m_buckets[bucketIdx].push_back( entityIdx );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool EntitySpatialHash::IsEntityInHash( int entityIdx ) const
+{
+	return entityIdx >= 0
+		&& entityIdx < (int)m_isEntityInHash.size()
+		&& m_isEntityInHash[entityIdx];
+}
+
+
+//-----------------------------------------------------------------------------------------------
+IntVec2 EntitySpatialHash::GetCellForPosition( const Vec2& position )
+{
+	return IntVec2( (int)floorf( position.x / TILE_SIZE ), (int)floorf( position.y / TILE_SIZE ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int EntitySpatialHash::GetBucketIdx( const IntVec2& cell ) const
+{
+	unsigned int hash = ( (unsigned int)cell.x * 73856093u ) ^ ( (unsigned int)cell.y * 19349663u );
+	return (int)( hash & (unsigned int)( m_buckets.size() - 1 ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialHash::Rehash( int numBuckets )
+{
+	m_buckets.clear();
+	m_buckets.resize( numBuckets );
+
+	for ( int entityIdx = 0; entityIdx < (int)m_entityCells.size(); ++entityIdx )
+	{
+		if ( m_isEntityInHash[entityIdx] )
+		{
+			m_buckets[GetBucketIdx( m_entityCells[entityIdx] )].push_back( entityIdx );
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialHash::RemoveEntityFromBucket( int entityIdx, int bucketIdx )
+{
+	std::vector<int>& bucket = m_buckets[bucketIdx];
+	for ( int bucketEntityIdx = 0; bucketEntityIdx < (int)bucket.size(); ++bucketEntityIdx )
+	{
+		if ( bucket[bucketEntityIdx] == entityIdx )
+		{
+			bucket[bucketEntityIdx] = bucket.back();
+			bucket.pop_back();
+			return;
+		}
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+
+#include <vector>
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr int MIN_SPATIAL_HASH_BUCKETS = 256;
+
+
+//-----------------------------------------------------------------------------------------------
+// Uniform grid of tile sized cells hashed into a power of two number of buckets, holding indices into a Map's entity list.
+// Entities only change buckets when they cross into a new tile, so refreshing every entity each frame is cheap.
+// Buckets may hold entities from other cells that hash to the same bucket, check GetEntityCell before using them.
+class EntitySpatialHash
+{
+public:
+	EntitySpatialHash();
+	~EntitySpatialHash() = default;
+
+	void Clear();
+
+	void AddEntity( int entityIdx, const Vec2& position, float physicsRadius );
+	void RemoveEntity( int entityIdx );
+	void UpdateEntity( int entityIdx, const Vec2& position );
+
+	bool IsEntityInHash( int entityIdx ) const;
+	const IntVec2& GetEntityCell( int entityIdx ) const								{ return m_entityCells[entityIdx]; }
+	const std::vector<int>& GetBucketForCell( const IntVec2& cell ) const			{ return m_buckets[GetBucketIdx( cell )]; }
+	// Largest physics radius ever added, used to pick how many neighboring cells a query has to search
+	float GetMaxPhysicsRadius() const												{ return m_maxPhysicsRadius; }
+
+	static IntVec2 GetCellForPosition( const Vec2& position );
+
+private:
+	int GetBucketIdx( const IntVec2& cell ) const;
+	void Rehash( int numBuckets );
+	void RemoveEntityFromBucket( int entityIdx, int bucketIdx );
+
+private:
+	std::vector<std::vector<int>>	m_buckets;
+	std::vector<IntVec2>			m_entityCells;					// Indexed by entity index
+	std::vector<bool>				m_isEntityInHash;				// Indexed by entity index
+	int								m_numEntities = 0;
+	float							m_maxPhysicsRadius = 0.f;
+};
@@ -0,0 +1,521 @@
+#include "Game/EntitySpatialHashTests.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Time/Time.hpp"
+
+#include "Game/GameCommon.hpp"
+#include "Game/Entity.hpp"
+#include "Game/EntityDefinition.hpp"
+#include "Game/MapData.hpp"
+#include "Game/MapRegionTypeDefinition.hpp"
+#include "Game/PhysicsConfig.hpp"
+#include "Game/TileMap.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+static constexpr int NUM_FRAMES_PER_TEST_SCENE = 4;
+static constexpr int NUM_RAYS_PER_TEST_FRAME = 500;
+static const IntVec2 BENCHMARK_MAP_DIMENSIONS( 64, 64 );
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialHashTests::RunTests( int numScenes )
+{
+	RandomNumberGenerator rng;
+	rng.Reset( 49 );
+
+	int numFrames = 0;
+	int numRaycasts = 0;
+	int numPositionMismatches = 0;
+	int numCollidingPairMismatches = 0;
+	int numRaycastMismatches = 0;
+
+	for ( int sceneNum = 0; sceneNum < numScenes; ++sceneNum )
+	{
+		IntVec2 dimensions( rng.RollRandomIntInRange( 8, 40 ), rng.RollRandomIntInRange( 8, 40 ) );
+		SpatialHashTestScene scene;
+		if ( !CreateRandomScene( rng, dimensions, rng.RollRandomIntInRange( 2, 400 ), scene ) )
+		{
+			return;
+		}
+
+		TileMap& tileMap = *scene.tileMap;
+		std::vector<Entity*> removedEntities;
+
+		for ( int frameNum = 0; frameNum < NUM_FRAMES_PER_TEST_SCENE; ++frameNum )
+		{
+			MoveEntitiesRandomly( rng, scene );
+
+			// Take a few entities out of the map and put them back next frame, so emptied slots get refilled
+			if ( frameNum % 2 == 0 )
+			{
+				for ( int removeNum = 0; removeNum < 3; ++removeNum )
+				{
+					Entity* entity = tileMap.m_entities[rng.RollRandomIntLessThan( (int)tileMap.m_entities.size() )];
+					if ( entity != nullptr )
+					{
+						tileMap.RemoveOwnershipOfEntity( entity );
+						removedEntities.push_back( entity );
+					}
+				}
+			}
+			else
+			{
+				for ( int entityIdx = 0; entityIdx < (int)removedEntities.size(); ++entityIdx )
+				{
+					removedEntities[entityIdx]->SetPosition( GetRandomOpenPosition( rng, scene ) );
+					tileMap.TakeOwnershipOfEntity( removedEntities[entityIdx] );
+				}
+
+				removedEntities.clear();
+			}
+
+			std::vector<Vec2> startPositions;
+			std::vector<std::unordered_set<EntityId>> startCollidingEntities;
+			SaveEntityStates( tileMap, startPositions, startCollidingEntities );
+
+			ResolveEntityVsEntityCollisionsBruteForce( tileMap );
+
+			std::vector<Vec2> bruteForcePositions;
+			std::vector<std::unordered_set<EntityId>> bruteForceCollidingEntities;
+			SaveEntityStates( tileMap, bruteForcePositions, bruteForceCollidingEntities );
+
+			RestoreEntityStates( tileMap, startPositions, startCollidingEntities );
+			tileMap.ResolveEntityVsEntityCollisions();
+
+			std::vector<Vec2> positions;
+			std::vector<std::unordered_set<EntityId>> collidingEntities;
+			SaveEntityStates( tileMap, positions, collidingEntities );
+
+			for ( int entityIdx = 0; entityIdx < (int)positions.size(); ++entityIdx )
+			{
+				if ( positions[entityIdx] != bruteForcePositions[entityIdx] )
+				{
+					++numPositionMismatches;
+				}
+
+				if ( collidingEntities[entityIdx] != bruteForceCollidingEntities[entityIdx] )
+				{
+					++numCollidingPairMismatches;
+				}
+			}
+
+			for ( int rayNum = 0; rayNum < NUM_RAYS_PER_TEST_FRAME; ++rayNum )
+			{
+				Vec3 startPos;
+				Vec3 forwardNormal;
+				float maxDist;
+				RollRandomRay( rng, scene, startPos, forwardNormal, maxDist );
+
+				if ( !AreRaycastResultsEqual( tileMap.Raycast( startPos, forwardNormal, maxDist ), RaycastBruteForce( tileMap, startPos, forwardNormal, maxDist ) ) )
+				{
+					++numRaycastMismatches;
+				}
+			}
+
+			++numFrames;
+			numRaycasts += NUM_RAYS_PER_TEST_FRAME;
+		}
+
+		// The map only deletes entities it still owns
+		PTR_VECTOR_SAFE_DELETE( removedEntities );
+		PTR_SAFE_DELETE( scene.tileMap );
+	}
+
+	if ( numPositionMismatches > 0
+		 || numCollidingPairMismatches > 0
+		 || numRaycastMismatches > 0 )
+	{
+		g_devConsole->PrintError( Stringf( "Spatial hash tests failed: %i position, %i colliding pair and %i raycast mismatches against brute force",
+										   numPositionMismatches, numCollidingPairMismatches, numRaycastMismatches ) );
+		return;
+	}
+
+	g_devConsole->PrintString( Stringf( "Spatial hash tests passed: %i scenes, %i frames of collisions and %i raycasts match brute force", numScenes, numFrames, numRaycasts ), Rgba8::GREEN );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialHashTests::RunBenchmark( int numRaysPerScene )
+{
+	RandomNumberGenerator rng;
+	rng.Reset( 50 );
+
+	const int actorCounts[] = { 50, 100, 250, 500, 1000, 2500, 5000 };
+	for ( int countIdx = 0; countIdx < (int)( sizeof( actorCounts ) / sizeof( actorCounts[0] ) ); ++countIdx )
+	{
+		int numActors = actorCounts[countIdx];
+
+		SpatialHashTestScene scene;
+		if ( !CreateRandomScene( rng, BENCHMARK_MAP_DIMENSIONS, numActors, scene ) )
+		{
+			return;
+		}
+
+		TileMap& tileMap = *scene.tileMap;
+
+		std::vector<Vec2> startPositions;
+		std::vector<std::unordered_set<EntityId>> startCollidingEntities;
+		SaveEntityStates( tileMap, startPositions, startCollidingEntities );
+
+		// Settle the hash on the spawn positions first, in game that happens as entities are placed
+		tileMap.ResolveEntityVsEntityCollisions();
+		RestoreEntityStates( tileMap, startPositions, startCollidingEntities );
+
+		double timeBeforeBruteForce = GetCurrentTimeSeconds();
+		ResolveEntityVsEntityCollisionsBruteForce( tileMap );
+		double bruteForceCollisionSeconds = GetCurrentTimeSeconds() - timeBeforeBruteForce;
+		RestoreEntityStates( tileMap, startPositions, startCollidingEntities );
+
+		double timeBeforeHash = GetCurrentTimeSeconds();
+		tileMap.ResolveEntityVsEntityCollisions();
+		double hashCollisionSeconds = GetCurrentTimeSeconds() - timeBeforeHash;
+
+		std::vector<Vec3> rayStartPositions( numRaysPerScene );
+		std::vector<Vec3> rayForwardNormals( numRaysPerScene );
+		std::vector<float> rayMaxDists( numRaysPerScene );
+		for ( int rayIdx = 0; rayIdx < numRaysPerScene; ++rayIdx )
+		{
+			RollRandomRay( rng, scene, rayStartPositions[rayIdx], rayForwardNormals[rayIdx], rayMaxDists[rayIdx] );
+		}
+
+		std::vector<RaycastResult> bruteForceResults( numRaysPerScene );
+		timeBeforeBruteForce = GetCurrentTimeSeconds();
+		for ( int rayIdx = 0; rayIdx < numRaysPerScene; ++rayIdx )
+		{
+			bruteForceResults[rayIdx] = RaycastBruteForce( tileMap, rayStartPositions[rayIdx], rayForwardNormals[rayIdx], rayMaxDists[rayIdx] );
+		}
+		double bruteForceRaycastSeconds = GetCurrentTimeSeconds() - timeBeforeBruteForce;
+
+		std::vector<RaycastResult> hashResults( numRaysPerScene );
+		timeBeforeHash = GetCurrentTimeSeconds();
+		for ( int rayIdx = 0; rayIdx < numRaysPerScene; ++rayIdx )
+		{
+			hashResults[rayIdx] = tileMap.Raycast( rayStartPositions[rayIdx], rayForwardNormals[rayIdx], rayMaxDists[rayIdx] );
+		}
+		double hashRaycastSeconds = GetCurrentTimeSeconds() - timeBeforeHash;
+
+		int numRaycastMismatches = 0;
+		for ( int rayIdx = 0; rayIdx < numRaysPerScene; ++rayIdx )
+		{
+			if ( !AreRaycastResultsEqual( hashResults[rayIdx], bruteForceResults[rayIdx] ) )
+			{
+				++numRaycastMismatches;
+			}
+		}
+
+		g_devConsole->PrintString( Stringf( "%4i actors: collisions brute force %8.3f ms, spatial hash %6.3f ms (%5.1fx)  %i raycasts brute force %8.3f ms, spatial hash %6.3f ms (%5.1fx), %i mismatches",
+											numActors,
+											bruteForceCollisionSeconds * 1000.0, hashCollisionSeconds * 1000.0, bruteForceCollisionSeconds / hashCollisionSeconds,
+											numRaysPerScene, bruteForceRaycastSeconds * 1000.0, hashRaycastSeconds * 1000.0, bruteForceRaycastSeconds / hashRaycastSeconds,
+											numRaycastMismatches ),
+								   numRaycastMismatches == 0 ? Rgba8::GREEN : Rgba8::RED );
+
+		PTR_SAFE_DELETE( scene.tileMap );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool EntitySpatialHashTests::CreateRandomScene( RandomNumberGenerator& rng, const IntVec2& dimensions, int numActors, SpatialHashTestScene& out_scene )
+{
+	std::string openRegionName;
+	std::string solidRegionName;
+	for ( auto regionIter = MapRegionTypeDefinition::s_definitions.begin(); regionIter != MapRegionTypeDefinition::s_definitions.end(); ++regionIter )
+	{
+		const MapRegionTypeDefinition* regionTypeDef = regionIter->second;
+		if ( regionTypeDef->IsSolid() )
+		{
+			solidRegionName = regionTypeDef->GetName();
+		}
+		else
+		{
+			openRegionName = regionTypeDef->GetName();
+		}
+	}
+
+	std::vector<EntityDefinition*> actorDefs;
+	for ( auto entityDefIter = EntityDefinition::s_definitions.begin(); entityDefIter != EntityDefinition::s_definitions.end(); ++entityDefIter )
+	{
+		if ( entityDefIter->second->GetPhysicsRadius() > 0.f )
+		{
+			actorDefs.push_back( entityDefIter->second );
+		}
+	}
+
+	if ( openRegionName.empty()
+		 || solidRegionName.empty()
+		 || actorDefs.empty() )
+	{
+		g_devConsole->PrintError( "Spatial hash tests need a solid and an open map region type and an entity type with a physics radius" );
+		return false;
+	}
+
+	// Solid border with random solid tiles inside, MapData expects the top row first
+	out_scene.dimensions = dimensions;
+	out_scene.isTileSolid.resize( (size_t)dimensions.x * (size_t)dimensions.y );
+	for ( int tileY = 0; tileY < dimensions.y; ++tileY )
+	{
+		for ( int tileX = 0; tileX < dimensions.x; ++tileX )
+		{
+			bool isBorder = tileX == 0 || tileY == 0 || tileX == dimensions.x - 1 || tileY == dimensions.y - 1;
+			out_scene.isTileSolid[( tileY * dimensions.x ) + tileX] = isBorder || rng.RollPercentChance( .1f );
+		}
+	}
+
+	// Guarantee an open tile for the player start
+	out_scene.isTileSolid[dimensions.x + 1] = false;
+
+	std::string mapXml = Stringf( "<MapDefinition type=\"TileMap\" version=\"1\" dimensions=\"%i,%i\">", dimensions.x, dimensions.y );
+	mapXml += Stringf( "<Legend><Tile glyph=\"#\" regionType=\"%s\"/><Tile glyph=\".\" regionType=\"%s\"/></Legend><MapRows>", solidRegionName.c_str(), openRegionName.c_str() );
+	for ( int tileY = dimensions.y - 1; tileY >= 0; --tileY )
+	{
+		std::string tilesStr;
+		for ( int tileX = 0; tileX < dimensions.x; ++tileX )
+		{
+			tilesStr += out_scene.isTileSolid[( tileY * dimensions.x ) + tileX] ? '#' : '.';
+		}
+
+		mapXml += Stringf( "<MapRow tiles=\"%s\"/>", tilesStr.c_str() );
+	}
+	mapXml += "</MapRows><Entities><PlayerStart pos=\"1.5,1.5\" yaw=\"0\"/></Entities></MapDefinition>";
+
+	XmlDocument doc;
+	if ( doc.Parse( mapXml.c_str() ) != tinyxml2::XML_SUCCESS )
+	{
+		g_devConsole->PrintError( "Spatial hash tests couldn't parse the generated map" );
+		return false;
+	}
+
+	MapData mapData( *doc.RootElement(), "SpatialHashTestMap", openRegionName );
+	if ( !mapData.isValid )
+	{
+		return false;
+	}
+
+	out_scene.tileMap = new TileMap( mapData, nullptr );
+
+	// Some actors spawn right next to others so plenty of them start out overlapping
+	std::vector<Entity*>& entities = out_scene.tileMap->m_entities;
+	for ( int actorNum = 0; actorNum < numActors; ++actorNum )
+	{
+		Entity* actor = out_scene.tileMap->SpawnNewEntityOfType( *actorDefs[rng.RollRandomIntLessThan( (int)actorDefs.size() )] );
+		if ( actorNum > 0
+			 && rng.RollPercentChance( .3f ) )
+		{
+			Entity* neighbor = entities[rng.RollRandomIntLessThan( actorNum )];
+			actor->SetPosition( neighbor->GetPosition() + rng.RollRandomDirection2D() * rng.RollRandomFloatInRange( 0.f, .4f ) );
+		}
+		else
+		{
+			actor->SetPosition( GetRandomOpenPosition( rng, out_scene ) );
+		}
+	}
+
+	// In game the map does this as entities update
+	out_scene.tileMap->UpdateAllEntitiesInSpatialHash();
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+Vec2 EntitySpatialHashTests::GetRandomOpenPosition( RandomNumberGenerator& rng, const SpatialHashTestScene& scene )
+{
+	while ( true )
+	{
+		int tileX = rng.RollRandomIntLessThan( scene.dimensions.x );
+		int tileY = rng.RollRandomIntLessThan( scene.dimensions.y );
+		if ( !scene.isTileSolid[( tileY * scene.dimensions.x ) + tileX] )
+		{
+			return Vec2( (float)tileX + rng.RollRandomFloatZeroToAlmostOne(), (float)tileY + rng.RollRandomFloatZeroToAlmostOne() ) * TILE_SIZE;
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Mostly small steps like walking, with the odd teleport so colliding pairs end up far apart
+void EntitySpatialHashTests::MoveEntitiesRandomly( RandomNumberGenerator& rng, const SpatialHashTestScene& scene )
+{
+	std::vector<Entity*>& entities = scene.tileMap->m_entities;
+	for ( int entityIdx = 0; entityIdx < (int)entities.size(); ++entityIdx )
+	{
+		Entity* const& entity = entities[entityIdx];
+		if ( entity == nullptr )
+		{
+			continue;
+		}
+
+		if ( rng.RollPercentChance( .05f ) )
+		{
+			entity->SetPosition( GetRandomOpenPosition( rng, scene ) );
+		}
+		else if ( rng.RollPercentChance( .8f ) )
+		{
+			entity->Translate( rng.RollRandomDirection2D() * rng.RollRandomFloatInRange( 0.f, .3f ) );
+		}
+	}
+
+	scene.tileMap->UpdateAllEntitiesInSpatialHash();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialHashTests::RollRandomRay( RandomNumberGenerator& rng, const SpatialHashTestScene& scene, Vec3& out_startPos, Vec3& out_forwardNormal, float& out_maxDist )
+{
+	// Shots from inside an actor, like a monster firing, hit it and any others overlapping it at distance 0
+	const std::vector<Entity*>& entities = scene.tileMap->m_entities;
+	Entity* shooter = entities.empty() ? nullptr : entities[rng.RollRandomIntLessThan( (int)entities.size() )];
+	if ( shooter != nullptr
+		 && rng.RollPercentChance( .25f ) )
+	{
+		out_startPos = Vec3( shooter->GetPosition(), shooter->GetEyeHeight() );
+	}
+	else if ( rng.RollPercentChance( .9f ) )
+	{
+		out_startPos = Vec3( GetRandomOpenPosition( rng, scene ), rng.RollRandomFloatInRange( .05f, .95f ) * TILE_SIZE );
+	}
+	else
+	{
+		out_startPos = Vec3( rng.RollRandomFloatInRange( -1.f, (float)scene.dimensions.x + 1.f ), rng.RollRandomFloatInRange( -1.f, (float)scene.dimensions.y + 1.f ),
+							 rng.RollRandomFloatInRange( -.2f, 1.2f ) * TILE_SIZE );
+	}
+
+	if ( rng.RollPercentChance( .05f ) )
+	{
+		out_forwardNormal = Vec3( 0.f, 0.f, rng.RollPercentChance( .5f ) ? 1.f : -1.f );
+	}
+	else
+	{
+		float pitchDegrees = rng.RollRandomFloatInRange( -20.f, 20.f );
+		out_forwardNormal = Vec3( rng.RollRandomDirection2D() * CosDegrees( pitchDegrees ), SinDegrees( pitchDegrees ) );
+	}
+
+	out_maxDist = rng.RollRandomFloatInRange( .5f, 20.f );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialHashTests::ResolveEntityVsEntityCollisionsBruteForce( Map& map )
+{
+	std::vector<Entity*>& entities = map.m_entities;
+	for ( int entityIdx = 0; entityIdx < (int)entities.size(); ++entityIdx )
+	{
+		Entity* const& entity = entities[entityIdx];
+		if ( entity == nullptr )
+		{
+			continue;
+		}
+
+		for ( int otherEntityIdx = entityIdx + 1; otherEntityIdx < (int)entities.size(); ++otherEntityIdx )
+		{
+			Entity* const& otherEntity = entities[otherEntityIdx];
+			if ( otherEntity == nullptr )
+			{
+				continue;
+			}
+
+			if ( !g_physicsConfig->DoLayersInteract( entity->GetCollisionLayer(), otherEntity->GetCollisionLayer() ) )
+			{
+				continue;
+			}
+
+			map.ResolveCollisionEvents( entity, otherEntity );
+
+			if ( entity == nullptr
+				 || otherEntity == nullptr )
+			{
+				continue;
+			}
+
+			map.ResolveEntityVsEntityCollision( *entity, *otherEntity );
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+RaycastResult EntitySpatialHashTests::RaycastBruteForce( const TileMap& tileMap, const Vec3& startPos, const Vec3& forwardNormal, float maxDist )
+{
+	RaycastResult closestImpact;
+	closestImpact.impactDist = maxDist;
+
+	RaycastResult floorResult = tileMap.RaycastAgainstZPlane( startPos, forwardNormal, maxDist, 0.f );
+	if ( floorResult.didImpact
+		 && floorResult.impactDist < closestImpact.impactDist )
+	{
+		closestImpact = floorResult;
+	}
+
+	RaycastResult ceilingResult = tileMap.RaycastAgainstZPlane( startPos, forwardNormal, maxDist, TILE_SIZE );
+	if ( ceilingResult.didImpact
+		 && ceilingResult.impactDist < closestImpact.impactDist )
+	{
+		closestImpact = ceilingResult;
+	}
+
+	RaycastResult wallsResult = tileMap.RaycastAgainstWalls( startPos, forwardNormal, maxDist );
+	if ( wallsResult.didImpact
+		 && wallsResult.impactDist < closestImpact.impactDist )
+	{
+		closestImpact = wallsResult;
+	}
+
+	RaycastResult entitiesResult = tileMap.RaycastAgainstEntitiesFast( startPos, forwardNormal, maxDist );
+	if ( entitiesResult.didImpact
+		 && entitiesResult.impactDist < closestImpact.impactDist )
+	{
+		closestImpact = entitiesResult;
+	}
+
+	return closestImpact;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialHashTests::SaveEntityStates( const Map& map, std::vector<Vec2>& out_positions, std::vector<std::unordered_set<EntityId>>& out_collidingEntities )
+{
+	out_positions.clear();
+	out_collidingEntities.clear();
+
+	for ( int entityIdx = 0; entityIdx < (int)map.m_entities.size(); ++entityIdx )
+	{
+		Entity* const& entity = map.m_entities[entityIdx];
+		out_positions.push_back( entity == nullptr ? Vec2::ZERO : entity->m_position );
+		out_collidingEntities.push_back( entity == nullptr ? std::unordered_set<EntityId>() : entity->m_collidingEntities );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialHashTests::RestoreEntityStates( Map& map, const std::vector<Vec2>& positions, const std::vector<std::unordered_set<EntityId>>& collidingEntities )
+{
+	for ( int entityIdx = 0; entityIdx < (int)map.m_entities.size(); ++entityIdx )
+	{
+		Entity* const& entity = map.m_entities[entityIdx];
+		if ( entity == nullptr )
+		{
+			continue;
+		}
+
+		entity->m_position = positions[entityIdx];
+		entity->m_collidingEntities = collidingEntities[entityIdx];
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool EntitySpatialHashTests::AreRaycastResultsEqual( const RaycastResult& result1, const RaycastResult& result2 )
+{
+	return result1.didImpact == result2.didImpact
+		&& result1.impactEntity == result2.impactEntity
+		&& result1.impactDist == result2.impactDist
+		&& result1.impactFraction == result2.impactFraction
+		&& result1.impactPos == result2.impactPos
+		&& result1.impactSurfaceNormal == result2.impactSurfaceNormal;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "Engine/Math/IntVec2.hpp"
+#include "Game/Map.hpp"
+
+#include <unordered_set>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------------------------
+class RandomNumberGenerator;
+class TileMap;
+
+
+//-----------------------------------------------------------------------------------------------
+struct SpatialHashTestScene
+{
+public:
+	TileMap* tileMap = nullptr;
+	IntVec2 dimensions;
+	std::vector<bool> isTileSolid;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+class EntitySpatialHashTests
+{
+	friend class RaycastBatchTests;
+
+public:
+	// Builds random tile maps full of actors and checks that collision resolution and raycasts through the
+	// spatial hash give exactly the same positions, colliding pairs and impacts as checking every entity
+	static void RunTests( int numScenes );
+	// Times collision resolution and raycasts with and without the spatial hash, from 50 up to 5000 actors
+	static void RunBenchmark( int numRaysPerScene );
+
+private:
+	static bool CreateRandomScene( RandomNumberGenerator& rng, const IntVec2& dimensions, int numActors, SpatialHashTestScene& out_scene );
+	static Vec2 GetRandomOpenPosition( RandomNumberGenerator& rng, const SpatialHashTestScene& scene );
+	static void MoveEntitiesRandomly( RandomNumberGenerator& rng, const SpatialHashTestScene& scene );
+	static void RollRandomRay( RandomNumberGenerator& rng, const SpatialHashTestScene& scene, Vec3& out_startPos, Vec3& out_forwardNormal, float& out_maxDist );
+
+	// Map::ResolveEntityVsEntityCollisions and TileMap::Raycast as they were before the spatial hash
+	static void ResolveEntityVsEntityCollisionsBruteForce( Map& map );
+	static RaycastResult RaycastBruteForce( const TileMap& tileMap, const Vec3& startPos, const Vec3& forwardNormal, float maxDist );
+
+	static void SaveEntityStates( const Map& map, std::vector<Vec2>& out_positions, std::vector<std::unordered_set<EntityId>>& out_collidingEntities );
+	static void RestoreEntityStates( Map& map, const std::vector<Vec2>& positions, const std::vector<std::unordered_set<EntityId>>& collidingEntities );
+	static bool AreRaycastResultsEqual( const RaycastResult& result1, const RaycastResult& result2 );
+};
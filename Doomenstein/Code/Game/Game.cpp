@@ -41,11 +41,13 @@
 #include "Engine/ZephyrCore/ZephyrUtils.hpp"
 
 #include "Game/Entity.hpp"
+#include "Game/EntitySpatialHashTests.hpp"
 #include "Game/PhysicsConfig.hpp"
 #include "Game/GameJobs.hpp"
 #include "Game/MapData.hpp"
 #include "Game/MapRegionTypeDefinition.hpp"
 #include "Game/MapMaterialTypeDefinition.hpp"
+#include "Game/RaycastBatchTests.hpp"
 #include "Game/TileDefinition.hpp"
 #include "Game/World.hpp"
 
@@ -101,6 +103,10 @@ void Game::Startup()
 	g_eventSystem->RegisterEvent( "set_mouse_sensitivity", "Usage: set_mouse_sensitivity multiplier=NUMBER. Set the multiplier for mouse sensitivity.", eUsageLocation::DEV_CONSOLE, SetMouseSensitivity );
 	g_eventSystem->RegisterEvent( "light_set_ambient_color", "Usage: light_set_ambient_color color=r,g,b", eUsageLocation::DEV_CONSOLE, SetAmbientLightColor );
 	g_eventSystem->RegisterMethodEvent( "warp", "Usage: warp <map=string> <pos=float,float> <yaw=float>", eUsageLocation::DEV_CONSOLE, this, &Game::WarpMapCommand );
+	g_eventSystem->RegisterMethodEvent( "test_spatial_hash", "Usage: test_spatial_hash numScenes=20 Check entity collisions and raycasts through the spatial hash against brute force on random maps.", eUsageLocation::DEV_CONSOLE, this, &Game::TestSpatialHashCommand );
+	g_eventSystem->RegisterMethodEvent( "benchmark_spatial_hash", "Usage: benchmark_spatial_hash numRays=2000 Time entity collisions and raycasts with and without the spatial hash from 50 to 5000 actors.", eUsageLocation::DEV_CONSOLE, this, &Game::BenchmarkSpatialHashCommand );
+	g_eventSystem->RegisterMethodEvent( "test_raycast_batch", "Usage: test_raycast_batch numScenes=20 Check batched raycasts against sequential raycasts on random maps.", eUsageLocation::DEV_CONSOLE, this, &Game::TestRaycastBatchCommand );
+	g_eventSystem->RegisterMethodEvent( "benchmark_raycast_batch", "Usage: benchmark_raycast_batch numRays=20000 Time raycasts one at a time against one batch split across job workers.", eUsageLocation::DEV_CONSOLE, this, &Game::BenchmarkRaycastBatchCommand );
 
 	g_inputSystem->PushMouseOptions( CURSOR_RELATIVE, false, true );
 		
@@ -1204,6 +1210,62 @@ void Game::WarpMapCommand( EventArgs* args )
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void Game::TestSpatialHashCommand( EventArgs* args )
+{
+	int numScenes = args->GetValue( "numScenes", 20 );
+	if ( numScenes < 1 )
+	{
+		g_devConsole->PrintError( "numScenes must be at least 1" );
+		return;
+	}
+
+	EntitySpatialHashTests::RunTests( numScenes );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Game::BenchmarkSpatialHashCommand( EventArgs* args )
+{
+	int numRays = args->GetValue( "numRays", 2000 );
+	if ( numRays < 1 )
+	{
+		g_devConsole->PrintError( "numRays must be at least 1" );
+		return;
+	}
+
+	EntitySpatialHashTests::RunBenchmark( numRays );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Game::TestRaycastBatchCommand( EventArgs* args )
+{
+	int numScenes = args->GetValue( "numScenes", 20 );
+	if ( numScenes < 1 )
+	{
+		g_devConsole->PrintError( "numScenes must be at least 1" );
+		return;
+	}
+
+	RaycastBatchTests::RunTests( numScenes );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Game::BenchmarkRaycastBatchCommand( EventArgs* args )
+{
+	int numRays = args->GetValue( "numRays", 20000 );
+	if ( numRays < 1 )
+	{
+		g_devConsole->PrintError( "numRays must be at least 1" );
+		return;
+	}
+
+	RaycastBatchTests::RunBenchmark( numRays );
+}
+
+
 //-----------------------------------------------------------------------------------------------
 Entity* Game::GetEntityById( EntityId id )
 {
@@ -145,6 +145,10 @@ private:
 	
 	// Events
 	void WarpMapCommand( EventArgs* args );
+	void TestSpatialHashCommand( EventArgs* args );
+	void BenchmarkSpatialHashCommand( EventArgs* args );
+	void TestRaycastBatchCommand( EventArgs* args );
+	void BenchmarkRaycastBatchCommand( EventArgs* args );
 
 private:
 	Clock* m_gameClock = nullptr;
@@ -6,6 +6,8 @@
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Renderer/MeshUtils.hpp"
 
+#include "Game/TileMap.hpp"
+
 
 //-----------------------------------------------------------------------------------------------
 // TestJob
@@ -31,3 +33,60 @@ void TestJob::ClaimJobCallback()
 	std::string msg = Stringf( "Claiming job %i", m_id );
 	g_devConsole->PrintString( msg, Rgba8::PURPLE );
 }
+
+
+//-----------------------------------------------------------------------------------------------
+// RaycastBatchState
+//-----------------------------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------------------------
+RaycastBatchState::RaycastBatchState( const TileMap& tileMap, const RayQuery* queries, RaycastResult* out_results, int numQueries )
+	: m_tileMap( tileMap )
+	, m_queries( queries )
+	, m_results( out_results )
+	, m_numQueries( numQueries )
+	, m_numGroups( ( numQueries + RAYCAST_BATCH_GROUP_SIZE - 1 ) / RAYCAST_BATCH_GROUP_SIZE )
+	, m_nextGroupIdx( 0 )
+	, m_numGroupsComplete( 0 )
+{
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool RaycastBatchState::RaycastNextGroup()
+{
+	int groupIdx = m_nextGroupIdx++;
+	if ( groupIdx >= m_numGroups )
+	{
+		return false;
+	}
+
+	int firstQueryIdx = groupIdx * RAYCAST_BATCH_GROUP_SIZE;
+	int numGroupQueries = Min( RAYCAST_BATCH_GROUP_SIZE, m_numQueries - firstQueryIdx );
+	m_tileMap.RaycastBatchGroup( m_queries + firstQueryIdx, m_results + firstQueryIdx, numGroupQueries );
+
+	++m_numGroupsComplete;
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// RaycastBatchJob
+//-----------------------------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------------------------
+RaycastBatchJob::RaycastBatchJob( std::shared_ptr<RaycastBatchState> batchState )
+	: m_batchState( batchState )
+{
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void RaycastBatchJob::Execute()
+{
+	while ( m_batchState->RaycastNextGroup() )
+	{
+	}
+}
@@ -1,6 +1,15 @@
 #pragma once
 #include "Engine/Core/JobSystem.hpp"
 
+#include <atomic>
+#include <memory>
+
+
+//-----------------------------------------------------------------------------------------------
+class TileMap;
+struct RayQuery;
+struct RaycastResult;
+
 
 //-----------------------------------------------------------------------------------------------
 class TestJob : public Job
@@ -15,3 +24,41 @@ public:
 private:
 	float m_result = 0.f;
 };
+
+
+//-----------------------------------------------------------------------------------------------
+// Groups of one TileMap::RaycastBatch call, claimed one at a time by the calling thread and its jobs.
+// Jobs can start after the call has returned, so they hold this through a shared_ptr and only touch the queries of groups they claim.
+class RaycastBatchState
+{
+public:
+	RaycastBatchState( const TileMap& tileMap, const RayQuery* queries, RaycastResult* out_results, int numQueries );
+
+	// Raycasts the next unclaimed group, returns false once every group has been claimed
+	bool RaycastNextGroup();
+	bool AreAllGroupsComplete() const						{ return m_numGroupsComplete == m_numGroups; }
+
+private:
+	const TileMap&		m_tileMap;
+	const RayQuery*		m_queries = nullptr;
+	RaycastResult*		m_results = nullptr;
+	int					m_numQueries = 0;
+	int					m_numGroups = 0;
+
+	std::atomic<int>	m_nextGroupIdx;
+	std::atomic<int>	m_numGroupsComplete;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+class RaycastBatchJob : public Job
+{
+public:
+	RaycastBatchJob( std::shared_ptr<RaycastBatchState> batchState );
+	virtual ~RaycastBatchJob() {}
+
+	virtual void Execute() override;				// Called by worker thread
+
+private:
+	std::shared_ptr<RaycastBatchState> m_batchState;
+};
@@ -16,6 +16,8 @@
 #include "Game/PhysicsConfig.hpp"
 #include "Game/World.hpp"
 
+#include <algorithm>
+
 
 //-----------------------------------------------------------------------------------------------
 Map::Map( const MapData& mapData, World* world )
@@ -47,6 +49,7 @@ void Map::Update( float deltaSeconds )
 		}
 
 		entity->Update( deltaSeconds );
+		UpdateEntityInSpatialHash( entityIdx );
 	}
 
 	ResolveEntityVsEntityCollisions();
@@ -110,6 +113,7 @@ Entity* Map::SpawnNewEntityOfType( const EntityDefinition& entityDef )
 {
 	Entity* entity = new Entity( entityDef, this );
 	m_entities.emplace_back( entity );
+	UpdateEntityInSpatialHash( (int)m_entities.size() - 1 );
 	return entity;
 }
 
@@ -196,6 +200,7 @@ void Map::RemoveOwnershipOfEntity( Entity* entityToRemove )
 		if ( entity == entityToRemove )
 		{
 			m_entities[entityIdx] = nullptr;
+			m_entitySpatialHash.RemoveEntity( entityIdx );
 		}
 	}
 }
@@ -210,11 +215,27 @@ void Map::TakeOwnershipOfEntity( Entity* entityToAdd )
 		if ( entity == nullptr )
 		{
 			entity = entityToAdd;
+			UpdateEntityInSpatialHash( entityIdx );
 			return;
 		}
 	}
 
 	m_entities.push_back( entityToAdd );
+	UpdateEntityInSpatialHash( (int)m_entities.size() - 1 );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Map::UpdateEntityInSpatialHash( Entity* entity )
+{
+	for ( int entityIdx = 0; entityIdx < (int)m_entities.size(); ++entityIdx )
+	{
+		if ( m_entities[entityIdx] == entity )
+		{
+			UpdateEntityInSpatialHash( entityIdx );
+			return;
+		}
+	}
 }
 
 
@@ -304,6 +325,9 @@ void Map::LoadEntities( const std::vector<MapEntityDefinition>& mapEntityDefs )
 			continue;
 		}
 
+		// Spawned entities are appended and slots are never reordered, so this stays valid if the script spawns more
+		int newEntityIdx = (int)m_entities.size() - 1;
+
 		// Must be saved before initializing zephyr script
 		newEntity->SetName( mapEntityDef.name );
 		m_world->SaveEntityByName( newEntity );
@@ -312,6 +336,7 @@ void Map::LoadEntities( const std::vector<MapEntityDefinition>& mapEntityDefs )
 
 		newEntity->SetPosition( mapEntityDef.position );
 		newEntity->SetOrientationDegrees( mapEntityDef.yawDegrees );
+		UpdateEntityInSpatialHash( newEntityIdx );
 
 		// Define initial script values defined in map file
 		// Note: These will override any initial values already defined in the EntityDefinition
@@ -324,6 +349,9 @@ void Map::LoadEntities( const std::vector<MapEntityDefinition>& mapEntityDefs )
 //-----------------------------------------------------------------------------------------------
 void Map::ResolveEntityVsEntityCollisions()
 {
+	// Scripts and warps can move entities outside of Update
+	UpdateAllEntitiesInSpatialHash();
+
 	for ( int entityIdx = 0; entityIdx < (int)m_entities.size(); ++entityIdx )
 	{
 		Entity* const& entity = m_entities[entityIdx];
@@ -332,9 +360,18 @@ void Map::ResolveEntityVsEntityCollisions()
 			continue;
 		}
 
-		for ( int otherEntityIdx = entityIdx + 1; otherEntityIdx < (int)m_entities.size(); ++otherEntityIdx )
+		// Pairs are resolved in the same order as checking every entity against every later one
+		GetEntityCollisionCandidates( entityIdx, m_collisionCandidateIndices );
+
+		for ( int candidateIdx = 0; candidateIdx < (int)m_collisionCandidateIndices.size(); ++candidateIdx )
 		{
+			int otherEntityIdx = m_collisionCandidateIndices[candidateIdx];
 			Entity* const& otherEntity = m_entities[otherEntityIdx];
+			if ( entity == nullptr )
+			{
+				break;
+			}
+
 			if ( otherEntity == nullptr )
 			{
 				continue;
@@ -355,11 +392,82 @@ void Map::ResolveEntityVsEntityCollisions()
 			}
 
 			ResolveEntityVsEntityCollision( *entity, *otherEntity );
+
+			UpdateEntityInSpatialHash( entityIdx );
+			UpdateEntityInSpatialHash( otherEntityIdx );
 		}
 	}
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Every later entity that could overlap this one, plus any it was colliding with so leave events still fire, sorted by index
+void Map::GetEntityCollisionCandidates( int entityIdx, std::vector<int>& out_otherEntityIndices ) const
+{
+	out_otherEntityIndices.clear();
+
+	const Entity& entity = *m_entities[entityIdx];
+
+	// Search a cell further than two of the biggest discs can reach, so pushes from earlier pairs
+	// can't move an entity into range of one that wasn't gathered
+	int cellSearchRadius = (int)ceilf( 2.f * m_entitySpatialHash.GetMaxPhysicsRadius() / TILE_SIZE ) + 1;
+	const IntVec2& entityCell = m_entitySpatialHash.GetEntityCell( entityIdx );
+
+	for ( int cellY = entityCell.y - cellSearchRadius; cellY <= entityCell.y + cellSearchRadius; ++cellY )
+	{
+		for ( int cellX = entityCell.x - cellSearchRadius; cellX <= entityCell.x + cellSearchRadius; ++cellX )
+		{
+			IntVec2 cell( cellX, cellY );
+			const std::vector<int>& bucket = m_entitySpatialHash.GetBucketForCell( cell );
+			for ( int bucketEntityIdx = 0; bucketEntityIdx < (int)bucket.size(); ++bucketEntityIdx )
+			{
+				int otherEntityIdx = bucket[bucketEntityIdx];
+				if ( otherEntityIdx > entityIdx
+					 && m_entitySpatialHash.GetEntityCell( otherEntityIdx ) == cell )
+				{
+					out_otherEntityIndices.push_back( otherEntityIdx );
+				}
+			}
+		}
+	}
+
+	int numNearbyEntities = (int)out_otherEntityIndices.size();
+	for ( auto collidingIter = entity.m_collidingEntities.begin(); collidingIter != entity.m_collidingEntities.end(); ++collidingIter )
+	{
+		EntityId collidingId = *collidingIter;
+
+		bool isNearby = false;
+		for ( int nearbyIdx = 0; nearbyIdx < numNearbyEntities; ++nearbyIdx )
+		{
+			if ( m_entities[out_otherEntityIndices[nearbyIdx]]->GetId() == collidingId )
+			{
+				isNearby = true;
+				break;
+			}
+		}
+
+		if ( isNearby )
+		{
+			continue;
+		}
+
+		// Only happens when an entity jumps far in a single frame, so a linear search is fine
+		for ( int otherEntityIdx = entityIdx + 1; otherEntityIdx < (int)m_entities.size(); ++otherEntityIdx )
+		{
+			Entity* const& otherEntity = m_entities[otherEntityIdx];
+			if ( otherEntity != nullptr
+				 && otherEntity->GetId() == collidingId )
+			{
+				out_otherEntityIndices.push_back( otherEntityIdx );
+				break;
+			}
+		}
+	}
+
+	std::sort( out_otherEntityIndices.begin(), out_otherEntityIndices.end() );
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void Map::ResolveCollisionEvents( Entity* entity, Entity* otherEntity )
 {
@@ -490,3 +598,33 @@ void Map::ResolveEntityVsEntityCollision( Entity& entity1, Entity& entity2 )
 		}
 	}
 }
+
+//-----------------------------------------------------------------------------------------------
+void Map::UpdateEntityInSpatialHash( int entityIdx )
+{
+	Entity* const& entity = m_entities[entityIdx];
+	if ( entity == nullptr )
+	{
+		m_entitySpatialHash.RemoveEntity( entityIdx );
+		return;
+	}
+
+	if ( m_entitySpatialHash.IsEntityInHash( entityIdx ) )
+	{
+		m_entitySpatialHash.UpdateEntity( entityIdx, entity->GetPosition() );
+	}
+	else
+	{
+		m_entitySpatialHash.AddEntity( entityIdx, entity->GetPosition(), entity->GetPhysicsRadius() );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Map::UpdateAllEntitiesInSpatialHash()
+{
+	for ( int entityIdx = 0; entityIdx < (int)m_entities.size(); ++entityIdx )
+	{
+		UpdateEntityInSpatialHash( entityIdx );
+	}
+}
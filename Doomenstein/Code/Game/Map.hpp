@@ -1,6 +1,7 @@
 #pragma once
 #include "Game/Tile.hpp"
 #include "Game/Entity.hpp"
+#include "Game/EntitySpatialHash.hpp"
 
 #include <string>
 #include <vector>
@@ -28,9 +29,20 @@ struct RaycastResult
 };
 
 
+//-----------------------------------------------------------------------------------------------
+struct RayQuery
+{
+	Vec3 startPos;
+	Vec3 forwardNormal;
+	float maxDist = 0.f;
+};
+
+
 //-----------------------------------------------------------------------------------------------
 class Map
 {
+	friend class EntitySpatialHashTests;
+
 public:
 	Map( const MapData& mapData, World* world );
 	virtual ~Map();
@@ -57,6 +69,8 @@ public:
 
 	void				RemoveOwnershipOfEntity( Entity* entityToRemove );
 	void				TakeOwnershipOfEntity( Entity* entityToAdd );
+	// Call after moving an owned entity outside of Update, e.g. when warping it
+	void				UpdateEntityInSpatialHash( Entity* entity );
 
 	Entity*				GetEntityById( EntityId id );
 	Entity*				GetEntityByName( const std::string& name );
@@ -66,11 +80,16 @@ protected:
 	void LoadEntities( const std::vector<MapEntityDefinition>& mapEntityDefs );
 
 	void ResolveEntityVsEntityCollisions();
+	void GetEntityCollisionCandidates( int entityIdx, std::vector<int>& out_otherEntityIndices ) const;
 	void ResolveCollisionEvents( Entity* entity, Entity* otherEntity );
 	void ResolveEntityVsEntityCollision( Entity& entity1, Entity& entity2 );
 
 	virtual RaycastResult Raycast( const Vec3& startPos, const Vec3& forwardNormal, float maxDist ) const = 0;
 
+	// Moves the entity to the cell it's in now, or out of the hash if its slot was emptied
+	void UpdateEntityInSpatialHash( int entityIdx );
+	void UpdateAllEntitiesInSpatialHash();
+
 protected:
 	std::string				m_name;
 	World*					m_world = nullptr;
@@ -80,4 +99,6 @@ protected:
 	float					m_playerStartYaw = 0.f;
 
 	std::vector<Entity*>	m_entities;
+	EntitySpatialHash		m_entitySpatialHash;					// Indexed by position in m_entities
+	std::vector<int>		m_collisionCandidateIndices;			// Scratch space for ResolveEntityVsEntityCollisions
 };
@@ -0,0 +1,168 @@
+#include "Game/RaycastBatchTests.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Time/Time.hpp"
+
+#include "Game/GameCommon.hpp"
+#include "Game/EntitySpatialHashTests.hpp"
+#include "Game/TileMap.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+static constexpr int MAX_TEST_BATCH_SIZE = 4000;
+static const IntVec2 BENCHMARK_MAP_DIMENSIONS( 64, 64 );
+
+
+//-----------------------------------------------------------------------------------------------
+void RaycastBatchTests::RunTests( int numScenes )
+{
+	RandomNumberGenerator rng;
+	rng.Reset( 51 );
+
+	int numRaycasts = 0;
+	int numSequentialMismatches = 0;
+	int numRepeatMismatches = 0;
+
+	for ( int sceneNum = 0; sceneNum < numScenes; ++sceneNum )
+	{
+		IntVec2 dimensions( rng.RollRandomIntInRange( 8, 40 ), rng.RollRandomIntInRange( 8, 40 ) );
+		SpatialHashTestScene scene;
+		if ( !EntitySpatialHashTests::CreateRandomScene( rng, dimensions, rng.RollRandomIntInRange( 2, 400 ), scene ) )
+		{
+			return;
+		}
+
+		TileMap& tileMap = *scene.tileMap;
+
+		// Every other batch is around a group in size, so partly filled and single group batches get checked as well as split ones
+		int maxBatchSize = sceneNum % 2 == 0 ? RAYCAST_BATCH_GROUP_SIZE * 2 : MAX_TEST_BATCH_SIZE;
+		int numQueries = rng.RollRandomIntInRange( 1, maxBatchSize );
+
+		std::vector<RayQuery> queries( numQueries );
+		for ( int queryIdx = 0; queryIdx < numQueries; ++queryIdx )
+		{
+			RayQuery& query = queries[queryIdx];
+			EntitySpatialHashTests::RollRandomRay( rng, scene, query.startPos, query.forwardNormal, query.maxDist );
+		}
+
+		std::vector<RaycastResult> sequentialResults( numQueries );
+		for ( int queryIdx = 0; queryIdx < numQueries; ++queryIdx )
+		{
+			const RayQuery& query = queries[queryIdx];
+			sequentialResults[queryIdx] = tileMap.Raycast( query.startPos, query.forwardNormal, query.maxDist );
+		}
+
+		std::vector<RaycastResult> batchResults( numQueries );
+		tileMap.RaycastBatch( queries.data(), batchResults.data(), numQueries );
+
+		// Workers pick up groups in a different order each run, which mustn't change anything
+		std::vector<RaycastResult> repeatBatchResults( numQueries );
+		tileMap.RaycastBatch( queries.data(), repeatBatchResults.data(), numQueries );
+
+		for ( int queryIdx = 0; queryIdx < numQueries; ++queryIdx )
+		{
+			if ( !AreRaycastResultsIdentical( batchResults[queryIdx], sequentialResults[queryIdx] ) )
+			{
+				++numSequentialMismatches;
+			}
+
+			if ( !AreRaycastResultsIdentical( repeatBatchResults[queryIdx], batchResults[queryIdx] ) )
+			{
+				++numRepeatMismatches;
+			}
+		}
+
+		numRaycasts += numQueries;
+
+		PTR_SAFE_DELETE( scene.tileMap );
+	}
+
+	int numWorkerThreads = g_jobSystem != nullptr ? g_jobSystem->GetNumWorkerThreads() : 0;
+	if ( numSequentialMismatches > 0
+		 || numRepeatMismatches > 0 )
+	{
+		g_devConsole->PrintError( Stringf( "Raycast batch tests failed with %i workers: %i results differ from sequential raycasts and %i differ between batch runs",
+										   numWorkerThreads, numSequentialMismatches, numRepeatMismatches ) );
+		return;
+	}
+
+	g_devConsole->PrintString( Stringf( "Raycast batch tests passed with %i workers: %i scenes, %i batched raycasts match sequential raycasts", numWorkerThreads, numScenes, numRaycasts ), Rgba8::GREEN );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void RaycastBatchTests::RunBenchmark( int numRays )
+{
+	RandomNumberGenerator rng;
+	rng.Reset( 52 );
+
+	int numWorkerThreads = g_jobSystem != nullptr ? g_jobSystem->GetNumWorkerThreads() : 0;
+
+	const int actorCounts[] = { 100, 1000, 5000 };
+	for ( int countIdx = 0; countIdx < (int)( sizeof( actorCounts ) / sizeof( actorCounts[0] ) ); ++countIdx )
+	{
+		int numActors = actorCounts[countIdx];
+
+		SpatialHashTestScene scene;
+		if ( !EntitySpatialHashTests::CreateRandomScene( rng, BENCHMARK_MAP_DIMENSIONS, numActors, scene ) )
+		{
+			return;
+		}
+
+		TileMap& tileMap = *scene.tileMap;
+
+		std::vector<RayQuery> queries( numRays );
+		for ( int queryIdx = 0; queryIdx < numRays; ++queryIdx )
+		{
+			RayQuery& query = queries[queryIdx];
+			EntitySpatialHashTests::RollRandomRay( rng, scene, query.startPos, query.forwardNormal, query.maxDist );
+		}
+
+		std::vector<RaycastResult> sequentialResults( numRays );
+		double timeBeforeSequential = GetCurrentTimeSeconds();
+		for ( int queryIdx = 0; queryIdx < numRays; ++queryIdx )
+		{
+			const RayQuery& query = queries[queryIdx];
+			sequentialResults[queryIdx] = tileMap.Raycast( query.startPos, query.forwardNormal, query.maxDist );
+		}
+		double sequentialSeconds = GetCurrentTimeSeconds() - timeBeforeSequential;
+
+		std::vector<RaycastResult> batchResults( numRays );
+		double timeBeforeBatch = GetCurrentTimeSeconds();
+		tileMap.RaycastBatch( queries.data(), batchResults.data(), numRays );
+		double batchSeconds = GetCurrentTimeSeconds() - timeBeforeBatch;
+
+		int numMismatches = 0;
+		for ( int queryIdx = 0; queryIdx < numRays; ++queryIdx )
+		{
+			if ( !AreRaycastResultsIdentical( batchResults[queryIdx], sequentialResults[queryIdx] ) )
+			{
+				++numMismatches;
+			}
+		}
+
+		g_devConsole->PrintString( Stringf( "%4i actors: %i raycasts one at a time %8.3f ms, batched on %i workers %8.3f ms (%5.1fx), %i mismatches",
+											numActors, numRays, sequentialSeconds * 1000.0, numWorkerThreads, batchSeconds * 1000.0, sequentialSeconds / batchSeconds, numMismatches ),
+								   numMismatches == 0 ? Rgba8::GREEN : Rgba8::RED );
+
+		PTR_SAFE_DELETE( scene.tileMap );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool RaycastBatchTests::AreRaycastResultsIdentical( const RaycastResult& result1, const RaycastResult& result2 )
+{
+	return result1.startPos == result2.startPos
+		&& result1.forwardNormal == result2.forwardNormal
+		&& result1.maxDist == result2.maxDist
+		&& result1.didImpact == result2.didImpact
+		&& result1.impactPos == result2.impactPos
+		&& result1.impactEntity == result2.impactEntity
+		&& result1.impactFraction == result2.impactFraction
+		&& result1.impactDist == result2.impactDist
+		&& result1.impactSurfaceNormal == result2.impactSurfaceNormal;
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include "Game/Map.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+class RaycastBatchTests
+{
+public:
+	// Checks that TileMap::RaycastBatch gives exactly the same results as calling Raycast on each query in order,
+	// and the same results again when run a second time, on random maps with batches of many sizes
+	static void RunTests( int numScenes );
+	// Times numRays raycasts one at a time against a single batch, with the job system's workers
+	static void RunBenchmark( int numRays );
+
+private:
+	static bool AreRaycastResultsIdentical( const RaycastResult& result1, const RaycastResult& result2 );
+};
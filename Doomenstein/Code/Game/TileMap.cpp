@@ -1,4 +1,7 @@
 #include "Game/TileMap.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/JobSystem.hpp"
 #include "Engine/Core/Vertex_PCUTBN.hpp"
 #include "Engine/Math/FloatRange.hpp"
 #include "Engine/Math/MathUtils.hpp"
@@ -13,11 +16,15 @@
 
 #include "Game/GameCommon.hpp"
 #include "Game/Game.hpp"
+#include "Game/GameJobs.hpp"
 #include "Game/MapData.hpp"
 #include "Game/MapRegionTypeDefinition.hpp"
 #include "Game/MapMaterialTypeDefinition.hpp"
 #include "Game/PhysicsConfig.hpp"
 
+#include <memory>
+#include <thread>
+
 
 //-----------------------------------------------------------------------------------------------
 TileMap::TileMap( const MapData& mapData, World* world )
@@ -235,14 +242,16 @@ RaycastResult TileMap::Raycast( const Vec3& startPos, const Vec3& forwardNormal,
 		closestImpact = ceilingResult;
 	}
 
-	RaycastResult wallsResult = RaycastAgainstWalls( startPos, forwardNormal, maxDist );
+	// Walls and entities past the floor or ceiling impact can't be any closer, so the grid walk can stop there
+	RaycastResult wallsResult;
+	RaycastResult entitiesResult;
+	RaycastAgainstWallsAndEntities( startPos, forwardNormal, maxDist, closestImpact.impactDist, wallsResult, &entitiesResult );
 	if ( wallsResult.didImpact
 		 && wallsResult.impactDist < closestImpact.impactDist )
 	{
 		closestImpact = wallsResult;
 	}
 
-	RaycastResult entitiesResult = RaycastAgainstEntitiesFast( startPos, forwardNormal, maxDist );
 	if ( entitiesResult.didImpact
 		 && entitiesResult.impactDist < closestImpact.impactDist )
 	{
@@ -253,6 +262,130 @@ RaycastResult TileMap::Raycast( const Vec3& startPos, const Vec3& forwardNormal,
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void TileMap::RaycastBatch( const RayQuery* queries, RaycastResult* out_results, int numQueries ) const
+{
+	int numGroups = ( numQueries + RAYCAST_BATCH_GROUP_SIZE - 1 ) / RAYCAST_BATCH_GROUP_SIZE;
+	int numWorkerThreads = g_jobSystem != nullptr ? g_jobSystem->GetNumWorkerThreads() : 0;
+	if ( numGroups <= 1
+		 || numWorkerThreads == 0 )
+	{
+		for ( int firstQueryIdx = 0; firstQueryIdx < numQueries; firstQueryIdx += RAYCAST_BATCH_GROUP_SIZE )
+		{
+			RaycastBatchGroup( queries + firstQueryIdx, out_results + firstQueryIdx, Min( RAYCAST_BATCH_GROUP_SIZE, numQueries - firstQueryIdx ) );
+		}
+
+		return;
+	}
+
+	// This thread and the workers take groups until none are left, jobs picked up after that find nothing to do
+	std::shared_ptr<RaycastBatchState> batchState = std::make_shared<RaycastBatchState>( *this, queries, out_results, numQueries );
+
+	int numJobs = Min( numWorkerThreads, numGroups - 1 );
+	for ( int jobNum = 0; jobNum < numJobs; ++jobNum )
+	{
+		g_jobSystem->QueueJob( new RaycastBatchJob( batchState ) );
+	}
+
+	while ( batchState->RaycastNextGroup() )
+	{
+	}
+
+	// Results aren't ready until workers finish the groups they're in the middle of
+	while ( !batchState->AreAllGroupsComplete() )
+	{
+		std::this_thread::yield();
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void TileMap::RaycastBatchGroup( const RayQuery* queries, RaycastResult* out_results, int numQueries ) const
+{
+	ASSERT_OR_DIE( numQueries <= RAYCAST_BATCH_GROUP_SIZE, "Raycast batch group was given more than RAYCAST_BATCH_GROUP_SIZE queries" );
+
+	float startZs[RAYCAST_BATCH_GROUP_SIZE];
+	float endZs[RAYCAST_BATCH_GROUP_SIZE];
+	float castDists[RAYCAST_BATCH_GROUP_SIZE];
+	float zPlaneImpactDists[RAYCAST_BATCH_GROUP_SIZE];
+	float zPlaneImpactFractions[RAYCAST_BATCH_GROUP_SIZE];
+	float zPlaneImpactHeights[RAYCAST_BATCH_GROUP_SIZE];
+	bool didImpactZPlanes[RAYCAST_BATCH_GROUP_SIZE];
+
+	for ( int queryIdx = 0; queryIdx < numQueries; ++queryIdx )
+	{
+		const RayQuery& query = queries[queryIdx];
+		Vec3 endPos = query.startPos + ( query.maxDist * query.forwardNormal );
+
+		startZs[queryIdx] = query.startPos.z;
+		endZs[queryIdx] = endPos.z;
+		castDists[queryIdx] = ( endPos - query.startPos ).GetLength();
+		zPlaneImpactDists[queryIdx] = query.maxDist;
+		zPlaneImpactFractions[queryIdx] = 0.f;
+		zPlaneImpactHeights[queryIdx] = 0.f;
+		didImpactZPlanes[queryIdx] = false;
+	}
+
+	// Floor then ceiling for every ray, the ceiling has to be strictly closer to win just like in Raycast
+	const float zPlaneHeights[2] = { 0.f, TILE_SIZE };
+	for ( int zPlaneIdx = 0; zPlaneIdx < 2; ++zPlaneIdx )
+	{
+		float height = zPlaneHeights[zPlaneIdx];
+		for ( int queryIdx = 0; queryIdx < numQueries; ++queryIdx )
+		{
+			float impactFraction = ( height - startZs[queryIdx] ) / ( endZs[queryIdx] - startZs[queryIdx] );
+			float impactDist = castDists[queryIdx] * impactFraction;
+			bool isCloser = impactFraction > 0.f
+							&& impactFraction <= 1.f
+							&& impactDist < zPlaneImpactDists[queryIdx];
+
+			zPlaneImpactDists[queryIdx] = isCloser ? impactDist : zPlaneImpactDists[queryIdx];
+			zPlaneImpactFractions[queryIdx] = isCloser ? impactFraction : zPlaneImpactFractions[queryIdx];
+			zPlaneImpactHeights[queryIdx] = isCloser ? height : zPlaneImpactHeights[queryIdx];
+			didImpactZPlanes[queryIdx] = didImpactZPlanes[queryIdx] || isCloser;
+		}
+	}
+
+	// Then walls and entities, each ray's grid walk stops at its floor or ceiling impact
+	for ( int queryIdx = 0; queryIdx < numQueries; ++queryIdx )
+	{
+		const RayQuery& query = queries[queryIdx];
+
+		RaycastResult closestImpact;
+		closestImpact.impactDist = query.maxDist;
+		if ( didImpactZPlanes[queryIdx] )
+		{
+			// Same result RaycastAgainstZPlane gives, built from what the pass above already worked out
+			closestImpact.startPos = query.startPos;
+			closestImpact.forwardNormal = query.forwardNormal;
+			closestImpact.maxDist = query.maxDist;
+			closestImpact.didImpact = true;
+			closestImpact.impactFraction = zPlaneImpactFractions[queryIdx];
+			closestImpact.impactDist = zPlaneImpactDists[queryIdx];
+			closestImpact.impactPos = query.startPos + query.forwardNormal * closestImpact.impactDist;
+			closestImpact.impactSurfaceNormal = query.startPos.z > zPlaneImpactHeights[queryIdx] ? Vec3( 0.f, 0.f, 1.f ) : Vec3( 0.f, 0.f, -1.f );
+		}
+
+		RaycastResult wallsResult;
+		RaycastResult entitiesResult;
+		RaycastAgainstWallsAndEntities( query.startPos, query.forwardNormal, query.maxDist, zPlaneImpactDists[queryIdx], wallsResult, &entitiesResult );
+		if ( wallsResult.didImpact
+			 && wallsResult.impactDist < closestImpact.impactDist )
+		{
+			closestImpact = wallsResult;
+		}
+
+		if ( entitiesResult.didImpact
+			 && entitiesResult.impactDist < closestImpact.impactDist )
+		{
+			closestImpact = entitiesResult;
+		}
+
+		out_results[queryIdx] = closestImpact;
+	}
+}
+
+
 //-----------------------------------------------------------------------------------------------
 RaycastResult TileMap::RaycastAgainstZPlane( const Vec3& startPos, const Vec3& forwardNormal, float maxDist, float height ) const
 {	
@@ -286,100 +419,7 @@ RaycastResult TileMap::RaycastAgainstZPlane( const Vec3& startPos, const Vec3& f
 RaycastResult TileMap::RaycastAgainstWalls( const Vec3& startPos, const Vec3& forwardNormal, float maxDist ) const
 {
 	RaycastResult result;
-	result.startPos = startPos;
-	result.forwardNormal = forwardNormal;
-	result.maxDist = maxDist;
-
-	// Check if starting tile is solid
-	const Tile* startTile = GetTileFromWorldCoords( startPos.XY() );
-	if ( startTile == nullptr 
-		 || startTile->IsSolid() )
-	{
-		result.didImpact = true;
-		result.impactFraction = 0.f;
-		result.impactDist = 0.f;
-		result.impactPos = startPos;
-		result.impactSurfaceNormal = -forwardNormal;
-
-		return result;
-	}
-
-	// Calculate set up values to be used in each step of the raycast
-	Vec2 rayDisp = forwardNormal.XY() * maxDist;
-
-	// How far along the ray do you have to go to move 1 unit in the x direction of the grid
-	// if ray doesn't have any x movement this value is essentially infinity
-	float xDeltaDistAlongRay = 99999999.f;
-	if ( !IsNearlyEqual( rayDisp.x, 0.f, .000001f ) )
-	{
-		xDeltaDistAlongRay = maxDist / fabs( rayDisp.x );
-	}
-	// +1 or -1 to indicate which direction the steps will take
-	int tileStepDirX = (int)SignFloat( rayDisp.x );
-	// Instead of starting ray in the middle of a tile, adjust the start position
-	// to one of the edges of the starting tile depending on which way the ray faces
-	int offsetInTileCoordsToLeadingEdgeX = ( tileStepDirX + 1 ) / 2;
-	float firstVerticalIntersectionX = (float)( startTile->m_tileCoords.x + offsetInTileCoordsToLeadingEdgeX );
-
-	float dOfNextXCrossing = fabs( firstVerticalIntersectionX - startPos.x ) * xDeltaDistAlongRay;
-
-	// Repeat everything above but for y
-	float yDeltaDistAlongRay = 99999999.f;
-	if ( !IsNearlyEqual( rayDisp.y, 0.f, .000001f ) )
-	{
-		yDeltaDistAlongRay = maxDist / fabs( rayDisp.y );
-	}
-	int tileStepDirY = (int)SignFloat( rayDisp.y );
-
-	int offsetInTileCoordsToLeadingEdgeY = ( tileStepDirY + 1 ) / 2;
-	float firstHorizontalIntersectionY = (float)( startTile->m_tileCoords.y + offsetInTileCoordsToLeadingEdgeY );
-
-	float dOfNextYCrossing = fabs( firstHorizontalIntersectionY - startPos.y ) * yDeltaDistAlongRay;
-
-	int tileCoordX = startTile->m_tileCoords.x;
-	int tileCoordY = startTile->m_tileCoords.y;
-
-	// Perform raycast
-	while ( dOfNextXCrossing <= maxDist
-			|| dOfNextYCrossing <= maxDist )
-	{
-		// We'll cross X line next
-		if ( dOfNextXCrossing < dOfNextYCrossing )
-		{
-			tileCoordX += tileStepDirX;
-			// Hit a solid tile
-			if ( IsTileSolid( tileCoordX, tileCoordY ) )
-			{
-				result.didImpact = true;
-				result.impactFraction = dOfNextXCrossing / maxDist;
-				Vec3 startToImpact( forwardNormal * dOfNextXCrossing );
-				result.impactPos = startPos + startToImpact;
-				result.impactDist = dOfNextXCrossing;
-				result.impactSurfaceNormal = Vec3( (float)-tileStepDirX, 0.f, 0.f );
-				break;
-			}
-
-			dOfNextXCrossing += xDeltaDistAlongRay;
-		}
-		// We'll cross Y line next
-		else
-		{
-			tileCoordY += tileStepDirY;
-			// Hit a solid tile
-			if ( IsTileSolid( tileCoordX, tileCoordY ) )
-			{
-				result.didImpact = true;
-				result.impactFraction = dOfNextYCrossing/ maxDist;
-				Vec3 startToImpact( forwardNormal * dOfNextYCrossing );
-				result.impactPos = startPos + startToImpact;
-				result.impactDist = dOfNextYCrossing;
-				result.impactSurfaceNormal = Vec3( 0.f, (float)-tileStepDirY, 0.f );
-				break;
-			}
-
-			dOfNextYCrossing += yDeltaDistAlongRay;
-		}
-	}
+	RaycastAgainstWallsAndEntities( startPos, forwardNormal, maxDist, maxDist, result, nullptr );
 
 	return result;
 }
@@ -473,72 +513,7 @@ RaycastResult TileMap::RaycastAgainstEntitiesFast( const Vec3& startPos, const V
 			continue;
 		}
 
-		// i and j in terms of the forward vector's space
-		Vec2 iBasis = forwardNormal.XY().GetNormalized();
-		Vec2 jBasis = iBasis.GetRotated90Degrees();
-
-		// Project disc into forward vector's space
-		Vec2 displacementFromStartToCenterOfDisc = entity->m_position - startPos.XY();
-		Vec2 posOfCircleCenterAlongRay( DotProduct2D( iBasis, displacementFromStartToCenterOfDisc ), DotProduct2D( jBasis, displacementFromStartToCenterOfDisc ) );
-
-		// TODO: Account for y out of reasonable area also
-		if ( maxDist < posOfCircleCenterAlongRay.x - entity->GetPhysicsRadius()
-			 || posOfCircleCenterAlongRay.x + entity->GetPhysicsRadius() < 0.f )
-		{
-			continue;
-		}
-
-		// Use pythagorean theorum where 
-		// b = side of triangle made by disc center to closest point on line
-		// c = hypoteneuse of triangle made by disc radius
-		// a = side from nearest point on line to disc center to intersection point
-		float bSquared = posOfCircleCenterAlongRay.y * posOfCircleCenterAlongRay.y;
-		float cSquared = entity->GetPhysicsRadius() * entity->GetPhysicsRadius();
-		float aSquared = cSquared - bSquared;
-
-		FloatRange dOverlap;
-		// Did not overlap
-		if ( aSquared < 0.f )
-		{
-			continue;
-		}
-		// Touching the edge, only 1 intersection point
-		else if ( IsNearlyEqual( aSquared, 0.f ) )
-		{
-			dOverlap.min = posOfCircleCenterAlongRay.x;
-			dOverlap.max = posOfCircleCenterAlongRay.x;
-		}
-		// Forard vector has 2 intersection points with disc
-		else
-		{
-			float a = sqrtf( aSquared );
-			dOverlap.min = posOfCircleCenterAlongRay.x - a;
-			dOverlap.max = posOfCircleCenterAlongRay.x + a;
-		}
-		
-		// If the min intersection point is behind the start of the forward vector, clamp it to vector start
-		dOverlap.min = ClampMin( dOverlap.min, 0.f );
-
-		// Project XY along the XYZ forward to see how far along it went
-		float maxDistXY = DotProduct3D( Vec3( forwardNormal.XY(), 0.f ).GetNormalized(), forwardNormal ) * maxDist;
-		float tOverlapMin = dOverlap.min / maxDistXY;
-				
-		float impactDist = tOverlapMin * maxDist;
-		Vec3 impactDisp = forwardNormal * impactDist;
-		Vec3 impactPos = startPos + impactDisp;
-
-		if ( impactDist < result.impactDist )
-		{
-			if ( !DoesRayHitEntityAlongZ( result, impactPos, *entity ) )
-			{
-				continue;
-			}
-
-			result.didImpact = true;
-			result.impactFraction = dOverlap.min / maxDist;
-			result.impactDist = impactDist;
-			result.impactEntity = entity;
-		}
+		UpdateClosestEntityImpact( result, *entity, false );
 	}
 
 	return result;
@@ -597,6 +572,272 @@ bool TileMap::DoesRayHitEntityAlongZ( RaycastResult& raycastResult, const Vec3&
 }
 
 
+//-----------------------------------------------------------------------------------------------
+bool TileMap::UpdateClosestEntityImpact( RaycastResult& raycastResult, Entity& entity, bool winsTies ) const
+{
+	const Vec3& startPos = raycastResult.startPos;
+	const Vec3& forwardNormal = raycastResult.forwardNormal;
+	float maxDist = raycastResult.maxDist;
+
+	// i and j in terms of the forward vector's space
+	Vec2 iBasis = forwardNormal.XY().GetNormalized();
+	Vec2 jBasis = iBasis.GetRotated90Degrees();
+
+	// Project disc into forward vector's space
+	Vec2 displacementFromStartToCenterOfDisc = entity.m_position - startPos.XY();
+	Vec2 posOfCircleCenterAlongRay( DotProduct2D( iBasis, displacementFromStartToCenterOfDisc ), DotProduct2D( jBasis, displacementFromStartToCenterOfDisc ) );
+
+	// TODO: Account for y out of reasonable area also
+	if ( maxDist < posOfCircleCenterAlongRay.x - entity.GetPhysicsRadius()
+		 || posOfCircleCenterAlongRay.x + entity.GetPhysicsRadius() < 0.f )
+	{
+		return false;
+	}
+
+	// Use pythagorean theorum where 
+	// b = side of triangle made by disc center to closest point on line
+	// c = hypoteneuse of triangle made by disc radius
+	// a = side from nearest point on line to disc center to intersection point
+	float bSquared = posOfCircleCenterAlongRay.y * posOfCircleCenterAlongRay.y;
+	float cSquared = entity.GetPhysicsRadius() * entity.GetPhysicsRadius();
+	float aSquared = cSquared - bSquared;
+
+	FloatRange dOverlap;
+	// Did not overlap
+	if ( aSquared < 0.f )
+	{
+		return false;
+	}
+	// Touching the edge, only 1 intersection point
+	else if ( IsNearlyEqual( aSquared, 0.f ) )
+	{
+		dOverlap.min = posOfCircleCenterAlongRay.x;
+		dOverlap.max = posOfCircleCenterAlongRay.x;
+	}
+	// Forard vector has 2 intersection points with disc
+	else
+	{
+		float a = sqrtf( aSquared );
+		dOverlap.min = posOfCircleCenterAlongRay.x - a;
+		dOverlap.max = posOfCircleCenterAlongRay.x + a;
+	}
+	
+	// If the min intersection point is behind the start of the forward vector, clamp it to vector start
+	dOverlap.min = ClampMin( dOverlap.min, 0.f );
+
+	// Project XY along the XYZ forward to see how far along it went
+	float maxDistXY = DotProduct3D( Vec3( forwardNormal.XY(), 0.f ).GetNormalized(), forwardNormal ) * maxDist;
+	float tOverlapMin = dOverlap.min / maxDistXY;
+			
+	float impactDist = tOverlapMin * maxDist;
+	Vec3 impactDisp = forwardNormal * impactDist;
+	Vec3 impactPos = startPos + impactDisp;
+
+	if ( impactDist < raycastResult.impactDist
+		 || ( winsTies && impactDist == raycastResult.impactDist ) )
+	{
+		if ( !DoesRayHitEntityAlongZ( raycastResult, impactPos, entity ) )
+		{
+			return false;
+		}
+
+		raycastResult.didImpact = true;
+		raycastResult.impactFraction = dOverlap.min / maxDist;
+		raycastResult.impactDist = impactDist;
+		raycastResult.impactEntity = &entity;
+
+		return true;
+	}
+
+	return false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void TileMap::RaycastAgainstEntitiesInCells( RaycastResult& raycastResult, int& closestEntityIdx, const IntVec2& minCell, const IntVec2& maxCell ) const
+{
+	for ( int cellY = minCell.y; cellY <= maxCell.y; ++cellY )
+	{
+		for ( int cellX = minCell.x; cellX <= maxCell.x; ++cellX )
+		{
+			IntVec2 cell( cellX, cellY );
+			const std::vector<int>& bucket = m_entitySpatialHash.GetBucketForCell( cell );
+			for ( int bucketEntityIdx = 0; bucketEntityIdx < (int)bucket.size(); ++bucketEntityIdx )
+			{
+				int entityIdx = bucket[bucketEntityIdx];
+				if ( m_entitySpatialHash.GetEntityCell( entityIdx ) != cell )
+				{
+					continue;
+				}
+
+				Entity* const& entity = m_entities[entityIdx];
+				if ( entity == nullptr
+					 || entity->IsPossessed() )
+				{
+					continue;
+				}
+
+				// Of two equally close entities the earlier one wins, same as checking every entity in order
+				bool winsTies = closestEntityIdx >= 0 && entityIdx < closestEntityIdx;
+				if ( UpdateClosestEntityImpact( raycastResult, *entity, winsTies ) )
+				{
+					closestEntityIdx = entityIdx;
+				}
+			}
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void TileMap::RaycastAgainstWallsAndEntities( const Vec3& startPos, const Vec3& forwardNormal, float maxDist, float maxUsefulDist,
+											  RaycastResult& out_wallsResult, RaycastResult* out_entitiesResult ) const
+{
+	RaycastResult& result = out_wallsResult;
+	result.startPos = startPos;
+	result.forwardNormal = forwardNormal;
+	result.maxDist = maxDist;
+
+	if ( out_entitiesResult != nullptr )
+	{
+		out_entitiesResult->startPos = startPos;
+		out_entitiesResult->forwardNormal = forwardNormal;
+		out_entitiesResult->maxDist = maxDist;
+		out_entitiesResult->impactDist = maxDist;
+	}
+
+	// Check if starting tile is solid
+	const Tile* startTile = GetTileFromWorldCoords( startPos.XY() );
+	if ( startTile == nullptr 
+		 || startTile->IsSolid() )
+	{
+		result.didImpact = true;
+		result.impactFraction = 0.f;
+		result.impactDist = 0.f;
+		result.impactPos = startPos;
+		result.impactSurfaceNormal = -forwardNormal;
+
+		return;
+	}
+
+	// Calculate set up values to be used in each step of the raycast
+	Vec2 rayDisp = forwardNormal.XY() * maxDist;
+
+	// How far along the ray do you have to go to move 1 unit in the x direction of the grid
+	// if ray doesn't have any x movement this value is essentially infinity
+	float xDeltaDistAlongRay = 99999999.f;
+	if ( !IsNearlyEqual( rayDisp.x, 0.f, .000001f ) )
+	{
+		xDeltaDistAlongRay = maxDist / fabs( rayDisp.x );
+	}
+	// +1 or -1 to indicate which direction the steps will take
+	int tileStepDirX = (int)SignFloat( rayDisp.x );
+	// Instead of starting ray in the middle of a tile, adjust the start position
+	// to one of the edges of the starting tile depending on which way the ray faces
+	int offsetInTileCoordsToLeadingEdgeX = ( tileStepDirX + 1 ) / 2;
+	float firstVerticalIntersectionX = (float)( startTile->m_tileCoords.x + offsetInTileCoordsToLeadingEdgeX );
+
+	float dOfNextXCrossing = fabs( firstVerticalIntersectionX - startPos.x ) * xDeltaDistAlongRay;
+
+	// Repeat everything above but for y
+	float yDeltaDistAlongRay = 99999999.f;
+	if ( !IsNearlyEqual( rayDisp.y, 0.f, .000001f ) )
+	{
+		yDeltaDistAlongRay = maxDist / fabs( rayDisp.y );
+	}
+	int tileStepDirY = (int)SignFloat( rayDisp.y );
+
+	int offsetInTileCoordsToLeadingEdgeY = ( tileStepDirY + 1 ) / 2;
+	float firstHorizontalIntersectionY = (float)( startTile->m_tileCoords.y + offsetInTileCoordsToLeadingEdgeY );
+
+	float dOfNextYCrossing = fabs( firstHorizontalIntersectionY - startPos.y ) * yDeltaDistAlongRay;
+
+	int tileCoordX = startTile->m_tileCoords.x;
+	int tileCoordY = startTile->m_tileCoords.y;
+
+	// Entities can reach out of their cell by their physics radius, so every tile the ray passes through checks the cells around it too
+	int cellSearchRadius = 0;
+	int closestEntityIdx = -1;
+	if ( out_entitiesResult != nullptr )
+	{
+		cellSearchRadius = (int)( m_entitySpatialHash.GetMaxPhysicsRadius() / TILE_SIZE ) + 1;
+		RaycastAgainstEntitiesInCells( *out_entitiesResult, closestEntityIdx,
+									   IntVec2( tileCoordX - cellSearchRadius, tileCoordY - cellSearchRadius ),
+									   IntVec2( tileCoordX + cellSearchRadius, tileCoordY + cellSearchRadius ) );
+	}
+
+	// Perform raycast
+	while ( dOfNextXCrossing <= maxDist
+			|| dOfNextYCrossing <= maxDist )
+	{
+		// The caller already has something closer than anything past here
+		if ( Min( dOfNextXCrossing, dOfNextYCrossing ) > maxUsefulDist )
+		{
+			break;
+		}
+
+		// Entities can't be hit any closer than where the ray enters the tiles they're near
+		if ( closestEntityIdx >= 0
+			 && Min( dOfNextXCrossing, dOfNextYCrossing ) > out_entitiesResult->impactDist )
+		{
+			break;
+		}
+
+		// We'll cross X line next
+		if ( dOfNextXCrossing < dOfNextYCrossing )
+		{
+			tileCoordX += tileStepDirX;
+			// Hit a solid tile
+			if ( IsTileSolid( tileCoordX, tileCoordY ) )
+			{
+				result.didImpact = true;
+				result.impactFraction = dOfNextXCrossing / maxDist;
+				Vec3 startToImpact( forwardNormal * dOfNextXCrossing );
+				result.impactPos = startPos + startToImpact;
+				result.impactDist = dOfNextXCrossing;
+				result.impactSurfaceNormal = Vec3( (float)-tileStepDirX, 0.f, 0.f );
+				break;
+			}
+
+			// The ray only moves one way, so only the column of cells that just came in reach is new
+			if ( out_entitiesResult != nullptr )
+			{
+				int cellX = tileCoordX + ( tileStepDirX * cellSearchRadius );
+				RaycastAgainstEntitiesInCells( *out_entitiesResult, closestEntityIdx,
+											   IntVec2( cellX, tileCoordY - cellSearchRadius ), IntVec2( cellX, tileCoordY + cellSearchRadius ) );
+			}
+
+			dOfNextXCrossing += xDeltaDistAlongRay;
+		}
+		// We'll cross Y line next
+		else
+		{
+			tileCoordY += tileStepDirY;
+			// Hit a solid tile
+			if ( IsTileSolid( tileCoordX, tileCoordY ) )
+			{
+				result.didImpact = true;
+				result.impactFraction = dOfNextYCrossing/ maxDist;
+				Vec3 startToImpact( forwardNormal * dOfNextYCrossing );
+				result.impactPos = startPos + startToImpact;
+				result.impactDist = dOfNextYCrossing;
+				result.impactSurfaceNormal = Vec3( 0.f, (float)-tileStepDirY, 0.f );
+				break;
+			}
+
+			if ( out_entitiesResult != nullptr )
+			{
+				int cellY = tileCoordY + ( tileStepDirY * cellSearchRadius );
+				RaycastAgainstEntitiesInCells( *out_entitiesResult, closestEntityIdx,
+											   IntVec2( tileCoordX - cellSearchRadius, cellY ), IntVec2( tileCoordX + cellSearchRadius, cellY ) );
+			}
+
+			dOfNextYCrossing += yDeltaDistAlongRay;
+		}
+	}
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void TileMap::PopulateTiles( const std::vector<MapRegionTypeDefinition*>& regionTypeDefs )
 {
@@ -647,6 +888,7 @@ void TileMap::ResolveEntityVsWallCollisions()
 		}
 
 		ResolveEntityVsWallCollision( *entity );
+		UpdateEntityInSpatialHash( entityIdx );
 	}
 }
 
@@ -9,6 +9,11 @@ struct MapData;
 class GPUMesh;
 class Material;
 
+
+//-----------------------------------------------------------------------------------------------
+constexpr int RAYCAST_BATCH_GROUP_SIZE = 64;
+
+
 //-----------------------------------------------------------------------------------------------
 enum class eCardinalDirection
 {
@@ -40,13 +45,27 @@ public:
 	virtual void DebugRender() const override;
 
 	virtual RaycastResult Raycast( const Vec3& startPos, const Vec3& forwardNormal, float maxDist ) const override;
+	// Gives the same results as calling Raycast for each query. Batches of more than one group are shared with the job system's workers,
+	// so the map and its entities must not change until this returns.
+	void RaycastBatch( const RayQuery* queries, RaycastResult* out_results, int numQueries ) const;
+	// Raycasts up to RAYCAST_BATCH_GROUP_SIZE queries a step at a time, floor and ceiling for every ray, then walls and entities.
+	// Only reads the map, so any number of threads can run groups at once.
+	void RaycastBatchGroup( const RayQuery* queries, RaycastResult* out_results, int numQueries ) const;
 	RaycastResult RaycastAgainstZPlane( const Vec3& startPos, const Vec3& forwardNormal, float maxDist, float height ) const;
 	RaycastResult RaycastAgainstWalls( const Vec3& startPos, const Vec3& forwardNormal, float maxDist ) const;
 	RaycastResult RaycastAgainstEntities( const Vec3& startPos, const Vec3& forwardNormal, float maxDist ) const;
 	RaycastResult RaycastAgainstEntitiesFast( const Vec3& startPos, const Vec3& forwardNormal, float maxDist ) const;
 	bool DoesRayHitEntityAlongZ( RaycastResult& raycastResult, const Vec3& potentialImpactPos, const Entity& entity ) const;
+	// Moves the impact to the entity if the ray hits it closer than raycastResult.impactDist, or just as close when winsTies is set
+	bool UpdateClosestEntityImpact( RaycastResult& raycastResult, Entity& entity, bool winsTies ) const;
 
 private:
+	// Grid DDA shared by walls and entities, entities are only tested in the spatial hash cells near the tiles the ray passes through.
+	// Stops early once no later tile can hold a closer entity or anything closer than maxUsefulDist, in that case the wall result is left without an impact.
+	void				RaycastAgainstWallsAndEntities( const Vec3& startPos, const Vec3& forwardNormal, float maxDist, float maxUsefulDist,
+														RaycastResult& out_wallsResult, RaycastResult* out_entitiesResult ) const;
+	void				RaycastAgainstEntitiesInCells( RaycastResult& raycastResult, int& closestEntityIdx, const IntVec2& minCell, const IntVec2& maxCell ) const;
+
 	void				PopulateTiles( const std::vector<MapRegionTypeDefinition*>& regionTypeDefs );
 	void				CreateInitialTiles( const std::vector<MapRegionTypeDefinition*>& regionTypeDefs );
 
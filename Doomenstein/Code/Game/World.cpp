@@ -154,6 +154,10 @@ void World::WarpEntityToMap( Entity* entityToWarp, const std::string& destMapNam
 
 	entityToWarp->SetPosition( newPos );
 	entityToWarp->SetOrientationDegrees( newYawDegrees );
+	if ( m_curMap != nullptr )
+	{
+		m_curMap->UpdateEntityInSpatialHash( entityToWarp );
+	}
 }
 
 
@@ -20,6 +20,7 @@
 #include "Engine/Time/Time.hpp"
 #include "Engine/Time/Clock.hpp"
 #include "Game/Game.hpp"
+#include "Game/HeadlessServerStats.hpp"
 #include "Game/AuthoritativeServer.hpp"
 #include "Game/RemoteServer.hpp"
 #include "Game/PlayerClient.hpp"
@@ -38,7 +39,7 @@ App::~App()
 
 
 //-----------------------------------------------------------------------------------------------
-void App::Startup( eAppMode appMode )
+void App::Startup( eAppMode appMode, EventArgs* args )
 {
 	m_appMode = appMode;
 
@@ -84,8 +85,12 @@ void App::Startup( eAppMode appMode )
 		g_devConsole->SetRenderer( g_renderer );
 		g_devConsole->SetBitmapFont( g_renderer->GetSystemFont() );
 	}
+	else
+	{
+		StartupHeadlessServer( args );
+	}
 
-	InitializeServerAndClient( appMode );
+	InitializeServerAndClient( appMode, args );
 
 	g_eventSystem->RegisterEvent( "quit", "Quit the game.", eUsageLocation::EVERYWHERE, QuitGame );
 	g_eventSystem->RegisterEvent( "start_multiplayer_server", "Usage: start_multiplayer_server port=<port number>. Start a multiplayer server communicating on given port.", eUsageLocation::DEV_CONSOLE, StartMultiplayerServerCommand );
@@ -107,6 +112,13 @@ void App::Shutdown()
 		g_inputSystem->Shutdown();
 		g_window->Close();
 	}
+	else
+	{
+		g_devConsole->Shutdown();
+		EndHighResolutionSleep();
+
+		PTR_SAFE_DELETE( m_headlessServerStats );
+	}
 
 	g_networkingSystem->Shutdown();
 	g_jobSystem->Shutdown();
@@ -126,6 +138,12 @@ void App::Shutdown()
 //-----------------------------------------------------------------------------------------------
 void App::RunFrame()
 {
+	if ( m_appMode == eAppMode::HEADLESS_SERVER )
+	{
+		RunServerTick();
+		return;
+	}
+
 	BeginFrame();											// for all engine systems (NOT the game)
 	Update();												// for the game only
 	Render();												// for the game only
@@ -133,6 +151,69 @@ void App::RunFrame()
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void App::StartupHeadlessServer( EventArgs* args )
+{
+	// No window to draw it in, the console only collects messages and mirrors them to the log
+	g_devConsole = new DevConsole();
+	g_devConsole->Startup();
+
+	int port = 48000;
+	float tickRate = g_gameConfigBlackboard.GetValue( "serverTickRate", 60.f );
+	double statsIntervalSeconds = 5.0;
+	if ( args != nullptr )
+	{
+		port = args->GetValue( "port", port );
+		tickRate = args->GetValue( "tickRate", tickRate );
+		statsIntervalSeconds = (double)args->GetValue( "statsInterval", (float)statsIntervalSeconds );
+	}
+
+	std::string logFilePath = Stringf( "HeadlessServer_%i.log", port );
+	if ( !g_devConsole->OpenLogFile( logFilePath ) )
+	{
+		g_devConsole->PrintError( Stringf( "Headless server couldn't open log file '%s'", logFilePath.c_str() ) );
+	}
+
+	if ( tickRate <= 0.f )
+	{
+		g_devConsole->PrintError( Stringf( "Invalid server tick rate '%.2f', using 60", tickRate ) );
+		tickRate = 60.f;
+	}
+
+	m_serverTickSeconds = 1.0 / (double)tickRate;
+	m_headlessServerStats = new HeadlessServerStats( m_serverTickSeconds, statsIntervalSeconds );
+
+	BeginHighResolutionSleep();
+	m_nextServerTickTime = GetCurrentTimeSeconds();
+
+	g_devConsole->PrintString( Stringf( "Headless server starting on port %i at %.1f ticks per second", port, tickRate ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void App::RunServerTick()
+{
+	double tickStartTime = GetCurrentTimeSeconds();
+
+	BeginFrame();
+	Update();
+	EndFrame();
+
+	double tickEndTime = GetCurrentTimeSeconds();
+	m_headlessServerStats->RecordTick( tickEndTime - tickStartTime, tickEndTime );
+
+	// Ticks are scheduled on a fixed grid so sleep overshoot doesn't drift the rate, but a tick that ran
+	// long starts the grid over rather than being followed by a burst of catch up ticks
+	m_nextServerTickTime += m_serverTickSeconds;
+	if ( m_nextServerTickTime < tickEndTime )
+	{
+		m_nextServerTickTime = tickEndTime;
+	}
+
+	SleepUntilTimeSeconds( m_nextServerTickTime );
+}
+
+
 //-----------------------------------------------------------------------------------------------
 bool App::HandleQuitRequested()
 {
@@ -8,6 +8,7 @@
 class Camera;
 class RenderContext;
 class Game;
+class HeadlessServerStats;
 enum class eWindowMode;
 
 
@@ -17,7 +18,7 @@ class App
 public:
 	App();
 	~App();
-	void Startup( eAppMode appMode = eAppMode::SINGLE_PLAYER );
+	void Startup( eAppMode appMode = eAppMode::SINGLE_PLAYER, EventArgs* args = nullptr );
 	void Shutdown();
 	void RunFrame();
 
@@ -34,6 +35,9 @@ private:
 	void Render() const;
 	void EndFrame();
 
+	void StartupHeadlessServer( EventArgs* args );
+	void RunServerTick();
+
 	void RestartApp( eAppMode appMode = eAppMode::SINGLE_PLAYER, EventArgs* args = nullptr );
 	void InitializeServerAndClient( eAppMode appMode = eAppMode::SINGLE_PLAYER, EventArgs* args = nullptr );
 	void DeallocateServerAndClient( eAppMode appMode = eAppMode::SINGLE_PLAYER );
@@ -46,4 +50,9 @@ private:
 private:
 	bool m_isQuitting = false;
 	eAppMode m_appMode = eAppMode::SINGLE_PLAYER;
+
+	// Headless server
+	double m_serverTickSeconds = 1.0 / 60.0;
+	double m_nextServerTickTime = 0.0;
+	HeadlessServerStats* m_headlessServerStats = nullptr;
 };
@@ -27,6 +27,10 @@ AuthoritativeServer::AuthoritativeServer( EventArgs* args )
 //-----------------------------------------------------------------------------------------------
 void AuthoritativeServer::Startup( eAppMode appMode )
 {
+	g_eventSystem->RegisterMethodEvent( "snapshot_quantization", "Usage: snapshot_quantization positionBits=<int> yawBits=<int> min=<float> max=<float>. Set the precision of replicated entity positions and orientations.", eUsageLocation::DEV_CONSOLE, this, &AuthoritativeServer::SetSnapshotQuantization );
+	g_eventSystem->RegisterMethodEvent( "snapshot_relevancy", "Usage: snapshot_relevancy enabled=<bool> radius=<float> fullRateRadius=<float> minRate=<float> hiddenScale=<float>. Set how often each remote client is sent entities by distance and line of sight.", eUsageLocation::DEV_CONSOLE, this, &AuthoritativeServer::SetSnapshotRelevancy );
+	g_eventSystem->RegisterMethodEvent( "snapshot_stats", "Print snapshot bandwidth for each remote client.", eUsageLocation::DEV_CONSOLE, this, &AuthoritativeServer::PrintSnapshotStats );
+
 	StartGame( appMode );
 }
 
@@ -34,6 +38,8 @@ void AuthoritativeServer::Startup( eAppMode appMode )
 //-----------------------------------------------------------------------------------------------
 void AuthoritativeServer::Shutdown()
 {
+	g_eventSystem->DeRegisterObject( this );
+
 	Server::Shutdown();
 }
 
@@ -131,7 +137,7 @@ void AuthoritativeServer::ProcessTCPMessages()
 //-----------------------------------------------------------------------------------------------
 void AuthoritativeServer::ProcessUDPMessages()
 {
-	std::vector<UDPData> newMessages = g_networkingSystem->ReceiveUDPMessages();
+	std::vector<UDPData>& newMessages = g_networkingSystem->ReceiveUDPMessages();
 
 	for ( UDPData& data : newMessages )
 	{
@@ -176,6 +182,68 @@ void AuthoritativeServer::ProcessUDPMessages()
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void AuthoritativeServer::SetSnapshotQuantization( EventArgs* args )
+{
+	SnapshotQuantization quantization = RemoteClient::GetSnapshotQuantization();
+	quantization.positionBits = args->GetValue( "positionBits", quantization.positionBits );
+	quantization.yawBits = args->GetValue( "yawBits", quantization.yawBits );
+	quantization.positionMin = args->GetValue( "min", quantization.positionMin );
+	quantization.positionMax = args->GetValue( "max", quantization.positionMax );
+
+	if ( !quantization.IsValid() )
+	{
+		g_devConsole->PrintError( Stringf( "Bits must be between %i and %i and max must be greater than min", MIN_SNAPSHOT_QUANTIZATION_BITS, MAX_SNAPSHOT_QUANTIZATION_BITS ) );
+		return;
+	}
+
+	// Remote clients notice the change and send full snapshots until the new precision has been acked
+	RemoteClient::SetSnapshotQuantization( quantization );
+
+	g_devConsole->PrintString( Stringf( "Snapshot quantization: %i position bits over [%.1f, %.1f], %i yaw bits", 
+										quantization.positionBits, quantization.positionMin, quantization.positionMax, quantization.yawBits ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void AuthoritativeServer::SetSnapshotRelevancy( EventArgs* args )
+{
+	EntityRelevancySettings settings = RemoteClient::GetRelevancySettings();
+	settings.isEnabled = args->GetValue( "enabled", settings.isEnabled );
+	settings.relevantRadius = args->GetValue( "radius", settings.relevantRadius );
+	settings.fullRateRadius = args->GetValue( "fullRateRadius", settings.fullRateRadius );
+	settings.minUpdateRate = args->GetValue( "minRate", settings.minUpdateRate );
+	settings.hiddenUpdateScale = args->GetValue( "hiddenScale", settings.hiddenUpdateScale );
+
+	if ( settings.fullRateRadius < 0.f
+		 || settings.relevantRadius < settings.fullRateRadius
+		 || settings.minUpdateRate <= 0.f || settings.minUpdateRate > 1.f
+		 || settings.hiddenUpdateScale <= 0.f || settings.hiddenUpdateScale > 1.f )
+	{
+		g_devConsole->PrintError( "Radius must be at least fullRateRadius and minRate and hiddenScale must be in (0, 1]" );
+		return;
+	}
+
+	RemoteClient::SetRelevancySettings( settings );
+
+	g_devConsole->PrintString( Stringf( "Snapshot relevancy %s: radius %.1f, full rate within %.1f, min rate %.2f, hidden scale %.2f",
+										settings.isEnabled ? "enabled" : "disabled", settings.relevantRadius, settings.fullRateRadius,
+										settings.minUpdateRate, settings.hiddenUpdateScale ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void AuthoritativeServer::PrintSnapshotStats( EventArgs* args )
+{
+	UNUSED( args );
+
+	for ( Client* client : m_clients )
+	{
+		client->PrintNetworkStats();
+	}
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void AuthoritativeServer::Update()
 {
@@ -287,11 +355,16 @@ void AuthoritativeServer::RegisterNewClient( Client* client )
 //-----------------------------------------------------------------------------------------------
 void AuthoritativeServer::SendMessageToAllDistantClients( ClientRequest* clientRequest )
 {
-	// Skip the first client since that will be the server's player client
-	for ( int clientIdx = 1; clientIdx < (int)m_clients.size(); ++clientIdx )
+	for ( int clientIdx = 0; clientIdx < (int)m_clients.size(); ++clientIdx )
 	{
 		Client*& client = m_clients[clientIdx];
 		
+		// The server's own player client is local, a headless server doesn't have one
+		if ( client == g_playerClient )
+		{
+			continue;
+		}
+
 		client->SendMessageToDistantClient( clientRequest );
 	}
 }
@@ -53,6 +53,10 @@ protected:
 	void ProcessUDPMessages();
 
 private:
+	// Console commands
+	void SetSnapshotQuantization( EventArgs* args );
+	void SetSnapshotRelevancy( EventArgs* args );
+	void PrintSnapshotStats( EventArgs* args );
 
 private:
 	int m_nextLocalBindPort = 48471;
@@ -29,6 +29,8 @@ public:
 
 	virtual void SendMessageToDistantClient( ClientRequest* message ) = 0;
 
+	virtual void PrintNetworkStats() const									{}
+
 protected:
 	int m_clientId = -1;
 };
@@ -180,7 +180,10 @@ void Entity::TakeDamage( int damage )
 		Die();
 	}
 	
-	g_playerClient->AddScreenShakeIntensity(.05f);
+	if ( g_playerClient != nullptr )
+	{
+		g_playerClient->AddScreenShakeIntensity(.05f);
+	}
 }
 
 
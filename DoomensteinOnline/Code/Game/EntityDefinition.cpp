@@ -106,6 +106,13 @@ EntityDefinition::EntityDefinition( const XmlElement& entityDefElem )
 		}
 		m_billboardStyle = GetBillboardStyleFromString( billboardStyleStr );
 
+		// A headless server never draws entities so there are no textures to build sprite animations from
+		if ( g_renderer == nullptr )
+		{
+			m_isValid = true;
+			return;
+		}
+
 		SpriteSheet* spriteSheet = SpriteSheet::GetSpriteSheetByPath( spriteSheetPath );
 		if ( spriteSheet == nullptr )
 		{
@@ -0,0 +1,63 @@
+#include "Game/EntityRelevancy.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Game/Entity.hpp"
+#include "Game/Map.hpp"
+
+#include <algorithm>
+
+
+//-----------------------------------------------------------------------------------------------
+void EntityRelevancyFilter::SelectEntitiesToUpdate( const Entity& viewer, const EntityRelevancySettings& settings, std::vector<EntityId>& out_entityIds )
+{
+	out_entityIds.clear();
+	m_nearbyEntities.clear();
+
+	Map* map = viewer.GetMap();
+	if ( map == nullptr )
+	{
+		return;
+	}
+
+	map->GetLivingEntitiesInRadius( viewer.GetPosition(), settings.relevantRadius, m_nearbyEntities );
+
+	for ( Entity* entity : m_nearbyEntities )
+	{
+		float& priority = m_entityPriorities[entity->GetId()];
+		priority += GetUpdateRate( viewer, *entity, settings );
+		if ( priority >= 1.f )
+		{
+			// Keep the remainder so rates that don't divide 1 evenly still average out
+			priority = ClampMinMax( priority - 1.f, 0.f, 1.f );
+			out_entityIds.push_back( entity->GetId() );
+		}
+	}
+
+	std::sort( out_entityIds.begin(), out_entityIds.end() );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+float EntityRelevancyFilter::GetUpdateRate( const Entity& viewer, const Entity& entity, const EntityRelevancySettings& settings ) const
+{
+	if ( &entity == &viewer )
+	{
+		return 1.f;
+	}
+
+	float distance = GetDistance2D( viewer.GetPosition(), entity.GetPosition() );
+	if ( distance <= settings.fullRateRadius )
+	{
+		return 1.f;
+	}
+
+	float updateRate = RangeMapFloat( settings.fullRateRadius, settings.relevantRadius, 1.f, settings.minUpdateRate, distance );
+	updateRate = ClampMinMax( updateRate, settings.minUpdateRate, 1.f );
+
+	// Only entities far enough to be throttled anyway are worth a raycast
+	if ( !viewer.GetMap()->HasLineOfSight( viewer.GetPosition(), entity.GetPosition() ) )
+	{
+		updateRate *= settings.hiddenUpdateScale;
+	}
+
+	return updateRate;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "Game/GameCommon.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------------------------
+class Entity;
+
+
+//-----------------------------------------------------------------------------------------------
+struct EntityRelevancySettings
+{
+public:
+	bool isEnabled = true;
+	float relevantRadius = 24.f;			// Entities further away than this aren't updated at all
+	float fullRateRadius = 6.f;				// Entities this close are updated in every snapshot
+	float minUpdateRate = .2f;				// Fraction of snapshots an entity at the edge of relevantRadius is updated in
+	float hiddenUpdateScale = .25f;			// Scales the rate of entities the viewer has no line of sight to
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Picks which entities one viewer gets fresh state for in each snapshot. Every snapshot the entities near the viewer
+// gain priority at a rate that falls off with distance and line of sight, and are updated once it reaches 1, so nearby
+// entities are updated every snapshot and distant or hidden ones every few.
+class EntityRelevancyFilter
+{
+public:
+	EntityRelevancyFilter() = default;
+	~EntityRelevancyFilter() = default;
+
+	// out_entityIds is cleared and filled sorted
+	void	SelectEntitiesToUpdate( const Entity& viewer, const EntityRelevancySettings& settings, std::vector<EntityId>& out_entityIds );
+	void	RemoveEntity( EntityId entityId )								{ m_entityPriorities.erase( entityId ); }
+
+	int		GetNumNearbyEntities() const									{ return (int)m_nearbyEntities.size(); }
+
+private:
+	float	GetUpdateRate( const Entity& viewer, const Entity& entity, const EntityRelevancySettings& settings ) const;
+
+private:
+	std::unordered_map<EntityId, float> m_entityPriorities;
+	std::vector<Entity*> m_nearbyEntities;
+};
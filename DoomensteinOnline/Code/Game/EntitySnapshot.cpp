@@ -0,0 +1,466 @@
+#include "Game/EntitySnapshot.hpp"
+#include "Engine/Core/BitBufferParser.hpp"
+#include "Engine/Core/BitBufferWriter.hpp"
+#include "Engine/Core/BufferUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <algorithm>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr int SNAPSHOT_COUNT_BITS = 16;
+constexpr int SMALL_ENTITY_ID_GAP_BITS = 4;
+constexpr int FULL_ENTITY_ID_BITS = 32;
+constexpr int SMALL_FIELD_DELTA_BITS = 8;
+
+enum eSnapshotFieldBit : uint32_t
+{
+	SNAPSHOT_FIELD_X	= BIT_FLAG( 0 ),
+	SNAPSHOT_FIELD_Y	= BIT_FLAG( 1 ),
+	SNAPSHOT_FIELD_YAW	= BIT_FLAG( 2 ),
+};
+constexpr int NUM_SNAPSHOT_FIELD_BITS = 3;
+
+
+//-----------------------------------------------------------------------------------------------
+// Entities to write into one part, ids in each list are ascending
+struct EntitySnapshotPart
+{
+public:
+	std::vector<EntityId> removedEntityIds;
+	std::vector<const EntitySnapshotState*> changedStates;
+	std::vector<const EntitySnapshotState*> baselineStates;		// nullptr when the entity is new
+};
+
+
+//-----------------------------------------------------------------------------------------------
+bool SnapshotQuantization::IsValid() const
+{
+	return positionBits >= MIN_SNAPSHOT_QUANTIZATION_BITS && positionBits <= MAX_SNAPSHOT_QUANTIZATION_BITS
+		&& yawBits >= MIN_SNAPSHOT_QUANTIZATION_BITS && yawBits <= MAX_SNAPSHOT_QUANTIZATION_BITS
+		&& positionMax > positionMin;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool SnapshotQuantization::operator==( const SnapshotQuantization& other ) const
+{
+	return positionMin == other.positionMin
+		&& positionMax == other.positionMax
+		&& positionBits == other.positionBits
+		&& yawBits == other.yawBits;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+EntitySnapshotState::EntitySnapshotState( EntityId entityId, const Vec2& position, float yawDegrees, const SnapshotQuantization& quantization )
+	: entityId( entityId )
+{
+	quantizedX = QuantizeFloat( position.x, quantization.positionMin, quantization.positionMax, quantization.positionBits );
+	quantizedY = QuantizeFloat( position.y, quantization.positionMin, quantization.positionMax, quantization.positionBits );
+
+	float wrappedYawDegrees = fmodf( yawDegrees, 360.f );
+	if ( wrappedYawDegrees < 0.f )
+	{
+		wrappedYawDegrees += 360.f;
+	}
+	quantizedYaw = QuantizeFloat( wrappedYawDegrees, 0.f, 360.f, quantization.yawBits );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+Vec2 EntitySnapshotState::GetPosition( const SnapshotQuantization& quantization ) const
+{
+	return Vec2( DequantizeFloat( quantizedX, quantization.positionMin, quantization.positionMax, quantization.positionBits ),
+				 DequantizeFloat( quantizedY, quantization.positionMin, quantization.positionMax, quantization.positionBits ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+float EntitySnapshotState::GetYawDegrees( const SnapshotQuantization& quantization ) const
+{
+	return DequantizeFloat( quantizedYaw, 0.f, 360.f, quantization.yawBits );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySnapshot::Clear()
+{
+	sequenceNum = 0;
+	entityStates.clear();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySnapshot::SortEntityStates()
+{
+	std::sort( entityStates.begin(), entityStates.end(), 
+			   []( const EntitySnapshotState& a, const EntitySnapshotState& b ) { return a.entityId < b.entityId; } );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static std::vector<EntitySnapshotState>::const_iterator FindEntityStateLowerBound( const std::vector<EntitySnapshotState>& entityStates, EntityId entityId )
+{
+	return std::lower_bound( entityStates.begin(), entityStates.end(), entityId,
+							 []( const EntitySnapshotState& state, EntityId id ) { return state.entityId < id; } );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+const EntitySnapshotState* EntitySnapshot::FindEntityState( EntityId entityId ) const
+{
+	auto iter = FindEntityStateLowerBound( entityStates, entityId );
+	if ( iter == entityStates.end()
+		 || iter->entityId != entityId )
+	{
+		return nullptr;
+	}
+
+	return &( *iter );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySnapshot::SetEntityState( const EntitySnapshotState& entityState )
+{
+	auto iter = FindEntityStateLowerBound( entityStates, entityState.entityId );
+	size_t stateIdx = iter - entityStates.begin();
+	if ( iter != entityStates.end()
+		 && iter->entityId == entityState.entityId )
+	{
+		entityStates[stateIdx] = entityState;
+		return;
+	}
+
+	entityStates.insert( entityStates.begin() + stateIdx, entityState );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySnapshot::RemoveEntityState( EntityId entityId )
+{
+	auto iter = FindEntityStateLowerBound( entityStates, entityId );
+	if ( iter != entityStates.end()
+		 && iter->entityId == entityId )
+	{
+		entityStates.erase( iter );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Ids are written in ascending order, so most are a small step from the previous one
+static int GetEntityIdNumBits( EntityId entityId, EntityId previousEntityId )
+{
+	int64_t gap = (int64_t)entityId - (int64_t)previousEntityId;
+	if ( gap >= 1 && gap <= ( 1 << SMALL_ENTITY_ID_GAP_BITS ) )
+	{
+		return 1 + SMALL_ENTITY_ID_GAP_BITS;
+	}
+
+	return 1 + FULL_ENTITY_ID_BITS;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static void AppendEntityId( BitBufferWriter& writer, EntityId entityId, EntityId previousEntityId )
+{
+	int64_t gap = (int64_t)entityId - (int64_t)previousEntityId;
+	if ( gap >= 1 && gap <= ( 1 << SMALL_ENTITY_ID_GAP_BITS ) )
+	{
+		writer.AppendBool( true );
+		writer.AppendBits( (uint32_t)( gap - 1 ), SMALL_ENTITY_ID_GAP_BITS );
+		return;
+	}
+
+	writer.AppendBool( false );
+	writer.AppendSignedBits( entityId, FULL_ENTITY_ID_BITS );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static EntityId ParseEntityId( BitBufferParser& parser, EntityId previousEntityId )
+{
+	if ( parser.ParseBool() )
+	{
+		return previousEntityId + 1 + (EntityId)parser.ParseBits( SMALL_ENTITY_ID_GAP_BITS );
+	}
+
+	return (EntityId)parser.ParseSignedBits( FULL_ENTITY_ID_BITS );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static bool IsSmallFieldDelta( uint32_t value, uint32_t baselineValue, int fieldBits )
+{
+	// Not worth it when the full value is already as small as a delta
+	if ( fieldBits <= SMALL_FIELD_DELTA_BITS )
+	{
+		return false;
+	}
+
+	int64_t delta = (int64_t)value - (int64_t)baselineValue;
+	int64_t maxSmallDelta = ( 1 << ( SMALL_FIELD_DELTA_BITS - 1 ) ) - 1;
+	return delta >= -maxSmallDelta - 1 && delta <= maxSmallDelta;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static int GetFieldNumBits( uint32_t value, uint32_t baselineValue, int fieldBits )
+{
+	return 1 + ( IsSmallFieldDelta( value, baselineValue, fieldBits ) ? SMALL_FIELD_DELTA_BITS : fieldBits );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static void AppendField( BitBufferWriter& writer, uint32_t value, uint32_t baselineValue, int fieldBits )
+{
+	if ( IsSmallFieldDelta( value, baselineValue, fieldBits ) )
+	{
+		writer.AppendBool( true );
+		writer.AppendSignedBits( (int32_t)( (int64_t)value - (int64_t)baselineValue ), SMALL_FIELD_DELTA_BITS );
+		return;
+	}
+
+	writer.AppendBool( false );
+	writer.AppendBits( value, fieldBits );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static bool ParseField( BitBufferParser& parser, uint32_t baselineValue, int fieldBits, uint32_t& out_value )
+{
+	if ( !parser.ParseBool() )
+	{
+		out_value = parser.ParseBits( fieldBits );
+		return true;
+	}
+
+	int64_t value = (int64_t)baselineValue + (int64_t)parser.ParseSignedBits( SMALL_FIELD_DELTA_BITS );
+	int64_t maxValue = ( (int64_t)1 << fieldBits ) - 1;
+	if ( value < 0 || value > maxValue )
+	{
+		return false;
+	}
+
+	out_value = (uint32_t)value;
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static uint32_t GetChangedFieldBits( const EntitySnapshotState& state, const EntitySnapshotState& baselineState )
+{
+	uint32_t changedFields = 0;
+	if ( state.quantizedX != baselineState.quantizedX )			{ changedFields |= SNAPSHOT_FIELD_X; }
+	if ( state.quantizedY != baselineState.quantizedY )			{ changedFields |= SNAPSHOT_FIELD_Y; }
+	if ( state.quantizedYaw != baselineState.quantizedYaw )		{ changedFields |= SNAPSHOT_FIELD_YAW; }
+
+	return changedFields;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static int GetChangedStateNumBits( const EntitySnapshotState& state, const EntitySnapshotState* baselineState, const SnapshotQuantization& quantization )
+{
+	// New entity flag
+	int numBits = 1;
+	if ( baselineState == nullptr )
+	{
+		return numBits + 2 * quantization.positionBits + quantization.yawBits;
+	}
+
+	numBits += NUM_SNAPSHOT_FIELD_BITS;
+
+	uint32_t changedFields = GetChangedFieldBits( state, *baselineState );
+	if ( changedFields & SNAPSHOT_FIELD_X )		{ numBits += GetFieldNumBits( state.quantizedX, baselineState->quantizedX, quantization.positionBits ); }
+	if ( changedFields & SNAPSHOT_FIELD_Y )		{ numBits += GetFieldNumBits( state.quantizedY, baselineState->quantizedY, quantization.positionBits ); }
+	if ( changedFields & SNAPSHOT_FIELD_YAW )	{ numBits += GetFieldNumBits( state.quantizedYaw, baselineState->quantizedYaw, quantization.yawBits ); }
+
+	return numBits;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static void AppendChangedState( BitBufferWriter& writer, const EntitySnapshotState& state, const EntitySnapshotState* baselineState, const SnapshotQuantization& quantization )
+{
+	writer.AppendBool( baselineState == nullptr );
+	if ( baselineState == nullptr )
+	{
+		writer.AppendBits( state.quantizedX, quantization.positionBits );
+		writer.AppendBits( state.quantizedY, quantization.positionBits );
+		writer.AppendBits( state.quantizedYaw, quantization.yawBits );
+		return;
+	}
+
+	uint32_t changedFields = GetChangedFieldBits( state, *baselineState );
+	writer.AppendBits( changedFields, NUM_SNAPSHOT_FIELD_BITS );
+
+	if ( changedFields & SNAPSHOT_FIELD_X )		{ AppendField( writer, state.quantizedX, baselineState->quantizedX, quantization.positionBits ); }
+	if ( changedFields & SNAPSHOT_FIELD_Y )		{ AppendField( writer, state.quantizedY, baselineState->quantizedY, quantization.positionBits ); }
+	if ( changedFields & SNAPSHOT_FIELD_YAW )	{ AppendField( writer, state.quantizedYaw, baselineState->quantizedYaw, quantization.yawBits ); }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static bool ParseChangedState( BitBufferParser& parser, const EntitySnapshot* baseline, const SnapshotQuantization& quantization, EntitySnapshotState& out_state )
+{
+	bool isNewEntity = parser.ParseBool();
+	if ( isNewEntity )
+	{
+		out_state.quantizedX = parser.ParseBits( quantization.positionBits );
+		out_state.quantizedY = parser.ParseBits( quantization.positionBits );
+		out_state.quantizedYaw = parser.ParseBits( quantization.yawBits );
+		return true;
+	}
+
+	const EntitySnapshotState* baselineState = baseline != nullptr ? baseline->FindEntityState( out_state.entityId ) : nullptr;
+	if ( baselineState == nullptr )
+	{
+		return false;
+	}
+
+	out_state.quantizedX = baselineState->quantizedX;
+	out_state.quantizedY = baselineState->quantizedY;
+	out_state.quantizedYaw = baselineState->quantizedYaw;
+
+	uint32_t changedFields = parser.ParseBits( NUM_SNAPSHOT_FIELD_BITS );
+	if ( ( changedFields & SNAPSHOT_FIELD_X ) && !ParseField( parser, baselineState->quantizedX, quantization.positionBits, out_state.quantizedX ) )		{ return false; }
+	if ( ( changedFields & SNAPSHOT_FIELD_Y ) && !ParseField( parser, baselineState->quantizedY, quantization.positionBits, out_state.quantizedY ) )		{ return false; }
+	if ( ( changedFields & SNAPSHOT_FIELD_YAW ) && !ParseField( parser, baselineState->quantizedYaw, quantization.yawBits, out_state.quantizedYaw ) )	{ return false; }
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void WriteEntitySnapshotParts( const EntitySnapshot& current, const EntitySnapshot* baseline, std::vector<std::vector<byte>>& out_parts )
+{
+	const SnapshotQuantization& quantization = current.quantization;
+	constexpr int MAX_PART_BITS = MAX_ENTITY_SNAPSHOT_PART_BYTES * 8;
+	constexpr int PART_HEADER_BITS = 2 * SNAPSHOT_COUNT_BITS;
+
+	std::vector<EntitySnapshotPart> parts( 1 );
+	int partNumBits = PART_HEADER_BITS;
+	EntityId previousRemovedId = -1;
+	EntityId previousChangedId = -1;
+
+	auto startNewPartIfFull = [&]( int entryNumBits )
+	{
+		if ( partNumBits + entryNumBits <= MAX_PART_BITS )
+		{
+			return;
+		}
+
+		parts.emplace_back();
+		partNumBits = PART_HEADER_BITS;
+		previousRemovedId = -1;
+		previousChangedId = -1;
+	};
+
+	// Removals, anything in the baseline that isn't in the current snapshot
+	if ( baseline != nullptr )
+	{
+		for ( const EntitySnapshotState& baselineState : baseline->entityStates )
+		{
+			if ( current.FindEntityState( baselineState.entityId ) != nullptr )
+			{
+				continue;
+			}
+
+			// Id costs depend on the previous id in the part, so recompute once a new part has started
+			startNewPartIfFull( GetEntityIdNumBits( baselineState.entityId, previousRemovedId ) );
+			partNumBits += GetEntityIdNumBits( baselineState.entityId, previousRemovedId );
+			parts.back().removedEntityIds.push_back( baselineState.entityId );
+			previousRemovedId = baselineState.entityId;
+		}
+	}
+
+	// New and changed entities
+	for ( const EntitySnapshotState& state : current.entityStates )
+	{
+		const EntitySnapshotState* baselineState = baseline != nullptr ? baseline->FindEntityState( state.entityId ) : nullptr;
+		if ( baselineState != nullptr
+			 && GetChangedFieldBits( state, *baselineState ) == 0 )
+		{
+			continue;
+		}
+
+		int stateNumBits = GetChangedStateNumBits( state, baselineState, quantization );
+		startNewPartIfFull( GetEntityIdNumBits( state.entityId, previousChangedId ) + stateNumBits );
+		partNumBits += GetEntityIdNumBits( state.entityId, previousChangedId ) + stateNumBits;
+		parts.back().changedStates.push_back( &state );
+		parts.back().baselineStates.push_back( baselineState );
+		previousChangedId = state.entityId;
+	}
+
+	out_parts.clear();
+	out_parts.resize( parts.size() );
+	for ( int partIdx = 0; partIdx < (int)parts.size(); ++partIdx )
+	{
+		const EntitySnapshotPart& part = parts[partIdx];
+		BitBufferWriter writer( out_parts[partIdx] );
+
+		writer.AppendBits( (uint32_t)part.removedEntityIds.size(), SNAPSHOT_COUNT_BITS );
+		EntityId previousId = -1;
+		for ( EntityId removedEntityId : part.removedEntityIds )
+		{
+			AppendEntityId( writer, removedEntityId, previousId );
+			previousId = removedEntityId;
+		}
+
+		writer.AppendBits( (uint32_t)part.changedStates.size(), SNAPSHOT_COUNT_BITS );
+		previousId = -1;
+		for ( int stateIdx = 0; stateIdx < (int)part.changedStates.size(); ++stateIdx )
+		{
+			const EntitySnapshotState& state = *part.changedStates[stateIdx];
+			AppendEntityId( writer, state.entityId, previousId );
+			AppendChangedState( writer, state, part.baselineStates[stateIdx], quantization );
+			previousId = state.entityId;
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool ReadEntitySnapshotPart( const byte* data, uint32_t size, const EntitySnapshot* baseline, EntitySnapshot& out_snapshot, std::vector<EntityId>& out_changedEntityIds )
+{
+	BitBufferParser parser( data, size );
+
+	int numRemoved = (int)parser.ParseBits( SNAPSHOT_COUNT_BITS );
+	EntityId previousId = -1;
+	for ( int removedIdx = 0; removedIdx < numRemoved && !parser.HasOverrun(); ++removedIdx )
+	{
+		EntityId removedEntityId = ParseEntityId( parser, previousId );
+		out_snapshot.RemoveEntityState( removedEntityId );
+		previousId = removedEntityId;
+	}
+
+	int numChanged = (int)parser.ParseBits( SNAPSHOT_COUNT_BITS );
+	previousId = -1;
+	for ( int changedIdx = 0; changedIdx < numChanged && !parser.HasOverrun(); ++changedIdx )
+	{
+		EntitySnapshotState state;
+		state.entityId = ParseEntityId( parser, previousId );
+		if ( !ParseChangedState( parser, baseline, out_snapshot.quantization, state ) )
+		{
+			return false;
+		}
+
+		out_snapshot.SetEntityState( state );
+		out_changedEntityIds.push_back( state.entityId );
+		previousId = state.entityId;
+	}
+
+	return !parser.HasOverrun();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool IsSnapshotSequenceNewer( uint16_t a, uint16_t b )
+{
+	return a != b 
+		&& (uint16_t)( a - b ) < 0x8000;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Game/GameCommon.hpp"
+
+#include <vector>
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr int ENTITY_SNAPSHOT_HISTORY_SIZE = 32;
+constexpr int MAX_ENTITY_SNAPSHOT_PARTS = 32;
+
+// Leaves room for the EntitySnapshotRequest header so every part fits in a batched datagram
+constexpr int MAX_ENTITY_SNAPSHOT_PART_BYTES = 400;
+
+constexpr int MIN_SNAPSHOT_QUANTIZATION_BITS = 1;
+constexpr int MAX_SNAPSHOT_QUANTIZATION_BITS = 24;
+
+
+//-----------------------------------------------------------------------------------------------
+struct SnapshotQuantization
+{
+public:
+	float positionMin = -64.f;
+	float positionMax = 192.f;
+	int positionBits = 16;
+	int yawBits = 10;
+
+public:
+	// Settings read off the network have to pass this before anything is parsed or dequantized with them
+	bool IsValid() const;
+
+	bool operator==( const SnapshotQuantization& other ) const;
+	bool operator!=( const SnapshotQuantization& other ) const				{ return !( *this == other ); }
+};
+
+
+//-----------------------------------------------------------------------------------------------
+struct EntitySnapshotState
+{
+public:
+	EntityId entityId = -1;
+	uint32_t quantizedX = 0;
+	uint32_t quantizedY = 0;
+	uint32_t quantizedYaw = 0;
+
+public:
+	EntitySnapshotState() = default;
+	EntitySnapshotState( EntityId entityId, const Vec2& position, float yawDegrees, const SnapshotQuantization& quantization );
+
+	Vec2 GetPosition( const SnapshotQuantization& quantization ) const;
+	float GetYawDegrees( const SnapshotQuantization& quantization ) const;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// The replicated state of every entity at one point in time, states are kept sorted by entity id
+struct EntitySnapshot
+{
+public:
+	uint16_t sequenceNum = 0;
+	SnapshotQuantization quantization;
+	std::vector<EntitySnapshotState> entityStates;
+
+public:
+	void Clear();
+	void SortEntityStates();
+	const EntitySnapshotState* FindEntityState( EntityId entityId ) const;
+	void SetEntityState( const EntitySnapshotState& entityState );
+	void RemoveEntityState( EntityId entityId );
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Encodes only what changed since baseline (everything when baseline is null), split into parts of at most
+// MAX_ENTITY_SNAPSHOT_PART_BYTES that can each be decoded on their own. Quantized fields that changed by a
+// little are sent as small deltas, entities missing from current are sent as removals.
+void WriteEntitySnapshotParts( const EntitySnapshot& current, const EntitySnapshot* baseline, std::vector<std::vector<byte>>& out_parts );
+
+// Applies one part on top of out_snapshot, which should start as a copy of the same baseline the part was written
+// against. Returns false if the part was malformed. Ids of the entities the part moved are added to out_changedEntityIds.
+bool ReadEntitySnapshotPart( const byte* data, uint32_t size, const EntitySnapshot* baseline, EntitySnapshot& out_snapshot, std::vector<EntityId>& out_changedEntityIds );
+
+// Sequence numbers wrap, a is newer than b if it is less than half the range ahead
+bool IsSnapshotSequenceNewer( uint16_t a, uint16_t b );
@@ -151,15 +151,21 @@ void Game::LoadAssets()
 {
 	g_devConsole->PrintString( "Loading Assets...", Rgba8::WHITE );
 
-	// Audio
-	m_testSound = g_audioSystem->CreateOrGetSound( "Data/Audio/TestSound.mp3" );
-	g_audioSystem->CreateOrGetSound( "Data/Audio/Teleporter.wav" );
+	// A headless server only needs the game definitions
+	if ( g_audioSystem != nullptr )
+	{
+		m_testSound = g_audioSystem->CreateOrGetSound( "Data/Audio/TestSound.mp3" );
+		g_audioSystem->CreateOrGetSound( "Data/Audio/Teleporter.wav" );
+	}
 
-	g_renderer->CreateOrGetTextureFromFile( "Data/Images/Terrain_8x8.png" );
-	g_renderer->CreateOrGetTextureFromFile( "Data/Images/Test_StbiFlippedAndOpenGL.png" );
-	g_renderer->CreateOrGetTextureFromFile( "Data/Images/Hud_Base.png" );
+	if ( g_renderer != nullptr )
+	{
+		g_renderer->CreateOrGetTextureFromFile( "Data/Images/Terrain_8x8.png" );
+		g_renderer->CreateOrGetTextureFromFile( "Data/Images/Test_StbiFlippedAndOpenGL.png" );
+		g_renderer->CreateOrGetTextureFromFile( "Data/Images/Hud_Base.png" );
 
-	SpriteSheet::CreateAndRegister( "ViewModels", *( g_renderer->CreateOrGetTextureFromFile( "Data/Images/ViewModelsSpriteSheet_8x8.png" ) ), IntVec2( 8, 8 ) );
+		SpriteSheet::CreateAndRegister( "ViewModels", *( g_renderer->CreateOrGetTextureFromFile( "Data/Images/ViewModelsSpriteSheet_8x8.png" ) ), IntVec2( 8, 8 ) );
+	}
 	
 	LoadXmlEntityTypes();
 	LoadXmlMapMaterials();
@@ -289,7 +295,7 @@ void Game::LoadXmlMapMaterials()
 		{
 			g_devConsole->PrintError( Stringf( "MapMaterialsTypes.xml: MaterialsSheet node '%s' is missing an image", name.c_str() ) );
 		}
-		else
+		else if ( g_renderer != nullptr )
 		{
 			SpriteSheet::CreateAndRegister( name, *g_renderer->CreateOrGetTextureFromFile( imagePath.c_str() ), layout );
 		}
@@ -297,7 +303,8 @@ void Game::LoadXmlMapMaterials()
 		materialsSheetElement = materialsSheetElement->NextSiblingElement( "MaterialsSheet" );
 	}
 
-	if ( SpriteSheet::s_definitions.empty() )
+	if ( g_renderer != nullptr
+		 && SpriteSheet::s_definitions.empty() )
 	{
 		g_devConsole->PrintError( "MapMaterialsTypes.xml: Must define at least one valid MaterialsSheet node." );
 		return;
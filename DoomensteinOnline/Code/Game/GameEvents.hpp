@@ -39,6 +39,9 @@ enum eClientFunctionType
 	DRAW_SHOT,
 	UPDATE_PLAYER_SCORE,
 
+	ENTITY_SNAPSHOT,
+	ENTITY_SNAPSHOT_ACK,
+
 	NUM_TYPES
 };
 
@@ -326,3 +329,48 @@ public:
 	{
 	}
 };
+
+
+//-----------------------------------------------------------------------------------------------
+// One part of an entity snapshot, followed by size bytes of bit packed entity states (see EntitySnapshot.hpp)
+struct EntitySnapshotRequest : ClientRequest
+{
+public:
+	float positionMin = 0.f;
+	float positionMax = 0.f;
+	uint16_t sequenceNum = 0;
+	uint16_t baselineSequenceNum = 0;
+	uint16_t size = 0;
+	uint8_t hasBaseline = 0;
+	uint8_t partIdx = 0;
+	uint8_t numParts = 0;
+	uint8_t positionBits = 0;
+	uint8_t yawBits = 0;
+
+public:
+	EntitySnapshotRequest( int clientId, uint16_t sequenceNum, bool hasBaseline, uint16_t baselineSequenceNum, uint8_t partIdx, uint8_t numParts, uint16_t size )
+		: ClientRequest( clientId, eClientFunctionType::ENTITY_SNAPSHOT )
+		, sequenceNum( sequenceNum )
+		, baselineSequenceNum( baselineSequenceNum )
+		, size( size )
+		, hasBaseline( hasBaseline ? 1 : 0 )
+		, partIdx( partIdx )
+		, numParts( numParts )
+	{
+	}
+};
+
+
+//-----------------------------------------------------------------------------------------------
+struct EntitySnapshotAckRequest : ClientRequest
+{
+public:
+	uint16_t sequenceNum = 0;
+
+public:
+	EntitySnapshotAckRequest( int clientId, uint16_t sequenceNum )
+		: ClientRequest( clientId, eClientFunctionType::ENTITY_SNAPSHOT_ACK )
+		, sequenceNum( sequenceNum )
+	{
+	}
+};
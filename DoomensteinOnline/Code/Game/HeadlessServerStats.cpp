@@ -0,0 +1,73 @@
+#include "Game/HeadlessServerStats.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Networking/NetworkingSystem.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Server.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+HeadlessServerStats::HeadlessServerStats( double tickBudgetSeconds, double printIntervalSeconds )
+	: m_tickBudgetSeconds( tickBudgetSeconds )
+	, m_printIntervalSeconds( printIntervalSeconds )
+{
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void HeadlessServerStats::RecordTick( double tickSeconds, double currentTimeSeconds )
+{
+	if ( m_intervalStartTime < 0.0 )
+	{
+		m_intervalStartTime = currentTimeSeconds;
+	}
+
+	++m_numTicks;
+	m_totalTickSeconds += tickSeconds;
+	if ( tickSeconds > m_maxTickSeconds )
+	{
+		m_maxTickSeconds = tickSeconds;
+	}
+
+	if ( tickSeconds > m_tickBudgetSeconds )
+	{
+		++m_numOverBudgetTicks;
+	}
+
+	double elapsedSeconds = currentTimeSeconds - m_intervalStartTime;
+	if ( elapsedSeconds >= m_printIntervalSeconds )
+	{
+		PrintAndReset( elapsedSeconds );
+		m_intervalStartTime = currentTimeSeconds;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void HeadlessServerStats::PrintAndReset( double elapsedSeconds )
+{
+	float ticksPerSecond = (float)( (double)m_numTicks / elapsedSeconds );
+	float averageTickMs = m_numTicks > 0 ? (float)( m_totalTickSeconds / (double)m_numTicks * 1000.0 ) : 0.f;
+	float maxTickMs = (float)( m_maxTickSeconds * 1000.0 );
+	int numClients = g_server != nullptr ? g_server->GetNumClients() : 0;
+
+	g_devConsole->PrintString( Stringf( "Server: %.1f ticks/s, tick avg %.2fms max %.2fms, %i over budget, %i clients",
+										ticksPerSecond, averageTickMs, maxTickMs, m_numOverBudgetTicks, numClients ) );
+
+	if ( g_networkingSystem != nullptr )
+	{
+		const UDPSendStats& sendStats = g_networkingSystem->GetUDPSendStats();
+		const UDPReceiveStats& receiveStats = g_networkingSystem->GetUDPReceiveStats();
+
+		float totalBytesPerSecond = sendStats.payloadBytesPerSecond + sendStats.overheadBytesPerSecond;
+		float overheadPercent = totalBytesPerSecond > 0.f ? sendStats.overheadBytesPerSecond / totalBytesPerSecond * 100.f : 0.f;
+
+		g_devConsole->PrintString( Stringf( "UDP: sending %.1f datagrams/s %.0f bytes/s (%.1f%% overhead), %i received last tick, %i dropped since startup",
+											sendStats.datagramsPerSecond, totalBytesPerSecond, overheadPercent, receiveStats.numProcessed, receiveStats.numDropped ) );
+	}
+
+	m_numTicks = 0;
+	m_numOverBudgetTicks = 0;
+	m_totalTickSeconds = 0.0;
+	m_maxTickSeconds = 0.0;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+
+//-----------------------------------------------------------------------------------------------
+// Accumulates how long each server tick took and periodically logs it alongside client count and
+// UDP bandwidth, since a headless server has no screen to show any of this on
+class HeadlessServerStats
+{
+public:
+	HeadlessServerStats( double tickBudgetSeconds, double printIntervalSeconds );
+	~HeadlessServerStats() = default;
+
+	void RecordTick( double tickSeconds, double currentTimeSeconds );
+
+private:
+	void PrintAndReset( double elapsedSeconds );
+
+private:
+	double m_tickBudgetSeconds = 0.0;
+	double m_printIntervalSeconds = 5.0;
+	double m_intervalStartTime = -1.0;
+
+	int m_numTicks = 0;
+	int m_numOverBudgetTicks = 0;
+	double m_totalTickSeconds = 0.0;
+	double m_maxTickSeconds = 0.0;
+};
@@ -5,18 +5,54 @@
 #include <crtdbg.h>
 
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/NamedProperties.hpp"
+#include "Engine/Core/StringUtils.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/App.hpp"
 
 
+//-----------------------------------------------------------------------------------------------
+// Command line is a list of space separated tokens, "headless" runs a dedicated server with no window
+// and key=value pairs are passed along as startup args, e.g. "headless port=48000 tickRate=30"
+static eAppMode ParseCommandLine( const std::string& commandLine, EventArgs& out_args )
+{
+	eAppMode appMode = eAppMode::SINGLE_PLAYER;
+
+	Strings tokens = SplitStringOnDelimiter( commandLine, ' ' );
+	for ( const std::string& token : tokens )
+	{
+		if ( token.empty() )
+		{
+			continue;
+		}
+
+		if ( !_strcmpi( token.c_str(), "headless" ) )
+		{
+			appMode = eAppMode::HEADLESS_SERVER;
+			continue;
+		}
+
+		Strings keyValuePair = SplitStringOnDelimiter( token, '=' );
+		if ( keyValuePair.size() == 2 )
+		{
+			out_args.SetValue( keyValuePair[0], keyValuePair[1] );
+		}
+	}
+
+	return appMode;
+}
+
+
 //-----------------------------------------------------------------------------------------------
 int WINAPI WinMain( _In_ HINSTANCE applicationInstanceHandle, _In_opt_ HINSTANCE, _In_ LPSTR commandLineString, _In_ int )
 {
-	UNUSED( commandLineString );
 	UNUSED( applicationInstanceHandle );
+
+	EventArgs commandLineArgs;
+	eAppMode appMode = ParseCommandLine( commandLineString, commandLineArgs );
 							
 	g_app = new App();	
-	g_app->Startup();
+	g_app->Startup( appMode, &commandLineArgs );
 	
 	// Program main loop; keep running frames until it's time to quit
 	while( !g_app->IsQuitting() )			
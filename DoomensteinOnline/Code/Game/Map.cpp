@@ -54,7 +54,12 @@ void Map::Update( float deltaSeconds )
 	}
 
 	ResolveEntityVsEntityCollisions();
-	UpdateMeshes();
+
+	if ( g_renderer != nullptr )
+	{
+		UpdateMeshes();
+	}
+
 	ResolveEntityVsPortalCollisions();
 
 	CleanupDeadEntities();
@@ -340,6 +345,37 @@ std::vector<Entity*> Map::GetAllLivingEntities()
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void Map::GetLivingEntitiesInRadius( const Vec2& position, float radius, std::vector<Entity*>& out_entities ) const
+{
+	float radiusSquared = radius * radius;
+
+	for ( Entity* entity : m_livingEntities )
+	{
+		if ( entity == nullptr
+			 || entity->GetMap() != this )
+		{
+			continue;
+		}
+
+		if ( GetDistanceSquared2D( entity->GetPosition(), position ) <= radiusSquared )
+		{
+			out_entities.push_back( entity );
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool Map::HasLineOfSight( const Vec2& startPos, const Vec2& endPos ) const
+{
+	UNUSED( startPos );
+	UNUSED( endPos );
+
+	return true;
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void Map::DeleteAllEntities()
 {
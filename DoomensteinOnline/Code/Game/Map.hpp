@@ -58,6 +58,10 @@ public:
 	std::vector<Entity*> GetAllLivingEntities();
 	void DeleteAllEntities();
 
+	// Appends the living entities within radius of position, maps with a spatial structure override this to skip the rest
+	virtual void GetLivingEntitiesInRadius( const Vec2& position, float radius, std::vector<Entity*>& out_entities ) const;
+	virtual bool HasLineOfSight( const Vec2& startPos, const Vec2& endPos ) const;
+
 	virtual RaycastResult Raycast( const Vec3& startPos, const Vec3& forwardNormal, float maxDist ) const = 0;
 	virtual Entity* GetEntityFromRaycast( const Vec3& startPos, const Vec3& forwardNormal, float maxDist ) const = 0;
 
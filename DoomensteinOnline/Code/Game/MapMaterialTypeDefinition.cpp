@@ -2,6 +2,7 @@
 #include "Engine/Core/DevConsole.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Renderer/SpriteSheet.hpp"
+#include "Game/GameCommon.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
@@ -39,17 +40,24 @@ MapMaterialTypeDefinition::MapMaterialTypeDefinition( const XmlElement& mapMater
 		return;
 	}
 
-	m_sheet = SpriteSheet::GetSpriteSheetByName( sheetStr );
-	if ( m_sheet == nullptr )
+	m_spriteCoords = ParseXmlAttribute( mapMaterialTypeDefElem, "spriteCoords", m_spriteCoords );
+	if ( m_spriteCoords == IntVec2( -1, -1 ) )
 	{
-		g_devConsole->PrintError( Stringf( "Material type '%s' references a sprite sheet '%s' that isn't defined", m_name.c_str(), sheetStr.c_str() ) );
+		g_devConsole->PrintError( Stringf( "Material type '%s' is missing a spriteCoords attribute", m_name.c_str() ) );
 		return;
 	}
 
-	m_spriteCoords = ParseXmlAttribute( mapMaterialTypeDefElem, "spriteCoords", m_spriteCoords );
-	if ( m_spriteCoords == IntVec2( -1, -1 ) )
+	// Sprite sheets are only created when there is a renderer, a headless server keeps the material without one
+	if ( g_renderer == nullptr )
 	{
-		g_devConsole->PrintError( Stringf( "Material type '%s' is missing a spriteCoords attribute", m_name.c_str() ) );
+		m_isValid = true;
+		return;
+	}
+
+	m_sheet = SpriteSheet::GetSpriteSheetByName( sheetStr );
+	if ( m_sheet == nullptr )
+	{
+		g_devConsole->PrintError( Stringf( "Material type '%s' references a sprite sheet '%s' that isn't defined", m_name.c_str(), sheetStr.c_str() ) );
 		return;
 	}
 
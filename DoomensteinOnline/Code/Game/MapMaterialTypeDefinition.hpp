@@ -30,6 +30,6 @@ public:
 private:
 	bool m_isValid = false;
 	std::string m_name;
-	SpriteSheet* m_sheet;
+	SpriteSheet* m_sheet = nullptr;
 	IntVec2 m_spriteCoords = IntVec2( -1, -1 );
 };
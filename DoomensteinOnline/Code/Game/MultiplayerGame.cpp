@@ -56,19 +56,22 @@ void MultiplayerGame::ShootEntity( EntityId shooterId, const Vec3& forwardVector
 	//Entity* targetEntity = map->GetEntityFromRaycast( Vec3( entity->GetPosition(), entity->GetEyeHeight() ), forwardVector, shotRange );
 	RaycastResult shotResult = map->Raycast( Vec3( entity->GetPosition(), entity->GetEyeHeight() ), forwardVector, shotRange );
 
-	if ( shotResult.didImpact )
+	if ( g_playerClient != nullptr )
 	{
-		Vec3 start = shotResult.startPos;
-		start.z -= .1f;
-		g_playerClient->DrawShot( start, shotResult.impactPos, g_playerClient->GetColorForPlayer( playerNum ) );
-	}
-	else
-	{
-		Vec3 start( entity->GetPosition(), entity->GetEyeHeight() - .1f );
-		g_playerClient->DrawShot( start, start + ( forwardVector * shotRange ), g_playerClient->GetColorForPlayer( playerNum ) );
+		if ( shotResult.didImpact )
+		{
+			Vec3 start = shotResult.startPos;
+			start.z -= .1f;
+			g_playerClient->DrawShot( start, shotResult.impactPos, PlayerClient::GetColorForPlayer( playerNum ) );
+		}
+		else
+		{
+			Vec3 start( entity->GetPosition(), entity->GetEyeHeight() - .1f );
+			g_playerClient->DrawShot( start, start + ( forwardVector * shotRange ), PlayerClient::GetColorForPlayer( playerNum ) );
+		}
 	}
 
-	ClientRequest* drawShotReq = new DrawShotRequest( -1, shotResult.startPos, shotResult.impactPos, g_playerClient->GetColorForPlayer( playerNum ) );
+	ClientRequest* drawShotReq = new DrawShotRequest( -1, shotResult.startPos, shotResult.impactPos, PlayerClient::GetColorForPlayer( playerNum ) );
 	g_server->SendMessageToAllDistantClients( drawShotReq );
 
 	PTR_SAFE_DELETE( drawShotReq );
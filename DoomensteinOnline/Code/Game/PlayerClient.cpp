@@ -445,12 +445,12 @@ void PlayerClient::RenderScore() const
 		return;
 	}
 
-	DebugAddScreenTextf( Vec4( 0.45f, .97f, 0.f, 0.f ), Vec2::ZERO, 25.f, m_playerColors[m_playerNum], 0.f,
+	DebugAddScreenTextf( Vec4( 0.45f, .97f, 0.f, 0.f ), Vec2::ZERO, 25.f, GetColorForPlayer( m_playerNum ), 0.f,
 						 "Player %i", m_playerNum + 1 );
 
 	for ( int playerIdx = 0; playerIdx < (int)playerScores.size(); ++playerIdx )
 	{
-		DebugAddScreenTextf( Vec4( 0.01f, .97f - (float)playerIdx * .04f, 0.f, 0.f ), Vec2::ZERO, 25.f, m_playerColors[playerIdx], 0.f,
+		DebugAddScreenTextf( Vec4( 0.01f, .97f - (float)playerIdx * .04f, 0.f, 0.f ), Vec2::ZERO, 25.f, GetColorForPlayer( playerIdx ), 0.f,
 							 "P%i Score: %i",
 							 playerIdx + 1, playerScores[playerIdx] );
 	}
@@ -582,13 +582,16 @@ void PlayerClient::SetPlayerNum( int playerNum )
 //-----------------------------------------------------------------------------------------------
 Rgba8 PlayerClient::GetColorForPlayer( int playerNum )
 {
+	// Static so a headless server with no player client can still color the shots it sends out
+	static const Rgba8 s_playerColors[8] = { Rgba8::BLUE, Rgba8::RED, Rgba8::GREEN, Rgba8::YELLOW, Rgba8::PURPLE, Rgba8::ORANGE, Rgba8::CYAN, Rgba8::MAGENTA };
+
 	if ( playerNum < 0
 		 || playerNum >= 8 )
 	{
 		return Rgba8::WHITE;
 	}
 
-	return m_playerColors[playerNum];
+	return s_playerColors[playerNum];
 }
 
 
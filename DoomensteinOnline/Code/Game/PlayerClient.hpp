@@ -46,7 +46,7 @@ public:
 	void			SetPlayerId( EntityId playerId );
 	void			SetPlayerNum( int playerNum );
 
-	Rgba8			GetColorForPlayer( int playerNum );
+	static Rgba8	GetColorForPlayer( int playerNum );
 	void			DrawShot( const Vec3& start, const Vec3& end, const Rgba8& color );
 
 	// Events
@@ -107,5 +107,4 @@ private:
 	float m_gamma = 2.2f;
 
 	int m_playerNum = 0;
-	Rgba8 m_playerColors[8] = { Rgba8::BLUE, Rgba8::RED, Rgba8::GREEN, Rgba8::YELLOW, Rgba8::PURPLE, Rgba8::ORANGE, Rgba8::CYAN, Rgba8::MAGENTA };
 };
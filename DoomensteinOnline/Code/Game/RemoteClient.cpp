@@ -1,5 +1,6 @@
 #include "Game/RemoteClient.hpp"
 #include "Engine/Core/DevConsole.hpp"
+#include "Engine/Math/MathUtils.hpp"
 #include "Engine/Networking/NetworkingSystem.hpp"
 #include "Engine/Time/Time.hpp"
 #include "Game/Server.hpp"
@@ -8,6 +9,14 @@
 #include "Game/GameCommon.hpp"
 #include "Game/Entity.hpp"
 
+#include <algorithm>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------------------------
+SnapshotQuantization RemoteClient::s_snapshotQuantization;
+EntityRelevancySettings RemoteClient::s_relevancySettings;
+
 
 //-----------------------------------------------------------------------------------------------
 RemoteClient::RemoteClient( ConnectionInfo connectionInfo )
@@ -27,6 +36,7 @@ void RemoteClient::Startup()
 	g_networkingSystem->SendUDPMessage( 4820, &req, sizeof( req ) );*/
 
 	m_lastUpdateTime = GetCurrentTimeSeconds();
+	m_snapshotStatsStartTime = m_lastUpdateTime;
 }
 
 
@@ -83,7 +93,7 @@ void RemoteClient::SendUpdatedGameWorldToServer()
 		{
 			CreateEntityRequest req( m_clientId, entity->GetId(), entity->GetType(), entity->GetPosition(), entity->GetOrientationDegrees() );
 			g_devConsole->PrintString( Stringf( "UDP: CreateEntity" ), Rgba8::BLUE );
-			g_networkingSystem->SendUDPMessage( m_connectionInfo.distantSendToPort, &req, sizeof( req ), true );
+			g_networkingSystem->SendUDPMessage( m_connectionInfo.distantSendToPort, &req, sizeof( req ), eUDPChannel::RELIABLE_ORDERED );
 			//Sleep( 10 );
 		}
 
@@ -97,26 +107,207 @@ void RemoteClient::SendUpdatedGameWorldToServer()
 			m_lastUpdateTime = GetCurrentTimeSeconds();
 		}
 
-		std::vector<Entity*> entities = g_game->GetLivingEntitiesInCurrentMap();
+		SendEntitySnapshot();
+		
+		// Update client's deltaSeconds
+		ServerLastDeltaSecondsRequest lastDeltaSecondsReq( m_clientId, g_game->GetLastDeltaSeconds() );
+		g_networkingSystem->SendBatchedUDPMessage( m_connectionInfo.distantSendToPort, &lastDeltaSecondsReq, sizeof( lastDeltaSecondsReq ) );
+		g_networkingSystem->FlushUDPMessageBatches();
+	}
+}
+
 
-		for ( Entity* entity : entities )
+//-----------------------------------------------------------------------------------------------
+void RemoteClient::SendEntitySnapshot()
+{
+	EntitySnapshot& snapshot = m_sentSnapshots[m_nextSnapshotSequenceNum % ENTITY_SNAPSHOT_HISTORY_SIZE];
+	snapshot.Clear();
+	snapshot.sequenceNum = m_nextSnapshotSequenceNum;
+	snapshot.quantization = s_snapshotQuantization;
+
+	AddEntitiesToSnapshot( snapshot );
+
+	// Delta against the newest snapshot the server has acked, or send everything if that one is gone from the history
+	const EntitySnapshot* baseline = nullptr;
+	if ( m_hasAckedSnapshot
+		 && (uint16_t)( m_nextSnapshotSequenceNum - m_lastAckedSnapshotSequenceNum ) < ENTITY_SNAPSHOT_HISTORY_SIZE )
+	{
+		const EntitySnapshot& ackedSnapshot = m_sentSnapshots[m_lastAckedSnapshotSequenceNum % ENTITY_SNAPSHOT_HISTORY_SIZE];
+		if ( ackedSnapshot.sequenceNum == m_lastAckedSnapshotSequenceNum
+			 && ackedSnapshot.quantization == snapshot.quantization )
 		{
-			if ( entity == nullptr )
-			{
-				continue;
-			}
+			baseline = &ackedSnapshot;
+		}
+	}
 
-			UpdateEntityOnRemoteServerRequest req( m_clientId, entity->GetId(), entity->GetPosition(), entity->GetOrientationDegrees() );
+	std::vector<std::vector<byte>> parts;
+	WriteEntitySnapshotParts( snapshot, baseline, parts );
+	if ( parts.size() > MAX_ENTITY_SNAPSHOT_PARTS )
+	{
+		g_devConsole->PrintError( Stringf( "Entity snapshot needs %i parts, only %i are supported", (int)parts.size(), MAX_ENTITY_SNAPSHOT_PARTS ) );
+		return;
+	}
+
+	std::vector<byte> message;
+	for ( int partIdx = 0; partIdx < (int)parts.size(); ++partIdx )
+	{
+		const std::vector<byte>& part = parts[partIdx];
 
-			g_networkingSystem->SendUDPMessage( m_connectionInfo.distantSendToPort, &req, sizeof( req ) );
+		EntitySnapshotRequest req( m_clientId, snapshot.sequenceNum, baseline != nullptr, m_lastAckedSnapshotSequenceNum, (uint8_t)partIdx, (uint8_t)parts.size(), (uint16_t)part.size() );
+		req.positionMin = snapshot.quantization.positionMin;
+		req.positionMax = snapshot.quantization.positionMax;
+		req.positionBits = (uint8_t)snapshot.quantization.positionBits;
+		req.yawBits = (uint8_t)snapshot.quantization.yawBits;
 
-			//std::this_thread::sleep_for( std::chrono::microseconds( 2 ) );
+		message.resize( sizeof( req ) + part.size() );
+		memcpy( &message[0], &req, sizeof( req ) );
+		if ( !part.empty() )
+		{
+			memcpy( &message[sizeof( req )], &part[0], part.size() );
 		}
-		
-		// Update client's deltaSeconds
-		ServerLastDeltaSecondsRequest lastDeltaSecondsReq( m_clientId, g_game->GetLastDeltaSeconds() );
-		g_networkingSystem->SendUDPMessage( m_connectionInfo.distantSendToPort, &lastDeltaSecondsReq, sizeof( lastDeltaSecondsReq ) );
+
+		g_networkingSystem->SendBatchedUDPMessage( m_connectionInfo.distantSendToPort, &message[0], message.size() );
+		m_numSnapshotBytesSentThisPeriod += (int)message.size();
+	}
+
+	++m_numSnapshotsSentThisPeriod;
+	if ( baseline == nullptr )
+	{
+		++m_numFullSnapshotsSentThisPeriod;
+	}
+
+	++m_nextSnapshotSequenceNum;
+	m_hasSentSnapshot = true;
+
+	UpdateSnapshotStats();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void RemoteClient::AddEntitiesToSnapshot( EntitySnapshot& snapshot )
+{
+	// The previous snapshot is the slot before this one, so it's only valid after something has been sent
+	const EntitySnapshot* previousSnapshot = nullptr;
+	if ( m_hasSentSnapshot )
+	{
+		previousSnapshot = &m_sentSnapshots[(uint16_t)( m_nextSnapshotSequenceNum - 1 ) % ENTITY_SNAPSHOT_HISTORY_SIZE];
+		if ( previousSnapshot->quantization != snapshot.quantization )
+		{
+			previousSnapshot = nullptr;
+		}
+	}
+
+	// Without a player to measure from, or a previous snapshot to carry skipped entities over from, everything is updated
+	Entity* player = m_playerId != -1 ? g_game->GetEntityById( m_playerId ) : nullptr;
+	bool isFiltering = s_relevancySettings.isEnabled
+					   && player != nullptr
+					   && previousSnapshot != nullptr;
+	if ( isFiltering )
+	{
+		m_relevancyFilter.SelectEntitiesToUpdate( *player, s_relevancySettings, m_entityIdsToUpdate );
+	}
+
+	std::vector<Entity*> entities = g_game->GetLivingEntitiesInCurrentMap();
+	snapshot.entityStates.reserve( entities.size() );
+	m_numEntitiesUpdatedLastSnapshot = 0;
+	for ( Entity* entity : entities )
+	{
+		if ( entity == nullptr )
+		{
+			continue;
+		}
+
+		EntityId entityId = entity->GetId();
+		if ( !isFiltering
+			 || std::binary_search( m_entityIdsToUpdate.begin(), m_entityIdsToUpdate.end(), entityId ) )
+		{
+			snapshot.entityStates.emplace_back( entityId, entity->GetPosition(), entity->GetOrientationDegrees(), snapshot.quantization );
+			++m_numEntitiesUpdatedLastSnapshot;
+			continue;
+		}
+
+		// Skipped entities repeat the state the client was last sent, which costs nothing once the client has acked it.
+		// Entities that have never been relevant to this client are left out until they are.
+		const EntitySnapshotState* previousState = previousSnapshot->FindEntityState( entityId );
+		if ( previousState != nullptr )
+		{
+			snapshot.entityStates.push_back( *previousState );
+		}
+	}
+	snapshot.SortEntityStates();
+
+	m_numEntitiesLastSnapshot = (int)snapshot.entityStates.size();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool RemoteClient::IsPositionRelevant( const Vec2& position ) const
+{
+	if ( !s_relevancySettings.isEnabled )
+	{
+		return true;
+	}
+
+	Entity* player = m_playerId != -1 ? g_game->GetEntityById( m_playerId ) : nullptr;
+	if ( player == nullptr )
+	{
+		return true;
+	}
+
+	return GetDistanceSquared2D( player->GetPosition(), position ) <= s_relevancySettings.relevantRadius * s_relevancySettings.relevantRadius;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void RemoteClient::AckEntitySnapshot( uint16_t sequenceNum )
+{
+	// Only move forward, acks can arrive out of order
+	if ( m_hasAckedSnapshot
+		 && !IsSnapshotSequenceNewer( sequenceNum, m_lastAckedSnapshotSequenceNum ) )
+	{
+		return;
+	}
+
+	// Ignore acks for snapshots we haven't sent
+	if ( !IsSnapshotSequenceNewer( m_nextSnapshotSequenceNum, sequenceNum ) )
+	{
+		return;
+	}
+
+	m_lastAckedSnapshotSequenceNum = sequenceNum;
+	m_hasAckedSnapshot = true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void RemoteClient::UpdateSnapshotStats()
+{
+	double currentTime = GetCurrentTimeSeconds();
+	double elapsedSeconds = currentTime - m_snapshotStatsStartTime;
+	if ( elapsedSeconds < 1.0 )
+	{
+		return;
 	}
+
+	m_snapshotBytesPerSecond = (float)( (double)m_numSnapshotBytesSentThisPeriod / elapsedSeconds );
+	m_averageSnapshotBytes = m_numSnapshotsSentThisPeriod > 0 ? (float)m_numSnapshotBytesSentThisPeriod / (float)m_numSnapshotsSentThisPeriod : 0.f;
+	m_numFullSnapshotsLastPeriod = m_numFullSnapshotsSentThisPeriod;
+
+	m_snapshotStatsStartTime = currentTime;
+	m_numSnapshotBytesSentThisPeriod = 0;
+	m_numSnapshotsSentThisPeriod = 0;
+	m_numFullSnapshotsSentThisPeriod = 0;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void RemoteClient::PrintNetworkStats() const
+{
+	g_devConsole->PrintString( Stringf( "Client %i: snapshots %.0f bytes/s, %.1f bytes per snapshot, %i full snapshots last second, last acked %i of %i", 
+										m_clientId, m_snapshotBytesPerSecond, m_averageSnapshotBytes, m_numFullSnapshotsLastPeriod,
+										m_hasAckedSnapshot ? (int)m_lastAckedSnapshotSequenceNum : -1, (int)m_nextSnapshotSequenceNum - 1 ) );
+	g_devConsole->PrintString( Stringf( "Client %i: %i of %i replicated entities updated last snapshot, %i nearby", 
+										m_clientId, m_numEntitiesUpdatedLastSnapshot, m_numEntitiesLastSnapshot, m_relevancyFilter.GetNumNearbyEntities() ) );
 }
 
 
@@ -129,15 +320,16 @@ void RemoteClient::SendMessageToDistantClient( ClientRequest* message )
 		{
 			CreateEntityRequest* createEntityReq = (CreateEntityRequest*)message;
 			g_devConsole->PrintString( Stringf( "UDP: RC CreateEntity" ), Rgba8::BLUE );
-			g_networkingSystem->SendUDPMessage( m_connectionInfo.distantSendToPort, createEntityReq, sizeof( *createEntityReq ), true );
+			g_networkingSystem->SendUDPMessage( m_connectionInfo.distantSendToPort, createEntityReq, sizeof( *createEntityReq ), eUDPChannel::RELIABLE_ORDERED );
 		}
 		break;
 
 		case eClientFunctionType::NOTIFY_ENTITY_DIED:
 		{
 			NotifyEntityDiedRequest* notifyEntityDiedReq = (NotifyEntityDiedRequest*)message;
+			m_relevancyFilter.RemoveEntity( notifyEntityDiedReq->entityId );
 			g_devConsole->PrintString( Stringf( "UDP: RC EntityDied" ), Rgba8::BLUE );
-			g_networkingSystem->SendUDPMessage( m_connectionInfo.distantSendToPort, notifyEntityDiedReq, sizeof( *notifyEntityDiedReq ), true );
+			g_networkingSystem->SendUDPMessage( m_connectionInfo.distantSendToPort, notifyEntityDiedReq, sizeof( *notifyEntityDiedReq ), eUDPChannel::RELIABLE_ORDERED );
 		}
 		break;
 
@@ -145,15 +337,22 @@ void RemoteClient::SendMessageToDistantClient( ClientRequest* message )
 		{
 			UpdatePlayerScoreRequest* updatePlayerScoreReq = (UpdatePlayerScoreRequest*)message;
 			//g_devConsole->PrintString( Stringf( "UDP: RC Update Score" ), Rgba8::BLUE );
-			g_networkingSystem->SendUDPMessage( m_connectionInfo.distantSendToPort, updatePlayerScoreReq, sizeof( *updatePlayerScoreReq ), true, 100 );
+			g_networkingSystem->SendUDPMessage( m_connectionInfo.distantSendToPort, updatePlayerScoreReq, sizeof( *updatePlayerScoreReq ), eUDPChannel::RELIABLE_UNORDERED, 100 );
 		}
 		break;
 
 		case eClientFunctionType::DRAW_SHOT:
 		{
+			// Shots are only cosmetic, skip the ones too far from this client's player to matter
 			DrawShotRequest* drawShotReq = (DrawShotRequest*)message;
+			if ( !IsPositionRelevant( drawShotReq->start.XY() )
+				 && !IsPositionRelevant( drawShotReq->end.XY() ) )
+			{
+				break;
+			}
+
 			g_devConsole->PrintString( Stringf( "UDP: RC DrawShot" ), Rgba8::BLUE );
-			g_networkingSystem->SendUDPMessage( m_connectionInfo.distantSendToPort, drawShotReq, sizeof( *drawShotReq ), true, 20 );
+			g_networkingSystem->SendUDPMessage( m_connectionInfo.distantSendToPort, drawShotReq, sizeof( *drawShotReq ), eUDPChannel::RELIABLE_UNORDERED, 20 );
 		}
 		break;
 	}
@@ -168,7 +367,7 @@ void RemoteClient::SetClientId( int id )
 	RemoteClientRegistrationRequest req( m_clientId );
 
 	g_devConsole->PrintString( Stringf( "UDP: SetClientId" ), Rgba8::BLUE );
-	g_networkingSystem->SendUDPMessage( m_connectionInfo.distantSendToPort, &req, sizeof( req ), true, 100000 );
+	g_networkingSystem->SendUDPMessage( m_connectionInfo.distantSendToPort, &req, sizeof( req ), eUDPChannel::RELIABLE_ORDERED );
 
 	m_remoteServerInitState = eInitializationState::SENT;
 }
@@ -187,7 +386,7 @@ void RemoteClient::SetPlayer( Entity* entity )
 	SetPlayerIdRequest req( m_clientId, m_playerId );
 
 	g_devConsole->PrintString( Stringf( "UDP: SetPlayer" ), Rgba8::BLUE );
-	g_networkingSystem->SendUDPMessage( m_connectionInfo.distantSendToPort, &req, sizeof( req ), true, 100000 );
+	g_networkingSystem->SendUDPMessage( m_connectionInfo.distantSendToPort, &req, sizeof( req ), eUDPChannel::RELIABLE_ORDERED );
 
 	g_game->AddPlayerScore( m_clientId, m_playerId );
 
@@ -255,6 +454,14 @@ void RemoteClient::ProcessUDPMessages()
 				data.Process();
 			}
 			break;
+
+			case eClientFunctionType::ENTITY_SNAPSHOT_ACK:
+			{
+				const EntitySnapshotAckRequest* ackReq = reinterpret_cast<const EntitySnapshotAckRequest*>( req );
+				AckEntitySnapshot( ackReq->sequenceNum );
+				data.Process();
+			}
+			break;
 		}
 	}
 
@@ -1,6 +1,8 @@
 #pragma once
 #include "Game/Client.hpp"
 #include "Game/AuthoritativeServer.hpp"
+#include "Game/EntityRelevancy.hpp"
+#include "Game/EntitySnapshot.hpp"
 #include "Game/GameCommon.hpp"
 
 
@@ -35,8 +37,21 @@ public:
 	virtual void SetClientId( int id ) override;
 	virtual void SetPlayer( Entity* entity ) override;
 
+	virtual void PrintNetworkStats() const override;
+
+	static void SetSnapshotQuantization( const SnapshotQuantization& quantization )		{ s_snapshotQuantization = quantization; }
+	static const SnapshotQuantization& GetSnapshotQuantization()							{ return s_snapshotQuantization; }
+
+	static void SetRelevancySettings( const EntityRelevancySettings& settings )			{ s_relevancySettings = settings; }
+	static const EntityRelevancySettings& GetRelevancySettings()							{ return s_relevancySettings; }
+
 private:
 	void ProcessUDPMessages();
+	void SendEntitySnapshot();
+	void AddEntitiesToSnapshot( EntitySnapshot& snapshot );
+	bool IsPositionRelevant( const Vec2& position ) const;
+	void AckEntitySnapshot( uint16_t sequenceNum );
+	void UpdateSnapshotStats();
 
 private:
 	ConnectionInfo m_connectionInfo;
@@ -47,4 +62,27 @@ private:
 	eInitializationState m_remoteServerPlayerIdInitState = eInitializationState::NOT_SENT;
 
 	double m_lastUpdateTime = 1.f;
+
+	// Every snapshot is kept until it falls out of the history so any acked one can be a baseline
+	EntitySnapshot m_sentSnapshots[ENTITY_SNAPSHOT_HISTORY_SIZE];
+	uint16_t m_nextSnapshotSequenceNum = 0;
+	uint16_t m_lastAckedSnapshotSequenceNum = 0;
+	bool m_hasAckedSnapshot = false;
+	bool m_hasSentSnapshot = false;
+
+	EntityRelevancyFilter m_relevancyFilter;
+	std::vector<EntityId> m_entityIdsToUpdate;
+	int m_numEntitiesUpdatedLastSnapshot = 0;
+	int m_numEntitiesLastSnapshot = 0;
+
+	double m_snapshotStatsStartTime = 0.0;
+	int m_numSnapshotBytesSentThisPeriod = 0;
+	int m_numSnapshotsSentThisPeriod = 0;
+	int m_numFullSnapshotsSentThisPeriod = 0;
+	float m_snapshotBytesPerSecond = 0.f;
+	float m_averageSnapshotBytes = 0.f;
+	int m_numFullSnapshotsLastPeriod = 0;
+
+	static SnapshotQuantization s_snapshotQuantization;
+	static EntityRelevancySettings s_relevancySettings;
 };
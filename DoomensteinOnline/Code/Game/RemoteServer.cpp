@@ -125,7 +125,7 @@ void RemoteServer::ProcessTCPMessages()
 
 				KeyVerificationRequest keyVerifyReq( m_remoteClientId, responseReq->connectKey );
 				g_devConsole->PrintString( Stringf( "UDP: RS KeyVerify" ), Rgba8::BLUE );
-				g_networkingSystem->SendUDPMessage( m_udpSendToPort, &keyVerifyReq, sizeof( keyVerifyReq ), true );
+				g_networkingSystem->SendUDPMessage( m_udpSendToPort, &keyVerifyReq, sizeof( keyVerifyReq ), eUDPChannel::RELIABLE_ORDERED );
 			}
 			break;
 		}
@@ -183,7 +183,7 @@ void RemoteServer::ProcessUDPMessages()
 
 				SetPlayerIdAckRequest ackReq( m_remoteClientId );
 				g_devConsole->PrintString( Stringf( "UDP: RS PlayerIdAck" ), Rgba8::BLUE );
-				g_networkingSystem->SendUDPMessage( m_udpSendToPort, &ackReq, sizeof( ackReq ), true );
+				g_networkingSystem->SendUDPMessage( m_udpSendToPort, &ackReq, sizeof( ackReq ), eUDPChannel::RELIABLE_ORDERED );
 
 			}
 			break;
@@ -255,6 +255,17 @@ void RemoteServer::ProcessUDPMessages()
 			}
 			break;
 
+			case eClientFunctionType::ENTITY_SNAPSHOT:
+			{
+				if ( g_game != nullptr )
+				{
+					ProcessEntitySnapshotPart( data );
+				}
+
+				data.Process();
+			}
+			break;
+
 			case eClientFunctionType::UPDATE_PLAYER_SCORE:
 			{
 				UpdatePlayerScoreRequest* updatePlayerScoreReq = (UpdatePlayerScoreRequest*)req;
@@ -273,6 +284,147 @@ void RemoteServer::ProcessUDPMessages()
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void RemoteServer::ProcessEntitySnapshotPart( const UDPData& data )
+{
+	// The fixed part has to be there before size, numParts and partIdx can be trusted
+	if ( data.GetLength() < sizeof( UDPMessageHeader ) + sizeof( EntitySnapshotRequest ) )
+	{
+		return;
+	}
+
+	const EntitySnapshotRequest* snapshotReq = reinterpret_cast<const EntitySnapshotRequest*>( data.GetPayload() );
+	if ( data.GetLength() < sizeof( UDPMessageHeader ) + sizeof( EntitySnapshotRequest ) + snapshotReq->size
+		 || snapshotReq->numParts == 0
+		 || snapshotReq->numParts > MAX_ENTITY_SNAPSHOT_PARTS
+		 || snapshotReq->partIdx >= snapshotReq->numParts )
+	{
+		return;
+	}
+
+	// Bad widths would die in the bit parser or overflow dequantizing, so a bad packet must not get that far
+	SnapshotQuantization quantization;
+	quantization.positionMin = snapshotReq->positionMin;
+	quantization.positionMax = snapshotReq->positionMax;
+	quantization.positionBits = snapshotReq->positionBits;
+	quantization.yawBits = snapshotReq->yawBits;
+	if ( !quantization.IsValid() )
+	{
+		return;
+	}
+
+	uint16_t sequenceNum = snapshotReq->sequenceNum;
+
+	// Anything at or before the last complete snapshot is stale
+	if ( m_hasCompletedSnapshot
+		 && !IsSnapshotSequenceNewer( sequenceNum, m_lastCompletedSnapshotSequenceNum ) )
+	{
+		return;
+	}
+
+	if ( !m_isAssemblingSnapshot
+		 || m_assemblingSnapshot.sequenceNum != sequenceNum )
+	{
+		// Parts of an older snapshot arriving after a newer one has started are dropped
+		if ( m_isAssemblingSnapshot
+			 && IsSnapshotSequenceNewer( m_assemblingSnapshot.sequenceNum, sequenceNum ) )
+		{
+			return;
+		}
+
+		// Start from the baseline the server deltaed against, without it none of this snapshot can be decoded
+		if ( snapshotReq->hasBaseline )
+		{
+			const EntitySnapshot& baseline = m_receivedSnapshots[snapshotReq->baselineSequenceNum % ENTITY_SNAPSHOT_HISTORY_SIZE];
+			if ( !m_hasCompletedSnapshot
+				 || baseline.sequenceNum != snapshotReq->baselineSequenceNum )
+			{
+				return;
+			}
+
+			m_assemblingSnapshot = baseline;
+		}
+		else
+		{
+			m_assemblingSnapshot.Clear();
+		}
+
+		m_assemblingSnapshot.sequenceNum = sequenceNum;
+		m_assemblingSnapshot.quantization = quantization;
+		m_isAssemblingSnapshot = true;
+		m_assemblingPartsReceivedMask = 0;
+		m_assemblingNumParts = snapshotReq->numParts;
+	}
+	else if ( quantization != m_assemblingSnapshot.quantization )
+	{
+		// Every part of one snapshot is written with the same settings
+		return;
+	}
+
+	uint32_t partBit = 1u << snapshotReq->partIdx;
+	if ( ( m_assemblingPartsReceivedMask & partBit ) != 0 )
+	{
+		return;
+	}
+
+	const EntitySnapshot* baseline = snapshotReq->hasBaseline ? &m_receivedSnapshots[snapshotReq->baselineSequenceNum % ENTITY_SNAPSHOT_HISTORY_SIZE] : nullptr;
+	const byte* partData = reinterpret_cast<const byte*>( data.GetPayload() + sizeof( EntitySnapshotRequest ) );
+
+	m_changedEntityIds.clear();
+	if ( !ReadEntitySnapshotPart( partData, snapshotReq->size, baseline, m_assemblingSnapshot, m_changedEntityIds ) )
+	{
+		g_devConsole->PrintError( Stringf( "Received malformed entity snapshot %i part %i", (int)sequenceNum, (int)snapshotReq->partIdx ) );
+		m_isAssemblingSnapshot = false;
+		return;
+	}
+
+	m_assemblingPartsReceivedMask |= partBit;
+
+	// Apply what this part moved right away rather than waiting for the rest of the snapshot
+	ApplyEntitySnapshotStates( m_assemblingSnapshot, m_changedEntityIds );
+
+	uint32_t allPartsMask = m_assemblingNumParts >= 32 ? 0xFFFFFFFF : ( 1u << m_assemblingNumParts ) - 1u;
+	if ( m_assemblingPartsReceivedMask != allPartsMask )
+	{
+		return;
+	}
+
+	// Complete, the server can now use it as a baseline
+	m_receivedSnapshots[sequenceNum % ENTITY_SNAPSHOT_HISTORY_SIZE] = m_assemblingSnapshot;
+	m_lastCompletedSnapshotSequenceNum = sequenceNum;
+	m_hasCompletedSnapshot = true;
+	m_isAssemblingSnapshot = false;
+
+	// Entities left out as unchanged may have moved in snapshots we never completed, so set everything
+	m_changedEntityIds.clear();
+	for ( const EntitySnapshotState& entityState : m_assemblingSnapshot.entityStates )
+	{
+		m_changedEntityIds.push_back( entityState.entityId );
+	}
+	ApplyEntitySnapshotStates( m_assemblingSnapshot, m_changedEntityIds );
+
+	EntitySnapshotAckRequest ackReq( m_remoteClientId, sequenceNum );
+	g_networkingSystem->SendBatchedUDPMessage( m_udpSendToPort, &ackReq, sizeof( ackReq ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void RemoteServer::ApplyEntitySnapshotStates( const EntitySnapshot& snapshot, const std::vector<EntityId>& entityIds ) const
+{
+	for ( EntityId entityId : entityIds )
+	{
+		const EntitySnapshotState* entityState = snapshot.FindEntityState( entityId );
+		if ( entityState == nullptr )
+		{
+			continue;
+		}
+
+		g_game->SetEntityPosition( entityId, entityState->GetPosition( snapshot.quantization ) );
+		g_game->SetEntityOrientation( entityId, entityState->GetYawDegrees( snapshot.quantization ) );
+	}
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void RemoteServer::RequestUDPConnection()
 {
@@ -318,7 +470,7 @@ void RemoteServer::ReceiveClientRequests( const std::vector<const ClientRequest*
 				CreateEntityRequest* createEntityReq = (CreateEntityRequest*)req;
 				createEntityReq->clientId = m_remoteClientId;
 				g_devConsole->PrintString( Stringf( "UDP: RS CreateEntity" ), Rgba8::BLUE );
-				g_networkingSystem->SendUDPMessage( m_udpSendToPort, createEntityReq, sizeof( *createEntityReq ), true );
+				g_networkingSystem->SendUDPMessage( m_udpSendToPort, createEntityReq, sizeof( *createEntityReq ), eUDPChannel::RELIABLE_ORDERED );
 
 			}
 			break;
@@ -328,7 +480,7 @@ void RemoteServer::ReceiveClientRequests( const std::vector<const ClientRequest*
 				UpdateEntityRequest* updateEntityReq = (UpdateEntityRequest*)req;
 				updateEntityReq->clientId = m_remoteClientId;
 				//g_devConsole->PrintString( Stringf( "UDP: RS UpdateEntity" ), Rgba8::BLUE );
-				g_networkingSystem->SendUDPMessage( m_udpSendToPort, updateEntityReq, sizeof( *updateEntityReq ) );
+				g_networkingSystem->SendBatchedUDPMessage( m_udpSendToPort, updateEntityReq, sizeof( *updateEntityReq ) );
 			}
 			break;
 
@@ -337,7 +489,7 @@ void RemoteServer::ReceiveClientRequests( const std::vector<const ClientRequest*
 				ShootRequest* shootReq = (ShootRequest*)req;
 				shootReq->clientId = m_remoteClientId;
 				g_devConsole->PrintString( Stringf( "UDP: RS Shoot" ), Rgba8::BLUE );
-				g_networkingSystem->SendUDPMessage( m_udpSendToPort, shootReq, sizeof( *shootReq ), true, 10 );
+				g_networkingSystem->SendUDPMessage( m_udpSendToPort, shootReq, sizeof( *shootReq ), eUDPChannel::RELIABLE_UNORDERED, 10 );
 			}
 			break;
 		}
@@ -1,9 +1,11 @@
 #pragma once
 #include "Game/Server.hpp"
+#include "Game/EntitySnapshot.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
 class PlayerClient;
+class UDPData;
 
 
 //-----------------------------------------------------------------------------------------------
@@ -33,6 +35,8 @@ protected:
 
 private:
 	void RequestUDPConnection();
+	void ProcessEntitySnapshotPart( const UDPData& data );
+	void ApplyEntitySnapshotStates( const EntitySnapshot& snapshot, const std::vector<EntityId>& entityIds ) const;
 
 private:
 	PlayerClient* m_playerClient = nullptr;
@@ -42,4 +46,16 @@ private:
 	int m_udpSendToPort = 4800;
 
 	bool m_isTCPClientClosed = false;
+
+	// Completed snapshots are kept as possible baselines for the server's deltas
+	EntitySnapshot m_receivedSnapshots[ENTITY_SNAPSHOT_HISTORY_SIZE];
+	uint16_t m_lastCompletedSnapshotSequenceNum = 0;
+	bool m_hasCompletedSnapshot = false;
+
+	// A snapshot can arrive in several parts, it only becomes a baseline once every part is here
+	EntitySnapshot m_assemblingSnapshot;
+	bool m_isAssemblingSnapshot = false;
+	uint32_t m_assemblingPartsReceivedMask = 0;
+	int m_assemblingNumParts = 0;
+	std::vector<EntityId> m_changedEntityIds;
 };
@@ -31,6 +31,8 @@ public:
 
 	virtual void SendMessageToAllDistantClients( ClientRequest* clientRequest ) = 0;
 
+	int GetNumClients() const												{ return (int)m_clients.size(); }
+
 protected:
 	virtual void StartGame( eAppMode appMode ) = 0;
 	virtual void ProcessNetworkMessages() = 0;
@@ -27,7 +27,16 @@ TileMap::TileMap( const MapData& mapData, World* world )
 
 	BuildCardinalDirectionsArray();
 	PopulateTiles( mapData.regionTypeDefs );
-	CreateTestBoxes();
+
+	m_sectorDimensions = IntVec2( ( m_dimensions.x + TILE_MAP_SECTOR_SIZE - 1 ) / TILE_MAP_SECTOR_SIZE,
+								  ( m_dimensions.y + TILE_MAP_SECTOR_SIZE - 1 ) / TILE_MAP_SECTOR_SIZE );
+	m_sectorLivingEntityIndices.resize( m_sectorDimensions.x * m_sectorDimensions.y );
+	UpdateEntitySectors();
+
+	if ( g_renderer != nullptr )
+	{
+		CreateTestBoxes();
+	}
 }
 
 
@@ -70,8 +79,10 @@ void TileMap::Update( float deltaSeconds )
 	Map::Update( deltaSeconds );
 
 	ResolveEntityVsWallCollisions();
+	UpdateEntitySectors();
 
-	if ( g_playerClient->g_raytraceFollowCamera )
+	if ( g_playerClient != nullptr
+		 && g_playerClient->g_raytraceFollowCamera )
 	{
 		m_raytraceTransform = g_playerClient->GetWorldCamera()->GetTransform();
 	}
@@ -804,6 +815,119 @@ bool TileMap::IsAdjacentTileSolid( const Tile& tile, eCardinalDirection directio
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void TileMap::GetLivingEntitiesInRadius( const Vec2& position, float radius, std::vector<Entity*>& out_entities ) const
+{
+	IntVec2 minSectorCoords = GetSectorCoordsFromWorldCoords( position - Vec2( radius, radius ) );
+	IntVec2 maxSectorCoords = GetSectorCoordsFromWorldCoords( position + Vec2( radius, radius ) );
+	float radiusSquared = radius * radius;
+
+	for ( int sectorY = minSectorCoords.y; sectorY <= maxSectorCoords.y; ++sectorY )
+	{
+		for ( int sectorX = minSectorCoords.x; sectorX <= maxSectorCoords.x; ++sectorX )
+		{
+			const std::vector<int>& sectorEntityIndices = m_sectorLivingEntityIndices[sectorX + sectorY * m_sectorDimensions.x];
+			for ( int livingEntityIdx : sectorEntityIndices )
+			{
+				// Sectors are only brought up to date in Update, an entity may have died since
+				Entity* entity = m_livingEntities[livingEntityIdx];
+				if ( entity == nullptr
+					 || entity->GetMap() != this )
+				{
+					continue;
+				}
+
+				if ( GetDistanceSquared2D( entity->GetPosition(), position ) <= radiusSquared )
+				{
+					out_entities.push_back( entity );
+				}
+			}
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool TileMap::HasLineOfSight( const Vec2& startPos, const Vec2& endPos ) const
+{
+	Vec2 displacement = endPos - startPos;
+	float distance = displacement.GetLength();
+	if ( distance < .0001f )
+	{
+		return true;
+	}
+
+	RaycastResult result = RaycastAgainstWalls( Vec3( startPos, 0.f ), Vec3( displacement / distance, 0.f ), distance );
+	return !result.didImpact;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void TileMap::UpdateEntitySectors()
+{
+	m_livingEntitySectorIndices.resize( m_livingEntities.size(), -1 );
+
+	for ( int livingEntityIdx = 0; livingEntityIdx < (int)m_livingEntities.size(); ++livingEntityIdx )
+	{
+		// Dead entities are left in the list as null and warped ones keep pointing at their new map, both leave the sectors
+		const Entity* entity = m_livingEntities[livingEntityIdx];
+		int newSectorIdx = -1;
+		if ( entity != nullptr
+			 && entity->GetMap() == this )
+		{
+			newSectorIdx = GetSectorIndexFromWorldCoords( entity->GetPosition() );
+		}
+
+		int& sectorIdx = m_livingEntitySectorIndices[livingEntityIdx];
+		if ( newSectorIdx == sectorIdx )
+		{
+			continue;
+		}
+
+		if ( sectorIdx != -1 )
+		{
+			std::vector<int>& oldSectorEntityIndices = m_sectorLivingEntityIndices[sectorIdx];
+			for ( int& oldSectorEntityIdx : oldSectorEntityIndices )
+			{
+				if ( oldSectorEntityIdx == livingEntityIdx )
+				{
+					oldSectorEntityIdx = oldSectorEntityIndices.back();
+					oldSectorEntityIndices.pop_back();
+					break;
+				}
+			}
+		}
+
+		if ( newSectorIdx != -1 )
+		{
+			m_sectorLivingEntityIndices[newSectorIdx].push_back( livingEntityIdx );
+		}
+
+		sectorIdx = newSectorIdx;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+IntVec2 TileMap::GetSectorCoordsFromWorldCoords( const Vec2& worldCoords ) const
+{
+	// Anything outside the map is kept in the nearest edge sector
+	int sectorX = ClampMinMaxInt( RoundDownToInt( worldCoords.x ) / TILE_MAP_SECTOR_SIZE, 0, m_sectorDimensions.x - 1 );
+	int sectorY = ClampMinMaxInt( RoundDownToInt( worldCoords.y ) / TILE_MAP_SECTOR_SIZE, 0, m_sectorDimensions.y - 1 );
+
+	return IntVec2( sectorX, sectorY );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int TileMap::GetSectorIndexFromWorldCoords( const Vec2& worldCoords ) const
+{
+	IntVec2 sectorCoords = GetSectorCoordsFromWorldCoords( worldCoords );
+
+	return sectorCoords.x + sectorCoords.y * m_sectorDimensions.x;
+}
+
+
 //-----------------------------------------------------------------------------------------------
 bool TileMap::IsTileSolid( int xCoord, int yCoord ) const
 {
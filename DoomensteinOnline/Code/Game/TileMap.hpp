@@ -3,6 +3,11 @@
 #include "Engine/Math/Transform.hpp"
 
 
+//-----------------------------------------------------------------------------------------------
+// Width and height in tiles of the sectors living entities are bucketed into for area queries
+constexpr int TILE_MAP_SECTOR_SIZE = 8;
+
+
 //-----------------------------------------------------------------------------------------------
 struct MapData;
 class GPUMesh;
@@ -47,6 +52,9 @@ public:
 
 	virtual Entity* GetEntityFromRaycast( const Vec3& startPos, const Vec3& forwardNormal, float maxDist ) const override;
 
+	virtual void GetLivingEntitiesInRadius( const Vec2& position, float radius, std::vector<Entity*>& out_entities ) const override;
+	virtual bool HasLineOfSight( const Vec2& startPos, const Vec2& endPos ) const override;
+
 private:
 	void				PopulateTiles( const std::vector<MapRegionTypeDefinition*>& regionTypeDefs );
 	void				CreateInitialTiles( const std::vector<MapRegionTypeDefinition*>& regionTypeDefs );
@@ -69,6 +77,11 @@ private:
 	const Vec2			GetWorldCoordsFromTile( const Tile& tile ) const;
 
 	std::vector<const Tile*>	GetTilesInRadius( const Tile& centerTile, int radius, bool includeCenterTile ) const;
+
+	// Sector helpers
+	void				UpdateEntitySectors();
+	IntVec2				GetSectorCoordsFromWorldCoords( const Vec2& worldCoords ) const;
+	int					GetSectorIndexFromWorldCoords( const Vec2& worldCoords ) const;
 	
 	void				RenderTiles() const;
 
@@ -87,6 +100,12 @@ private:
 
 	Vec2				m_cardinalDirectionOffsets[9];
 
+	// Each sector holds indices into m_livingEntities, and each living entity remembers its sector so
+	// only the ones that crossed into a new sector get moved
+	IntVec2							m_sectorDimensions;
+	std::vector<std::vector<int>>	m_sectorLivingEntityIndices;
+	std::vector<int>				m_livingEntitySectorIndices;
+
 	// For cube tests
 	GPUMesh* m_cubeMesh = nullptr;
 	Material* m_testMaterial = nullptr;
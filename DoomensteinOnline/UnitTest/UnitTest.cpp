@@ -3,11 +3,20 @@
 
 #define TEST_MODE
 
+#include "Engine/Core/MPMCRingQueue.hpp"
+#include "Engine/Core/SPSCRingQueue.hpp"
+#include "Engine/Core/SynchronizedBlockingQueue.hpp"
+#include "Engine/Core/SynchronizedNonBlockingQueue.hpp"
+#include "Engine/Networking/LoopbackUDPNetwork.hpp"
+#include "Engine/Networking/UDPConnection.hpp"
+#include "Engine/Networking/UDPPacketPool.hpp"
 #include "Engine/Networking/UDPSocket.hpp"
 
 #include <winsock2.h>
 #include <ws2tcpip.h>
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <mutex>
 #include <thread>
@@ -91,16 +100,15 @@ namespace UnitTest
 			static std::mutex lock;
 
 			const UDPMessageHeader* msgHeader = nullptr;
+			std::array<char, BUFFER_SIZE> buffer;
 
 			do
 			{
-				UDPData data = socket.Receive();
+				UDPData data = socket.Receive( &buffer[0], buffer.size() );
 
 				message.text = "";
 				if ( data.GetLength() > 0 )
 				{
-					auto& buffer = socket.ReceiveBuffer();
-
 					// Copy the message header.
 					msgHeader = reinterpret_cast<const UDPMessageHeader*>( &buffer[0] );
 					if ( msgHeader->length > 0 )
@@ -160,4 +168,515 @@ namespace UnitTest
 			}
 		}
 	};
+
+
+	TEST_CLASS( UDPPacketPoolTestCase )
+	{
+	public:
+		//-----------------------------------------------------------------------------------------------
+		TEST_METHOD( UDPPacketPoolTest )
+		{
+			Logger::WriteMessage( "Starting UDP Packet Pool Test..." );
+
+			UDPPacketPool pool( 4, BUFFER_SIZE );
+			Assert::AreEqual( 4, pool.GetNumFreePackets() );
+
+			char* packets[4];
+			for ( int packetIdx = 0; packetIdx < 4; ++packetIdx )
+			{
+				packets[packetIdx] = pool.Acquire();
+				Assert::IsNotNull( packets[packetIdx] );
+				Assert::IsTrue( pool.OwnsPacket( packets[packetIdx] ) );
+			}
+
+			Assert::IsNull( pool.Acquire() );
+			Assert::AreEqual( 0, pool.GetNumFreePackets() );
+
+			// Packets must not overlap or a later datagram would overwrite an earlier one
+			Assert::IsTrue( packets[1] - packets[0] >= BUFFER_SIZE || packets[0] - packets[1] >= BUFFER_SIZE );
+
+			pool.Release( packets[2] );
+			Assert::AreEqual( 1, pool.GetNumFreePackets() );
+			Assert::IsTrue( pool.Acquire() == packets[2] );
+		}
+
+
+		//-----------------------------------------------------------------------------------------------
+		TEST_METHOD( UDPPacketPoolThreadedTest )
+		{
+			Logger::WriteMessage( "Starting threaded UDP Packet Pool Test..." );
+
+			UDPPacketPool pool( 64, BUFFER_SIZE );
+
+			auto workerMain = [&pool]()
+			{
+				for ( int iteration = 0; iteration < 100000; ++iteration )
+				{
+					char* packet = pool.Acquire();
+					if ( packet != nullptr )
+					{
+						pool.Release( packet );
+					}
+				}
+			};
+
+			std::thread workerOne( workerMain );
+			std::thread workerTwo( workerMain );
+			std::thread workerThree( workerMain );
+			workerOne.join();
+			workerTwo.join();
+			workerThree.join();
+
+			Assert::AreEqual( 64, pool.GetNumFreePackets() );
+		}
+	};
+
+	TEST_CLASS( UDPConnectionTestCase )
+	{
+	public:
+		//-----------------------------------------------------------------------------------------------
+		static std::array<char, BUFFER_SIZE> MakeDataMessage( int value )
+		{
+			std::array<char, BUFFER_SIZE> data = {};
+			UDPMessageHeader* header = reinterpret_cast<UDPMessageHeader*>( &data[0] );
+			header->id = (uint16_t)eMessasgeProtocolIds::DATA;
+			header->size = (uint16_t)sizeof( int );
+			memcpy( &data[sizeof( UDPMessageHeader )], &value, sizeof( int ) );
+			return data;
+		}
+
+
+		//-----------------------------------------------------------------------------------------------
+		static int GetMessageValue( const UDPData& data )
+		{
+			int value = 0;
+			memcpy( &value, data.GetPayload(), sizeof( int ) );
+			return value;
+		}
+
+
+		//-----------------------------------------------------------------------------------------------
+		TEST_METHOD( UDPConnectionOrderedTest )
+		{
+			Logger::WriteMessage( "Starting UDP Connection Ordered Test..." );
+
+			UDPConnection sender;
+			UDPConnection receiver;
+			for ( int value = 0; value < 3; ++value )
+			{
+				sender.QueueReliableMessage( MakeDataMessage( value ), eUDPChannel::RELIABLE_ORDERED, -1 );
+			}
+
+			std::vector<std::array<char, BUFFER_SIZE>> packets;
+			sender.GetReliableMessagesToSend( 0.0, packets );
+			Assert::AreEqual( 3, (int)packets.size() );
+			for ( std::array<char, BUFFER_SIZE>& packet : packets )
+			{
+				sender.StampOutgoingPacket( *reinterpret_cast<UDPMessageHeader*>( &packet[0] ), 0.0 );
+			}
+
+			// Packet 0 is lost, 2 arrives before 1 and 1 arrives twice
+			std::vector<UDPData> delivered;
+			int arrivalOrder[] = { 2, 1, 1 };
+			for ( int packetIdx : arrivalOrder )
+			{
+				char* packet = &packets[packetIdx][0];
+				receiver.ReceivePacketHeader( *reinterpret_cast<UDPMessageHeader*>( packet ), 0.05 );
+				receiver.ReceiveReliableMessage( UDPData( sizeof( UDPMessageHeader ) + sizeof( int ), packet, "", 0 ), delivered );
+			}
+			Assert::AreEqual( 0, (int)delivered.size() );
+			Assert::AreEqual( 1, receiver.GetStats().numDuplicatesDropped );
+
+			// The receiver's ack covers packets 1 and 2, so only message 0 is resent once its timer runs out
+			std::array<char, BUFFER_SIZE> ackPacket = {};
+			UDPMessageHeader* ackHeader = reinterpret_cast<UDPMessageHeader*>( &ackPacket[0] );
+			ackHeader->id = (uint16_t)eMessasgeProtocolIds::ACK;
+			receiver.StampOutgoingPacket( *ackHeader, 0.05 );
+			Assert::AreEqual( 2, (int)ackHeader->ack );
+			Assert::AreEqual( 1ull, ackHeader->ackBits );
+			sender.ReceivePacketHeader( *ackHeader, 0.1 );
+
+			packets.clear();
+			sender.GetReliableMessagesToSend( 0.1 + sender.GetResendSeconds(), packets );
+			Assert::AreEqual( 1, (int)packets.size() );
+			sender.StampOutgoingPacket( *reinterpret_cast<UDPMessageHeader*>( &packets[0][0] ), 0.3 );
+
+			char* resentPacket = &packets[0][0];
+			receiver.ReceivePacketHeader( *reinterpret_cast<UDPMessageHeader*>( resentPacket ), 0.35 );
+			Assert::IsTrue( receiver.ReceiveReliableMessage( UDPData( sizeof( UDPMessageHeader ) + sizeof( int ), resentPacket, "", 0 ), delivered ) );
+
+			Assert::AreEqual( 3, (int)delivered.size() );
+			for ( int value = 0; value < 3; ++value )
+			{
+				Assert::AreEqual( value, GetMessageValue( delivered[value] ) );
+			}
+		}
+
+
+		//-----------------------------------------------------------------------------------------------
+		TEST_METHOD( UDPConnectionAckBitsTest )
+		{
+			Logger::WriteMessage( "Starting UDP Connection Ack Bits Test..." );
+
+			UDPConnection sender;
+			UDPConnection receiver;
+
+			// Every other packet of 80 arrives, the ack bitfield reaches back 64 packets from the newest
+			for ( int packetIdx = 0; packetIdx < 80; ++packetIdx )
+			{
+				UDPMessageHeader header;
+				header.id = (uint16_t)eMessasgeProtocolIds::BATCH;
+				sender.StampOutgoingPacket( header, 0.0 );
+				if ( packetIdx % 2 == 1 )
+				{
+					receiver.ReceivePacketHeader( header, 0.0 );
+				}
+			}
+
+			UDPMessageHeader ackHeader;
+			ackHeader.id = (uint16_t)eMessasgeProtocolIds::ACK;
+			receiver.StampOutgoingPacket( ackHeader, 0.0 );
+			Assert::AreEqual( 79, (int)ackHeader.ack );
+			Assert::AreEqual( 0xAAAAAAAAAAAAAAAAull, ackHeader.ackBits );
+
+			sender.ReceivePacketHeader( ackHeader, 0.1 );
+			Assert::AreEqual( 33, sender.GetStats().numPacketsAcked );
+			Assert::AreEqual( 0.1f, sender.GetStats().roundTripSeconds, 0.001f );
+		}
+
+
+		//-----------------------------------------------------------------------------------------------
+		TEST_METHOD( UDPConnectionLongBurstTest )
+		{
+			Logger::WriteMessage( "Starting UDP Connection Long Burst Test..." );
+
+			UDPConnection sender;
+			UDPConnection receiver;
+
+			// 200 packets arrive in one frame, far more than the ack bitfield covers
+			int numImmediateAcks = 0;
+			for ( int packetIdx = 0; packetIdx < 200; ++packetIdx )
+			{
+				UDPMessageHeader header;
+				header.id = (uint16_t)eMessasgeProtocolIds::BATCH;
+				sender.StampOutgoingPacket( header, 0.0 );
+				receiver.ReceivePacketHeader( header, 0.0 );
+
+				if ( receiver.NeedsImmediateAck() )
+				{
+					UDPMessageHeader ackHeader;
+					ackHeader.id = (uint16_t)eMessasgeProtocolIds::ACK;
+					receiver.StampOutgoingPacket( ackHeader, 0.0 );
+					sender.ReceivePacketHeader( ackHeader, 0.1 );
+					++numImmediateAcks;
+				}
+			}
+
+			// The end of frame ack picks up the rest, nothing is left for the resend timer
+			UDPMessageHeader ackHeader;
+			ackHeader.id = (uint16_t)eMessasgeProtocolIds::ACK;
+			receiver.StampOutgoingPacket( ackHeader, 0.0 );
+			sender.ReceivePacketHeader( ackHeader, 0.1 );
+
+			Assert::AreEqual( 3, numImmediateAcks );
+			Assert::AreEqual( 200, sender.GetStats().numPacketsAcked );
+		}
+	};
+
+	TEST_CLASS( LoopbackUDPNetworkTestCase )
+	{
+	public:
+		//-----------------------------------------------------------------------------------------------
+		static std::vector<int> SendAndReceiveFrames( const LoopbackUDPNetworkConfig& config, int numFrames )
+		{
+			LoopbackUDPNetwork network( config );
+			LoopbackUDPTransport sender( &network, 48001 );
+			LoopbackUDPTransport receiver( &network, 48000 );
+			sender.Bind( 48000 );
+			receiver.Bind( 48001 );
+
+			std::vector<int> receivedValues;
+			std::array<char, BUFFER_SIZE> receiveBuffer;
+			for ( int frameIdx = 0; frameIdx <= numFrames + 60; ++frameIdx )
+			{
+				network.SetNetworkTime( (double)frameIdx / 60.0 );
+				if ( frameIdx < numFrames )
+				{
+					sender.Send( reinterpret_cast<const char*>( &frameIdx ), sizeof( int ) );
+				}
+
+				UDPData data = receiver.Receive( &receiveBuffer[0], receiveBuffer.size() );
+				while ( data.GetLength() > 0 )
+				{
+					int value = 0;
+					memcpy( &value, data.GetData(), sizeof( int ) );
+					receivedValues.push_back( value );
+
+					data = receiver.Receive( &receiveBuffer[0], receiveBuffer.size() );
+				}
+			}
+
+			return receivedValues;
+		}
+
+
+		//-----------------------------------------------------------------------------------------------
+		TEST_METHOD( LoopbackUDPLatencyTest )
+		{
+			Logger::WriteMessage( "Starting Loopback UDP Latency Test..." );
+
+			LoopbackUDPNetworkConfig config;
+			config.latencySeconds = 0.1;
+			LoopbackUDPNetwork network( config );
+			LoopbackUDPTransport sender( &network, 48001 );
+			LoopbackUDPTransport receiver( &network, 48000 );
+			sender.Bind( 48000 );
+			receiver.Bind( 48001 );
+
+			sender.Send( "hello", 6 );
+
+			std::array<char, BUFFER_SIZE> receiveBuffer;
+			network.SetNetworkTime( 0.05 );
+			Assert::AreEqual( 0, (int)receiver.Receive( &receiveBuffer[0], receiveBuffer.size() ).GetLength() );
+
+			network.SetNetworkTime( 0.1 );
+			UDPData data = receiver.Receive( &receiveBuffer[0], receiveBuffer.size() );
+			Assert::AreEqual( 6, (int)data.GetLength() );
+			Assert::AreEqual( "hello", data.GetData() );
+			Assert::AreEqual( 48000, data.GetFromPort() );
+		}
+
+
+		//-----------------------------------------------------------------------------------------------
+		TEST_METHOD( LoopbackUDPDeterminismTest )
+		{
+			Logger::WriteMessage( "Starting Loopback UDP Determinism Test..." );
+
+			LoopbackUDPNetworkConfig config;
+			config.latencySeconds = 0.05;
+			config.jitterSeconds = 0.02;
+			config.lossChance = 0.2f;
+			config.reorderChance = 0.1f;
+			config.seed = 7;
+
+			std::vector<int> firstRun = SendAndReceiveFrames( config, 100 );
+			std::vector<int> secondRun = SendAndReceiveFrames( config, 100 );
+
+			Assert::IsTrue( firstRun.size() < 100 );
+			Assert::IsTrue( firstRun == secondRun );
+			Assert::IsFalse( std::is_sorted( firstRun.begin(), firstRun.end() ) );
+		}
+
+
+		//-----------------------------------------------------------------------------------------------
+		TEST_METHOD( LoopbackUDPSendBatchTest )
+		{
+			Logger::WriteMessage( "Starting Loopback UDP Send Batch Test..." );
+
+			LoopbackUDPNetwork network;
+			LoopbackUDPTransport sender( &network, 48001 );
+			LoopbackUDPTransport receiver( &network, 48000 );
+			sender.Bind( 48000 );
+			receiver.Bind( 48001 );
+
+			constexpr int NUM_DATAGRAMS = 100;
+			int values[NUM_DATAGRAMS];
+			UDPDatagramView datagrams[NUM_DATAGRAMS];
+			for ( int datagramIdx = 0; datagramIdx < NUM_DATAGRAMS; ++datagramIdx )
+			{
+				values[datagramIdx] = datagramIdx;
+				datagrams[datagramIdx].data = reinterpret_cast<const char*>( &values[datagramIdx] );
+				datagrams[datagramIdx].length = sizeof( int );
+			}
+
+			int numSendCalls = 0;
+			Assert::AreEqual( NUM_DATAGRAMS, sender.SendBatch( datagrams, NUM_DATAGRAMS, numSendCalls ) );
+			Assert::AreEqual( NUM_DATAGRAMS, numSendCalls );
+
+			std::array<char, BUFFER_SIZE> receiveBuffer;
+			for ( int datagramIdx = 0; datagramIdx < NUM_DATAGRAMS; ++datagramIdx )
+			{
+				UDPData data = receiver.Receive( &receiveBuffer[0], receiveBuffer.size() );
+				Assert::AreEqual( (int)sizeof( int ), (int)data.GetLength() );
+
+				int value = -1;
+				memcpy( &value, data.GetData(), sizeof( int ) );
+				Assert::AreEqual( datagramIdx, value );
+			}
+		}
+	};
+
+	TEST_CLASS( RingQueueTestCase )
+	{
+	public:
+		//-----------------------------------------------------------------------------------------------
+		// Each producer pushes its own increasing values, the consumer checks they all arrive and stay in order per producer
+		template<typename PUSH_FUNC, typename POP_ALL_FUNC>
+		static double RunContentionBenchmark( int numProducers, int numValuesPerProducer, PUSH_FUNC push, POP_ALL_FUNC popAll )
+		{
+			auto startTime = std::chrono::high_resolution_clock::now();
+
+			std::vector<std::thread> producers;
+			for ( int producerIdx = 0; producerIdx < numProducers; ++producerIdx )
+			{
+				producers.emplace_back( [=]()
+										{
+											for ( int valueIdx = 0; valueIdx < numValuesPerProducer; ++valueIdx )
+											{
+												push( producerIdx * numValuesPerProducer + valueIdx );
+											}
+										} );
+			}
+
+			std::vector<int> nextValues( numProducers );
+			for ( int producerIdx = 0; producerIdx < numProducers; ++producerIdx )
+			{
+				nextValues[producerIdx] = producerIdx * numValuesPerProducer;
+			}
+
+			std::vector<int> values;
+			int numReceived = 0;
+			bool isInOrder = true;
+			while ( numReceived < numProducers * numValuesPerProducer )
+			{
+				values.clear();
+				popAll( values );
+				for ( int value : values )
+				{
+					int producerIdx = value / numValuesPerProducer;
+					isInOrder = isInOrder && value == nextValues[producerIdx];
+					nextValues[producerIdx] = value + 1;
+				}
+				numReceived += (int)values.size();
+			}
+
+			for ( std::thread& producer : producers )
+			{
+				producer.join();
+			}
+
+			Assert::IsTrue( isInOrder );
+			Assert::AreEqual( numProducers * numValuesPerProducer, numReceived );
+
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+			return elapsed.count();
+		}
+
+
+		//-----------------------------------------------------------------------------------------------
+		TEST_METHOD( SPSCRingQueueTest )
+		{
+			Logger::WriteMessage( "Starting SPSC Ring Queue Test..." );
+
+			SPSCRingQueue<int> queue( 3 );
+			Assert::AreEqual( 4, queue.GetCapacity() );
+			Assert::IsTrue( queue.IsEmpty() );
+
+			int values[6] = { 0, 1, 2, 3, 4, 5 };
+			Assert::AreEqual( 4, queue.PushMultiple( values, 6 ) );
+			Assert::IsFalse( queue.Push( 4 ) );
+
+			int value = -1;
+			Assert::IsTrue( queue.Pop( value ) );
+			Assert::AreEqual( 0, value );
+			Assert::IsTrue( queue.Push( 4 ) );
+
+			std::vector<int> poppedValues;
+			Assert::AreEqual( 4, queue.PopAll( poppedValues ) );
+			Assert::IsTrue( poppedValues == std::vector<int>( { 1, 2, 3, 4 } ) );
+			Assert::IsFalse( queue.Pop( value ) );
+		}
+
+
+		//-----------------------------------------------------------------------------------------------
+		TEST_METHOD( MPMCRingQueueTest )
+		{
+			Logger::WriteMessage( "Starting MPMC Ring Queue Test..." );
+
+			MPMCRingQueue<int> queue( 4 );
+			int values[6] = { 0, 1, 2, 3, 4, 5 };
+			Assert::AreEqual( 4, queue.PushMultiple( values, 6 ) );
+			Assert::IsFalse( queue.Push( 4 ) );
+
+			// Wrap around a few laps to make sure slots are handed back correctly
+			for ( int lap = 0; lap < 3; ++lap )
+			{
+				std::vector<int> poppedValues;
+				Assert::AreEqual( 4, queue.PopAll( poppedValues ) );
+				Assert::IsTrue( queue.IsEmpty() );
+				Assert::AreEqual( 4, queue.PushMultiple( values, 4 ) );
+			}
+		}
+
+
+		//-----------------------------------------------------------------------------------------------
+		TEST_METHOD( RingQueueWaitTest )
+		{
+			Logger::WriteMessage( "Starting Ring Queue Wait Test..." );
+
+			SPSCRingQueue<int> queue( 16, true );
+			std::vector<int> poppedValues;
+			std::thread consumer( [&]()
+								  {
+									  while ( queue.WaitAndPopAll( poppedValues ) > 0 ) {}
+								  } );
+
+			for ( int value = 0; value < 10; ++value )
+			{
+				queue.Push( value );
+				std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+			}
+
+			while ( !queue.IsEmpty() )
+			{
+				std::this_thread::yield();
+			}
+
+			queue.StopWaiting();
+			consumer.join();
+
+			Assert::AreEqual( 10, (int)poppedValues.size() );
+		}
+
+
+		//-----------------------------------------------------------------------------------------------
+		TEST_METHOD( RingQueueContentionBenchmark )
+		{
+			Logger::WriteMessage( "Starting Ring Queue Contention Benchmark..." );
+
+			constexpr int NUM_VALUES = 1000000;
+			constexpr int NUM_PRODUCERS = 4;
+
+			SynchronizedNonBlockingQueue<int> lockedQueue;
+			double lockedSingleMs = RunContentionBenchmark( 1, NUM_VALUES,
+															[&]( int value ) { lockedQueue.Push( value ); },
+															[&]( std::vector<int>& out_values ) { int value; while ( lockedQueue.Pop( value ) ) { out_values.push_back( value ); } } );
+
+			SynchronizedBlockingQueue<int> blockingQueue;
+			double blockingSingleMs = RunContentionBenchmark( 1, NUM_VALUES,
+															  [&]( int value ) { blockingQueue.Push( value ); },
+															  [&]( std::vector<int>& out_values ) { blockingQueue.PopAll( out_values ); } );
+
+			SPSCRingQueue<int> spscQueue( 4096, true );
+			double spscMs = RunContentionBenchmark( 1, NUM_VALUES,
+													[&]( int value ) { while ( !spscQueue.Push( value ) ) { std::this_thread::yield(); } },
+													[&]( std::vector<int>& out_values ) { spscQueue.WaitAndPopAll( out_values ); } );
+
+			double lockedMultiMs = RunContentionBenchmark( NUM_PRODUCERS, NUM_VALUES / NUM_PRODUCERS,
+														   [&]( int value ) { lockedQueue.Push( value ); },
+														   [&]( std::vector<int>& out_values ) { int value; while ( lockedQueue.Pop( value ) ) { out_values.push_back( value ); } } );
+
+			MPMCRingQueue<int> mpmcQueue( 4096, true );
+			double mpmcMs = RunContentionBenchmark( NUM_PRODUCERS, NUM_VALUES / NUM_PRODUCERS,
+													[&]( int value ) { while ( !mpmcQueue.Push( value ) ) { std::this_thread::yield(); } },
+													[&]( std::vector<int>& out_values ) { mpmcQueue.WaitAndPopAll( out_values ); } );
+
+			std::string results = "1 producer: SynchronizedNonBlockingQueue " + std::to_string( lockedSingleMs ) + " ms, "
+				+ "SynchronizedBlockingQueue " + std::to_string( blockingSingleMs ) + " ms, "
+				+ "SPSCRingQueue " + std::to_string( spscMs ) + " ms\n"
+				+ std::to_string( NUM_PRODUCERS ) + " producers: SynchronizedNonBlockingQueue " + std::to_string( lockedMultiMs ) + " ms, "
+				+ "MPMCRingQueue " + std::to_string( mpmcMs ) + " ms\n";
+			Logger::WriteMessage( results.c_str() );
+		}
+	};
 }
@@ -0,0 +1,80 @@
+#include "Engine/Core/BitBufferParser.hpp"
+#include "Engine/Core/BufferUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+BitBufferParser::BitBufferParser( const void* dataPtr, uint32_t sizeOfData )
+	: m_dataStartPtr( (const byte*)dataPtr )
+	, m_numBitsTotal( sizeOfData * 8 )
+{
+}
+
+
+//-----------------------------------------------------------------------------------------------
+BitBufferParser::BitBufferParser( const std::vector<byte>& dataBuffer )
+	: BitBufferParser( dataBuffer.data(), (uint32_t)dataBuffer.size() )
+{
+}
+
+
+//-----------------------------------------------------------------------------------------------
+uint32_t BitBufferParser::ParseBits( int numBits )
+{
+	GUARANTEE_OR_DIE( numBits >= 0 && numBits <= 32, "BitBufferParser can only parse between 0 and 32 bits at a time" );
+
+	if ( (uint32_t)numBits > m_numBitsTotal - m_numBitsRead )
+	{
+		m_hasOverrun = true;
+		m_numBitsRead = m_numBitsTotal;
+		return 0;
+	}
+
+	uint32_t value = 0;
+	int numBitsParsed = 0;
+	while ( numBitsParsed < numBits )
+	{
+		uint32_t byteIdx = m_numBitsRead >> 3;
+		int bitIdxInByte = (int)( m_numBitsRead & 7 );
+		
+		int numBitsToRead = Min( numBits - numBitsParsed, 8 - bitIdxInByte );
+		uint32_t bits = ( (uint32_t)m_dataStartPtr[byteIdx] >> bitIdxInByte ) & ( ( 1u << numBitsToRead ) - 1u );
+
+		value |= bits << numBitsParsed;
+
+		numBitsParsed += numBitsToRead;
+		m_numBitsRead += (uint32_t)numBitsToRead;
+	}
+
+	return value;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int32_t BitBufferParser::ParseSignedBits( int numBits )
+{
+	uint32_t value = ParseBits( numBits );
+	if ( numBits > 0 
+		 && numBits < 32 
+		 && ( value & ( 1u << ( numBits - 1 ) ) ) != 0 )
+	{
+		value |= ~( ( 1u << numBits ) - 1u );
+	}
+
+	return (int32_t)value;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool BitBufferParser::ParseBool()
+{
+	return ParseBits( 1 ) != 0;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+float BitBufferParser::ParseQuantizedFloat( float minValue, float maxValue, int numBits )
+{
+	return DequantizeFloat( ParseBits( numBits ), minValue, maxValue, numBits );
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "Engine/Core/EngineCommon.hpp"
+
+#include <vector>
+
+
+//-----------------------------------------------------------------------------------------------
+// Reads values written by a BitBufferWriter. Meant for data off the network, so reading past the end
+// doesn't die, it returns zeros and sets a flag the caller checks once it's done parsing.
+class BitBufferParser
+{
+public:
+	BitBufferParser( const void* dataPtr, uint32_t sizeOfData );
+	BitBufferParser( const std::vector<byte>& dataBuffer );
+
+	uint32_t ParseBits( int numBits );
+	int32_t ParseSignedBits( int numBits );
+	bool ParseBool();
+	float ParseQuantizedFloat( float minValue, float maxValue, int numBits );
+
+	bool HasOverrun() const											{ return m_hasOverrun; }
+	uint32_t GetNumBitsRemaining() const							{ return m_numBitsTotal - m_numBitsRead; }
+
+private:
+	const byte* m_dataStartPtr = nullptr;
+	uint32_t m_numBitsTotal = 0;
+	uint32_t m_numBitsRead = 0;
+	bool m_hasOverrun = false;
+};
@@ -0,0 +1,60 @@
+#include "Engine/Core/BitBufferWriter.hpp"
+#include "Engine/Core/BufferUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+BitBufferWriter::BitBufferWriter( std::vector<byte>& buffer )
+	: m_buffer( buffer )
+{
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void BitBufferWriter::AppendBits( uint32_t value, int numBits )
+{
+	GUARANTEE_OR_DIE( numBits >= 0 && numBits <= 32, "BitBufferWriter can only append between 0 and 32 bits at a time" );
+
+	m_numBitsWritten += (uint32_t)numBits;
+
+	while ( numBits > 0 )
+	{
+		if ( m_numBitsUsedInLastByte == 8 )
+		{
+			m_buffer.push_back( 0 );
+			m_numBitsUsedInLastByte = 0;
+		}
+
+		int numBitsToWrite = Min( numBits, 8 - m_numBitsUsedInLastByte );
+		uint32_t bitsToWrite = value & ( ( 1u << numBitsToWrite ) - 1u );
+
+		m_buffer.back() |= (byte)( bitsToWrite << m_numBitsUsedInLastByte );
+
+		m_numBitsUsedInLastByte += numBitsToWrite;
+		numBits -= numBitsToWrite;
+		value >>= numBitsToWrite;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void BitBufferWriter::AppendSignedBits( int32_t value, int numBits )
+{
+	// Two's complement truncated to numBits, BitBufferParser::ParseSignedBits sign extends it again
+	AppendBits( (uint32_t)value, numBits );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void BitBufferWriter::AppendBool( bool newBool )
+{
+	AppendBits( newBool ? 1 : 0, 1 );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void BitBufferWriter::AppendQuantizedFloat( float value, float minValue, float maxValue, int numBits )
+{
+	AppendBits( QuantizeFloat( value, minValue, maxValue, numBits ), numBits );
+}
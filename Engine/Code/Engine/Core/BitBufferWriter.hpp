@@ -0,0 +1,28 @@
+#pragma once
+#include "Engine/Core/EngineCommon.hpp"
+
+#include <vector>
+
+
+//-----------------------------------------------------------------------------------------------
+// Packs values using only as many bits as they need, for network messages where every byte counts.
+// Bits are filled from the least significant end of each byte, read them back with a BitBufferParser.
+class BitBufferWriter
+{
+public:
+	BitBufferWriter( std::vector<byte>& buffer );
+
+	void AppendBits( uint32_t value, int numBits );
+	void AppendSignedBits( int32_t value, int numBits );
+	void AppendBool( bool newBool );
+	void AppendQuantizedFloat( float value, float minValue, float maxValue, int numBits );
+
+	uint32_t GetNumBitsWritten() const								{ return m_numBitsWritten; }
+	uint32_t GetBufferLength() const								{ return (uint32_t)m_buffer.size(); }
+
+private:
+	std::vector<byte>&	m_buffer;
+
+	uint32_t m_numBitsWritten = 0;
+	int m_numBitsUsedInLastByte = 8;		// 8 means the next bit starts a new byte
+};
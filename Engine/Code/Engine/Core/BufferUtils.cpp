@@ -56,3 +56,40 @@ void Reverse8BytesInPlace( byte* dataPtr )
 }
 
 
+
+
+//-----------------------------------------------------------------------------------------------
+uint32_t QuantizeFloat( float value, float minValue, float maxValue, int numBits )
+{
+	uint32_t maxQuantizedValue = numBits >= 32 ? 0xFFFFFFFF : ( 1u << numBits ) - 1u;
+	if ( maxValue <= minValue )
+	{
+		return 0;
+	}
+
+	float fraction = ( value - minValue ) / ( maxValue - minValue );
+	if ( !( fraction > 0.f ) )
+	{
+		return 0;
+	}
+	if ( fraction >= 1.f )
+	{
+		return maxQuantizedValue;
+	}
+
+	return (uint32_t)( (double)fraction * (double)maxQuantizedValue + .5 );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+float DequantizeFloat( uint32_t quantizedValue, float minValue, float maxValue, int numBits )
+{
+	uint32_t maxQuantizedValue = numBits >= 32 ? 0xFFFFFFFF : ( 1u << numBits ) - 1u;
+	if ( maxQuantizedValue == 0 )
+	{
+		return minValue;
+	}
+
+	double fraction = (double)quantizedValue / (double)maxQuantizedValue;
+	return minValue + (float)( fraction * (double)( maxValue - minValue ) );
+}
@@ -16,3 +16,7 @@ eBufferEndianMode GetNativeEndianness();
 void Reverse2BytesInPlace( byte* dataPtr );
 void Reverse4BytesInPlace( byte* dataPtr );
 void Reverse8BytesInPlace( byte* dataPtr );
+
+// Maps value from [minValue, maxValue] onto an unsigned integer of numBits bits (clamped), and back
+uint32_t QuantizeFloat( float value, float minValue, float maxValue, int numBits );
+float DequantizeFloat( uint32_t quantizedValue, float minValue, float maxValue, int numBits );
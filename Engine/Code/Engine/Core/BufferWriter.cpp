@@ -225,6 +225,25 @@ void BufferWriter::AppendVertexPCUTBN( const Vertex_PCUTBN& newVertexPCUTBN )
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void BufferWriter::AppendBytes( const void* data, uint32_t numBytes )
+{
+	const byte* dataAsBytes = (const byte*)data;
+	m_buffer.insert( m_buffer.end(), dataAsBytes, dataAsBytes + numBytes );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void BufferWriter::AppendPaddingToAlignment( uint32_t alignment )
+{
+	size_t remainder = m_buffer.size() % alignment;
+	if ( remainder != 0 )
+	{
+		m_buffer.resize( m_buffer.size() + ( alignment - remainder ), 0 );
+	}
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void BufferWriter::Append2BytesToBuffer( byte* dataPtr )
 {
@@ -46,6 +46,10 @@ public:
 	void AppendVertexPCU( const Vertex_PCU& newVertexPCU );
 	void AppendVertexPCUTBN( const Vertex_PCUTBN& newVertexPCUTBN );
 
+	// Raw blocks, copied as is in native byte order
+	void AppendBytes( const void* data, uint32_t numBytes );
+	void AppendPaddingToAlignment( uint32_t alignment );
+
 	uint32_t GetBufferLength() const;
 	void OverwriteInt32AtOffset( int32_t newInt32, uint32_t offsetToOverwrite );
 	void OverwriteUint32AtOffset( uint32_t newUint32, uint32_t offsetToOverwrite );
@@ -10,6 +10,15 @@ CPUMesh::CPUMesh( const std::vector<Vertex_PCUTBN>& vertices, const std::vector<
 }
 
 
+//-----------------------------------------------------------------------------------------------
+CPUMesh::CPUMesh( std::vector<Vertex_PCUTBN>&& vertices, std::vector<uint>&& indices )
+	: m_vertices( std::move( vertices ) )
+	, m_indices( std::move( indices ) )
+{
+
+}
+
+
 //-----------------------------------------------------------------------------------------------
 CPUMesh::CPUMesh()
 {
@@ -10,9 +10,10 @@ class CPUMesh
 public:
 	CPUMesh();
 	CPUMesh( const std::vector<Vertex_PCUTBN>& vertices, const std::vector<uint>& indices );
+	CPUMesh( std::vector<Vertex_PCUTBN>&& vertices, std::vector<uint>&& indices );
 
-	std::vector<Vertex_PCUTBN> GetVertices() const								{ return m_vertices; }
-	std::vector<uint> GetIndices() const										{ return m_indices; }
+	const std::vector<Vertex_PCUTBN>& GetVertices() const						{ return m_vertices; }
+	const std::vector<uint>& GetIndices() const									{ return m_indices; }
 
 	int GetNumVertices() const													{ return (int)m_vertices.size(); }
 	int GetNumIndices() const													{ return (int)m_indices.size(); }
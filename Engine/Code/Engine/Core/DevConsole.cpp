@@ -88,6 +88,7 @@ void DevConsole::Shutdown()
 	m_renderer = nullptr;
 
 	SavePersistentHistory();
+	CloseLogFile();
 }
 
 
@@ -112,6 +113,50 @@ void DevConsole::SetBitmapFont( BitmapFont* font )
 }
 
 
+//-----------------------------------------------------------------------------------------------
+bool DevConsole::OpenLogFile( const std::string& filePath )
+{
+	CloseLogFile();
+
+	m_logFile = new std::ofstream();
+	m_logFile->open( filePath.c_str(), std::ios::out | std::ios::app );
+	if ( !m_logFile->is_open() )
+	{
+		PTR_SAFE_DELETE( m_logFile );
+		PrintError( Stringf( "Couldn't open dev console log file '%s'", filePath.c_str() ) );
+		return false;
+	}
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void DevConsole::CloseLogFile()
+{
+	if ( m_logFile == nullptr )
+	{
+		return;
+	}
+
+	m_logFile->close();
+	PTR_SAFE_DELETE( m_logFile );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void DevConsole::WriteToLogFile( const std::string& message )
+{
+	if ( m_logFile == nullptr )
+	{
+		return;
+	}
+
+	// Flushed every line so the log is still useful if the process is killed
+	*m_logFile << message << std::endl;
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void DevConsole::ProcessInput()
 {
@@ -136,6 +181,7 @@ void DevConsole::PrintString( const std::string& message, const Rgba8& textColor
 {
 	m_logMessages.push_back( DevConsoleLogMessage( message, textColor ) );
 	m_latestLogMessageToPrint = (int)m_logMessages.size() - 1;
+	WriteToLogFile( message );
 }
 
 
@@ -144,6 +190,7 @@ void DevConsole::PrintError( const std::string& message )
 {
 	m_logMessages.push_back( DevConsoleLogMessage( message, Rgba8::RED ) );
 	m_latestLogMessageToPrint = (int)m_logMessages.size() - 1;
+	WriteToLogFile( "Error: " + message );
 	Open();
 }
 
@@ -153,6 +200,7 @@ void DevConsole::PrintWarning( const std::string& message )
 {
 	m_logMessages.push_back( DevConsoleLogMessage( message, Rgba8::YELLOW ) );
 	m_latestLogMessageToPrint = (int)m_logMessages.size() - 1;
+	WriteToLogFile( "Warning: " + message );
 }
 
 
@@ -467,13 +515,23 @@ void DevConsole::Close()
 	m_currentCommandStr.clear();
 	SetCursorPosition( 0 );
 	m_currentCommandHistoryPos = (int)m_commandHistory.size();
-	m_inputSystem->PopMouseOptions();
+
+	if ( m_inputSystem != nullptr )
+	{
+		m_inputSystem->PopMouseOptions();
+	}
 }
 
 
 //-----------------------------------------------------------------------------------------------
 void DevConsole::Open()
 {
+	// Without an input system, e.g. on a headless server, there is nothing to type into the console with
+	if ( m_inputSystem == nullptr )
+	{
+		return;
+	}
+
 	if ( !m_isOpen )
 	{
 		m_inputSystem->PushMouseOptions( CURSOR_ABSOLUTE, true, false );
@@ -2,6 +2,7 @@
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 
+#include <iosfwd>
 #include <string>
 #include <vector>
 
@@ -51,6 +52,10 @@ public:
 	void SetInputSystem( InputSystem* inputSystem );
 	void SetBitmapFont( BitmapFont* font );
 
+	// Mirrors every message to a file as well, for when there is no window to show the console in
+	bool OpenLogFile( const std::string& filePath );
+	void CloseLogFile();
+
 	void ProcessInput();
 
 	void PrintString( const std::string& message, const Rgba8& textColor = Rgba8::WHITE );
@@ -92,6 +97,8 @@ private:
 	void UpdateAutoCompleteIdx( bool isReversed, int numCommands );
 	void ExecuteCommand();
 
+	void WriteToLogFile( const std::string& message );
+
 	void SetCommandString( std::string newString );
 	void PasteFromClipboard();
 
@@ -108,6 +115,7 @@ private:
 	Camera* m_devConsoleCamera = nullptr;
 
 	std::vector<DevConsoleLogMessage> m_logMessages;
+	std::ofstream* m_logFile = nullptr;
 	int m_latestLogMessageToPrint = 0;
 
 	std::string m_currentCommandStr;
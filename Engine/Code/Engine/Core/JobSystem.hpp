@@ -59,6 +59,8 @@ public:
 
 	Job* GetBestAvailableJob();
 
+	int GetNumWorkerThreads() const						{ return (int)m_workerThreads.size(); }
+
 private:
 	void StopAllThreads();
 
@@ -0,0 +1,235 @@
+#pragma once
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/RingQueueCommon.hpp"
+
+#include <atomic>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------------------------
+// Bounded lock free queue for any number of producer and consumer threads (Vyukov's bounded queue).
+// Every slot carries a sequence number saying whose turn it is, so a thread claims a slot with one
+// compare exchange on the shared index and publishes it with one store to the slot's sequence.
+// With a single consumer it is the MPSC queue the networking reader threads need.
+template<typename T>
+class MPMCRingQueue
+{
+public:
+	// Waiting costs producers a full memory fence per publish, so queues whose consumer never sleeps leave it off
+	explicit MPMCRingQueue( int capacity, bool canConsumerWait = false );
+	~MPMCRingQueue();
+
+	MPMCRingQueue( const MPMCRingQueue& other ) = delete;
+	MPMCRingQueue& operator=( const MPMCRingQueue& other ) = delete;
+
+	// Returns false when the queue is full
+	bool Push( const T& value );
+	// Stops at the first value that doesn't fit, returns how many were taken so the caller can keep the rest
+	int PushMultiple( const T* values, int numValues );
+
+	bool Pop( T& out_value );
+	// Appends everything that can be popped right now to out_values, returns the number popped
+	int PopAll( std::vector<T>& out_values );
+	// Same as PopAll but sleeps while the queue is empty, only returns 0 once StopWaiting has been called.
+	// Needs canConsumerWait.
+	int WaitAndPopAll( std::vector<T>& out_values );
+
+	void StopWaiting()													{ m_waiter.StopWaiting(); }
+
+	// Only a snapshot when other threads are pushing or popping
+	bool IsEmpty() const;
+	int GetCapacity() const												{ return (int)( m_indexMask + 1 ); }
+
+private:
+	bool PushWithoutNotify( const T& value );
+
+private:
+	struct Slot
+	{
+		std::atomic<size_t> sequence;
+		T value;
+	};
+
+	Slot* m_slots = nullptr;
+	size_t m_indexMask = 0;
+
+	char m_producerPadding[RING_QUEUE_CACHE_LINE_SIZE];
+	std::atomic<size_t> m_writeIdx{ 0 };
+
+	char m_consumerPadding[RING_QUEUE_CACHE_LINE_SIZE];
+	std::atomic<size_t> m_readIdx{ 0 };
+
+	char m_waiterPadding[RING_QUEUE_CACHE_LINE_SIZE];
+	RingQueueWaiter m_waiter;
+	bool m_canConsumerWait = false;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+MPMCRingQueue<T>::MPMCRingQueue( int capacity, bool canConsumerWait )
+	: m_canConsumerWait( canConsumerWait )
+{
+	GUARANTEE_OR_DIE( capacity > 0, "MPMCRingQueue needs a positive capacity" );
+
+	size_t numSlots = GetRingQueueCapacity( capacity );
+	m_slots = new Slot[numSlots];
+	m_indexMask = numSlots - 1;
+
+	for ( size_t slotIdx = 0; slotIdx < numSlots; ++slotIdx )
+	{
+		m_slots[slotIdx].sequence.store( slotIdx, std::memory_order_relaxed );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+MPMCRingQueue<T>::~MPMCRingQueue()
+{
+	delete[] m_slots;
+	m_slots = nullptr;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+bool MPMCRingQueue<T>::Push( const T& value )
+{
+	if ( !PushWithoutNotify( value ) )
+	{
+		return false;
+	}
+
+	if ( m_canConsumerWait )
+	{
+		m_waiter.NotifyIfWaiting();
+	}
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+int MPMCRingQueue<T>::PushMultiple( const T* values, int numValues )
+{
+	int numPushed = 0;
+	while ( numPushed < numValues
+			&& PushWithoutNotify( values[numPushed] ) )
+	{
+		++numPushed;
+	}
+
+	if ( numPushed > 0
+		 && m_canConsumerWait )
+	{
+		m_waiter.NotifyIfWaiting();
+	}
+
+	return numPushed;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+bool MPMCRingQueue<T>::PushWithoutNotify( const T& value )
+{
+	size_t writeIdx = m_writeIdx.load( std::memory_order_relaxed );
+	while ( true )
+	{
+		Slot& slot = m_slots[writeIdx & m_indexMask];
+		size_t sequence = slot.sequence.load( std::memory_order_acquire );
+		ptrdiff_t turnOffset = (ptrdiff_t)sequence - (ptrdiff_t)writeIdx;
+
+		if ( turnOffset == 0 )
+		{
+			// The slot is free for this lap, try to claim it
+			if ( m_writeIdx.compare_exchange_weak( writeIdx, writeIdx + 1, std::memory_order_relaxed ) )
+			{
+				slot.value = value;
+				slot.sequence.store( writeIdx + 1, std::memory_order_release );
+				return true;
+			}
+		}
+		else if ( turnOffset < 0 )
+		{
+			// Still holds a value from the previous lap that hasn't been popped
+			return false;
+		}
+		else
+		{
+			writeIdx = m_writeIdx.load( std::memory_order_relaxed );
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+bool MPMCRingQueue<T>::Pop( T& out_value )
+{
+	size_t readIdx = m_readIdx.load( std::memory_order_relaxed );
+	while ( true )
+	{
+		Slot& slot = m_slots[readIdx & m_indexMask];
+		size_t sequence = slot.sequence.load( std::memory_order_acquire );
+		ptrdiff_t turnOffset = (ptrdiff_t)sequence - (ptrdiff_t)( readIdx + 1 );
+
+		if ( turnOffset == 0 )
+		{
+			if ( m_readIdx.compare_exchange_weak( readIdx, readIdx + 1, std::memory_order_relaxed ) )
+			{
+				out_value = std::move( slot.value );
+
+				// Hand the slot back to producers for the next lap
+				slot.sequence.store( readIdx + m_indexMask + 1, std::memory_order_release );
+				return true;
+			}
+		}
+		else if ( turnOffset < 0 )
+		{
+			return false;
+		}
+		else
+		{
+			readIdx = m_readIdx.load( std::memory_order_relaxed );
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+int MPMCRingQueue<T>::PopAll( std::vector<T>& out_values )
+{
+	int numPopped = 0;
+
+	T value;
+	while ( Pop( value ) )
+	{
+		out_values.push_back( std::move( value ) );
+		++numPopped;
+	}
+
+	return numPopped;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+int MPMCRingQueue<T>::WaitAndPopAll( std::vector<T>& out_values )
+{
+	GUARANTEE_OR_DIE( m_canConsumerWait, "MPMCRingQueue was constructed without canConsumerWait" );
+
+	m_waiter.WaitUntil( [this]() { return !IsEmpty(); } );
+	return PopAll( out_values );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+bool MPMCRingQueue<T>::IsEmpty() const
+{
+	size_t readIdx = m_readIdx.load( std::memory_order_acquire );
+	return m_slots[readIdx & m_indexMask].sequence.load( std::memory_order_acquire ) != readIdx + 1;
+}
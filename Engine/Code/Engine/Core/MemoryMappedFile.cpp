@@ -0,0 +1,77 @@
+#include "Engine/Core/MemoryMappedFile.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+
+//-----------------------------------------------------------------------------------------------
+MemoryMappedFile::~MemoryMappedFile()
+{
+	Close();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool MemoryMappedFile::Open( const std::string& filename )
+{
+	Close();
+
+	HANDLE fileHandle = CreateFileA( filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+	if ( fileHandle == INVALID_HANDLE_VALUE )
+	{
+		return false;
+	}
+	m_fileHandle = fileHandle;
+
+	LARGE_INTEGER fileSize;
+	if ( !GetFileSizeEx( fileHandle, &fileSize )
+		 || fileSize.QuadPart == 0 )
+	{
+		// Empty files can't be mapped
+		Close();
+		return false;
+	}
+
+	HANDLE mappingHandle = CreateFileMappingA( fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+	if ( mappingHandle == nullptr )
+	{
+		Close();
+		return false;
+	}
+	m_mappingHandle = mappingHandle;
+
+	m_data = (const byte*)MapViewOfFile( mappingHandle, FILE_MAP_READ, 0, 0, 0 );
+	if ( m_data == nullptr )
+	{
+		Close();
+		return false;
+	}
+
+	m_size = (uint64_t)fileSize.QuadPart;
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void MemoryMappedFile::Close()
+{
+	if ( m_data != nullptr )
+	{
+		UnmapViewOfFile( m_data );
+		m_data = nullptr;
+	}
+
+	if ( m_mappingHandle != nullptr )
+	{
+		CloseHandle( (HANDLE)m_mappingHandle );
+		m_mappingHandle = nullptr;
+	}
+
+	if ( m_fileHandle != nullptr )
+	{
+		CloseHandle( (HANDLE)m_fileHandle );
+		m_fileHandle = nullptr;
+	}
+
+	m_size = 0;
+}
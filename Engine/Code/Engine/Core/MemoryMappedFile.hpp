@@ -0,0 +1,32 @@
+#pragma once
+#include "Engine/Core/EngineCommon.hpp"
+
+#include <string>
+
+
+//-----------------------------------------------------------------------------------------------
+// Read only view of a whole file, the OS pages the contents in on demand instead of copying
+// everything into a new buffer up front. The view starts on a page boundary.
+class MemoryMappedFile
+{
+public:
+	MemoryMappedFile() = default;
+	~MemoryMappedFile();
+
+	MemoryMappedFile( const MemoryMappedFile& other ) = delete;
+	MemoryMappedFile& operator=( const MemoryMappedFile& other ) = delete;
+
+	bool Open( const std::string& filename );
+	void Close();
+
+	bool		IsOpen() const												{ return m_data != nullptr; }
+	const byte* GetData() const												{ return m_data; }
+	uint64_t	GetSize() const												{ return m_size; }
+
+private:
+	void* m_fileHandle = nullptr;
+	void* m_mappingHandle = nullptr;
+
+	const byte* m_data = nullptr;
+	uint64_t m_size = 0;
+};
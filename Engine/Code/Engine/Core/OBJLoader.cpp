@@ -1,6 +1,8 @@
 #include "Engine/Core/ObjLoader.hpp"
 #include "Engine/Core/DevConsole.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/FileUtils.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/Vertex_PCUTBN.hpp"
 #include "Engine/Math/MathUtils.hpp"
@@ -11,217 +13,737 @@
 #include "Engine/Time/Time.hpp"
 #include "ThirdParty/mikkt/mikktspace.h"
 
-#include <iostream>
-#include <fstream>
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <unordered_map>
 
 
 //-----------------------------------------------------------------------------------------------
-void ObjLoader::LoadFromFile( std::vector<Vertex_PCUTBN>& vertices,
-							  const std::string& filename,
-							  bool& out_fileHadNormals )
+// Obj parsing
+//
+// The whole file is read into one buffer and tokenized in place, numbers are parsed straight out
+// of the buffer without building any strings. Large files can be split on line boundaries and the
+// pieces parsed on separate threads, a quick counting pass first gives every piece the number of
+// v/vt/vn lines before it so relative face indices can be resolved while parsing.
+//-----------------------------------------------------------------------------------------------
+constexpr int OBJ_INDEX_NOT_GIVEN = INT_MIN;		// v or v/vt, the vertex has no entry for this attribute
+constexpr int OBJ_INDEX_INHERIT = INT_MIN + 1;		// v//vn, the entry is empty so the last given index is reused
+
+
+//-----------------------------------------------------------------------------------------------
+enum class eObjLineType
 {
-	double startTime = GetCurrentTimeSeconds();
+	NONE,
+	POSITION,
+	NORMAL,
+	UV,
+	UNSUPPORTED_UV,			// vt with a component count we can't use, warned about and not added
+	FACE,
+	METADATA,
+	MATERIAL_LIBRARY,
+};
+
 
+//-----------------------------------------------------------------------------------------------
+struct ObjMetadataLine
+{
 	std::string line;
-	std::ifstream objFile;
-	objFile.open( filename, std::ios::in );
+	int lineNum = 0;
+};
 
-	if ( !objFile.is_open() )
-	{
-		// Load error model
-		return;
-	}
+
+//-----------------------------------------------------------------------------------------------
+struct ObjFileSection
+{
+	const char* start = nullptr;
+	const char* end = nullptr;
+
+	// Counts of everything before this section in the file
+	int firstLineNum = 0;
+	int numPositionsBefore = 0;
+	int numNormalsBefore = 0;
+	int numUVsBefore = 0;
+
+	// Counts inside this section, filled in by the counting pass
+	int numLines = 0;
+	int numPositions = 0;
+	int numNormals = 0;
+	int numUVs = 0;
 
 	std::vector<Vec3> positions;
 	std::vector<Vec3> normals;
 	std::vector<Vec3> uvTexCoords;
 	std::vector<ObjFace> faces;
-	ObjVertex lastObjVertex;
-	Mat44 scaleTransform = Mat44::IDENTITY;
-	OrientationMetaData orientationMetaData;
-	int lineNum = 0;
-	while ( std::getline( objFile, line ) )
+	std::vector<ObjMetadataLine> metadataLines;
+	Strings warnings;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+static bool IsObjWhitespace( char c )
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static const char* SkipObjWhitespace( const char* cursor, const char* lineEnd )
+{
+	while ( cursor < lineEnd && IsObjWhitespace( *cursor ) )
 	{
-		++lineNum;
+		++cursor;
+	}
 
-		line = TrimOuterWhitespace( line );
-		
-		if ( IsEmptyOrWhitespace( line ) )
+	return cursor;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static const char* SkipObjToken( const char* cursor, const char* lineEnd )
+{
+	while ( cursor < lineEnd && !IsObjWhitespace( *cursor ) )
+	{
+		++cursor;
+	}
+
+	return cursor;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static const char* FindObjLineEnd( const char* cursor, const char* bufferEnd )
+{
+	const char* lineEnd = (const char*)memchr( cursor, '\n', bufferEnd - cursor );
+	return lineEnd != nullptr ? lineEnd : bufferEnd;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static bool IsObjKeyword( const char* token, const char* tokenEnd, const char* keyword )
+{
+	size_t keywordLength = strlen( keyword );
+	return (size_t)( tokenEnd - token ) == keywordLength
+		&& memcmp( token, keyword, keywordLength ) == 0;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Parses a float the same way (float)atof would. Plain decimals with at most 19 significant digits
+// and a small exponent are computed exactly in a double (a single correctly rounded multiply or divide
+// by an exact power of 10), anything else falls back to strtod.
+//-----------------------------------------------------------------------------------------------
+static const char* ParseObjFloat( const char* cursor, const char* tokenEnd, float& out_value )
+{
+	static const double s_exactPowersOf10[] =
+	{
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	const char* numberStart = cursor;
+
+	bool isNegative = false;
+	if ( cursor < tokenEnd && ( *cursor == '-' || *cursor == '+' ) )
+	{
+		isNegative = *cursor == '-';
+		++cursor;
+	}
+
+	uint64_t mantissa = 0;
+	int numSignificantDigits = 0;
+	int numDigits = 0;
+	int exponent = 0;
+
+	while ( cursor < tokenEnd && *cursor >= '0' && *cursor <= '9' )
+	{
+		if ( mantissa != 0 || *cursor != '0' )
 		{
-			continue;
+			++numSignificantDigits;
 		}
 
-		Strings dataStrings = SplitStringOnDelimiter( line, ' ' );
-		dataStrings = TrimOuterWhitespace( dataStrings );
+		mantissa = mantissa * 10 + (uint64_t)( *cursor - '0' );
+		++numDigits;
+		++cursor;
+	}
 
-		if ( dataStrings[0] == "mtllib" )
+	if ( cursor < tokenEnd && *cursor == '.' )
+	{
+		++cursor;
+		while ( cursor < tokenEnd && *cursor >= '0' && *cursor <= '9' )
 		{
-			// TODO: Handle materials
+			if ( mantissa != 0 || *cursor != '0' )
+			{
+				++numSignificantDigits;
+			}
+
+			mantissa = mantissa * 10 + (uint64_t)( *cursor - '0' );
+			--exponent;
+			++numDigits;
+			++cursor;
 		}
-		else if ( dataStrings[0] == "#SquirrelMeta" )
+	}
+
+	bool canUseFastPath = numDigits > 0 && numSignificantDigits <= 19;
+
+	if ( canUseFastPath
+		 && cursor < tokenEnd 
+		 && ( *cursor == 'e' || *cursor == 'E' ) )
+	{
+		++cursor;
+
+		bool isExponentNegative = false;
+		if ( cursor < tokenEnd && ( *cursor == '-' || *cursor == '+' ) )
 		{
-			ParseMetadata( dataStrings, lineNum, scaleTransform, orientationMetaData );
+			isExponentNegative = *cursor == '-';
+			++cursor;
 		}
-		else if( dataStrings[0] == "v" )
+
+		int explicitExponent = 0;
+		int numExponentDigits = 0;
+		while ( cursor < tokenEnd && *cursor >= '0' && *cursor <= '9' )
 		{
-			AppendVertexData( dataStrings, positions );
+			if ( explicitExponent < 10000 )
+			{
+				explicitExponent = explicitExponent * 10 + ( *cursor - '0' );
+			}
+			++numExponentDigits;
+			++cursor;
 		}
-		else if ( dataStrings[0] == "vn" )
+
+		canUseFastPath = numExponentDigits > 0;
+		exponent += isExponentNegative ? -explicitExponent : explicitExponent;
+	}
+
+	if ( canUseFastPath
+		 && cursor == tokenEnd
+		 && mantissa <= ( 1ULL << 53 )
+		 && exponent >= -22 
+		 && exponent <= 22 )
+	{
+		double value = (double)mantissa;
+		value = exponent < 0 ? value / s_exactPowersOf10[-exponent] : value * s_exactPowersOf10[exponent];
+		out_value = (float)( isNegative ? -value : value );
+		return cursor;
+	}
+
+	// Rare formats (long mantissas, big exponents, inf/nan, hex), copy the token so strtod can't run past it
+	char numberText[128];
+	size_t numberLength = tokenEnd - numberStart;
+	if ( numberLength >= sizeof( numberText ) )
+	{
+		numberLength = sizeof( numberText ) - 1;
+	}
+	memcpy( numberText, numberStart, numberLength );
+	numberText[numberLength] = '\0';
+
+	out_value = (float)strtod( numberText, nullptr );
+	return tokenEnd;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static const char* ParseObjInt( const char* cursor, const char* tokenEnd, int& out_value )
+{
+	bool isNegative = false;
+	if ( cursor < tokenEnd && ( *cursor == '-' || *cursor == '+' ) )
+	{
+		isNegative = *cursor == '-';
+		++cursor;
+	}
+
+	int value = 0;
+	while ( cursor < tokenEnd && *cursor >= '0' && *cursor <= '9' )
+	{
+		value = value * 10 + ( *cursor - '0' );
+		++cursor;
+	}
+
+	out_value = isNegative ? -value : value;
+	return cursor;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static int ParseObjVec3( const char* cursor, const char* lineEnd, Vec3& out_vec )
+{
+	float components[3] = { 0.f, 0.f, 0.f };
+
+	int numComponents = 0;
+	cursor = SkipObjWhitespace( cursor, lineEnd );
+	while ( cursor < lineEnd )
+	{
+		const char* tokenEnd = SkipObjToken( cursor, lineEnd );
+		if ( numComponents < 3 )
 		{
-			AppendVertexData( dataStrings, normals );
+			ParseObjFloat( cursor, tokenEnd, components[numComponents] );
 		}
-		else if ( dataStrings[0] == "vt" )
+
+		++numComponents;
+		cursor = SkipObjWhitespace( tokenEnd, lineEnd );
+	}
+
+	out_vec = Vec3( components[0], components[1], components[2] );
+	return numComponents;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static int CountObjTokens( const char* cursor, const char* lineEnd )
+{
+	int numTokens = 0;
+	cursor = SkipObjWhitespace( cursor, lineEnd );
+	while ( cursor < lineEnd )
+	{
+		++numTokens;
+		cursor = SkipObjWhitespace( SkipObjToken( cursor, lineEnd ), lineEnd );
+	}
+
+	return numTokens;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// The counting and parsing passes both classify lines here, so the v/vt/vn counts given to each
+// section always match what the sections before it actually added
+//-----------------------------------------------------------------------------------------------
+static eObjLineType ClassifyObjLine( const char* cursor, const char* lineEnd, const char*& out_lineData )
+{
+	const char* keyword = SkipObjWhitespace( cursor, lineEnd );
+	const char* keywordEnd = SkipObjToken( keyword, lineEnd );
+	out_lineData = keywordEnd;
+
+	if ( keyword == keywordEnd )									{ return eObjLineType::NONE; }
+	if ( IsObjKeyword( keyword, keywordEnd, "v" ) )					{ return eObjLineType::POSITION; }
+	if ( IsObjKeyword( keyword, keywordEnd, "vn" ) )				{ return eObjLineType::NORMAL; }
+	if ( IsObjKeyword( keyword, keywordEnd, "f" ) )					{ return eObjLineType::FACE; }
+	if ( IsObjKeyword( keyword, keywordEnd, "#SquirrelMeta" ) )		{ return eObjLineType::METADATA; }
+	if ( IsObjKeyword( keyword, keywordEnd, "mtllib" ) )			{ return eObjLineType::MATERIAL_LIBRARY; }
+	if ( IsObjKeyword( keyword, keywordEnd, "vt" ) )
+	{
+		int numComponents = CountObjTokens( keywordEnd, lineEnd );
+		return numComponents >= 2 && numComponents <= 3 ? eObjLineType::UV : eObjLineType::UNSUPPORTED_UV;
+	}
+
+	return eObjLineType::NONE;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Converts a 1 based (or negative, relative to the end) obj index into a 0 based array index
+//-----------------------------------------------------------------------------------------------
+static int ResolveObjIndex( int objIndex, int numDefinedSoFar )
+{
+	return objIndex < 0 ? numDefinedSoFar + objIndex : objIndex - 1;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Face entries will always be in the form v/vt/vn with both vt and vn being optional
+//-----------------------------------------------------------------------------------------------
+static ObjVertex ParseObjFaceVertex( const char* cursor, const char* tokenEnd, int numPositions, int numUVs, int numNormals )
+{
+	ObjVertex vertex;
+	vertex.uv = OBJ_INDEX_NOT_GIVEN;
+	vertex.normal = OBJ_INDEX_NOT_GIVEN;
+
+	int objIndex = 0;
+	if ( cursor < tokenEnd && *cursor != '/' )
+	{
+		cursor = ParseObjInt( cursor, tokenEnd, objIndex );
+		vertex.position = ResolveObjIndex( objIndex, numPositions );
+	}
+
+	// Check if we have texture coords
+	if ( cursor < tokenEnd && *cursor == '/' )
+	{
+		++cursor;
+		vertex.uv = OBJ_INDEX_INHERIT;
+		if ( cursor < tokenEnd && *cursor != '/' )
 		{
-			AppendVertexUVs( dataStrings, uvTexCoords );
+			cursor = ParseObjInt( cursor, tokenEnd, objIndex );
+			vertex.uv = ResolveObjIndex( objIndex, numUVs );
 		}
-		else if ( dataStrings[0] == "f" )
+	}
+
+	// Check if we have normals
+	if ( cursor < tokenEnd && *cursor == '/' )
+	{
+		++cursor;
+		vertex.normal = OBJ_INDEX_INHERIT;
+		if ( cursor < tokenEnd )
 		{
-			AppendFace( dataStrings, faces, lastObjVertex );
+			ParseObjInt( cursor, tokenEnd, objIndex );
+			vertex.normal = ResolveObjIndex( objIndex, numNormals );
 		}
 	}
 
-	objFile.close();
+	return vertex;
+}
 
-	//g_devConsole->PrintString( Stringf( "Processing obj file took: %f s", GetCurrentTimeSeconds() - startTime ) );
-	startTime = GetCurrentTimeSeconds();
 
-	for( uint faceIdx = 0; faceIdx < faces.size(); ++faceIdx )
+//-----------------------------------------------------------------------------------------------
+static void CountObjFileSection( ObjFileSection& section )
+{
+	const char* cursor = section.start;
+	while ( cursor < section.end )
 	{
-		const ObjFace& face = faces[faceIdx];
-		Vertex_PCUTBN faceVertices[3];
-		for ( int faceVertIdx = 0; faceVertIdx < 3; ++faceVertIdx )
+		const char* lineEnd = FindObjLineEnd( cursor, section.end );
+		++section.numLines;
+
+		const char* lineData = nullptr;
+		eObjLineType lineType = ClassifyObjLine( cursor, lineEnd, lineData );
+		if ( lineType == eObjLineType::POSITION )		{ ++section.numPositions; }
+		else if ( lineType == eObjLineType::NORMAL )	{ ++section.numNormals; }
+		else if ( lineType == eObjLineType::UV )		{ ++section.numUVs; }
+
+		cursor = lineEnd + 1;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static void ParseObjFileSection( ObjFileSection& section )
+{
+	section.positions.reserve( section.numPositions );
+	section.normals.reserve( section.numNormals );
+	section.uvTexCoords.reserve( section.numUVs );
+	section.faces.reserve( section.numPositions * 2 );
+
+	std::vector<ObjVertex> polygonVertices;
+
+	int lineNum = section.firstLineNum;
+	const char* cursor = section.start;
+	while ( cursor < section.end )
+	{
+		const char* lineEnd = FindObjLineEnd( cursor, section.end );
+		const char* lineStart = cursor;
+		const char* nextLine = lineEnd + 1;
+		++lineNum;
+
+		const char* lineData = nullptr;
+		eObjLineType lineType = ClassifyObjLine( cursor, lineEnd, lineData );
+
+		if ( lineType == eObjLineType::POSITION )
 		{
-			Vertex_PCUTBN& vertex = faceVertices[faceVertIdx];
+			Vec3 position;
+			ParseObjVec3( lineData, lineEnd, position );
+			section.positions.push_back( position );
+		}
+		else if ( lineType == eObjLineType::NORMAL )
+		{
+			Vec3 normal;
+			ParseObjVec3( lineData, lineEnd, normal );
+			section.normals.push_back( normal );
+		}
+		else if ( lineType == eObjLineType::UV )
+		{
+			Vec3 uv;
+			ParseObjVec3( lineData, lineEnd, uv );
+			section.uvTexCoords.push_back( uv );
+		}
+		else if ( lineType == eObjLineType::UNSUPPORTED_UV )
+		{
+			section.warnings.push_back( Stringf( "Unsupported number of vertices: %d", CountObjTokens( lineData, lineEnd ) ) );
+		}
+		else if ( lineType == eObjLineType::FACE )
+		{
+			int numPositions = section.numPositionsBefore + (int)section.positions.size();
+			int numUVs = section.numUVsBefore + (int)section.uvTexCoords.size();
+			int numNormals = section.numNormalsBefore + (int)section.normals.size();
 
-			int indexIntoVertArray = face.vertices[faceVertIdx].position;
-			if ( indexIntoVertArray >= 0 )
+			polygonVertices.clear();
+			const char* token = SkipObjWhitespace( lineData, lineEnd );
+			while ( token < lineEnd )
 			{
-				vertex.position = positions[indexIntoVertArray];
+				const char* tokenEnd = SkipObjToken( token, lineEnd );
+				polygonVertices.push_back( ParseObjFaceVertex( token, tokenEnd, numPositions, numUVs, numNormals ) );
+				token = SkipObjWhitespace( tokenEnd, lineEnd );
+			}
+
+			if ( polygonVertices.size() < 3 )
+			{
+				section.warnings.push_back( Stringf( "Unsupported number of faces: %d", (int)polygonVertices.size() ) );
 			}
 			else
 			{
-				size_t indexFromEnd = positions.size() - indexIntoVertArray;
-				if ( indexFromEnd >= 0 )
+				// Triangulate as a fan around the first vertex, for quads this matches 0,1,2 and 0,2,3
+				for ( int polygonVertIdx = 2; polygonVertIdx < (int)polygonVertices.size(); ++polygonVertIdx )
 				{
-					vertex.position = positions[indexFromEnd];
+					ObjFace face;
+					face.vertices[0] = polygonVertices[0];
+					face.vertices[1] = polygonVertices[polygonVertIdx - 1];
+					face.vertices[2] = polygonVertices[polygonVertIdx];
+					section.faces.push_back( face );
 				}
 			}
+		}
+		else if ( lineType == eObjLineType::METADATA )
+		{
+			// Metadata is rare and reports errors, so keep the line and parse it on the loading thread
+			ObjMetadataLine metadataLine;
+			metadataLine.line = std::string( lineStart, lineEnd );
+			metadataLine.lineNum = lineNum;
+			section.metadataLines.push_back( metadataLine );
+		}
+		else if ( lineType == eObjLineType::MATERIAL_LIBRARY )
+		{
+			// TODO: Handle materials
+		}
 
-			int uvIdx = face.vertices[faceVertIdx].uv;
-			if( uvIdx != -1 )
+		cursor = nextLine;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static void SplitObjFileIntoSections( const char* buffer, size_t bufferSize, int numSections, std::vector<ObjFileSection>& out_sections )
+{
+	const char* bufferEnd = buffer + bufferSize;
+	const char* sectionStart = buffer;
+
+	for ( int sectionIdx = 0; sectionIdx < numSections; ++sectionIdx )
+	{
+		const char* sectionEnd = bufferEnd;
+		if ( sectionIdx < numSections - 1 )
+		{
+			// Move the split point forward to the start of the next line
+			sectionEnd = buffer + ( bufferSize * ( sectionIdx + 1 ) ) / numSections;
+			if ( sectionEnd < sectionStart )
 			{
-				vertex.uvTexCoords = uvTexCoords[uvIdx].XY();
+				sectionEnd = sectionStart;
 			}
-
-			int normalIdx = face.vertices[faceVertIdx].normal;
-			if ( normalIdx != -1 )
+			sectionEnd = FindObjLineEnd( sectionEnd, bufferEnd );
+			if ( sectionEnd < bufferEnd )
 			{
-				vertex.normal = normals[normalIdx].GetNormalized();
+				++sectionEnd;
 			}
-			
-			vertices.push_back( vertex );
 		}
 
-		out_fileHadNormals = normals.size() != 0;
-	}
-	
-	TransformVerts( vertices, scaleTransform );
-	TransformVerts( vertices, orientationMetaData.orientationMatrix );
+		if ( sectionEnd > sectionStart )
+		{
+			ObjFileSection section;
+			section.start = sectionStart;
+			section.end = sectionEnd;
+			out_sections.push_back( section );
+		}
 
-	if ( orientationMetaData.invertWindingOrder )
-	{
-		InvertVertWindingOrder( vertices );
+		sectionStart = sectionEnd;
 	}
-
-	//g_devConsole->PrintString( Stringf( "Appending verts took: %f s", GetCurrentTimeSeconds() - startTime ) );
 }
 
 
 //-----------------------------------------------------------------------------------------------
-bool ObjLoader::AppendVertexData( const Strings& dataStrings, std::vector<Vec3>& data )
+template <typename FUNC_TYPE>
+static void RunOnObjFileSections( std::vector<ObjFileSection>& sections, FUNC_TYPE sectionFunction )
 {
-	float x = 0.f;
-	float y = 0.f;
-	float z = 0.f;
-	
-	if ( dataStrings.size() > 1 )
+	if ( sections.size() == 1 )
 	{
-		x = (float)atof( dataStrings[1].c_str() );
+		sectionFunction( sections[0] );
+		return;
 	}
-	if ( dataStrings.size() > 2 )
+
+	std::vector<std::thread> threads;
+	threads.reserve( sections.size() );
+	for ( int sectionIdx = 0; sectionIdx < (int)sections.size(); ++sectionIdx )
 	{
-		y = (float)atof( dataStrings[2].c_str() );
+		threads.emplace_back( sectionFunction, std::ref( sections[sectionIdx] ) );
 	}
-	if ( dataStrings.size() > 3 )
+
+	for ( int threadIdx = 0; threadIdx < (int)threads.size(); ++threadIdx )
 	{
-		z = (float)atof( dataStrings[3].c_str() );
+		threads[threadIdx].join();
 	}
+}
 
-	data.push_back( Vec3( x, y, z ) );
 
-	return true;
+//-----------------------------------------------------------------------------------------------
+// Empty vt/vn entries reuse the last index given, which depends on every face before it in the file
+//-----------------------------------------------------------------------------------------------
+static int ResolveInheritedObjIndex( int index, int& lastIndex )
+{
+	if ( index == OBJ_INDEX_NOT_GIVEN )
+	{
+		return -1;
+	}
+
+	if ( index == OBJ_INDEX_INHERIT )
+	{
+		return lastIndex;
+	}
+
+	lastIndex = index;
+	return index;
 }
 
 
 //-----------------------------------------------------------------------------------------------
-bool ObjLoader::AppendVertexUVs( const Strings& dataStrings, std::vector<Vec3>& data )
+void ObjLoader::LoadFromFile( std::vector<Vertex_PCUTBN>& vertices,
+							  const std::string& filename,
+							  bool& out_fileHadNormals,
+							  int numThreads )
 {
-	if ( dataStrings.size() < 3 
-		 || dataStrings.size() > 4 )
+	double startTime = GetCurrentTimeSeconds();
+
+	char* fileBuffer = (char*)FileReadToNewBuffer( filename );
+	if ( fileBuffer == nullptr )
 	{
-		g_devConsole->PrintString( Stringf( "Unsupported number of vertices: %d", dataStrings.size() - 1 ), Rgba8::YELLOW );
-		return false;
+		// Load error model
+		return;
 	}
 
-	float u = ConvertStringToFloat( dataStrings[1] );
-	float v = ConvertStringToFloat( dataStrings[2] );
+	// Only worth splitting when each thread gets a decent amount of work
+	constexpr size_t MIN_BYTES_PER_THREAD = 1024 * 1024;
+
+	size_t fileSize = strlen( fileBuffer );
+	int maxUsefulThreads = (int)( fileSize / MIN_BYTES_PER_THREAD ) + 1;
+	numThreads = ClampMinMaxInt( numThreads, 1, maxUsefulThreads );
+
+	std::vector<ObjFileSection> sections;
+	SplitObjFileIntoSections( fileBuffer, fileSize, numThreads, sections );
+
+	RunOnObjFileSections( sections, CountObjFileSection );
 
-	float w = 0.f;
-	if( dataStrings.size() == 4 )
+	int numPositions = 0;
+	int numNormals = 0;
+	int numUVs = 0;
+	int numLines = 0;
+	for ( int sectionIdx = 0; sectionIdx < (int)sections.size(); ++sectionIdx )
 	{
-		w = ConvertStringToFloat( dataStrings[3] );
+		ObjFileSection& section = sections[sectionIdx];
+		section.firstLineNum = numLines;
+		section.numPositionsBefore = numPositions;
+		section.numNormalsBefore = numNormals;
+		section.numUVsBefore = numUVs;
+
+		numLines += section.numLines;
+		numPositions += section.numPositions;
+		numNormals += section.numNormals;
+		numUVs += section.numUVs;
 	}
 
-	data.push_back( Vec3( u, v, w ) );
+	RunOnObjFileSections( sections, ParseObjFileSection );
 
-	return true;
-}
+	delete[] fileBuffer;
+	fileBuffer = nullptr;
 
+	// Merge the small per attribute arrays, faces are read straight out of each section below
+	std::vector<Vec3> positions;
+	std::vector<Vec3> normals;
+	std::vector<Vec3> uvTexCoords;
+	positions.reserve( numPositions );
+	normals.reserve( numNormals );
+	uvTexCoords.reserve( numUVs );
 
-//-----------------------------------------------------------------------------------------------
-bool ObjLoader::AppendFace( const Strings& dataStrings, std::vector<ObjFace>& data, ObjVertex& lastObjVertex )
-{
-	if ( dataStrings.size() < 4 
-		 || dataStrings.size() > 5 )
+	Mat44 scaleTransform = Mat44::IDENTITY;
+	OrientationMetaData orientationMetaData;
+
+	size_t numFaces = 0;
+	for ( int sectionIdx = 0; sectionIdx < (int)sections.size(); ++sectionIdx )
 	{
-		g_devConsole->PrintString( Stringf( "Unsupported number of faces: %d", dataStrings.size() - 1 ), Rgba8::YELLOW );
-		return false;
+		ObjFileSection& section = sections[sectionIdx];
+		positions.insert( positions.end(), section.positions.begin(), section.positions.end() );
+		normals.insert( normals.end(), section.normals.begin(), section.normals.end() );
+		uvTexCoords.insert( uvTexCoords.end(), section.uvTexCoords.begin(), section.uvTexCoords.end() );
+		numFaces += section.faces.size();
+
+		for ( int metadataIdx = 0; metadataIdx < (int)section.metadataLines.size(); ++metadataIdx )
+		{
+			const ObjMetadataLine& metadataLine = section.metadataLines[metadataIdx];
+
+			Strings dataStrings = SplitStringOnDelimiter( TrimOuterWhitespace( metadataLine.line ), ' ' );
+			dataStrings = TrimOuterWhitespace( dataStrings );
+
+			ParseMetadata( dataStrings, metadataLine.lineNum, scaleTransform, orientationMetaData );
+		}
+
+		for ( int warningIdx = 0; warningIdx < (int)section.warnings.size(); ++warningIdx )
+		{
+			g_devConsole->PrintString( section.warnings[warningIdx], Rgba8::YELLOW );
+		}
+
+		section.positions = std::vector<Vec3>();
+		section.normals = std::vector<Vec3>();
+		section.uvTexCoords = std::vector<Vec3>();
 	}
 
-	ObjVertex vert0( CreateObjVertexFromString( dataStrings[1], lastObjVertex ) );
-	ObjVertex vert1( CreateObjVertexFromString( dataStrings[2], lastObjVertex ) );
-	ObjVertex vert2( CreateObjVertexFromString( dataStrings[3], lastObjVertex ) );
+	//g_devConsole->PrintString( Stringf( "Processing obj file took: %f s", GetCurrentTimeSeconds() - startTime ) );
+	startTime = GetCurrentTimeSeconds();
 
-	ObjFace face0;
-	face0.vertices[0] = vert0;
-	face0.vertices[1] = vert1;
-	face0.vertices[2] = vert2;
-	
-	data.push_back( face0 );
+	// Positions and normals are shared between faces, so transform each one once here rather than
+	// every vertex after the mesh is built. Same math and order as TransformVerts.
+	Mat44 scaleDirectionMatrix = scaleTransform.GetNormalizedDirectionMatrix3D();
+	Mat44 orientationDirectionMatrix = orientationMetaData.orientationMatrix.GetNormalizedDirectionMatrix3D();
+	for ( int positionIdx = 0; positionIdx < (int)positions.size(); ++positionIdx )
+	{
+		Vec3& position = positions[positionIdx];
+		position = scaleTransform.TransformPosition3D( position );
+		position = orientationMetaData.orientationMatrix.TransformPosition3D( position );
+	}
 
-	if( dataStrings.size() == 5 )
+	for ( int normalIdx = 0; normalIdx < (int)normals.size(); ++normalIdx )
 	{
-		ObjVertex vert3( CreateObjVertexFromString( dataStrings[4], lastObjVertex ) );
+		Vec3& normal = normals[normalIdx];
+		normal = normal.GetNormalized();
+		normal = scaleDirectionMatrix.TransformVector3D( normal );
+		normal = orientationDirectionMatrix.TransformVector3D( normal );
+	}
 
-		ObjFace face1;
-		face1.vertices[0] = vert0;
-		face1.vertices[1] = vert2;
-		face1.vertices[2] = vert3;
+	vertices.reserve( vertices.size() + numFaces * 3 );
 
-		data.push_back( face1 );
+	int lastUVIdx = -1;
+	int lastNormalIdx = -1;
+	for ( int sectionIdx = 0; sectionIdx < (int)sections.size(); ++sectionIdx )
+	{
+		const std::vector<ObjFace>& faces = sections[sectionIdx].faces;
+		for( uint faceIdx = 0; faceIdx < faces.size(); ++faceIdx )
+		{
+			const ObjFace& face = faces[faceIdx];
+			for ( int faceVertIdx = 0; faceVertIdx < 3; ++faceVertIdx )
+			{
+				Vertex_PCUTBN vertex;
+
+				int positionIdx = face.vertices[faceVertIdx].position;
+				if ( positionIdx >= 0 
+					 && positionIdx < (int)positions.size() )
+				{
+					vertex.position = positions[positionIdx];
+				}
+
+				int uvIdx = ResolveInheritedObjIndex( face.vertices[faceVertIdx].uv, lastUVIdx );
+				if( uvIdx >= 0
+					&& uvIdx < (int)uvTexCoords.size() )
+				{
+					vertex.uvTexCoords = uvTexCoords[uvIdx].XY();
+				}
+
+				int normalIdx = ResolveInheritedObjIndex( face.vertices[faceVertIdx].normal, lastNormalIdx );
+				if ( normalIdx >= 0
+					 && normalIdx < (int)normals.size() )
+				{
+					vertex.normal = normals[normalIdx];
+				}
+			
+				vertices.push_back( vertex );
+			}
+		}
+
+		sections[sectionIdx] = ObjFileSection();
 	}
 
-	return true;
+	if ( numFaces > 0 )
+	{
+		out_fileHadNormals = normals.size() != 0;
+	}
+
+	if ( orientationMetaData.invertWindingOrder )
+	{
+		InvertVertWindingOrder( vertices );
+	}
+
+	//g_devConsole->PrintString( Stringf( "Appending verts took: %f s", GetCurrentTimeSeconds() - startTime ) );
 }
 
 
@@ -335,47 +857,6 @@ Vec3 ObjLoader::GetVecForRelativeDir( const std::string& relativeDir )
 }
 
 
-//-----------------------------------------------------------------------------------------------
-// Face entries will always be in the form v/vt/vn with both vt and vn being optional
-//-----------------------------------------------------------------------------------------------
-ObjVertex ObjLoader::CreateObjVertexFromString( const std::string& indexStr, ObjVertex& lastObjVertex )
-{
-	Strings indicesStr = SplitStringOnDelimiter( indexStr, '/' );
-
-	ObjVertex newVertex;
-	// Subtract 1 to line up the indices with arrays
-	if( !indicesStr[0].empty() )
-	{
-		newVertex.position = ConvertStringToInt( indicesStr[0] ) - 1;
-		lastObjVertex.position = newVertex.position;
-	}
-
-	// Check if we have texture coords
-	if( indicesStr.size() > 1 )
-	{
-		if ( !indicesStr[1].empty() )
-		{
-			lastObjVertex.uv = ConvertStringToInt( indicesStr[1] ) - 1;
-		}
-
-		newVertex.uv = lastObjVertex.uv;
-	}
-
-	// Check if we have normals
-	if ( indicesStr.size() > 2 )
-	{
-		if ( !indicesStr[2].empty() )
-		{
-			lastObjVertex.normal = ConvertStringToInt( indicesStr[2] ) - 1;
-		}
-
-		newVertex.normal = lastObjVertex.normal;
-	}
-		
-	return newVertex;
-}
-
-
 //-----------------------------------------------------------------------------------------------
 void ObjLoader::InvertVertVs( std::vector<Vertex_PCUTBN>& vertices )
 {
@@ -449,40 +930,134 @@ void ObjLoader::TransformVerts( std::vector<Vertex_PCUTBN>& vertices, const Mat4
 
 
 //-----------------------------------------------------------------------------------------------
-void ObjLoader::CleanMesh( std::vector<Vertex_PCUTBN>& vertices, std::vector<uint>& indices )
+// Vertex welding
+//-----------------------------------------------------------------------------------------------
+static bool AreVerticesWeldable( const Vertex_PCUTBN& vertA, const Vertex_PCUTBN& vertB, float positionEpsilon )
+{
+	return IsNearlyEqual( vertA.position, vertB.position, positionEpsilon )
+		&& vertA.color == vertB.color
+		&& IsNearlyEqual( vertA.uvTexCoords, vertB.uvTexCoords )
+		&& IsNearlyEqual( vertA.normal, vertB.normal )
+		&& IsNearlyEqual( vertA.tangent, vertB.tangent )
+		&& IsNearlyEqual( vertA.bitangent, vertB.bitangent );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static int64_t GetWeldCellCoord( float value, float cellSize )
+{
+	return (int64_t)floor( (double)value / (double)cellSize );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static uint64_t GetWeldCellKey( int64_t cellX, int64_t cellY, int64_t cellZ )
+{
+	return ( (uint64_t)cellX * 73856093ULL ) ^ ( (uint64_t)cellY * 19349663ULL ) ^ ( (uint64_t)cellZ * 83492791ULL );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Unique vertices are bucketed by position into cells twice the epsilon wide, so every vertex that
+// can compare equal to a new one sits in the 1-8 cells its +/- epsilon box overlaps. Buckets keep
+// their vertices in insertion order and the lowest matching index across them wins, which is the
+// same vertex the old linear scan over all unique vertices would have found first.
+//-----------------------------------------------------------------------------------------------
+void ObjLoader::CleanMesh( std::vector<Vertex_PCUTBN>& vertices, std::vector<uint>& indices, float positionEpsilon )
 {
 	//size_t bytesBefore = vertices.size() * sizeof( Vertex_PCUTBN );
 
+	GUARANTEE_OR_DIE( positionEpsilon > 0.f, "CleanMesh requires a positive position epsilon" );
+
+	struct WeldCell
+	{
+		int firstUniqueIdx = -1;
+		int lastUniqueIdx = -1;
+	};
+
+	float cellSize = 2.f * positionEpsilon;
+
 	std::vector<Vertex_PCUTBN> uniqueVertices;
 	uniqueVertices.reserve( vertices.size() );
 
-	uint index = 0;
+	std::vector<int> nextUniqueIdxInCell;
+	nextUniqueIdxInCell.reserve( vertices.size() );
+
+	std::unordered_map<uint64_t, WeldCell> cells;
+	cells.reserve( vertices.size() );
+
+	indices.reserve( indices.size() + vertices.size() );
+
 	for ( uint vertIdx = 0; vertIdx < vertices.size(); ++vertIdx )
 	{
-		bool foundVertex = false;
-		for ( uint uniqueVertIdx = 0; uniqueVertIdx < uniqueVertices.size(); ++uniqueVertIdx )
+		const Vertex_PCUTBN& vertex = vertices[vertIdx];
+
+		int64_t minCellX = GetWeldCellCoord( vertex.position.x - positionEpsilon, cellSize );
+		int64_t minCellY = GetWeldCellCoord( vertex.position.y - positionEpsilon, cellSize );
+		int64_t minCellZ = GetWeldCellCoord( vertex.position.z - positionEpsilon, cellSize );
+		int64_t maxCellX = GetWeldCellCoord( vertex.position.x + positionEpsilon, cellSize );
+		int64_t maxCellY = GetWeldCellCoord( vertex.position.y + positionEpsilon, cellSize );
+		int64_t maxCellZ = GetWeldCellCoord( vertex.position.z + positionEpsilon, cellSize );
+
+		int matchingUniqueIdx = -1;
+		for ( int64_t cellZ = minCellZ; cellZ <= maxCellZ; ++cellZ )
 		{
-			// We found the vertex already, just add the index and move to next vert
-			if ( uniqueVertices[uniqueVertIdx] == vertices[vertIdx] )
+			for ( int64_t cellY = minCellY; cellY <= maxCellY; ++cellY )
 			{
-				indices.push_back( uniqueVertIdx );
-
-				foundVertex = true;
-				break;
+				for ( int64_t cellX = minCellX; cellX <= maxCellX; ++cellX )
+				{
+					auto cellIter = cells.find( GetWeldCellKey( cellX, cellY, cellZ ) );
+					if ( cellIter == cells.end() )
+					{
+						continue;
+					}
+
+					// Cells are in ascending order, so stop once we can't beat the best match so far
+					for ( int uniqueIdx = cellIter->second.firstUniqueIdx; uniqueIdx != -1; uniqueIdx = nextUniqueIdxInCell[uniqueIdx] )
+					{
+						if ( matchingUniqueIdx != -1
+							 && uniqueIdx >= matchingUniqueIdx )
+						{
+							break;
+						}
+
+						if ( AreVerticesWeldable( uniqueVertices[uniqueIdx], vertex, positionEpsilon ) )
+						{
+							matchingUniqueIdx = uniqueIdx;
+							break;
+						}
+					}
+				}
 			}
 		}
 
-		if ( foundVertex )
+		// We found the vertex already, just add the index and move to next vert
+		if ( matchingUniqueIdx != -1 )
 		{
+			indices.push_back( (uint)matchingUniqueIdx );
 			continue;
 		}
 
-		uniqueVertices.push_back( vertices[vertIdx] );
-		indices.push_back( index );
-		++index;
+		int newUniqueIdx = (int)uniqueVertices.size();
+		uniqueVertices.push_back( vertex );
+		nextUniqueIdxInCell.push_back( -1 );
+		indices.push_back( (uint)newUniqueIdx );
+
+		WeldCell& cell = cells[GetWeldCellKey( GetWeldCellCoord( vertex.position.x, cellSize ),
+											   GetWeldCellCoord( vertex.position.y, cellSize ),
+											   GetWeldCellCoord( vertex.position.z, cellSize ) )];
+		if ( cell.lastUniqueIdx == -1 )
+		{
+			cell.firstUniqueIdx = newUniqueIdx;
+		}
+		else
+		{
+			nextUniqueIdxInCell[cell.lastUniqueIdx] = newUniqueIdx;
+		}
+		cell.lastUniqueIdx = newUniqueIdx;
 	}
 
-	vertices = uniqueVertices;
+	vertices.swap( uniqueVertices );
 
 	//size_t bytesAfter = vertices.size() * sizeof( Vertex_PCUTBN ) + indices.size() * sizeof( uint );
 
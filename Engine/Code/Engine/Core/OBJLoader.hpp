@@ -43,7 +43,8 @@ class ObjLoader
 public:	
 	static void LoadFromFile( std::vector<Vertex_PCUTBN>& vertices,
 							  const std::string& filename,
-							  bool& out_fileHadNormals );
+							  bool& out_fileHadNormals,
+							  int numThreads = 1 );
 
 	static void InvertVertVs( std::vector<Vertex_PCUTBN>& vertices );
 	static void GenerateVertNormals( std::vector<Vertex_PCUTBN>& vertices );
@@ -51,15 +52,9 @@ public:
 	static void InvertIndexWindingOrder( std::vector<uint>& indices );
 	static void GenerateVertTangents( std::vector<Vertex_PCUTBN>& vertices );
 	static void TransformVerts( std::vector<Vertex_PCUTBN>& vertices, const Mat44& transform );
-	static void CleanMesh( std::vector<Vertex_PCUTBN>& vertices, std::vector<uint>& indices );
+	static void CleanMesh( std::vector<Vertex_PCUTBN>& vertices, std::vector<uint>& indices, float positionEpsilon = .0001f );
 
 private:
-	static bool AppendVertexData( const Strings& dataStrings, std::vector<Vec3>& data );
-	static bool AppendVertexUVs( const Strings& dataStrings, std::vector<Vec3>& data );
-	static bool AppendFace( const Strings& dataStrings, std::vector<ObjFace>& data, ObjVertex& lastObjVertex );
-
 	static bool ParseMetadata( const Strings& dataStrings, int lineNum, Mat44& scaleTransform, OrientationMetaData& orientationTransform );
 	static Vec3 GetVecForRelativeDir( const std::string& relativeDir );
-
-	static ObjVertex CreateObjVertexFromString( const std::string& indexStr, ObjVertex& lastObjVertex );
 };
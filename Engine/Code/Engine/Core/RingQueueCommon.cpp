@@ -0,0 +1,29 @@
+#include "Engine/Core/RingQueueCommon.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+void RingQueueWaiter::NotifyIfWaiting()
+{
+	std::atomic_thread_fence( std::memory_order_seq_cst );
+	if ( m_numWaiters.load( std::memory_order_relaxed ) == 0 )
+	{
+		return;
+	}
+
+	// Taking the lock means a waiter is either already asleep or hasn't checked its predicate yet
+	{
+		std::lock_guard<std::mutex> guard( m_mutex );
+	}
+	m_condition.notify_all();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void RingQueueWaiter::StopWaiting()
+{
+	{
+		std::lock_guard<std::mutex> guard( m_mutex );
+		m_isStopped.store( true, std::memory_order_release );
+	}
+	m_condition.notify_all();
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+
+//-----------------------------------------------------------------------------------------------
+// Padding between the producer and consumer indices so the two sides don't false share a cache line
+constexpr size_t RING_QUEUE_CACHE_LINE_SIZE = 64;
+
+
+//-----------------------------------------------------------------------------------------------
+// Ring indices are masked into the slot array, so capacities are rounded up to a power of two
+inline size_t GetRingQueueCapacity( int minCapacity )
+{
+	size_t capacity = 1;
+	while ( capacity < (size_t)minCapacity )
+	{
+		capacity <<= 1;
+	}
+
+	return capacity;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Optional sleep for consumers of the lock free ring queues. Producers only take the mutex when a
+// consumer has registered as waiting, so a busy queue never pays for a lock or a notify per push.
+class RingQueueWaiter
+{
+public:
+	RingQueueWaiter() = default;
+	~RingQueueWaiter() = default;
+
+	RingQueueWaiter( const RingQueueWaiter& other ) = delete;
+	RingQueueWaiter& operator=( const RingQueueWaiter& other ) = delete;
+
+	// Called by producers after publishing new values
+	void NotifyIfWaiting();
+
+	// Wakes all waiters and makes every later wait return immediately, so shutdown can't miss a sleeping consumer
+	void StopWaiting();
+	bool IsStopped() const												{ return m_isStopped.load( std::memory_order_acquire ); }
+
+	// Blocks until isReady returns true or StopWaiting is called
+	template<typename PREDICATE>
+	void WaitUntil( PREDICATE isReady );
+
+private:
+	std::atomic<int> m_numWaiters{ 0 };
+	std::atomic<bool> m_isStopped{ false };
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename PREDICATE>
+void RingQueueWaiter::WaitUntil( PREDICATE isReady )
+{
+	if ( isReady() || IsStopped() )
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> uniqueLock( m_mutex );
+	m_numWaiters.fetch_add( 1, std::memory_order_seq_cst );
+
+	// Pairs with the fence in NotifyIfWaiting, either the producer sees the waiter or this sees the new value
+	std::atomic_thread_fence( std::memory_order_seq_cst );
+
+	while ( !isReady() && !IsStopped() )
+	{
+		m_condition.wait( uniqueLock );
+	}
+
+	m_numWaiters.fetch_sub( 1, std::memory_order_relaxed );
+}
@@ -0,0 +1,169 @@
+#pragma once
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/RingQueueCommon.hpp"
+
+#include <atomic>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------------------------
+// Bounded lock free queue for exactly one producer thread and one consumer thread.
+// Each side keeps a stale copy of the other side's index and only reloads the shared one when the
+// queue looks full or empty, so steady traffic touches no shared cache line but the slots themselves.
+template<typename T>
+class SPSCRingQueue
+{
+public:
+	// Waiting costs producers a full memory fence per publish, so queues whose consumer never sleeps leave it off
+	explicit SPSCRingQueue( int capacity, bool canConsumerWait = false );
+	~SPSCRingQueue() = default;
+
+	SPSCRingQueue( const SPSCRingQueue& other ) = delete;
+	SPSCRingQueue& operator=( const SPSCRingQueue& other ) = delete;
+
+	// Producer thread only, returns false when the queue is full
+	bool Push( const T& value );
+	// Pushes as many values as fit with a single publish, returns how many were taken so the caller can keep the rest
+	int PushMultiple( const T* values, int numValues );
+
+	// Consumer thread only
+	bool Pop( T& out_value );
+	// Appends everything queued so far to out_values, returns the number popped
+	int PopAll( std::vector<T>& out_values );
+	// Same as PopAll but sleeps while the queue is empty, only returns 0 once StopWaiting has been called.
+	// Needs canConsumerWait.
+	int WaitAndPopAll( std::vector<T>& out_values );
+
+	void StopWaiting()													{ m_waiter.StopWaiting(); }
+
+	bool IsEmpty() const;
+	int GetCapacity() const												{ return (int)m_slots.size(); }
+
+private:
+	std::vector<T> m_slots;
+	size_t m_indexMask = 0;
+
+	char m_producerPadding[RING_QUEUE_CACHE_LINE_SIZE];
+	std::atomic<size_t> m_writeIdx{ 0 };
+	size_t m_cachedReadIdx = 0;
+
+	char m_consumerPadding[RING_QUEUE_CACHE_LINE_SIZE];
+	std::atomic<size_t> m_readIdx{ 0 };
+	size_t m_cachedWriteIdx = 0;
+
+	char m_waiterPadding[RING_QUEUE_CACHE_LINE_SIZE];
+	RingQueueWaiter m_waiter;
+	bool m_canConsumerWait = false;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+SPSCRingQueue<T>::SPSCRingQueue( int capacity, bool canConsumerWait )
+	: m_canConsumerWait( canConsumerWait )
+{
+	GUARANTEE_OR_DIE( capacity > 0, "SPSCRingQueue needs a positive capacity" );
+
+	m_slots.resize( GetRingQueueCapacity( capacity ) );
+	m_indexMask = m_slots.size() - 1;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+bool SPSCRingQueue<T>::Push( const T& value )
+{
+	return PushMultiple( &value, 1 ) == 1;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+int SPSCRingQueue<T>::PushMultiple( const T* values, int numValues )
+{
+	size_t writeIdx = m_writeIdx.load( std::memory_order_relaxed );
+	size_t numFreeSlots = m_slots.size() - ( writeIdx - m_cachedReadIdx );
+	if ( numFreeSlots < (size_t)numValues )
+	{
+		m_cachedReadIdx = m_readIdx.load( std::memory_order_acquire );
+		numFreeSlots = m_slots.size() - ( writeIdx - m_cachedReadIdx );
+	}
+
+	int numToPush = numFreeSlots < (size_t)numValues ? (int)numFreeSlots : numValues;
+	if ( numToPush == 0 )
+	{
+		return 0;
+	}
+
+	for ( int valueIdx = 0; valueIdx < numToPush; ++valueIdx )
+	{
+		m_slots[( writeIdx + valueIdx ) & m_indexMask] = values[valueIdx];
+	}
+
+	m_writeIdx.store( writeIdx + numToPush, std::memory_order_release );
+	if ( m_canConsumerWait )
+	{
+		m_waiter.NotifyIfWaiting();
+	}
+
+	return numToPush;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+bool SPSCRingQueue<T>::Pop( T& out_value )
+{
+	size_t readIdx = m_readIdx.load( std::memory_order_relaxed );
+	if ( readIdx == m_cachedWriteIdx )
+	{
+		m_cachedWriteIdx = m_writeIdx.load( std::memory_order_acquire );
+		if ( readIdx == m_cachedWriteIdx )
+		{
+			return false;
+		}
+	}
+
+	out_value = std::move( m_slots[readIdx & m_indexMask] );
+	m_readIdx.store( readIdx + 1, std::memory_order_release );
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+int SPSCRingQueue<T>::PopAll( std::vector<T>& out_values )
+{
+	size_t readIdx = m_readIdx.load( std::memory_order_relaxed );
+	m_cachedWriteIdx = m_writeIdx.load( std::memory_order_acquire );
+
+	int numPopped = (int)( m_cachedWriteIdx - readIdx );
+	for ( size_t slotIdx = readIdx; slotIdx != m_cachedWriteIdx; ++slotIdx )
+	{
+		out_values.push_back( std::move( m_slots[slotIdx & m_indexMask] ) );
+	}
+
+	m_readIdx.store( m_cachedWriteIdx, std::memory_order_release );
+
+	return numPopped;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+int SPSCRingQueue<T>::WaitAndPopAll( std::vector<T>& out_values )
+{
+	GUARANTEE_OR_DIE( m_canConsumerWait, "SPSCRingQueue was constructed without canConsumerWait" );
+
+	m_waiter.WaitUntil( [this]() { return !IsEmpty(); } );
+	return PopAll( out_values );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+bool SPSCRingQueue<T>::IsEmpty() const
+{
+	return m_readIdx.load( std::memory_order_acquire ) == m_writeIdx.load( std::memory_order_acquire );
+}
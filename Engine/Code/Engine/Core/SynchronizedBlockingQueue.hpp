@@ -2,6 +2,7 @@
 #include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <vector>
 
 
 //-----------------------------------------------------------------------------------------------
@@ -21,7 +22,11 @@ public:
 	SynchronizedBlockingQueue& operator=( SynchronizedBlockingQueue const&& ) = delete;
 
 	void Push( const T& value );
+	// Takes the lock and wakes waiters once for the whole batch
+	void PushMultiple( const std::vector<T>& values );
 	T Pop();
+	// Waits like Pop, then moves everything queued into out_values so a consumer can drain under one lock
+	void PopAll( std::vector<T>& out_values );
 
 	void NotifyAll();
 
@@ -49,6 +54,24 @@ void SynchronizedBlockingQueue<T>::Push( const T& value )
 }
 
 
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+void SynchronizedBlockingQueue<T>::PushMultiple( const std::vector<T>& values )
+{
+	if ( values.empty() )
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> guard( m_lock );
+	for ( const T& value : values )
+	{
+		base::push( value );
+	}
+	m_condition.notify_all();
+}
+
+
 //-----------------------------------------------------------------------------------------------
 template<typename T>
 typename T SynchronizedBlockingQueue<T>::Pop()
@@ -69,3 +92,23 @@ typename T SynchronizedBlockingQueue<T>::Pop()
 
 	return value;
 }
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+void SynchronizedBlockingQueue<T>::PopAll( std::vector<T>& out_values )
+{
+	out_values.clear();
+
+	std::unique_lock<std::mutex> uniqueLock( m_lock );
+	if ( base::empty() )
+	{
+		m_condition.wait( uniqueLock );
+	}
+
+	while ( !base::empty() )
+	{
+		out_values.push_back( base::front() );
+		base::pop();
+	}
+}
@@ -19,6 +19,9 @@ public:
 
 	void Push( const T& value );
 	bool Pop( T& out_value );
+
+	// Takes everything queued so far with a single lock, out_values should be empty
+	void PopAll( std::queue<T>& out_values );
 	
 private:
 	std::mutex		m_mutex;
@@ -55,3 +58,13 @@ typename bool SynchronizedNonBlockingQueue<T>::Pop( T& out_value )
 
 	return poppedSuccessfully;
 }
+
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+void SynchronizedNonBlockingQueue<T>::PopAll( std::queue<T>& out_values )
+{
+	m_mutex.lock();
+	m_queue.swap( out_values );
+	m_mutex.unlock();
+}
@@ -5,38 +5,294 @@
 #include "Engine/Core/Devconsole.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/MemoryMappedFile.hpp"
 #include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Renderer/GPUMesh.hpp"
+
+#include <math.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------------------------
+// TWSM 29.2 layout, all little endian:
+//	 0	'T' 'W' 'S' 'M', major version, minor version, vertex type, flags
+//	 8	vertex size, vertex count, index count, vertex block offset, index block offset (uint32s)
+//	28	uv bounds (AABB2), only used by quantized vertices
+//	48	vertex block, index block, each starting on a 16 byte boundary
+//
+// The blocks are stored exactly as they are laid out in memory, so a memory mapped file can be
+// handed to the renderer without touching individual vertices.
+// 29.1 files (19 byte header followed by unaligned Vertex_PCUTBNs and 32 bit indices) still load.
+//-----------------------------------------------------------------------------------------------
+constexpr byte TWSM_MAJOR_VERSION = 29;
+constexpr byte TWSM_MINOR_VERSION = 2;
+
+constexpr byte TWSM_VERTEX_TYPE_PCU = 0x01;
+constexpr byte TWSM_VERTEX_TYPE_PCUTBN = 0x02;
+constexpr byte TWSM_VERTEX_TYPE_PCUTBN_QUANTIZED = 0x03;
+
+constexpr byte TWSM_FLAG_16_BIT_INDICES = BIT_FLAG( 0 );
+
+constexpr uint32_t TWSM_MINOR_VERSION_1_HEADER_SIZE = 19;
+constexpr uint32_t TWSM_HEADER_SIZE = 48;
+constexpr uint32_t TWSM_BLOCK_ALIGNMENT = 16;
+
+constexpr int16_t TWSM_QUANTIZED_ZERO_VECTOR = -32768;
+
+
+//-----------------------------------------------------------------------------------------------
+struct TWSMQuantizedVertex
+{
+	Vec3 position;
+	Rgba8 color;
+	uint16_t uvTexCoords[2];
+
+	// Octahedral encoded unit vectors
+	int16_t tangent[2];
+	int16_t bitangent[2];
+	int16_t normal[2];
+};
+
+static_assert( sizeof( TWSMQuantizedVertex ) == 32, "TWSMQuantizedVertex must match the file layout" );
+
+
+//-----------------------------------------------------------------------------------------------
+// Where the pieces of a mesh live inside a loaded or mapped file
+struct TWSMFileView
+{
+	byte minorVersion = 0;
+	byte vertexType = 0;
+	byte flags = 0;
+
+	uint32_t numVertices = 0;
+	uint32_t numIndices = 0;
+	AABB2 uvBounds;
+
+	const byte* vertexData = nullptr;
+	const byte* indexData = nullptr;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+static uint32_t GetTWSMVertexSize( byte vertexType )
+{
+	switch ( vertexType )
+	{
+		case TWSM_VERTEX_TYPE_PCUTBN:				return sizeof( Vertex_PCUTBN );
+		case TWSM_VERTEX_TYPE_PCUTBN_QUANTIZED:		return sizeof( TWSMQuantizedVertex );
+		default:									return 0;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static int16_t QuantizeSignedUnitFloat( float value )
+{
+	return (int16_t)roundf( ClampMinMax( value, -1.f, 1.f ) * 32767.f );
+}
 
 
 //-----------------------------------------------------------------------------------------------
-void SaveMeshAsTWSMFile( const CPUMesh& mesh, const std::string& filename )
+static void EncodeOctahedralUnitVector( const Vec3& vector, int16_t* out_encoded )
 {
+	float manhattanLength = fabsf( vector.x ) + fabsf( vector.y ) + fabsf( vector.z );
+	if ( manhattanLength == 0.f )
+	{
+		out_encoded[0] = TWSM_QUANTIZED_ZERO_VECTOR;
+		out_encoded[1] = TWSM_QUANTIZED_ZERO_VECTOR;
+		return;
+	}
+
+	float x = vector.x / manhattanLength;
+	float y = vector.y / manhattanLength;
+	if ( vector.z < 0.f )
+	{
+		// Fold the lower hemisphere over the diagonals
+		float foldedX = ( 1.f - fabsf( y ) ) * SignFloat( x );
+		float foldedY = ( 1.f - fabsf( x ) ) * SignFloat( y );
+		x = foldedX;
+		y = foldedY;
+	}
+
+	out_encoded[0] = QuantizeSignedUnitFloat( x );
+	out_encoded[1] = QuantizeSignedUnitFloat( y );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static Vec3 DecodeOctahedralUnitVector( const int16_t* encoded )
+{
+	if ( encoded[0] == TWSM_QUANTIZED_ZERO_VECTOR
+		 && encoded[1] == TWSM_QUANTIZED_ZERO_VECTOR )
+	{
+		return Vec3::ZERO;
+	}
+
+	float x = (float)encoded[0] / 32767.f;
+	float y = (float)encoded[1] / 32767.f;
+	float z = 1.f - fabsf( x ) - fabsf( y );
+	if ( z < 0.f )
+	{
+		float unfoldedX = ( 1.f - fabsf( y ) ) * SignFloat( x );
+		float unfoldedY = ( 1.f - fabsf( x ) ) * SignFloat( y );
+		x = unfoldedX;
+		y = unfoldedY;
+	}
+
+	return Vec3( x, y, z ).GetNormalized();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static uint16_t QuantizeUVComponent( float value, float minValue, float maxValue )
+{
+	float range = maxValue - minValue;
+	if ( range <= 0.f )
+	{
+		return 0;
+	}
+
+	return (uint16_t)roundf( ClampZeroToOne( ( value - minValue ) / range ) * 65535.f );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static float DequantizeUVComponent( uint16_t value, float minValue, float maxValue )
+{
+	return minValue + ( (float)value / 65535.f ) * ( maxValue - minValue );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static TWSMQuantizedVertex QuantizeVertex( const Vertex_PCUTBN& vertex, const AABB2& uvBounds )
+{
+	TWSMQuantizedVertex quantizedVertex;
+	quantizedVertex.position = vertex.position;
+	quantizedVertex.color = vertex.color;
+	quantizedVertex.uvTexCoords[0] = QuantizeUVComponent( vertex.uvTexCoords.x, uvBounds.mins.x, uvBounds.maxs.x );
+	quantizedVertex.uvTexCoords[1] = QuantizeUVComponent( vertex.uvTexCoords.y, uvBounds.mins.y, uvBounds.maxs.y );
+	EncodeOctahedralUnitVector( vertex.tangent, quantizedVertex.tangent );
+	EncodeOctahedralUnitVector( vertex.bitangent, quantizedVertex.bitangent );
+	EncodeOctahedralUnitVector( vertex.normal, quantizedVertex.normal );
+
+	return quantizedVertex;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static Vertex_PCUTBN DequantizeVertex( const TWSMQuantizedVertex& quantizedVertex, const AABB2& uvBounds )
+{
+	Vertex_PCUTBN vertex;
+	vertex.position = quantizedVertex.position;
+	vertex.color = quantizedVertex.color;
+	vertex.uvTexCoords.x = DequantizeUVComponent( quantizedVertex.uvTexCoords[0], uvBounds.mins.x, uvBounds.maxs.x );
+	vertex.uvTexCoords.y = DequantizeUVComponent( quantizedVertex.uvTexCoords[1], uvBounds.mins.y, uvBounds.maxs.y );
+	vertex.tangent = DecodeOctahedralUnitVector( quantizedVertex.tangent );
+	vertex.bitangent = DecodeOctahedralUnitVector( quantizedVertex.bitangent );
+	vertex.normal = DecodeOctahedralUnitVector( quantizedVertex.normal );
+
+	return vertex;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static AABB2 GetUVBounds( const std::vector<Vertex_PCUTBN>& vertices )
+{
+	if ( vertices.empty() )
+	{
+		return AABB2( Vec2::ZERO, Vec2::ZERO );
+	}
+
+	AABB2 uvBounds( vertices[0].uvTexCoords, vertices[0].uvTexCoords );
+	for ( int vertexIdx = 1; vertexIdx < (int)vertices.size(); ++vertexIdx )
+	{
+		const Vec2& uv = vertices[vertexIdx].uvTexCoords;
+		uvBounds.mins.x = Min( uvBounds.mins.x, uv.x );
+		uvBounds.mins.y = Min( uvBounds.mins.y, uv.y );
+		uvBounds.maxs.x = Max( uvBounds.maxs.x, uv.x );
+		uvBounds.maxs.y = Max( uvBounds.maxs.y, uv.y );
+	}
+
+	return uvBounds;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void SaveMeshAsTWSMFile( const CPUMesh& mesh, const std::string& filename, const TWSMSaveOptions& options )
+{
+	const std::vector<Vertex_PCUTBN>& vertices = mesh.GetVertices();
+	const std::vector<uint>& indices = mesh.GetIndices();
+
+	uint32_t numVertices = (uint32_t)vertices.size();
+	uint32_t numIndices = (uint32_t)indices.size();
+
+	byte flags = 0;
+	if ( options.use16BitIndices
+		 && numVertices <= 0x10000 )
+	{
+		flags |= TWSM_FLAG_16_BIT_INDICES;
+	}
+
+	byte vertexType = options.quantizeVertices ? TWSM_VERTEX_TYPE_PCUTBN_QUANTIZED : TWSM_VERTEX_TYPE_PCUTBN;
+	uint32_t vertexSize = GetTWSMVertexSize( vertexType );
+	uint32_t indexSize = ( flags & TWSM_FLAG_16_BIT_INDICES ) != 0 ? sizeof( uint16_t ) : sizeof( uint32_t );
+	AABB2 uvBounds = options.quantizeVertices ? GetUVBounds( vertices ) : AABB2( Vec2::ZERO, Vec2::ZERO );
+
+	uint32_t vertexBlockOffset = TWSM_HEADER_SIZE;
+	uint32_t vertexBlockSize = numVertices * vertexSize;
+	uint32_t indexBlockOffset = vertexBlockOffset + vertexBlockSize;
+	indexBlockOffset += ( TWSM_BLOCK_ALIGNMENT - indexBlockOffset % TWSM_BLOCK_ALIGNMENT ) % TWSM_BLOCK_ALIGNMENT;
+	uint32_t indexBlockSize = numIndices * indexSize;
+
 	std::vector<byte> fileData;
+	fileData.reserve( indexBlockOffset + indexBlockSize );
+
 	BufferWriter bufferWriter( fileData );
+	bufferWriter.SetEndianMode( eBufferEndianMode::LITTLE );
 	bufferWriter.AppendByte( 'T' );
 	bufferWriter.AppendByte( 'W' );
 	bufferWriter.AppendByte( 'S' );
 	bufferWriter.AppendByte( 'M' );
-	bufferWriter.AppendByte( 29 );
-	bufferWriter.AppendByte( 1 );
+	bufferWriter.AppendByte( TWSM_MAJOR_VERSION );
+	bufferWriter.AppendByte( TWSM_MINOR_VERSION );
+	bufferWriter.AppendByte( vertexType );
+	bufferWriter.AppendByte( flags );
 
-	int numVertices = mesh.GetNumVertices();
-	int numIndices = mesh.GetNumIndices();
-	bufferWriter.AppendByte( 2 );
-	bufferWriter.AppendUint32( sizeof( Vertex_PCUTBN ) );
-	bufferWriter.AppendUint32( (uint32_t)numVertices );
-	bufferWriter.AppendUint32( (uint32_t)numIndices );
+	bufferWriter.AppendUint32( vertexSize );
+	bufferWriter.AppendUint32( numVertices );
+	bufferWriter.AppendUint32( numIndices );
+	bufferWriter.AppendUint32( vertexBlockOffset );
+	bufferWriter.AppendUint32( indexBlockOffset );
+	bufferWriter.AppendAABB2( uvBounds );
+	bufferWriter.AppendPaddingToAlignment( TWSM_BLOCK_ALIGNMENT );
 
-	std::vector<Vertex_PCUTBN> const& vertices =  mesh.GetVertices();
-	for ( int vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx )
+	// Blocks are written in native order, which is little endian on every platform we ship
+	if ( options.quantizeVertices )
 	{
-		bufferWriter.AppendVertexPCUTBN( vertices[vertexIdx] );
+		std::vector<TWSMQuantizedVertex> quantizedVertices;
+		quantizedVertices.reserve( numVertices );
+		for ( uint32_t vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx )
+		{
+			quantizedVertices.push_back( QuantizeVertex( vertices[vertexIdx], uvBounds ) );
+		}
+
+		bufferWriter.AppendBytes( quantizedVertices.data(), vertexBlockSize );
 	}
-	
-	std::vector<uint> const& indices = mesh.GetIndices();
-	for ( int indexIdx = 0; indexIdx < numIndices; ++indexIdx )
+	else
 	{
-		bufferWriter.AppendUint32( indices[indexIdx] );
+		bufferWriter.AppendBytes( vertices.data(), vertexBlockSize );
+	}
+	bufferWriter.AppendPaddingToAlignment( TWSM_BLOCK_ALIGNMENT );
+
+	if ( ( flags & TWSM_FLAG_16_BIT_INDICES ) != 0 )
+	{
+		std::vector<uint16_t> shortIndices( indices.begin(), indices.end() );
+		bufferWriter.AppendBytes( shortIndices.data(), indexBlockSize );
+	}
+	else
+	{
+		bufferWriter.AppendBytes( indices.data(), indexBlockSize );
 	}
 
 	WriteBufferToFile( filename, fileData.data(), (uint32_t)fileData.size() );
@@ -44,88 +300,251 @@ void SaveMeshAsTWSMFile( const CPUMesh& mesh, const std::string& filename )
 
 
 //-----------------------------------------------------------------------------------------------
-CPUMesh* LoadTWSMFileIntoCPUMesh( const std::string& filename )
+static bool ParseMinorVersion1Header( BufferParser& bufferParser, const byte* fileData, uint64_t fileSize, TWSMFileView& out_view )
 {
-	uint32_t fileSize = 0;
-	void* fileData = FileReadBinaryToNewBuffer( filename, &fileSize );
+	out_view.vertexType = bufferParser.ParseByte();
+	uint32_t vertexSize = bufferParser.ParseUint32();
+	out_view.numVertices = bufferParser.ParseUint32();
+	out_view.numIndices = bufferParser.ParseUint32();
 
-	if ( fileSize == 0 )
+	if ( fileSize != TWSM_MINOR_VERSION_1_HEADER_SIZE + (uint64_t)out_view.numVertices * vertexSize + (uint64_t)out_view.numIndices * sizeof( uint ) )
 	{
-		g_devConsole->PrintError( "Could not open ghsm file" );
-		return nullptr;
+		g_devConsole->PrintError( "Invalid File: filesize does not match size of file calculated from header" );
+		return false;
+	}
+
+	if ( out_view.vertexType == TWSM_VERTEX_TYPE_PCUTBN
+		 && vertexSize != sizeof( Vertex_PCUTBN ) )
+	{
+		g_devConsole->PrintError( Stringf( "Invalid File: Unexpected Vertex_PCUTBN size '%i' seen in file, should be '%i'", vertexSize, sizeof( Vertex_PCUTBN ) ) );
+		return false;
 	}
 
-	BufferParser bufferParser( fileData, fileSize );
+	out_view.vertexData = fileData + TWSM_MINOR_VERSION_1_HEADER_SIZE;
+	out_view.indexData = out_view.vertexData + (uint64_t)out_view.numVertices * vertexSize;
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static bool ParseMinorVersion2Header( BufferParser& bufferParser, const byte* fileData, uint64_t fileSize, TWSMFileView& out_view )
+{
+	if ( fileSize < TWSM_HEADER_SIZE )
+	{
+		g_devConsole->PrintError( "Invalid File: file is too small to hold a twsm header" );
+		return false;
+	}
+
+	out_view.vertexType = bufferParser.ParseByte();
+	out_view.flags = bufferParser.ParseByte();
+	uint32_t vertexSize = bufferParser.ParseUint32();
+	out_view.numVertices = bufferParser.ParseUint32();
+	out_view.numIndices = bufferParser.ParseUint32();
+	uint32_t vertexBlockOffset = bufferParser.ParseUint32();
+	uint32_t indexBlockOffset = bufferParser.ParseUint32();
+	out_view.uvBounds = bufferParser.ParseAABB2();
+
+	uint32_t expectedVertexSize = GetTWSMVertexSize( out_view.vertexType );
+	if ( vertexSize != expectedVertexSize )
+	{
+		g_devConsole->PrintError( Stringf( "Invalid File: Unexpected vertex size '%u' seen in file, should be '%u'", vertexSize, expectedVertexSize ) );
+		return false;
+	}
+
+	uint64_t indexSize = ( out_view.flags & TWSM_FLAG_16_BIT_INDICES ) != 0 ? sizeof( uint16_t ) : sizeof( uint32_t );
+	uint64_t vertexBlockEnd = (uint64_t)vertexBlockOffset + (uint64_t)out_view.numVertices * vertexSize;
+	uint64_t indexBlockEnd = (uint64_t)indexBlockOffset + (uint64_t)out_view.numIndices * indexSize;
+	if ( vertexBlockOffset < TWSM_HEADER_SIZE
+		 || vertexBlockOffset % TWSM_BLOCK_ALIGNMENT != 0
+		 || indexBlockOffset % TWSM_BLOCK_ALIGNMENT != 0
+		 || vertexBlockEnd > indexBlockOffset
+		 || indexBlockEnd != fileSize )
+	{
+		g_devConsole->PrintError( "Invalid File: block offsets in header do not match the file" );
+		return false;
+	}
+
+	out_view.vertexData = fileData + vertexBlockOffset;
+	out_view.indexData = fileData + indexBlockOffset;
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static bool ParseTWSMFile( const byte* fileData, uint64_t fileSize, TWSMFileView& out_view )
+{
+	if ( fileSize < TWSM_MINOR_VERSION_1_HEADER_SIZE )
+	{
+		g_devConsole->PrintError( "Invalid File: file is too small to hold a twsm header" );
+		return false;
+	}
+
+	BufferParser bufferParser( (void*)fileData, fileSize );
+	bufferParser.SetEndianMode( eBufferEndianMode::LITTLE );
 	if ( bufferParser.ParseChar() != 'T'
 		 || bufferParser.ParseChar() != 'W'
 		 || bufferParser.ParseChar() != 'S'
 		 || bufferParser.ParseChar() != 'M' )
 	{
-		g_devConsole->PrintError( "Invalid File: Header CC is not GHSM" );
-		return nullptr;
+		g_devConsole->PrintError( "Invalid File: Header CC is not TWSM" );
+		return false;
 	}
 	
-	// Temp checks for testing, will handle different revisions later
 	byte majorVersion = bufferParser.ParseByte();
-	if ( majorVersion != 29 )
+	if ( majorVersion != TWSM_MAJOR_VERSION )
 	{
-		g_devConsole->PrintError( "Invalid File: Expected major version 29" );
-		return nullptr;
+		g_devConsole->PrintError( Stringf( "Invalid File: Expected major version %i", TWSM_MAJOR_VERSION ) );
+		return false;
 	}
 
-	byte minorVersion = bufferParser.ParseByte();
-	if ( minorVersion != 1 )
+	out_view.minorVersion = bufferParser.ParseByte();
+	bool isValid = false;
+	switch ( out_view.minorVersion )
 	{
-		g_devConsole->PrintWarning( "Expected minor version 1, only parsing minor version 1 things" );
+		case 1: isValid = ParseMinorVersion1Header( bufferParser, fileData, fileSize, out_view ); break;
+		case 2: isValid = ParseMinorVersion2Header( bufferParser, fileData, fileSize, out_view ); break;
+
+		default:
+		{
+			g_devConsole->PrintError( Stringf( "Invalid File: Unsupported minor version %i", out_view.minorVersion ) );
+			return false;
+		}
 	}
-	
-	byte vertexType = bufferParser.ParseByte();
-	
-	uint32_t vertexSize =  bufferParser.ParseUint32();
-	uint32_t numVertices = bufferParser.ParseUint32();
-	uint32_t numIndices =  bufferParser.ParseUint32();
 
-	constexpr int HEADER_SIZE = 19;
-	if ( fileSize != HEADER_SIZE + numVertices * vertexSize + numIndices * sizeof( uint ) )
+	if ( !isValid )
 	{
-		g_devConsole->PrintError( "Invalid File: filesize does not match size of file calculated from header" );
-		return nullptr;
+		return false;
 	}
 
-	uint64_t offsetToEndOfHeader = bufferParser.GetNextReadLocation() - (const byte*)fileData;
-
-	switch ( vertexType )
+	switch ( out_view.vertexType )
 	{
-		case 0x01:
+		case TWSM_VERTEX_TYPE_PCUTBN:
+		case TWSM_VERTEX_TYPE_PCUTBN_QUANTIZED:
 		{
-			g_devConsole->PrintError( "Vertex format type PCU has not yet been implemented" );
-			return nullptr;
+			return true;
 		}
 
-		case 0x02:
+		case TWSM_VERTEX_TYPE_PCU:
 		{
-			if ( vertexSize != sizeof( Vertex_PCUTBN ) )
-			{
-				g_devConsole->PrintError( Stringf( "Invalid File: Unexpected Vertex_PCUTBN size '%i' seen in file, should be '%i'", vertexSize, sizeof( Vertex_PCUTBN ) ) );
-				return nullptr;
-			}
-
-			std::vector<Vertex_PCUTBN> vertices;
-			vertices.resize( numVertices );
-			memcpy( &vertices[0], (byte*)fileData + offsetToEndOfHeader, numVertices * vertexSize );
-
-			std::vector<uint> indices;
-			indices.resize( numIndices );
-			memcpy( indices.data(), (byte*)fileData + offsetToEndOfHeader + ( numVertices * vertexSize ), numIndices * sizeof( uint ) );
-
-			CPUMesh* mesh = new CPUMesh( vertices, indices );
-			return mesh;
+			g_devConsole->PrintError( "Vertex format type PCU has not yet been implemented" );
+			return false;
 		}
 
 		default:
 		{
 			g_devConsole->PrintError( "Invalid File: Unknown vertex format type" );
-			return nullptr;
+			return false;
 		}
 	}
 }
+
+
+//-----------------------------------------------------------------------------------------------
+static void CopyTWSMVertices( const TWSMFileView& view, std::vector<Vertex_PCUTBN>& out_vertices )
+{
+	out_vertices.resize( view.numVertices );
+	if ( view.numVertices == 0 )
+	{
+		return;
+	}
+
+	if ( view.vertexType == TWSM_VERTEX_TYPE_PCUTBN )
+	{
+		memcpy( out_vertices.data(), view.vertexData, view.numVertices * sizeof( Vertex_PCUTBN ) );
+		return;
+	}
+
+	const TWSMQuantizedVertex* quantizedVertices = (const TWSMQuantizedVertex*)view.vertexData;
+	for ( uint32_t vertexIdx = 0; vertexIdx < view.numVertices; ++vertexIdx )
+	{
+		out_vertices[vertexIdx] = DequantizeVertex( quantizedVertices[vertexIdx], view.uvBounds );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static void CopyTWSMIndices( const TWSMFileView& view, std::vector<uint>& out_indices )
+{
+	if ( ( view.flags & TWSM_FLAG_16_BIT_INDICES ) != 0 )
+	{
+		const uint16_t* shortIndices = (const uint16_t*)view.indexData;
+		out_indices.assign( shortIndices, shortIndices + view.numIndices );
+		return;
+	}
+
+	out_indices.resize( view.numIndices );
+	if ( view.numIndices > 0 )
+	{
+		memcpy( out_indices.data(), view.indexData, view.numIndices * sizeof( uint ) );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+CPUMesh* LoadTWSMFileIntoCPUMesh( const std::string& filename )
+{
+	MemoryMappedFile file;
+	if ( !file.Open( filename ) )
+	{
+		g_devConsole->PrintError( Stringf( "Could not open twsm file '%s'", filename.c_str() ) );
+		return nullptr;
+	}
+
+	TWSMFileView view;
+	if ( !ParseTWSMFile( file.GetData(), file.GetSize(), view ) )
+	{
+		return nullptr;
+	}
+
+	std::vector<Vertex_PCUTBN> vertices;
+	std::vector<uint> indices;
+	CopyTWSMVertices( view, vertices );
+	CopyTWSMIndices( view, indices );
+
+	return new CPUMesh( std::move( vertices ), std::move( indices ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+GPUMesh* LoadTWSMFileIntoGPUMesh( RenderContext* context, const std::string& filename )
+{
+	MemoryMappedFile file;
+	if ( !file.Open( filename ) )
+	{
+		g_devConsole->PrintError( Stringf( "Could not open twsm file '%s'", filename.c_str() ) );
+		return nullptr;
+	}
+
+	TWSMFileView view;
+	if ( !ParseTWSMFile( file.GetData(), file.GetSize(), view ) )
+	{
+		return nullptr;
+	}
+
+	// 29.1 blocks aren't aligned, so those go through a copy
+	if ( view.minorVersion == 1 )
+	{
+		std::vector<Vertex_PCUTBN> vertices;
+		std::vector<uint> indices;
+		CopyTWSMVertices( view, vertices );
+		CopyTWSMIndices( view, indices );
+
+		return new GPUMesh( context, (uint)vertices.size(), vertices.data(), (uint)indices.size(), indices.data() );
+	}
+
+	// Full precision vertices go straight from the mapped file to the vertex buffer
+	std::vector<Vertex_PCUTBN> dequantizedVertices;
+	const Vertex_PCUTBN* vertices = (const Vertex_PCUTBN*)view.vertexData;
+	if ( view.vertexType == TWSM_VERTEX_TYPE_PCUTBN_QUANTIZED )
+	{
+		CopyTWSMVertices( view, dequantizedVertices );
+		vertices = dequantizedVertices.data();
+	}
+
+	if ( ( view.flags & TWSM_FLAG_16_BIT_INDICES ) != 0 )
+	{
+		return new GPUMesh( context, view.numVertices, vertices, view.numIndices, (const uint16_t*)view.indexData );
+	}
+
+	return new GPUMesh( context, view.numVertices, vertices, view.numIndices, (const uint*)view.indexData );
+}
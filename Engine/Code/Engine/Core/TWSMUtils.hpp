@@ -4,8 +4,19 @@
 
 //-----------------------------------------------------------------------------------------------
 class CPUMesh;
+class GPUMesh;
+class RenderContext;
 
 
 //-----------------------------------------------------------------------------------------------
-void SaveMeshAsTWSMFile( const CPUMesh& mesh, const std::string& filename );
+struct TWSMSaveOptions
+{
+	bool use16BitIndices = true;		// only used when every index fits in 16 bits
+	bool quantizeVertices = false;		// octahedral 16 bit normals/tangents and 16 bit uvs, ~half the vertex size
+};
+
+
+//-----------------------------------------------------------------------------------------------
+void SaveMeshAsTWSMFile( const CPUMesh& mesh, const std::string& filename, const TWSMSaveOptions& options = TWSMSaveOptions() );
 CPUMesh* LoadTWSMFileIntoCPUMesh( const std::string& filename );
+GPUMesh* LoadTWSMFileIntoGPUMesh( RenderContext* context, const std::string& filename );
@@ -4,11 +4,37 @@
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Renderer/MeshUtils.hpp"
 
+#include <xmmintrin.h>
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr int NUM_PLANES_PER_SSE_BATCH = 4;
+
+
+//-----------------------------------------------------------------------------------------------
+static __m128 SelectSSE( const __m128& mask, const __m128& valueIfSet, const __m128& valueIfClear )
+{
+	return _mm_or_ps( _mm_and_ps( mask, valueIfSet ), _mm_andnot_ps( mask, valueIfClear ) );
+}
+
 
 //-----------------------------------------------------------------------------------------------
 void ConvexHull2D::AddPlane( const Plane2D& newPlane )
 {
 	m_boundingPlanes.push_back( newPlane );
+
+	int planeIdx = (int)m_boundingPlanes.size() - 1;
+	if ( planeIdx >= (int)m_planeDistances.size() )
+	{
+		// Padding planes have no normal and every point is 1 unit behind them, so they never clip a ray
+		m_planeNormalXs.resize( m_planeNormalXs.size() + NUM_PLANES_PER_SSE_BATCH, 0.f );
+		m_planeNormalYs.resize( m_planeNormalYs.size() + NUM_PLANES_PER_SSE_BATCH, 0.f );
+		m_planeDistances.resize( m_planeDistances.size() + NUM_PLANES_PER_SSE_BATCH, 1.f );
+	}
+
+	m_planeNormalXs[planeIdx] = newPlane.normal.x;
+	m_planeNormalYs[planeIdx] = newPlane.normal.y;
+	m_planeDistances[planeIdx] = newPlane.distance;
 }
 
 
@@ -30,47 +56,93 @@ bool ConvexHull2D::IsPointInside( const Vec2& point )
 
 
 //-----------------------------------------------------------------------------------------------
-RayConvexHullIntersectionResult ConvexHull2D::GetRayIntersectionResult( const Vec2& rayStartPos, const Vec2& rayForwardNormal )
+RayConvexHullIntersectionResult ConvexHull2D::GetRayIntersectionResult( const Vec2& rayStartPos, const Vec2& rayForwardNormal ) const
 {
-	// Find the furthest entry point on convex hull, since the entry will be the latest instance
-	float entryPointDist = -9999999.f;
-	Vec2 furthestEntryPointAlongRay( rayStartPos );
-	Vec2 surfaceNormalOfIntersectionPlane = Vec2::ZERO;
+	RayConvexHullIntersectionResult missResult( false, 0.f, rayStartPos, Vec2::ZERO );
+
+	__m128 zero = _mm_setzero_ps();
+	__m128 startX = _mm_set1_ps( rayStartPos.x );
+	__m128 startY = _mm_set1_ps( rayStartPos.y );
+	__m128 forwardX = _mm_set1_ps( rayForwardNormal.x );
+	__m128 forwardY = _mm_set1_ps( rayForwardNormal.y );
+
+	// Each lane keeps the latest entry and earliest exit of every 4th plane
+	__m128 entryDists = _mm_set1_ps( -1e30f );
+	__m128 exitDists = _mm_set1_ps( 1e30f );
+	__m128 entryPlaneIndices = _mm_set1_ps( -1.f );
+	__m128 planeIndices = _mm_setr_ps( 0.f, 1.f, 2.f, 3.f );
+	__m128 planeIndexStep = _mm_set1_ps( (float)NUM_PLANES_PER_SSE_BATCH );
+	__m128 missMask = zero;
+
+	for ( int planeIdx = 0; planeIdx < (int)m_planeDistances.size(); planeIdx += NUM_PLANES_PER_SSE_BATCH )
+	{
+		__m128 normalX = _mm_loadu_ps( &m_planeNormalXs[planeIdx] );
+		__m128 normalY = _mm_loadu_ps( &m_planeNormalYs[planeIdx] );
+		__m128 distance = _mm_loadu_ps( &m_planeDistances[planeIdx] );
 
-	for ( int planeIdx = 0; planeIdx < (int)m_boundingPlanes.size(); ++planeIdx )
+		// Positive when the start is in front of the plane
+		__m128 startHeights = _mm_sub_ps( _mm_add_ps( _mm_mul_ps( startX, normalX ), _mm_mul_ps( startY, normalY ) ), distance );
+		// Negative when the ray heads in through the plane
+		__m128 approachRates = _mm_add_ps( _mm_mul_ps( forwardX, normalX ), _mm_mul_ps( forwardY, normalY ) );
+		__m128 planeDists = _mm_div_ps( _mm_sub_ps( zero, startHeights ), approachRates );
+
+		__m128 isEntering = _mm_cmplt_ps( approachRates, zero );
+		__m128 isExiting = _mm_cmpgt_ps( approachRates, zero );
+
+		// Running parallel in front of any plane misses the whole hull
+		missMask = _mm_or_ps( missMask, _mm_andnot_ps( _mm_or_ps( isEntering, isExiting ), _mm_cmpgt_ps( startHeights, zero ) ) );
+
+		__m128 isLaterEntry = _mm_and_ps( isEntering, _mm_cmpgt_ps( planeDists, entryDists ) );
+		entryDists = SelectSSE( isLaterEntry, planeDists, entryDists );
+		entryPlaneIndices = SelectSSE( isLaterEntry, planeIndices, entryPlaneIndices );
+		exitDists = SelectSSE( isExiting, _mm_min_ps( exitDists, planeDists ), exitDists );
+
+		planeIndices = _mm_add_ps( planeIndices, planeIndexStep );
+	}
+
+	if ( _mm_movemask_ps( missMask ) != 0 )
 	{
-		Plane2D const& boundingPlane = m_boundingPlanes[planeIdx];
+		return missResult;
+	}
 
-		// Ignore this plane if it faces away from ray
-		if ( DotProduct2D( rayForwardNormal, boundingPlane.normal ) > 0.f )
+	float laneEntryDists[NUM_PLANES_PER_SSE_BATCH];
+	float laneExitDists[NUM_PLANES_PER_SSE_BATCH];
+	float laneEntryPlaneIndices[NUM_PLANES_PER_SSE_BATCH];
+	_mm_storeu_ps( laneEntryDists, entryDists );
+	_mm_storeu_ps( laneExitDists, exitDists );
+	_mm_storeu_ps( laneEntryPlaneIndices, entryPlaneIndices );
+
+	// Ties go to the lowest plane index to match walking the planes in order
+	float entryDist = laneEntryDists[0];
+	float exitDist = laneExitDists[0];
+	int entryPlaneIdx = (int)laneEntryPlaneIndices[0];
+	for ( int laneIdx = 1; laneIdx < NUM_PLANES_PER_SSE_BATCH; ++laneIdx )
+	{
+		int lanePlaneIdx = (int)laneEntryPlaneIndices[laneIdx];
+		if ( laneEntryDists[laneIdx] > entryDist
+			 || ( laneEntryDists[laneIdx] == entryDist && lanePlaneIdx >= 0 && ( entryPlaneIdx < 0 || lanePlaneIdx < entryPlaneIdx ) ) )
 		{
-			continue;
+			entryDist = laneEntryDists[laneIdx];
+			entryPlaneIdx = lanePlaneIdx;
 		}
 
-		Vec2 intersectionPoint = GetRayIntersectionPointWithPlane2D( rayStartPos, rayForwardNormal, boundingPlane );
-		// Ignore this plane if ray doesn't hit it
-		if ( IsNearlyEqual( intersectionPoint, rayStartPos ) )
-		{
-			continue;
-		}
+		exitDist = Min( exitDist, laneExitDists[laneIdx] );
+	}
 
-		// Ignore this point if it's outside the hull
-		if ( !IsPointInside( intersectionPoint + ( rayForwardNormal * .0001f ) ) )
-		{
-			continue;
-		}
+	if ( entryDist > exitDist
+		 || exitDist < 0.f )
+	{
+		return missResult;
+	}
 
-		// This is a potential entry point, check if it's further along the ray than current candidate
-		float distToIntersectionPoint = GetDistanceSquared2D( rayStartPos, intersectionPoint );
-		if ( distToIntersectionPoint > entryPointDist )
-		{
-			entryPointDist = distToIntersectionPoint;
-			furthestEntryPointAlongRay = intersectionPoint;
-			surfaceNormalOfIntersectionPlane = boundingPlane.normal;
-		}
+	// Starts inside, or every plane it could enter through is behind it
+	if ( entryDist < 0.f
+		 || entryPlaneIdx < 0 )
+	{
+		return RayConvexHullIntersectionResult( true, 0.f, rayStartPos, -rayForwardNormal );
 	}
-	
-	return RayConvexHullIntersectionResult( furthestEntryPointAlongRay, surfaceNormalOfIntersectionPlane );
+
+	return RayConvexHullIntersectionResult( true, entryDist, rayStartPos + ( rayForwardNormal * entryDist ), m_boundingPlanes[entryPlaneIdx].normal );
 }
 
 
@@ -12,12 +12,16 @@ class RenderContext;
 struct RayConvexHullIntersectionResult
 {
 public:
-	Vec2 intersectionPoint = Vec2::ZERO;
+	bool didImpact = false;
+	float impactDist = 0.f;							// Distance along the ray to the entry point, 0 if the ray starts inside
+	Vec2 intersectionPoint = Vec2::ZERO;			// Ray start on a miss
 	Vec2 surfaceNormal = Vec2::ZERO;
 
 public:
-	RayConvexHullIntersectionResult( const Vec2& intersectionPoint, const Vec2& surfaceNormal )
-		: intersectionPoint( intersectionPoint )
+	RayConvexHullIntersectionResult( bool didImpact, float impactDist, const Vec2& intersectionPoint, const Vec2& surfaceNormal )
+		: didImpact( didImpact )
+		, impactDist( impactDist )
+		, intersectionPoint( intersectionPoint )
 		, surfaceNormal( surfaceNormal )
 	{}
 };
@@ -34,10 +38,18 @@ public:
 
 	bool IsPointInside( const Vec2& point );
 
-	RayConvexHullIntersectionResult GetRayIntersectionResult( const Vec2& rayStartPos, const Vec2& rayForwardNormal );
+	// Clips the ray against 4 planes at a time with SSE, the entry is the last plane the ray crosses going in
+	RayConvexHullIntersectionResult GetRayIntersectionResult( const Vec2& rayStartPos, const Vec2& rayForwardNormal ) const;
 
 	void DebugRender( RenderContext* renderer, const Vec2& worldPosition ) const;
 
+	const std::vector<Plane2D>& GetBoundingPlanes() const								{ return m_boundingPlanes; }
+
 private:
 	std::vector<Plane2D> m_boundingPlanes;
+
+	// Planes again as structure of arrays for the SSE ray test, padded to a multiple of 4 with planes every point is behind
+	std::vector<float> m_planeNormalXs;
+	std::vector<float> m_planeNormalYs;
+	std::vector<float> m_planeDistances;
 };
@@ -0,0 +1,225 @@
+#include "Engine/Networking/LoopbackUDPNetwork.hpp"
+#include "Engine/Networking/NetworkingCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+
+#include <chrono>
+#include <cstring>
+
+
+//-----------------------------------------------------------------------------------------------
+LoopbackUDPNetwork::LoopbackUDPNetwork( const LoopbackUDPNetworkConfig& config )
+{
+	SetConfig( config );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void LoopbackUDPNetwork::SetConfig( const LoopbackUDPNetworkConfig& config )
+{
+	std::lock_guard<std::mutex> guard( m_lock );
+	m_config = config;
+	m_rng.Reset( config.seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+LoopbackUDPNetworkConfig LoopbackUDPNetwork::GetConfig()
+{
+	std::lock_guard<std::mutex> guard( m_lock );
+	return m_config;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void LoopbackUDPNetwork::SetNetworkTime( double currentTime )
+{
+	{
+		std::lock_guard<std::mutex> guard( m_lock );
+		m_currentTime = currentTime;
+	}
+
+	// Datagrams may have become due, wake the readers to check
+	m_condition.notify_all();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+double LoopbackUDPNetwork::GetNetworkTime()
+{
+	std::lock_guard<std::mutex> guard( m_lock );
+	return m_currentTime;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void LoopbackUDPNetwork::BindPort( int port )
+{
+	std::lock_guard<std::mutex> guard( m_lock );
+	if ( m_boundPorts.find( port ) != m_boundPorts.end() )
+	{
+		LOG_ERROR( "Loopback UDP port '%i' is already bound", port );
+		return;
+	}
+
+	m_boundPorts[port] = DatagramQueue();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void LoopbackUDPNetwork::UnbindPort( int port )
+{
+	{
+		std::lock_guard<std::mutex> guard( m_lock );
+		m_boundPorts.erase( port );
+	}
+
+	m_condition.notify_all();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void LoopbackUDPNetwork::Send( int fromPort, int toPort, const char* data, size_t length )
+{
+	if ( length > BUFFER_SIZE )
+	{
+		LOG_ERROR( "Loopback UDP datagram of '%i' bytes is larger than the '%i' byte limit", (int)length, BUFFER_SIZE );
+		return;
+	}
+
+	std::lock_guard<std::mutex> guard( m_lock );
+	++m_stats.numSent;
+
+	// Roll everything up front so a datagram's fate doesn't depend on which ports happen to be bound
+	bool isLost = m_rng.RollPercentChance( m_config.lossChance );
+	bool isReordered = m_rng.RollPercentChance( m_config.reorderChance );
+	double jitterSeconds = m_config.jitterSeconds * (double)m_rng.RollRandomFloatZeroToOneInclusive();
+
+	auto portIter = m_boundPorts.find( toPort );
+	if ( portIter == m_boundPorts.end() )
+	{
+		++m_stats.numUndeliverable;
+		return;
+	}
+
+	if ( isLost )
+	{
+		++m_stats.numLost;
+		return;
+	}
+
+	LoopbackUDPDatagram datagram;
+	memcpy( &datagram.data[0], data, length );
+	datagram.length = length;
+	datagram.arrivalTime = m_currentTime + m_config.latencySeconds + jitterSeconds;
+	datagram.sendIdx = m_nextSendIdx++;
+	datagram.fromPort = fromPort;
+
+	if ( isReordered )
+	{
+		datagram.arrivalTime += m_config.reorderDelaySeconds;
+		++m_stats.numReordered;
+	}
+
+	portIter->second.push( datagram );
+	m_condition.notify_all();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+UDPData LoopbackUDPNetwork::Receive( int port, char* receiveBuffer, size_t bufferSize )
+{
+	std::unique_lock<std::mutex> uniqueLock( m_lock );
+
+	auto isDatagramDue = [&]()
+	{
+		auto portIter = m_boundPorts.find( port );
+		return portIter != m_boundPorts.end()
+			&& !portIter->second.empty()
+			&& portIter->second.top().arrivalTime <= m_currentTime;
+	};
+
+	// Time only moves in SetNetworkTime so this can't spin waiting for a clock, the timeout just lets
+	// the reader thread notice it should quit
+	if ( !m_condition.wait_for( uniqueLock, std::chrono::milliseconds( 1 ), isDatagramDue ) )
+	{
+		return UDPData();
+	}
+
+	DatagramQueue& datagrams = m_boundPorts[port];
+	LoopbackUDPDatagram datagram = datagrams.top();
+	datagrams.pop();
+
+	if ( datagram.length > bufferSize - 1 )
+	{
+		LOG_ERROR( "Receive from received too much data for buffer" );
+		return UDPData();
+	}
+
+	memcpy( receiveBuffer, &datagram.data[0], datagram.length );
+	receiveBuffer[datagram.length] = '\0';
+	++m_stats.numDelivered;
+
+	return UDPData( datagram.length, receiveBuffer, "127.0.0.1", datagram.fromPort );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+LoopbackUDPNetworkStats LoopbackUDPNetwork::GetStats()
+{
+	std::lock_guard<std::mutex> guard( m_lock );
+	return m_stats;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+LoopbackUDPTransport::LoopbackUDPTransport( LoopbackUDPNetwork* network, int distantSendToPort )
+	: m_network( network )
+	, m_distantSendToPort( distantSendToPort )
+{
+}
+
+
+//-----------------------------------------------------------------------------------------------
+LoopbackUDPTransport::~LoopbackUDPTransport()
+{
+	Close();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void LoopbackUDPTransport::Bind( int localBindPort )
+{
+	m_localBindPort = localBindPort;
+	m_network->BindPort( localBindPort );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void LoopbackUDPTransport::Close()
+{
+	if ( m_localBindPort != -1 )
+	{
+		m_network->UnbindPort( m_localBindPort );
+		m_localBindPort = -1;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int LoopbackUDPTransport::Send( const char* data, size_t length )
+{
+	m_network->Send( m_localBindPort, m_distantSendToPort, data, length );
+	return (int)length;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+UDPData LoopbackUDPTransport::Receive( char* receiveBuffer, size_t bufferSize )
+{
+	if ( m_localBindPort == -1 )
+	{
+		return UDPData();
+	}
+
+	return m_network->Receive( m_localBindPort, receiveBuffer, bufferSize );
+}
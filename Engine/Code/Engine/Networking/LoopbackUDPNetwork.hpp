@@ -0,0 +1,128 @@
+#pragma once
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Networking/UDPTransport.hpp"
+
+#include <array>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------------------------
+struct LoopbackUDPNetworkConfig
+{
+public:
+	double latencySeconds = 0.0;
+	double jitterSeconds = 0.0;				// Extra random delay up to this much on top of the latency
+	float lossChance = 0.f;
+	float reorderChance = 0.f;				// Chance a datagram is held back so the ones sent after it overtake it
+	double reorderDelaySeconds = 0.02;
+	unsigned int seed = 0;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+struct LoopbackUDPNetworkStats
+{
+public:
+	int numSent = 0;
+	int numLost = 0;
+	int numReordered = 0;
+	int numDelivered = 0;
+	int numUndeliverable = 0;				// Sent to a port nothing was bound to
+};
+
+
+//-----------------------------------------------------------------------------------------------
+struct LoopbackUDPDatagram
+{
+public:
+	std::array<char, BUFFER_SIZE> data;
+	size_t length = 0;
+	double arrivalTime = 0.0;
+	int sendIdx = 0;						// Keeps datagrams arriving at the same time in send order
+	int fromPort = -1;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+struct LoopbackUDPDatagramLater
+{
+public:
+	bool operator()( const LoopbackUDPDatagram& lhs, const LoopbackUDPDatagram& rhs ) const
+	{
+		if ( lhs.arrivalTime != rhs.arrivalTime )
+		{
+			return lhs.arrivalTime > rhs.arrivalTime;
+		}
+
+		return lhs.sendIdx > rhs.sendIdx;
+	}
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// An in-process stand in for the network that delivers datagrams between ports with simulated latency, jitter,
+// loss and reordering. Time only moves when SetNetworkTime is called and all randomness comes from the seed,
+// so the same sends and time steps always produce the same deliveries.
+class LoopbackUDPNetwork
+{
+public:
+	explicit LoopbackUDPNetwork( const LoopbackUDPNetworkConfig& config = LoopbackUDPNetworkConfig() );
+	~LoopbackUDPNetwork() = default;
+
+	LoopbackUDPNetwork( const LoopbackUDPNetwork& other ) = delete;
+	LoopbackUDPNetwork& operator=( const LoopbackUDPNetwork& other ) = delete;
+
+	void	SetConfig( const LoopbackUDPNetworkConfig& config );
+	LoopbackUDPNetworkConfig GetConfig();
+
+	void	SetNetworkTime( double currentTime );
+	double	GetNetworkTime();
+
+	void	BindPort( int port );
+	void	UnbindPort( int port );
+
+	void	Send( int fromPort, int toPort, const char* data, size_t length );
+	// Waits briefly for a datagram to arrive and returns a UDPData with length 0 if none did
+	UDPData	Receive( int port, char* receiveBuffer, size_t bufferSize );
+
+	LoopbackUDPNetworkStats GetStats();
+
+private:
+	typedef std::priority_queue<LoopbackUDPDatagram, std::vector<LoopbackUDPDatagram>, LoopbackUDPDatagramLater> DatagramQueue;
+
+	std::mutex m_lock;
+	std::condition_variable m_condition;
+
+	LoopbackUDPNetworkConfig m_config;
+	RandomNumberGenerator m_rng;
+	double m_currentTime = 0.0;
+	int m_nextSendIdx = 0;
+
+	std::map<int, DatagramQueue> m_boundPorts;
+	LoopbackUDPNetworkStats m_stats;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+class LoopbackUDPTransport : public UDPTransport
+{
+public:
+	LoopbackUDPTransport( LoopbackUDPNetwork* network, int distantSendToPort );
+	virtual ~LoopbackUDPTransport();
+
+	virtual void	Bind( int localBindPort ) override;
+	virtual void	Close() override;
+	virtual int		Send( const char* data, size_t length ) override;
+	virtual UDPData	Receive( char* receiveBuffer, size_t bufferSize ) override;
+
+	virtual int		GetReceivePort() const override			{ return m_localBindPort; }
+
+private:
+	LoopbackUDPNetwork* m_network = nullptr;
+	int m_distantSendToPort = -1;
+	int m_localBindPort = -1;
+};
@@ -4,10 +4,6 @@
 #include <string>
 
 
-//-----------------------------------------------------------------------------------------------
-typedef uint16_t UniqueMessageId;
-
-
 //-----------------------------------------------------------------------------------------------
 enum class eMessasgeProtocolIds : std::uint16_t
 {
@@ -17,6 +13,8 @@ enum class eMessasgeProtocolIds : std::uint16_t
 	SERVER_DISCONNECTING,
 	DATA,
 	ACK,
+	UDP_STRESS_TEST,
+	BATCH,
 };
 
 
@@ -28,17 +26,39 @@ struct MessageHeader
 };
 
 
+//-----------------------------------------------------------------------------------------------
+// Reliable channels number their messages separately, ordered messages are held back until every earlier one has arrived
+enum class eUDPChannel : std::uint8_t
+{
+	UNRELIABLE,
+	RELIABLE_UNORDERED,
+	RELIABLE_ORDERED,
+};
+
+
 //-----------------------------------------------------------------------------------------------
 struct UDPMessageHeader
 {
 	uint16_t id = 0;
 	uint16_t size = 0;
-	uint16_t sequenceNum = 0;
-	uint16_t uniqueId = 0;
+	uint16_t sequenceNum = 0;		// Per connection packet sequence, assigned when the datagram is queued to send
+	uint16_t ack = 0;				// Newest packet sequence received from the other end
+	uint64_t ackBits = 0;			// Bit n set means packet ack - 1 - n was received too
+	uint16_t reliableId = 0;		// Message sequence within the channel, unused for unreliable messages
+	eUDPChannel channel = eUDPChannel::UNRELIABLE;
+	uint8_t hasAck = 0;				// Nothing has been received to ack until the first packet arrives
 	int localBindPort = 0;
 };
 
 
+//-----------------------------------------------------------------------------------------------
+// Each message packed into a BATCH datagram only carries its size, the datagram's UDPMessageHeader covers the rest
+struct UDPBatchedMessageHeader
+{
+	uint16_t size = 0;
+};
+
+
 //-----------------------------------------------------------------------------------------------
 struct ServerListeningMsg
 {
@@ -0,0 +1,137 @@
+#include "Engine/Networking/NetworkingCommon.hpp"
+
+#if defined( _WIN32 )
+
+//-----------------------------------------------------------------------------------------------
+// Winsock Library link
+//-----------------------------------------------------------------------------------------------
+#pragma comment(lib, "Ws2_32.lib")
+
+#else
+
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+#endif
+
+
+//-----------------------------------------------------------------------------------------------
+bool StartupSockets( int& out_errorCode )
+{
+	out_errorCode = 0;
+
+#if defined( _WIN32 )
+	WSADATA wsaData;
+	WORD wVersion MAKEWORD( 2, 2 );
+	int iResult = WSAStartup( wVersion, &wsaData );
+	if ( iResult != 0 )
+	{
+		out_errorCode = WSAGetLastError();
+		return false;
+	}
+#endif
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool ShutdownSockets( int& out_errorCode )
+{
+	out_errorCode = 0;
+
+#if defined( _WIN32 )
+	int iResult = WSACleanup();
+	if ( iResult == SOCKET_ERROR )
+	{
+		out_errorCode = WSAGetLastError();
+		return false;
+	}
+#endif
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int GetLastSocketError()
+{
+#if defined( _WIN32 )
+	return WSAGetLastError();
+#else
+	return errno;
+#endif
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool IsSocketWouldBlockError( int errorCode )
+{
+#if defined( _WIN32 )
+	return errorCode == WSAEWOULDBLOCK;
+#else
+	return errorCode == EWOULDBLOCK || errorCode == EAGAIN;
+#endif
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int CloseSocket( SOCKET socket )
+{
+#if defined( _WIN32 )
+	return closesocket( socket );
+#else
+	// Closing alone doesn't wake a thread blocked in recvfrom on Linux, shutting down the socket first does
+	shutdown( socket, SHUT_RDWR );
+	return close( socket );
+#endif
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool SetSocketBlockingMode( SOCKET socket, eBlockingMode mode )
+{
+#if defined( _WIN32 )
+	u_long nonBlocking = mode == eBlockingMode::NONBLOCKING ? 1 : 0;
+	return ioctlsocket( socket, FIONBIO, &nonBlocking ) != SOCKET_ERROR;
+#else
+	int flags = fcntl( socket, F_GETFL, 0 );
+	if ( flags == -1 )
+	{
+		return false;
+	}
+
+	flags = mode == eBlockingMode::NONBLOCKING ? ( flags | O_NONBLOCK ) : ( flags & ~O_NONBLOCK );
+	return fcntl( socket, F_SETFL, flags ) != -1;
+#endif
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int IsSocketReadable( SOCKET socket )
+{
+	fd_set readSet;
+	FD_ZERO( &readSet );
+	FD_SET( socket, &readSet );
+
+	// Winsock ignores the first argument, POSIX needs the highest descriptor plus one
+	timeval timeout = { 0l, 0l };
+	int iResult = select( (int)socket + 1, &readSet, NULL, NULL, &timeout );
+	if ( iResult == SOCKET_ERROR )
+	{
+		return SOCKET_ERROR;
+	}
+
+	return FD_ISSET( socket, &readSet ) ? 1 : 0;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+std::string GetSocketAddressString( const sockaddr_in& address )
+{
+	char addressStr[INET_ADDRSTRLEN] = {};
+	inet_ntop( AF_INET, (void*)&address.sin_addr, addressStr, sizeof( addressStr ) );
+
+	return Stringf( "%s:%i", addressStr, (int)ntohs( address.sin_port ) );
+}
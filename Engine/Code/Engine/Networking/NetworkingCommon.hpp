@@ -2,6 +2,11 @@
 #include "Engine/Core/StringUtils.hpp"
 
 
+//-----------------------------------------------------------------------------------------------
+// Socket API differences between Winsock and POSIX are kept to this header and NetworkingCommon.cpp,
+// everything else uses the SOCKET type and the helpers below
+#if defined( _WIN32 )
+
 #ifndef _WINSOCK_DEPRECATED_NO_WARNINGS
 #define _WINSOCK_DEPRECATED_NO_WARNINGS
 #endif
@@ -9,6 +14,29 @@
 #include <winsock2.h>
 #include <ws2tcpip.h>
 
+typedef int SocketAddressLength;
+
+constexpr int SOCKET_SEND_FLAGS = 0;
+
+#else
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+
+typedef int SOCKET;
+typedef socklen_t SocketAddressLength;
+
+constexpr SOCKET INVALID_SOCKET = -1;
+constexpr int SOCKET_ERROR = -1;
+
+// A peer closing a TCP connection shouldn't raise SIGPIPE and kill the process
+constexpr int SOCKET_SEND_FLAGS = MSG_NOSIGNAL;
+
+#endif
+
 
 class DevConsole;
 extern DevConsole* g_devConsole;
@@ -26,3 +54,20 @@ enum class eBlockingMode
 	BLOCKING,
 	NONBLOCKING
 };
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns false and sets out_errorCode if the socket library couldn't be started
+bool	StartupSockets( int& out_errorCode );
+bool	ShutdownSockets( int& out_errorCode );
+
+int		GetLastSocketError();
+bool	IsSocketWouldBlockError( int errorCode );
+int		CloseSocket( SOCKET socket );
+bool	SetSocketBlockingMode( SOCKET socket, eBlockingMode mode );
+
+// Zero timeout check for whether a recv or accept on the socket would return immediately, returns SOCKET_ERROR on failure
+int		IsSocketReadable( SOCKET socket );
+
+// Formats the address as "<ip4 address>:<port>"
+std::string GetSocketAddressString( const sockaddr_in& address );
@@ -6,18 +6,12 @@
 #include "Engine/Core/EventSystem.hpp"
 #include "Engine/Core/DevConsole.hpp"
 #include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Time/Time.hpp"
 
+#include <algorithm>
 #include <array>
-#include <chrono>
 #include <ctime>
-#include <winsock2.h>
-#include <ws2tcpip.h>
-
-
-//-----------------------------------------------------------------------------------------------
-// Winsock Library link
-//-----------------------------------------------------------------------------------------------
-#pragma comment(lib, "Ws2_32.lib")
 
 
 //-----------------------------------------------------------------------------------------------
@@ -34,19 +28,16 @@ void NetworkingSystem::Startup()
 	g_eventSystem->RegisterMethodEvent( "open_udp_port",	"Open a UDP port and specify target port, bindPort=<port number> sendToPort=<port number> ip=<ip address>", eUsageLocation::DEV_CONSOLE, this, &NetworkingSystem::OpenAndBindUDPPort );
 	g_eventSystem->RegisterMethodEvent( "close_udp_port",	"Close a UDP port, bindPort=<port number>", eUsageLocation::DEV_CONSOLE, this, &NetworkingSystem::CloseUDPPort );
 	g_eventSystem->RegisterMethodEvent( "send_udp_message", "Send a message, msg=\"<message text>\"", eUsageLocation::DEV_CONSOLE, this, &NetworkingSystem::SendUDPMessage );
-
-	std::chrono::time_point<std::chrono::system_clock> now = std::chrono::system_clock::now();
-	auto duration = now.time_since_epoch();
-	auto millis = std::chrono::duration_cast<std::chrono::milliseconds>( duration ).count();
-	m_rng.Reset( (uint)millis );
-
-	// Initialize winsock
-	WSADATA wsaData;
-	WORD wVersion MAKEWORD( 2, 2 );
-	int iResult = WSAStartup( wVersion, &wsaData );
-	if ( iResult != 0 )
+	g_eventSystem->RegisterMethodEvent( "udp_stress_test",	"Flood a loopback UDP port, port=<port number> rate=<datagrams per second> seconds=<duration>", eUsageLocation::DEV_CONSOLE, this, &NetworkingSystem::StartUDPStressTest );
+	g_eventSystem->RegisterMethodEvent( "udp_batching",		"Pack unreliable game messages into shared datagrams, enabled=<bool>", eUsageLocation::DEV_CONSOLE, this, &NetworkingSystem::SetUDPBatchingEnabled );
+	g_eventSystem->RegisterMethodEvent( "udp_stats",		"Print UDP send rates, header overhead and per connection round trip and resend stats", eUsageLocation::DEV_CONSOLE, this, &NetworkingSystem::PrintUDPStats );
+	g_eventSystem->RegisterMethodEvent( "udp_send_benchmark", "Time sending datagrams over a real loopback socket one sendto each vs SendBatch, count=<datagrams> size=<bytes> port=<port number>", eUsageLocation::DEV_CONSOLE, this, &NetworkingSystem::RunUDPSendBenchmark );
+	g_eventSystem->RegisterMethodEvent( "udp_loopback",		"Open new UDP ports on a simulated in-process network, enabled=<bool> latency=<seconds> jitter=<seconds> loss=<0-1> reorder=<0-1> seed=<int>", eUsageLocation::DEV_CONSOLE, this, &NetworkingSystem::SetLoopbackUDPEnabled );
+
+	int errorCode = 0;
+	if ( !StartupSockets( errorCode ) )
 	{
-		g_devConsole->PrintError( Stringf( "Networking System: WSAStartup failed with '%i'", WSAGetLastError() ) );
+		g_devConsole->PrintError( Stringf( "Networking System: socket startup failed with '%i'", errorCode ) );
 	}
 	
 	m_tcpServer = new TCPServer( eBlockingMode::NONBLOCKING );
@@ -60,17 +51,26 @@ void NetworkingSystem::Startup()
 //-----------------------------------------------------------------------------------------------
 void NetworkingSystem::BeginFrame()
 {
+	if ( m_loopbackUDPNetwork != nullptr )
+	{
+		m_loopbackUDPNetwork->SetNetworkTime( GetCurrentTimeSeconds() );
+	}
+
 	ProcessTCPCommunication();
+	UpdateUDPStressTest();
 	ProcessUDPCommunication();
 	ClearProcessedUDPMessages();
-	RetryReliableUDPMessages();
+	SendReliableUDPMessages();
+	UpdateUDPSendStats();
 }
 
 
 //-----------------------------------------------------------------------------------------------
 void NetworkingSystem::EndFrame()
 {
-
+	FlushUDPMessageBatches();
+	SendUDPAcks();
+	HandOffStagedUDPMessages();
 }
 
 
@@ -85,7 +85,7 @@ void NetworkingSystem::Shutdown()
 	PTR_SAFE_DELETE( m_tcpClient );
 	PTR_SAFE_DELETE( m_tcpServer );
 
-	m_outgoingMessages.NotifyAll();
+	m_outgoingMessages.StopWaiting();
 	
 	for ( auto& udpSocket : m_outgoingUDPSockets )
 	{
@@ -118,15 +118,22 @@ void NetworkingSystem::Shutdown()
 	m_udpReaderThread->join();
 	m_udpWriterThread->join();
 
+	for ( auto& connection : m_udpConnections )
+	{
+		connection.second->ReleaseBufferedMessages( m_udpPacketPool );
+	}
+
+	PTR_MAP_SAFE_DELETE( m_udpConnections );
 	PTR_MAP_SAFE_DELETE( m_outgoingUDPSockets );
 	PTR_MAP_SAFE_DELETE( m_localBoundUDPSockets );
+	PTR_SAFE_DELETE( m_loopbackUDPNetwork );
 	PTR_SAFE_DELETE( m_udpReaderThread );
 	PTR_SAFE_DELETE( m_udpWriterThread );
 
-	int iResult = WSACleanup();
-	if ( iResult == SOCKET_ERROR )
+	int errorCode = 0;
+	if ( !ShutdownSockets( errorCode ) )
 	{
-		g_devConsole->PrintError( Stringf( "Networking System: WSACleanup failed with '%i'", WSAGetLastError() ) );
+		g_devConsole->PrintError( Stringf( "Networking System: socket shutdown failed with '%i'", errorCode ) );
 	}
 }
 
@@ -306,14 +313,41 @@ void NetworkingSystem::ReceiveMessageFromTCPClient()
 //-----------------------------------------------------------------------------------------------
 void NetworkingSystem::ProcessUDPCommunication()
 {
-	UDPData data;
-	if ( !m_incomingMessages.Pop( data )
-		 || data.GetLength() <= 0 )
+	// Take everything the reader threads have queued so far in one go
+	m_newIncomingMessages.clear();
+	m_udpReceiveStats.numReceived = m_incomingMessages.PopAll( m_newIncomingMessages );
+
+	for ( const UDPData& data : m_newIncomingMessages )
 	{
-		return;
+		m_unprocessedIncomingMessages.push( data );
 	}
 
-	// Process message
+	int numProcessed = 0;
+	while ( !m_unprocessedIncomingMessages.empty()
+			&& numProcessed < MAX_UDP_MESSAGES_PROCESSED_PER_FRAME )
+	{
+		// Messages that weren't handed to the game are done with their packet as soon as they are processed
+		UDPData& data = m_unprocessedIncomingMessages.front();
+		if ( data.GetLength() == 0
+			 || !ProcessUDPMessage( data ) )
+		{
+			m_udpPacketPool.Release( data.GetData() );
+		}
+
+		m_unprocessedIncomingMessages.pop();
+		++numProcessed;
+	}
+
+	m_udpReceiveStats.numProcessed = numProcessed;
+	m_udpReceiveStats.numBacklogged = (int)m_unprocessedIncomingMessages.size();
+	m_udpReceiveStats.numDropped = m_numDroppedUDPMessages.load( std::memory_order_relaxed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the message was added to m_udpReceivedMessages and still needs its packet
+bool NetworkingSystem::ProcessUDPMessage( UDPData& data )
+{
 	const UDPMessageHeader* udpHeader = reinterpret_cast<const UDPMessageHeader*>( data.GetData() );
 	switch ( udpHeader->id )
 	{
@@ -323,80 +357,98 @@ void NetworkingSystem::ProcessUDPCommunication()
 		}
 		break;
 		
-		case (uint16_t)eMessasgeProtocolIds::DATA:
+		case (uint16_t)eMessasgeProtocolIds::DATA:					ReceiveUDPPacketHeader( *udpHeader ); return ProcessUDPDataMessage( data );
+		case (uint16_t)eMessasgeProtocolIds::ACK:					ReceiveUDPPacketHeader( *udpHeader ); break;
+		case (uint16_t)eMessasgeProtocolIds::UDP_STRESS_TEST:		++m_udpStressTest.numReceived; break;
+		case (uint16_t)eMessasgeProtocolIds::BATCH:					ReceiveUDPPacketHeader( *udpHeader ); ProcessUDPBatchMessage( data ); break;
+
+		default:
 		{
-			// This is a reliable message if it has a valid uniqueId
-			UniqueMessageId uniqueMsgId = udpHeader->uniqueId;
-			int distantToPort = udpHeader->localBindPort;
-			data.SetFromPort( distantToPort );
-			if ( uniqueMsgId > 0 )
-			{
-				// Send an ack for the reliable message
-				UDPMessageHeader ackHeader;
-				ackHeader.id = (uint16_t)eMessasgeProtocolIds::ACK;
-				ackHeader.size = (uint16_t)1;
-				ackHeader.uniqueId = uniqueMsgId;
-				//ackHeader.localBindPort = m_localBoundUDPSocket->GetReceivePort();
-				ackHeader.localBindPort = m_localBoundUDPSockets[distantToPort]->GetReceivePort();
+			g_devConsole->PrintError( Stringf( "Received msg with unknown id: %i", udpHeader->id ) );
+		}
+		break;
+	}
 
-				//g_devConsole->PrintString( Stringf( "Received reliable message %i from port %i", uniqueMsgId, ackHeader.localBindPort ), Rgba8::ORANGE );
+	return false;
+}
 
-				std::array<char, 512> buffer;
-				memcpy( &buffer, &ackHeader, sizeof( UDPMessageHeader ) );
-				buffer[sizeof( UDPMessageHeader ) + 1] = '\0';
 
-				UDPMessage udpMessage( distantToPort, buffer );
-				//UDPMessage udpMessage( data.GetFromPort(), buffer );
+//-----------------------------------------------------------------------------------------------
+bool NetworkingSystem::ProcessUDPDataMessage( UDPData& data )
+{
+	const UDPMessageHeader* udpHeader = reinterpret_cast<const UDPMessageHeader*>( data.GetData() );
 
-				m_outgoingMessages.Push( udpMessage );
+	int distantToPort = udpHeader->localBindPort;
+	data.SetFromPort( distantToPort );
+	if ( udpHeader->channel == eUDPChannel::UNRELIABLE )
+	{
+		m_udpReceivedMessages.push_back( data );
+		return true;
+	}
 
-				// If we have already received this message, break to avoid processing it again
-				const auto& receivedIter = m_receivedReliableMessages.find( distantToPort );
-				if ( receivedIter != m_receivedReliableMessages.end() )
-				{
-					// This port has an entry, look for message id
-					if ( receivedIter->second.find( uniqueMsgId ) != receivedIter->second.end() )
-					{
-						break;
-					}
-
-					// Add in new message id
-					receivedIter->second.insert( uniqueMsgId );
-				}
-				else
-				{
-					// We haven't seen any messages from this port, create a new set with id and add it to map
-					std::unordered_set<UniqueMessageId> uniqueIdSet = { uniqueMsgId };
-					m_receivedReliableMessages[distantToPort] = uniqueIdSet;
-				}
+	// The connection drops duplicates and holds ordered messages back until the ones before them arrive
+	return GetUDPConnection( distantToPort )->ReceiveReliableMessage( data, m_udpReceivedMessages );
+}
 
-			}
 
-			m_udpReceivedMessages.push_back( data );
-		}
-		break;
+//-----------------------------------------------------------------------------------------------
+// Acks ride on every DATA, BATCH and ACK datagram, this also records the packet so it gets acked in turn
+void NetworkingSystem::ReceiveUDPPacketHeader( const UDPMessageHeader& header )
+{
+	UDPConnection* connection = GetUDPConnection( header.localBindPort );
+	connection->ReceivePacketHeader( header, GetCurrentTimeSeconds() );
+
+	// Waiting for the end of the frame would let the oldest packets slide out of the ack bitfield unacked
+	if ( connection->NeedsImmediateAck() )
+	{
+		SendUDPAck( header.localBindPort );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void NetworkingSystem::ProcessUDPBatchMessage( const UDPData& data )
+{
+	const UDPMessageHeader* batchHeader = reinterpret_cast<const UDPMessageHeader*>( data.GetData() );
+
+	size_t batchEnd = Min( sizeof( UDPMessageHeader ) + (size_t)batchHeader->size, data.GetLength() );
+	size_t readPos = sizeof( UDPMessageHeader );
+	while ( readPos + sizeof( UDPBatchedMessageHeader ) <= batchEnd )
+	{
+		const UDPBatchedMessageHeader* messageHeader = reinterpret_cast<const UDPBatchedMessageHeader*>( data.GetData() + readPos );
+		readPos += sizeof( UDPBatchedMessageHeader );
 
-		case (uint16_t)eMessasgeProtocolIds::ACK:
+		size_t messageSize = (size_t)messageHeader->size;
+		if ( readPos + messageSize > batchEnd )
 		{
-			// Remove message from retry list once an ack is received for it			
-			UniqueMessageId ackId = udpHeader->uniqueId;
+			g_devConsole->PrintError( Stringf( "Received truncated UDP batch from port %i", batchHeader->localBindPort ) );
+			return;
+		}
 
-			auto reliableMessageIter = m_reliableUDPMessagesToRetry.find( ackId );
-			if ( reliableMessageIter != m_reliableUDPMessagesToRetry.end() )
-			{
-				g_devConsole->PrintString( Stringf( "Received ack for %i from port %i after retrying %i times", ackId, reliableMessageIter->second.udpMessage.sendToPort, reliableMessageIter->second.retryCount ), Rgba8::GREEN );
-				reliableMessageIter->second.hasBeenAcked = true;
-			}
-			m_reliableUDPMessagesToRetry.erase( ackId );
+		// Give each message its own packet with a full header so the game sees an ordinary DATA message
+		char* packet = m_udpPacketPool.Acquire();
+		if ( packet == nullptr )
+		{
+			m_numDroppedUDPMessages.fetch_add( 1, std::memory_order_relaxed );
+			readPos += messageSize;
+			continue;
 		}
-		break;
 
-		default:
+		UDPMessageHeader* msgHeader = reinterpret_cast<UDPMessageHeader*>( packet );
+		*msgHeader = UDPMessageHeader();
+		msgHeader->id = (uint16_t)eMessasgeProtocolIds::DATA;
+		msgHeader->size = messageHeader->size;
+		msgHeader->localBindPort = batchHeader->localBindPort;
+
+		memcpy( packet + sizeof( UDPMessageHeader ), data.GetData() + readPos, messageSize );
+		packet[sizeof( UDPMessageHeader ) + messageSize] = '\0';
+		readPos += messageSize;
+
+		UDPData messageData( sizeof( UDPMessageHeader ) + messageSize, packet, data.GetFromAddress(), data.GetFromPort() );
+		if ( !ProcessUDPDataMessage( messageData ) )
 		{
-			g_devConsole->PrintError( Stringf( "Received msg with unknown id: %i", udpHeader->id ) );
-			return;
+			m_udpPacketPool.Release( packet );
 		}
-		break;
 	}
 }
 
@@ -417,10 +469,29 @@ void NetworkingSystem::UDPReaderThreadMain( int localUDPPort )
 			continue;
 		}
 
-		UDPData data = iter->second->Receive();
-		if ( data.GetLength() > 0 )
+		// Receive straight into a pooled packet, the packet travels with the UDPData until the message is cleared
+		char* packet = m_udpPacketPool.Acquire();
+		if ( packet == nullptr )
+		{
+			// Still read the datagram so the socket doesn't back up, but there is nowhere to keep it
+			std::array<char, BUFFER_SIZE> discardBuffer;
+			UDPData discardedData = iter->second->Receive( &discardBuffer[0], discardBuffer.size() );
+			if ( discardedData.GetLength() > 0 )
+			{
+				m_numDroppedUDPMessages.fetch_add( 1, std::memory_order_relaxed );
+			}
+			continue;
+		}
+
+		UDPData data = iter->second->Receive( packet, (size_t)m_udpPacketPool.GetPacketSize() );
+		if ( data.GetLength() == 0 )
+		{
+			m_udpPacketPool.Release( packet );
+		}
+		else if ( !m_incomingMessages.Push( data ) )
 		{
-			m_incomingMessages.Push( data );
+			m_udpPacketPool.Release( packet );
+			m_numDroppedUDPMessages.fetch_add( 1, std::memory_order_relaxed );
 		}
 		//}
 	}
@@ -430,99 +501,207 @@ void NetworkingSystem::UDPReaderThreadMain( int localUDPPort )
 //-----------------------------------------------------------------------------------------------
 void NetworkingSystem::UDPWriterThreadMain()
 {
+	std::vector<UDPMessage> messages;
+	std::vector<int> messageIndices;
+	std::vector<UDPDatagramView> datagrams;
+
 	while ( !m_isQuitting )
 	{
-		UDPMessage message = m_outgoingMessages.Pop();
-		UDPMessageHeader* msgHeader = reinterpret_cast<UDPMessageHeader*>( &message.data[0] );
+		messages.clear();
+		if ( m_outgoingMessages.WaitAndPopAll( messages ) == 0 )
+		{
+			continue;
+		}
+
+		double startTime = GetCurrentTimeSeconds();
+		++m_numUDPWriterWakeups;
 
-		while ( msgHeader->size > 0 )
+		// Group by destination so each transport gets a single batch, stable so datagrams to one port keep their order
+		messageIndices.resize( messages.size() );
+		for ( int messageIdx = 0; messageIdx < (int)messages.size(); ++messageIdx )
 		{
-			UDPSocket* udpSocket = nullptr;
-			auto udpSocketIter = m_outgoingUDPSockets.find( message.sendToPort );
-			if ( udpSocketIter == m_outgoingUDPSockets.end() )
+			messageIndices[messageIdx] = messageIdx;
+		}
+
+		std::stable_sort( messageIndices.begin(), messageIndices.end(), 
+						  [&]( int a, int b )
+						  {
+							  return messages[a].sendToPort < messages[b].sendToPort;
+						  } );
+
+		int groupStartIdx = 0;
+		while ( groupStartIdx < (int)messageIndices.size() )
+		{
+			int sendToPort = messages[messageIndices[groupStartIdx]].sendToPort;
+			int groupEndIdx = groupStartIdx + 1;
+			while ( groupEndIdx < (int)messageIndices.size()
+					&& messages[messageIndices[groupEndIdx]].sendToPort == sendToPort )
 			{
-				// This is on a client with only 1 connection, send back on that socket
-				if ( m_outgoingUDPSockets.size() == 1 )
+				++groupEndIdx;
+			}
+
+			datagrams.clear();
+			for ( int groupIdx = groupStartIdx; groupIdx < groupEndIdx; ++groupIdx )
+			{
+				const UDPMessage& message = messages[messageIndices[groupIdx]];
+				const UDPMessageHeader* msgHeader = reinterpret_cast<const UDPMessageHeader*>( &message.data[0] );
+				if ( msgHeader->size == 0 )
 				{
-					udpSocket = m_outgoingUDPSockets.begin()->second;
+					continue;
 				}
+
+				UDPDatagramView datagram;
+				datagram.data = &message.data[0];
+				datagram.length = sizeof( UDPMessageHeader ) + msgHeader->size + 1;
+				datagrams.push_back( datagram );
 			}
-			else
+
+			UDPTransport* udpSocket = GetOutgoingUDPTransport( sendToPort );
+			if ( udpSocket != nullptr
+				 && !datagrams.empty() )
 			{
-				udpSocket = udpSocketIter->second;
+				int numSendCalls = 0;
+				m_numUDPWriterDatagrams += udpSocket->SendBatch( &datagrams[0], (int)datagrams.size(), numSendCalls );
+				m_numUDPWriterSendCalls += numSendCalls;
 			}
 
-			// Get next message and retry
-			if ( udpSocket == nullptr )
-			{
-				message = m_outgoingMessages.Pop();
-				msgHeader = reinterpret_cast<UDPMessageHeader*>( &message.data[0] );
+			groupStartIdx = groupEndIdx;
+		}
 
-				continue;
-			}
+		m_udpWriterBusyMicroseconds += (long long)( ( GetCurrentTimeSeconds() - startTime ) * 1000000.0 );
+	}
+}
 
-			// Copy the header and data into the buffer.
-			udpSocket->SendBuffer() = message.data;
 
-			udpSocket->Send( sizeof( UDPMessageHeader ) + msgHeader->size + 1 );
+//-----------------------------------------------------------------------------------------------
+UDPTransport* NetworkingSystem::GetOutgoingUDPTransport( int distantSendToPort )
+{
+	auto udpSocketIter = m_outgoingUDPSockets.find( distantSendToPort );
+	if ( udpSocketIter != m_outgoingUDPSockets.end() )
+	{
+		return udpSocketIter->second;
+	}
 
-			message = m_outgoingMessages.Pop();
-			msgHeader = reinterpret_cast<UDPMessageHeader*>( &message.data[0] );
-		}
+	// This is on a client with only 1 connection, send back on that socket
+	if ( m_outgoingUDPSockets.size() == 1 )
+	{
+		return m_outgoingUDPSockets.begin()->second;
 	}
+
+	return nullptr;
 }
 
 
 //-----------------------------------------------------------------------------------------------
 void NetworkingSystem::ClearProcessedUDPMessages()
 {
-	std::vector<int> indicesToDelete;
+	int numExpired = 0;
+	auto firstProcessedIter = std::remove_if( m_udpReceivedMessages.begin(), m_udpReceivedMessages.end(), 
+											  [&]( UDPData& data ) 
+											  {
+												  if ( !data.HasBeenProcessed() )
+												  {
+													  data.IncrementFramesUnprocessed();
+													  if ( data.GetNumFramesUnprocessed() <= MAX_FRAMES_UDP_MESSAGE_UNPROCESSED )
+													  {
+														  return false;
+													  }
+
+													  ++numExpired;
+												  }
+
+												  m_udpPacketPool.Release( data.GetData() );
+												  return true;
+											  } );
+
+	m_udpReceivedMessages.erase( firstProcessedIter, m_udpReceivedMessages.end() );
+	m_udpReceiveStats.numExpired = numExpired;
+}
+
 
-	for ( int udpMsgIdx = (int)m_udpReceivedMessages.size() - 1; udpMsgIdx >= 0; --udpMsgIdx )
+//-----------------------------------------------------------------------------------------------
+void NetworkingSystem::SendReliableUDPMessages()
+{
+	for ( auto& connection : m_udpConnections )
 	{
-		if ( m_udpReceivedMessages[udpMsgIdx].HasBeenProcessed() )
-		{
-			indicesToDelete.push_back( udpMsgIdx );
-		}
+		SendReliableUDPMessages( connection.first, *connection.second );
 	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Sends reliable messages that haven't gone out yet or whose resend timer has run out
+void NetworkingSystem::SendReliableUDPMessages( int distantSendToPort, UDPConnection& connection )
+{
+	m_reliableUDPMessagesToSend.clear();
+	connection.GetReliableMessagesToSend( GetCurrentTimeSeconds(), m_reliableUDPMessagesToSend );
 
-	for ( int idx : indicesToDelete )
+	for ( const std::array<char, 512>& messageData : m_reliableUDPMessagesToSend )
 	{
-		m_udpReceivedMessages.erase( m_udpReceivedMessages.begin() + idx );
+		PushOutgoingUDPMessage( UDPMessage( distantSendToPort, messageData ) );
 	}
 }
 
 
 //-----------------------------------------------------------------------------------------------
-void NetworkingSystem::RetryReliableUDPMessages()
+// Connections that received something this frame but had nothing to send back get an ack only datagram
+void NetworkingSystem::SendUDPAcks()
 {
-	std::vector<UniqueMessageId> expiredMessages;
-
-	for ( auto& reliableMessage : m_reliableUDPMessagesToRetry )
+	for ( auto& connection : m_udpConnections )
 	{
-		++reliableMessage.second.retryCount;
-		
-		// Only start retrying after the message has been sent once by the usual means
-		if ( reliableMessage.second.retryCount > 1 )
+		if ( connection.second->NeedsAck() )
 		{
-			m_outgoingMessages.Push( reliableMessage.second.udpMessage );
-		}
-		
-		if ( reliableMessage.second.retryCount > reliableMessage.second.maxRetryCount )
-		{
-			if ( reliableMessage.second.hasBeenAcked == false )
-			{
-				//g_devConsole->PrintString( Stringf( "Abandoning reliable message to port %i after 1000 retries", reliableMessage.second.udpMessage.sendToPort ) );
-			}
-			expiredMessages.push_back( reliableMessage.first );
+			SendUDPAck( connection.first );
 		}
 	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void NetworkingSystem::SendUDPAck( int distantSendToPort )
+{
+	auto localSocketIter = m_localBoundUDPSockets.find( distantSendToPort );
+	if ( localSocketIter == m_localBoundUDPSockets.end()
+		 || localSocketIter->second == nullptr )
+	{
+		return;
+	}
+
+	std::array<char, 512> buffer = {};
+	UDPMessageHeader* ackHeader = reinterpret_cast<UDPMessageHeader*>( &buffer[0] );
+	ackHeader->id = (uint16_t)eMessasgeProtocolIds::ACK;
+	ackHeader->size = (uint16_t)1;		// The writer thread skips empty messages, the payload is just the null terminator
+	ackHeader->localBindPort = localSocketIter->second->GetReceivePort();
+
+	PushOutgoingUDPMessage( UDPMessage( distantSendToPort, buffer ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+UDPConnection* NetworkingSystem::GetUDPConnection( int distantPort )
+{
+	UDPConnection*& connection = m_udpConnections[distantPort];
+	if ( connection == nullptr )
+	{
+		connection = new UDPConnection();
+	}
+
+	return connection;
+}
+
 
-	// Clean out old messages
-	for ( const auto& expiredMessageId : expiredMessages )
+//-----------------------------------------------------------------------------------------------
+void NetworkingSystem::DeleteUDPConnection( int distantPort )
+{
+	auto connectionIter = m_udpConnections.find( distantPort );
+	if ( connectionIter == m_udpConnections.end() )
 	{
-		m_reliableUDPMessagesToRetry.erase( expiredMessageId );
+		return;
 	}
+
+	connectionIter->second->ReleaseBufferedMessages( m_udpPacketPool );
+	PTR_SAFE_DELETE( connectionIter->second );
+	m_udpConnections.erase( connectionIter );
 }
 
 
@@ -780,7 +959,10 @@ void NetworkingSystem::OpenAndBindUDPPort( int localBindPort, int distantSendToP
 	//m_udpSocket = new UDPSocket( "", distantSendToPort );
 	//m_localBoundUDPSocket->Bind( localBindPort );
 
-	m_localBoundUDPSockets[distantSendToPort] = new UDPSocket( ipAddress, distantSendToPort );
+	// A new binding is a new session, sequence numbers from an earlier one would look like duplicates
+	DeleteUDPConnection( distantSendToPort );
+
+	m_localBoundUDPSockets[distantSendToPort] = CreateUDPTransport( distantSendToPort, ipAddress );
 	m_localBoundUDPSockets[distantSendToPort]->Bind( localBindPort );
 
 	m_udpReaderThreads.push_back( new std::thread( &NetworkingSystem::UDPReaderThreadMain, this, distantSendToPort ) );
@@ -790,7 +972,41 @@ void NetworkingSystem::OpenAndBindUDPPort( int localBindPort, int distantSendToP
 //-----------------------------------------------------------------------------------------------
 void NetworkingSystem::CreateAndRegisterUDPSocket( int distantSendToPort, const std::string& ipAddress )
 {
-	m_outgoingUDPSockets[distantSendToPort] = new UDPSocket( ipAddress, distantSendToPort );
+	m_outgoingUDPSockets[distantSendToPort] = CreateUDPTransport( distantSendToPort, ipAddress );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+UDPTransport* NetworkingSystem::CreateUDPTransport( int distantSendToPort, const std::string& ipAddress )
+{
+	if ( m_isLoopbackUDPEnabled )
+	{
+		return new LoopbackUDPTransport( m_loopbackUDPNetwork, distantSendToPort );
+	}
+
+	return new UDPSocket( ipAddress, distantSendToPort );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void NetworkingSystem::SetLoopbackUDPEnabled( bool isEnabled, const LoopbackUDPNetworkConfig& config )
+{
+	m_isLoopbackUDPEnabled = isEnabled;
+	if ( !isEnabled )
+	{
+		return;
+	}
+
+	if ( m_loopbackUDPNetwork == nullptr )
+	{
+		m_loopbackUDPNetwork = new LoopbackUDPNetwork( config );
+	}
+	else
+	{
+		m_loopbackUDPNetwork->SetConfig( config );
+	}
+
+	m_loopbackUDPNetwork->SetNetworkTime( GetCurrentTimeSeconds() );
 }
 
 
@@ -811,12 +1027,14 @@ void NetworkingSystem::CloseUDPPort( int localBindPort )
 	{
 		return;
 	}
-	UDPSocket* udpSocket = udpSocketIter->second;
+	UDPTransport* udpSocket = udpSocketIter->second;
 
 	udpSocket->Close();
 	PTR_SAFE_DELETE( udpSocket );
 
 	m_outgoingUDPSockets.erase( localBindPort );
+	m_outgoingUDPMessageBatches.erase( localBindPort );
+	DeleteUDPConnection( localBindPort );
 }
 
 
@@ -830,40 +1048,386 @@ void NetworkingSystem::SendUDPMessage( EventArgs* args )
 
 
 //-----------------------------------------------------------------------------------------------
-void NetworkingSystem::SendUDPMessage( int distantSendToPort, void* data, size_t dataSize, bool isReliable, int retryCount )
+void NetworkingSystem::SendUDPMessage( int distantSendToPort, const void* data, size_t dataSize, eUDPChannel channel, int maxResendCount )
 {
 	std::array<char, 512> buffer = {};
 	UDPMessageHeader* msgHeader = reinterpret_cast<UDPMessageHeader*>( &buffer[0] );
 
 	msgHeader->id = (uint16_t)eMessasgeProtocolIds::DATA;
 	msgHeader->size = (uint16_t)dataSize;
-	msgHeader->sequenceNum = (uint16_t)0;
 	msgHeader->localBindPort = m_localBoundUDPSockets[distantSendToPort]->GetReceivePort();
 
-	if ( isReliable )
+	memcpy( &buffer[sizeof( UDPMessageHeader )], data, msgHeader->size );
+
+	buffer[sizeof( UDPMessageHeader ) + msgHeader->size] = '\0';
+
+	if ( channel == eUDPChannel::UNRELIABLE )
 	{
-		msgHeader->uniqueId = GetNextUniqueMessageId();
+		PushOutgoingUDPMessage( UDPMessage( distantSendToPort, buffer ) );
+		return;
 	}
 
-	memcpy( &buffer[sizeof( UDPMessageHeader )], data, msgHeader->size );
+	// The connection assigns the message its id and keeps it until acked, it goes out now unless the channel's window is full
+	UDPConnection* connection = GetUDPConnection( distantSendToPort );
+	connection->QueueReliableMessage( buffer, channel, maxResendCount );
+	SendReliableUDPMessages( distantSendToPort, *connection );
+}
 
-	buffer[sizeof( UDPMessageHeader ) + msgHeader->size] = '\0';
 
-	UDPMessage udpMessage( distantSendToPort, buffer );
-	if ( isReliable )
+//-----------------------------------------------------------------------------------------------
+void NetworkingSystem::SendBatchedUDPMessage( int distantSendToPort, const void* data, size_t dataSize )
+{
+	constexpr size_t MAX_BATCHED_MESSAGE_SIZE = (size_t)MAX_UDP_MESSAGE_PAYLOAD_SIZE - sizeof( UDPBatchedMessageHeader );
+	if ( !m_isUDPBatchingEnabled
+		 || dataSize > MAX_BATCHED_MESSAGE_SIZE )
+	{
+		SendUDPMessage( distantSendToPort, data, dataSize );
+		return;
+	}
+
+	UDPMessageBatch& batch = m_outgoingUDPMessageBatches[distantSendToPort];
+
+	size_t batchedSize = sizeof( UDPBatchedMessageHeader ) + dataSize;
+	if ( (size_t)batch.payloadSize + batchedSize > (size_t)MAX_UDP_MESSAGE_PAYLOAD_SIZE )
+	{
+		FlushUDPMessageBatch( distantSendToPort, batch );
+	}
+
+	char* writePos = &batch.data[sizeof( UDPMessageHeader ) + batch.payloadSize];
+
+	UDPBatchedMessageHeader messageHeader;
+	messageHeader.size = (uint16_t)dataSize;
+	memcpy( writePos, &messageHeader, sizeof( UDPBatchedMessageHeader ) );
+	memcpy( writePos + sizeof( UDPBatchedMessageHeader ), data, dataSize );
+
+	batch.payloadSize += (int)batchedSize;
+	++batch.numMessages;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void NetworkingSystem::FlushUDPMessageBatches()
+{
+	for ( auto& batch : m_outgoingUDPMessageBatches )
+	{
+		FlushUDPMessageBatch( batch.first, batch.second );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void NetworkingSystem::FlushUDPMessageBatch( int distantSendToPort, UDPMessageBatch& batch )
+{
+	if ( batch.numMessages == 0 )
+	{
+		return;
+	}
+
+	// The port was closed or never bound, there's nowhere to send from so drop what was batched
+	auto localSocketIter = m_localBoundUDPSockets.find( distantSendToPort );
+	if ( localSocketIter == m_localBoundUDPSockets.end()
+		 || localSocketIter->second == nullptr )
+	{
+		batch.numMessages = 0;
+		batch.payloadSize = 0;
+		return;
+	}
+
+	UDPMessageHeader* msgHeader = reinterpret_cast<UDPMessageHeader*>( &batch.data[0] );
+	*msgHeader = UDPMessageHeader();
+	msgHeader->id = (uint16_t)eMessasgeProtocolIds::BATCH;
+	msgHeader->size = (uint16_t)batch.payloadSize;
+	msgHeader->localBindPort = localSocketIter->second->GetReceivePort();
+
+	batch.data[sizeof( UDPMessageHeader ) + batch.payloadSize] = '\0';
+
+	PushOutgoingUDPMessage( UDPMessage( distantSendToPort, batch.data ), batch.numMessages );
+
+	batch.numMessages = 0;
+	batch.payloadSize = 0;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void NetworkingSystem::PushOutgoingUDPMessage( UDPMessage udpMessage, int numMessages )
+{
+	UDPMessageHeader* msgHeader = reinterpret_cast<UDPMessageHeader*>( &udpMessage.data[0] );
+	if ( msgHeader->id == (uint16_t)eMessasgeProtocolIds::DATA
+		 || msgHeader->id == (uint16_t)eMessasgeProtocolIds::BATCH
+		 || msgHeader->id == (uint16_t)eMessasgeProtocolIds::ACK )
+	{
+		GetUDPConnection( udpMessage.sendToPort )->StampOutgoingPacket( *msgHeader, GetCurrentTimeSeconds() );
+	}
+
+	// Mirrors what the writer thread puts on the wire, plus the IPv4 and UDP headers every datagram pays for
+	constexpr int IPV4_UDP_HEADER_SIZE = 28;
+	int numWireBytes = IPV4_UDP_HEADER_SIZE + (int)sizeof( UDPMessageHeader ) + (int)msgHeader->size + 1;
+	int numPayloadBytes = (int)msgHeader->size;
+	if ( msgHeader->id == (uint16_t)eMessasgeProtocolIds::BATCH )
+	{
+		numPayloadBytes -= numMessages * (int)sizeof( UDPBatchedMessageHeader );
+	}
+
+	++m_numUDPDatagramsSent;
+	m_numUDPMessagesSent += numMessages;
+	m_numUDPPayloadBytesSent += numPayloadBytes;
+	m_numUDPOverheadBytesSent += numWireBytes - numPayloadBytes;
+
+	m_stagedOutgoingUDPMessages.push_back( udpMessage );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void NetworkingSystem::HandOffStagedUDPMessages()
+{
+	if ( m_stagedOutgoingUDPMessages.empty() )
+	{
+		return;
+	}
+
+	int numHandedOff = m_outgoingMessages.PushMultiple( &m_stagedOutgoingUDPMessages[0], (int)m_stagedOutgoingUDPMessages.size() );
+	m_stagedOutgoingUDPMessages.erase( m_stagedOutgoingUDPMessages.begin(), m_stagedOutgoingUDPMessages.begin() + numHandedOff );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void NetworkingSystem::UpdateUDPSendStats()
+{
+	double currentTime = GetCurrentTimeSeconds();
+	double elapsedSeconds = currentTime - m_udpSendStatsStartTime;
+	if ( elapsedSeconds < 1.0 )
+	{
+		return;
+	}
+
+	float invElapsedSeconds = 1.f / (float)elapsedSeconds;
+	m_udpSendStats.datagramsPerSecond = (float)m_numUDPDatagramsSent * invElapsedSeconds;
+	m_udpSendStats.messagesPerSecond = (float)m_numUDPMessagesSent * invElapsedSeconds;
+	m_udpSendStats.payloadBytesPerSecond = (float)m_numUDPPayloadBytesSent * invElapsedSeconds;
+	m_udpSendStats.overheadBytesPerSecond = (float)m_numUDPOverheadBytesSent * invElapsedSeconds;
+
+	m_udpSendStatsStartTime = currentTime;
+	m_numUDPDatagramsSent = 0;
+	m_numUDPMessagesSent = 0;
+	m_numUDPPayloadBytesSent = 0;
+	m_numUDPOverheadBytesSent = 0;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void NetworkingSystem::SetUDPBatchingEnabled( EventArgs* args )
+{
+	m_isUDPBatchingEnabled = args->GetValue( "enabled", true );
+
+	if ( !m_isUDPBatchingEnabled )
 	{
-		m_reliableUDPMessagesToRetry[msgHeader->uniqueId] = ReliableUDPMessage( udpMessage, retryCount );
-		g_devConsole->PrintString( Stringf( "Saving reliable message %i", msgHeader->uniqueId ) );
+		FlushUDPMessageBatches();
 	}
 
-	m_outgoingMessages.Push( udpMessage );
+	g_devConsole->PrintString( Stringf( "UDP batching %s", m_isUDPBatchingEnabled ? "enabled" : "disabled" ) );
 }
 
 
 //-----------------------------------------------------------------------------------------------
-UniqueMessageId NetworkingSystem::GetNextUniqueMessageId()
+void NetworkingSystem::SetLoopbackUDPEnabled( EventArgs* args )
 {
-	return (UniqueMessageId)m_rng.RollRandomIntInRange( 1, 65535 );
+	LoopbackUDPNetworkConfig config;
+	config.latencySeconds = (double)args->GetValue( "latency", 0.f );
+	config.jitterSeconds = (double)args->GetValue( "jitter", 0.f );
+	config.lossChance = args->GetValue( "loss", 0.f );
+	config.reorderChance = args->GetValue( "reorder", 0.f );
+	config.seed = (unsigned int)args->GetValue( "seed", 0 );
+
+	SetLoopbackUDPEnabled( args->GetValue( "enabled", true ), config );
+
+	if ( !m_isLoopbackUDPEnabled )
+	{
+		g_devConsole->PrintString( "UDP loopback disabled, ports opened from now on use real sockets" );
+		return;
+	}
+
+	g_devConsole->PrintString( Stringf( "UDP loopback enabled: %.0fms latency, %.0fms jitter, %.1f%% loss, %.1f%% reordered, seed %u", 
+										config.latencySeconds * 1000.0, config.jitterSeconds * 1000.0, 
+										config.lossChance * 100.f, config.reorderChance * 100.f, config.seed ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void NetworkingSystem::PrintUDPStats( EventArgs* args )
+{
+	UNUSED( args );
+
+	float totalBytesPerSecond = m_udpSendStats.payloadBytesPerSecond + m_udpSendStats.overheadBytesPerSecond;
+	float overheadPercent = totalBytesPerSecond > 0.f ? 100.f * m_udpSendStats.overheadBytesPerSecond / totalBytesPerSecond : 0.f;
+
+	g_devConsole->PrintString( Stringf( "UDP send (batching %s): %.0f datagrams/s, %.0f messages/s, %.1f messages per datagram", 
+										m_isUDPBatchingEnabled ? "on" : "off",
+										m_udpSendStats.datagramsPerSecond, m_udpSendStats.messagesPerSecond, 
+										m_udpSendStats.messagesPerSecond / Max( m_udpSendStats.datagramsPerSecond, 1.f ) ) );
+	g_devConsole->PrintString( Stringf( "UDP send: %.0f payload bytes/s, %.0f overhead bytes/s (%.1f%% overhead)", 
+										m_udpSendStats.payloadBytesPerSecond, m_udpSendStats.overheadBytesPerSecond, overheadPercent ) );
+	g_devConsole->PrintString( Stringf( "UDP receive: %i processed last frame, %i backlogged, %i dropped", 
+										m_udpReceiveStats.numProcessed, m_udpReceiveStats.numBacklogged, m_udpReceiveStats.numDropped ) );
+
+	int numWriterDatagrams = m_numUDPWriterDatagrams;
+	int numWriterSendCalls = m_numUDPWriterSendCalls;
+	int numWriterWakeups = m_numUDPWriterWakeups;
+	double writerBusyMilliseconds = (double)m_udpWriterBusyMicroseconds / 1000.0;
+	g_devConsole->PrintString( Stringf( "UDP writer: %i datagrams in %i send calls (%.1f per call), %.1f per wakeup, %.3f ms per 10k datagrams", 
+										numWriterDatagrams, numWriterSendCalls, 
+										(float)numWriterDatagrams / (float)Max( numWriterSendCalls, 1 ),
+										(float)numWriterDatagrams / (float)Max( numWriterWakeups, 1 ),
+										10000.0 * writerBusyMilliseconds / (double)Max( numWriterDatagrams, 1 ) ) );
+
+	for ( const auto& connection : m_udpConnections )
+	{
+		UDPConnectionStats stats = connection.second->GetStats();
+		g_devConsole->PrintString( Stringf( "UDP port %i: rtt %.1fms, jitter %.1fms, resend after %.0fms, %i/%i packets acked", 
+											connection.first, stats.roundTripSeconds * 1000.f, stats.jitterSeconds * 1000.f, stats.resendSeconds * 1000.f,
+											stats.numPacketsAcked, stats.numPacketsSent ) );
+		g_devConsole->PrintString( Stringf( "  reliable: %i in flight, %i queued, %i resent, %i abandoned, %i duplicates dropped", 
+											stats.numReliableInFlight, stats.numReliableQueued, stats.numResent, stats.numAbandoned, stats.numDuplicatesDropped ) );
+	}
+
+	if ( m_loopbackUDPNetwork != nullptr )
+	{
+		LoopbackUDPNetworkStats loopbackStats = m_loopbackUDPNetwork->GetStats();
+		g_devConsole->PrintString( Stringf( "UDP loopback: %i sent, %i lost, %i reordered, %i delivered, %i to unbound ports", 
+											loopbackStats.numSent, loopbackStats.numLost, loopbackStats.numReordered, 
+											loopbackStats.numDelivered, loopbackStats.numUndeliverable ) );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Runs on the calling thread against its own sockets, so the writer thread and any open ports are left alone
+//-----------------------------------------------------------------------------------------------
+void NetworkingSystem::RunUDPSendBenchmark( EventArgs* args )
+{
+	int numDatagrams = Max( args->GetValue( "count", 10000 ), 1 );
+	int datagramSize = ClampMinMaxInt( args->GetValue( "size", 128 ), 1, BUFFER_SIZE );
+	int port = args->GetValue( "port", 48999 );
+
+	// Bind a receiver so the datagrams are delivered like real traffic, nothing reads them so the excess is dropped
+	UDPSocket receiver( "", port );
+	receiver.Bind( port );
+	UDPSocket sender( "", port );
+
+	std::vector<char> data( datagramSize, 'x' );
+	std::vector<UDPDatagramView> datagrams( numDatagrams );
+	for ( int datagramIdx = 0; datagramIdx < numDatagrams; ++datagramIdx )
+	{
+		datagrams[datagramIdx].data = data.data();
+		datagrams[datagramIdx].length = data.size();
+	}
+
+	// The path the writer thread took before batching, one send call per datagram
+	double startTime = GetCurrentTimeSeconds();
+	for ( int datagramIdx = 0; datagramIdx < numDatagrams; ++datagramIdx )
+	{
+		sender.Send( data.data(), data.size() );
+	}
+	double singleSendSeconds = GetCurrentTimeSeconds() - startTime;
+
+	int numBatchSendCalls = 0;
+	startTime = GetCurrentTimeSeconds();
+	sender.SendBatch( datagrams.data(), numDatagrams, numBatchSendCalls );
+	double batchSendSeconds = GetCurrentTimeSeconds() - startTime;
+
+	double per10kScale = 10000.0 / (double)numDatagrams;
+	g_devConsole->PrintString( Stringf( "UDP send benchmark: %i datagrams of %i bytes to port %i", numDatagrams, datagramSize, port ) );
+	g_devConsole->PrintString( Stringf( "  one sendto each: %.0f send calls, %.3f ms per 10k datagrams", 
+										(double)numDatagrams * per10kScale, singleSendSeconds * 1000.0 * per10kScale ) );
+	g_devConsole->PrintString( Stringf( "  SendBatch:       %.0f send calls, %.3f ms per 10k datagrams", 
+										(double)numBatchSendCalls * per10kScale, batchSendSeconds * 1000.0 * per10kScale ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void NetworkingSystem::StartUDPStressTest( EventArgs* args )
+{
+	if ( m_udpStressTest.isRunning )
+	{
+		g_devConsole->PrintError( "A UDP stress test is already running" );
+		return;
+	}
+
+	int port = args->GetValue( "port", 48100 );
+	int datagramsPerSecond = args->GetValue( "rate", 50000 );
+	float durationSeconds = args->GetValue( "seconds", 5.f );
+
+	// Send to ourselves over loopback, the reader thread for this port receives everything we send
+	if ( m_localBoundUDPSockets.find( port ) == m_localBoundUDPSockets.end() )
+	{
+		OpenAndBindUDPPort( port, port );
+	}
+
+	if ( m_outgoingUDPSockets.find( port ) == m_outgoingUDPSockets.end() )
+	{
+		CreateAndRegisterUDPSocket( port );
+	}
+
+	m_udpStressTest = UDPStressTest();
+	m_udpStressTest.isRunning = true;
+	m_udpStressTest.port = port;
+	m_udpStressTest.datagramsPerSecond = datagramsPerSecond;
+	m_udpStressTest.startTime = GetCurrentTimeSeconds();
+	m_udpStressTest.endTime = m_udpStressTest.startTime + (double)durationSeconds;
+
+	g_devConsole->PrintString( Stringf( "Starting UDP stress test: %i datagrams/s to port %i for %.1fs", datagramsPerSecond, port, durationSeconds ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void NetworkingSystem::UpdateUDPStressTest()
+{
+	if ( !m_udpStressTest.isRunning )
+	{
+		return;
+	}
+
+	// Stats are from the previous frame's ProcessUDPCommunication
+	++m_udpStressTest.numFrames;
+	m_udpStressTest.maxReceivedInFrame = Max( m_udpStressTest.maxReceivedInFrame, m_udpReceiveStats.numReceived );
+	m_udpStressTest.maxBacklog = Max( m_udpStressTest.maxBacklog, m_udpReceiveStats.numBacklogged );
+
+	double currentTime = GetCurrentTimeSeconds();
+	if ( currentTime < m_udpStressTest.endTime )
+	{
+		int targetNumSent = (int)( ( currentTime - m_udpStressTest.startTime ) * (double)m_udpStressTest.datagramsPerSecond );
+
+		std::array<char, 512> buffer = {};
+		UDPMessageHeader* msgHeader = reinterpret_cast<UDPMessageHeader*>( &buffer[0] );
+		msgHeader->id = (uint16_t)eMessasgeProtocolIds::UDP_STRESS_TEST;
+		msgHeader->size = (uint16_t)sizeof( int );
+		msgHeader->localBindPort = m_udpStressTest.port;
+
+		while ( m_udpStressTest.numSent < targetNumSent )
+		{
+			memcpy( &buffer[sizeof( UDPMessageHeader )], &m_udpStressTest.numSent, sizeof( int ) );
+			PushOutgoingUDPMessage( UDPMessage( m_udpStressTest.port, buffer ) );
+			++m_udpStressTest.numSent;
+		}
+
+		return;
+	}
+
+	// Give the last datagrams a moment to arrive before reporting
+	constexpr double DRAIN_SECONDS = 1.0;
+	if ( currentTime < m_udpStressTest.endTime + DRAIN_SECONDS
+		 && m_udpStressTest.numReceived < m_udpStressTest.numSent )
+	{
+		return;
+	}
+
+	int numLost = m_udpStressTest.numSent - m_udpStressTest.numReceived;
+	double elapsedSeconds = currentTime - m_udpStressTest.startTime;
+	g_devConsole->PrintString( Stringf( "UDP stress test: sent %i, received %i, lost %i (%.2f%%)", 
+										m_udpStressTest.numSent, m_udpStressTest.numReceived, numLost, 100.f * (float)numLost / (float)Max( m_udpStressTest.numSent, 1 ) ) );
+	g_devConsole->PrintString( Stringf( "  %.0f datagrams/s received over %i frames, max %i received in one frame, max backlog %i", 
+										(double)m_udpStressTest.numReceived / elapsedSeconds, m_udpStressTest.numFrames, m_udpStressTest.maxReceivedInFrame, m_udpStressTest.maxBacklog ) );
+
+	m_udpStressTest.isRunning = false;
 }
 
 
@@ -882,5 +1446,5 @@ void NetworkingSystem::SendUDPTextMessage( int localBindPort, const std::string&
 
 	buffer[sizeof( UDPMessageHeader ) + msgHeader->size] = '\0';
 
-	m_outgoingMessages.Push( UDPMessage( localBindPort, buffer ) );
+	PushOutgoingUDPMessage( UDPMessage( localBindPort, buffer ) );
 }
@@ -1,17 +1,20 @@
 #pragma once
 #include "Engine/Core/EngineCommon.hpp"
-#include "Engine/Core/SynchronizedBlockingQueue.hpp"
-#include "Engine/Core/SynchronizedNonBlockingQueue.hpp"
-#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Core/MPMCRingQueue.hpp"
+#include "Engine/Core/SPSCRingQueue.hpp"
+#include "Engine/Networking/LoopbackUDPNetwork.hpp"
 #include "Engine/Networking/MessageProtocols.hpp"
 #include "Engine/Networking/TCPSocket.hpp"
+#include "Engine/Networking/UDPConnection.hpp"
+#include "Engine/Networking/UDPPacketPool.hpp"
 #include "Engine/Networking/UDPSocket.hpp"
 
 #include <array>
+#include <atomic>
 #include <map>
+#include <queue>
 #include <string>
 #include <thread>
-#include <unordered_set>
 #include <vector>
 
 
@@ -20,6 +23,22 @@ class TCPClient;
 class TCPServer;
 
 
+//-----------------------------------------------------------------------------------------------
+// Caps the work done in one BeginFrame, anything past this waits for the next frame
+constexpr int MAX_UDP_MESSAGES_PROCESSED_PER_FRAME = 8192;
+
+// Every received datagram lives in one of these packets until it is processed, once they are all in use new datagrams are dropped
+constexpr int UDP_PACKET_POOL_SIZE = 4096;
+constexpr int UDP_OUTGOING_QUEUE_SIZE = 4096;
+
+// Messages nobody marks as processed are released after this many frames so they can't exhaust the packet pool
+constexpr int MAX_FRAMES_UDP_MESSAGE_UNPROCESSED = 600;
+
+// Largest payload that fits in one datagram, the writer sends a null terminator after the payload and
+// UDPSocket::Receive needs one more byte to terminate what it received
+constexpr int MAX_UDP_MESSAGE_PAYLOAD_SIZE = BUFFER_SIZE - (int)sizeof( UDPMessageHeader ) - 2;
+
+
 //-----------------------------------------------------------------------------------------------
 struct UDPMessage
 {
@@ -38,41 +57,54 @@ public:
 
 
 //-----------------------------------------------------------------------------------------------
-struct ReliableUDPMessage
+// Unreliable messages to one port waiting to be sent together in a single BATCH datagram
+struct UDPMessageBatch
 {
 public:
-	UDPMessage udpMessage;
-	int retryCount = 0;
-	int maxRetryCount = 1000;
-	bool hasBeenAcked = false;
+	std::array<char, 512> data = {};
+	int numMessages = 0;
+	int payloadSize = 0;		// Bytes after the UDPMessageHeader, including each UDPBatchedMessageHeader
+};
 
-public:
-	ReliableUDPMessage() = default;
 
-	ReliableUDPMessage( UDPMessage udpMessage, int maxRetryCount )
-		: udpMessage( udpMessage )
-		, maxRetryCount( maxRetryCount )
-	{
-	}
+//-----------------------------------------------------------------------------------------------
+struct UDPReceiveStats
+{
+public:
+	int numReceived = 0;		// Datagrams taken from the reader threads this frame
+	int numProcessed = 0;		// Datagrams dispatched this frame
+	int numBacklogged = 0;		// Datagrams still waiting to be dispatched at the end of the frame
+	int numDropped = 0;			// Datagrams the reader threads dropped because the packet pool was empty, since startup
+	int numExpired = 0;			// Datagrams released this frame without ever being processed
 };
 
 
 //-----------------------------------------------------------------------------------------------
-struct ReceivedUDPMessageId
+struct UDPSendStats
 {
 public:
-	UniqueMessageId uniqueId = 0;
-	int port = 0;
+	float datagramsPerSecond = 0.f;
+	float messagesPerSecond = 0.f;			// Game messages, a batch datagram carries several
+	float payloadBytesPerSecond = 0.f;
+	float overheadBytesPerSecond = 0.f;		// Everything on the wire that isn't game payload
+};
+
 
+//-----------------------------------------------------------------------------------------------
+struct UDPStressTest
+{
 public:
-	ReceivedUDPMessageId() = default;
-	~ReceivedUDPMessageId() = default;
-
-	ReceivedUDPMessageId( UniqueMessageId uniqueId, int port )
-		: uniqueId( uniqueId )
-		, port( port )
-	{
-	}
+	bool isRunning = false;
+	int port = -1;
+	int datagramsPerSecond = 0;
+	double startTime = 0.0;
+	double endTime = 0.0;
+
+	int numSent = 0;
+	int numReceived = 0;
+	int numFrames = 0;
+	int maxReceivedInFrame = 0;
+	int maxBacklog = 0;
 };
 
 
@@ -106,9 +138,22 @@ public:
 	void OpenAndBindUDPPort( int localBindPort, int distantSendToPort, const std::string& ipAddress = "" );
 	void CreateAndRegisterUDPSocket( int distantSendToPort, const std::string& ipAddress = "" );
 	void CloseUDPPort( int localBindPort );
-	void SendUDPMessage( int distantSendToPort, void* data, size_t dataSize, bool isReliable = false, int retryCount = 1000 );
+	// maxResendCount only applies to RELIABLE_UNORDERED, ordered messages are resent until acked so later ones aren't stuck behind them
+	void SendUDPMessage( int distantSendToPort, const void* data, size_t dataSize, eUDPChannel channel = eUDPChannel::UNRELIABLE, int maxResendCount = 1000 );
 	void SendUDPTextMessage( int localBindPort, const std::string& text );
 
+	// Unreliable only, packed with other messages to the same port and sent when the datagram fills up or in EndFrame
+	void SendBatchedUDPMessage( int distantSendToPort, const void* data, size_t dataSize );
+	void FlushUDPMessageBatches();
+
+	const UDPReceiveStats& GetUDPReceiveStats() const					{ return m_udpReceiveStats; }
+	const UDPSendStats& GetUDPSendStats() const							{ return m_udpSendStats; }
+
+	// Ports opened while enabled exchange datagrams through an in-process LoopbackUDPNetwork instead of real sockets
+	void SetLoopbackUDPEnabled( bool isEnabled, const LoopbackUDPNetworkConfig& config = LoopbackUDPNetworkConfig() );
+	bool IsLoopbackUDPEnabled() const									{ return m_isLoopbackUDPEnabled; }
+	LoopbackUDPNetwork* GetLoopbackUDPNetwork() const					{ return m_loopbackUDPNetwork; }
+
 private:
 	// TCP
 	void ProcessTCPCommunication();
@@ -118,10 +163,25 @@ private:
 
 	// UDP
 	void ProcessUDPCommunication();
+	bool ProcessUDPMessage( UDPData& data );
+	bool ProcessUDPDataMessage( UDPData& data );
+	void ReceiveUDPPacketHeader( const UDPMessageHeader& header );
+	void ProcessUDPBatchMessage( const UDPData& data );
 	void UDPReaderThreadMain( int localUDPPort );
 	void UDPWriterThreadMain();
 	void ClearProcessedUDPMessages();
-	void RetryReliableUDPMessages();
+	void SendReliableUDPMessages();
+	void SendReliableUDPMessages( int distantSendToPort, UDPConnection& connection );
+	void SendUDPAcks();
+	void SendUDPAck( int distantSendToPort );
+	void FlushUDPMessageBatch( int distantSendToPort, UDPMessageBatch& batch );
+	void PushOutgoingUDPMessage( UDPMessage udpMessage, int numMessages = 1 );
+	void HandOffStagedUDPMessages();
+	UDPTransport* GetOutgoingUDPTransport( int distantSendToPort );
+	UDPTransport* CreateUDPTransport( int distantSendToPort, const std::string& ipAddress );
+	UDPConnection* GetUDPConnection( int distantPort );
+	void DeleteUDPConnection( int distantPort );
+	void UpdateUDPSendStats();
 
 	// Console commands
 	void StartTCPServer( EventArgs* args );
@@ -134,8 +194,13 @@ private:
 	void OpenAndBindUDPPort( EventArgs* args );
 	void CloseUDPPort( EventArgs* args );
 	void SendUDPMessage( EventArgs* args );
+	void StartUDPStressTest( EventArgs* args );
+	void SetUDPBatchingEnabled( EventArgs* args );
+	void SetLoopbackUDPEnabled( EventArgs* args );
+	void PrintUDPStats( EventArgs* args );
+	void RunUDPSendBenchmark( EventArgs* args );
 
-	UniqueMessageId GetNextUniqueMessageId();
+	void UpdateUDPStressTest();
 
 private:
 	// Just one server for now, can be array later
@@ -147,20 +212,51 @@ private:
 	std::vector<TCPData> m_tcpReceivedMessages;
 	std::vector<UDPData> m_udpReceivedMessages;
 
-	std::map<int, UDPSocket*> m_outgoingUDPSockets;
-	std::map<int, UDPSocket*> m_localBoundUDPSockets;
+	std::map<int, UDPTransport*> m_outgoingUDPSockets;
+	std::map<int, UDPTransport*> m_localBoundUDPSockets;
 	//UDPSocket* m_localBoundUDPSocket = nullptr;
 
-	SynchronizedNonBlockingQueue<UDPData> m_incomingMessages;
-	SynchronizedBlockingQueue<UDPMessage> m_outgoingMessages;
-
-	std::map<int, std::unordered_set<UniqueMessageId>> m_receivedReliableMessages;
-	std::map<UniqueMessageId, ReliableUDPMessage> m_reliableUDPMessagesToRetry;
+	// Every queued message holds a pooled packet, so this can't fill before the pool runs dry
+	MPMCRingQueue<UDPData> m_incomingMessages{ UDP_PACKET_POOL_SIZE };
+	std::vector<UDPData> m_newIncomingMessages;
+	std::queue<UDPData> m_unprocessedIncomingMessages;
+	UDPPacketPool m_udpPacketPool{ UDP_PACKET_POOL_SIZE, BUFFER_SIZE };
+	std::atomic<int> m_numDroppedUDPMessages{ 0 };
+	UDPReceiveStats m_udpReceiveStats;
+	UDPStressTest m_udpStressTest;
+	SPSCRingQueue<UDPMessage> m_outgoingMessages{ UDP_OUTGOING_QUEUE_SIZE, true };
+
+	// Collected on the main thread and handed to the writer once per frame, so it is woken once instead of per datagram.
+	// Anything that doesn't fit in m_outgoingMessages stays here for the next frame.
+	std::vector<UDPMessage> m_stagedOutgoingUDPMessages;
+
+	// Writer thread totals since startup, read by udp_stats
+	std::atomic<int> m_numUDPWriterDatagrams{ 0 };
+	std::atomic<int> m_numUDPWriterSendCalls{ 0 };
+	std::atomic<int> m_numUDPWriterWakeups{ 0 };
+	std::atomic<long long> m_udpWriterBusyMicroseconds{ 0 };
+
+	std::map<int, UDPMessageBatch> m_outgoingUDPMessageBatches;
+	bool m_isUDPBatchingEnabled = true;
+
+	// Created the first time loopback is enabled and kept until shutdown since transports may still point at it
+	LoopbackUDPNetwork* m_loopbackUDPNetwork = nullptr;
+	bool m_isLoopbackUDPEnabled = false;
+
+	// Totals since m_udpSendStatsStartTime, turned into per second rates in m_udpSendStats once a second
+	UDPSendStats m_udpSendStats;
+	double m_udpSendStatsStartTime = 0.0;
+	int m_numUDPDatagramsSent = 0;
+	int m_numUDPMessagesSent = 0;
+	int m_numUDPPayloadBytesSent = 0;
+	int m_numUDPOverheadBytesSent = 0;
+
+	// Keyed by distant port like the sockets, created when the first datagram is sent to or received from a port
+	std::map<int, UDPConnection*> m_udpConnections;
+	std::vector<std::array<char, 512>> m_reliableUDPMessagesToSend;
 
 	bool m_isQuitting = false;
 	std::thread* m_udpReaderThread = nullptr;
 	std::vector<std::thread*> m_udpReaderThreads;
 	std::thread* m_udpWriterThread = nullptr;
-
-	RandomNumberGenerator m_rng;
 };
@@ -4,6 +4,7 @@
 #include "Engine/Networking/TCPSocket.hpp"
 
 #include <cstdint>
+#include <cstring>
 
 
 //-----------------------------------------------------------------------------------------------
@@ -21,7 +22,7 @@ TCPSocket TCPClient::Connect( const std::string& host, int port )
 	struct addrinfo  addrHintsIn;
 	struct addrinfo* addrInfoOut = NULL;
 
-	ZeroMemory( &addrHintsIn, sizeof( addrHintsIn ) );
+	memset( &addrHintsIn, 0, sizeof( addrHintsIn ) );
 	addrHintsIn.ai_family = AF_INET;
 	addrHintsIn.ai_socktype = SOCK_STREAM;
 	addrHintsIn.ai_protocol = IPPROTO_TCP;
@@ -40,7 +41,7 @@ TCPSocket TCPClient::Connect( const std::string& host, int port )
 	m_socket = socket( addrInfoOut->ai_family, addrInfoOut->ai_socktype, addrInfoOut->ai_protocol );
 	if ( m_socket == INVALID_SOCKET )
 	{
-		g_devConsole->PrintError( Stringf( "Networking System: socket creation failed with '%i'", WSAGetLastError() ) );
+		g_devConsole->PrintError( Stringf( "Networking System: socket creation failed with '%i'", GetLastSocketError() ) );
 		freeaddrinfo( addrInfoOut );
 		return TCPSocket( INVALID_SOCKET );
 	}
@@ -49,7 +50,7 @@ TCPSocket TCPClient::Connect( const std::string& host, int port )
 	iResult = connect( m_socket, addrInfoOut->ai_addr, (int)addrInfoOut->ai_addrlen );
 	if ( iResult == SOCKET_ERROR )
 	{
-		closesocket( m_socket );
+		CloseSocket( m_socket );
 		m_socket = INVALID_SOCKET;
 	}
 	freeaddrinfo( addrInfoOut );
@@ -63,12 +64,10 @@ TCPSocket TCPClient::Connect( const std::string& host, int port )
 	// Set blocking mode as needed.
 	if ( m_blockingMode == eBlockingMode::NONBLOCKING )
 	{
-		u_long winsockmode = 1;
-		iResult = ioctlsocket( m_socket, FIONBIO, &winsockmode );
-		if ( iResult == SOCKET_ERROR )
+		if ( !SetSocketBlockingMode( m_socket, eBlockingMode::NONBLOCKING ) )
 		{
-			g_devConsole->PrintError( Stringf( "Networking System: ioctlsocket failed with '%i'", WSAGetLastError() ) );
-			closesocket( m_socket );
+			g_devConsole->PrintError( Stringf( "Networking System: setting nonblocking mode failed with '%i'", GetLastSocketError() ) );
+			CloseSocket( m_socket );
 			return TCPSocket( INVALID_SOCKET );
 		}
 	}
@@ -84,7 +83,7 @@ TCPSocket* TCPClient::ConnectAndCreateSocket( const std::string& host, int port
 	struct addrinfo  addrHintsIn;
 	struct addrinfo* addrInfoOut = NULL;
 
-	ZeroMemory( &addrHintsIn, sizeof( addrHintsIn ) );
+	memset( &addrHintsIn, 0, sizeof( addrHintsIn ) );
 	addrHintsIn.ai_family = AF_INET;
 	addrHintsIn.ai_socktype = SOCK_STREAM;
 	addrHintsIn.ai_protocol = IPPROTO_TCP;
@@ -103,7 +102,7 @@ TCPSocket* TCPClient::ConnectAndCreateSocket( const std::string& host, int port
 	m_socket = socket( addrInfoOut->ai_family, addrInfoOut->ai_socktype, addrInfoOut->ai_protocol );
 	if ( m_socket == INVALID_SOCKET )
 	{
-		g_devConsole->PrintError( Stringf( "Networking System: socket creation failed with '%i'", WSAGetLastError() ) );
+		g_devConsole->PrintError( Stringf( "Networking System: socket creation failed with '%i'", GetLastSocketError() ) );
 		freeaddrinfo( addrInfoOut );
 		return nullptr;
 	}
@@ -112,7 +111,7 @@ TCPSocket* TCPClient::ConnectAndCreateSocket( const std::string& host, int port
 	iResult = connect( m_socket, addrInfoOut->ai_addr, (int)addrInfoOut->ai_addrlen );
 	if ( iResult == SOCKET_ERROR )
 	{
-		closesocket( m_socket );
+		CloseSocket( m_socket );
 		m_socket = INVALID_SOCKET;
 	}
 	freeaddrinfo( addrInfoOut );
@@ -126,12 +125,10 @@ TCPSocket* TCPClient::ConnectAndCreateSocket( const std::string& host, int port
 	// Set blocking mode as needed.
 	if ( m_blockingMode == eBlockingMode::NONBLOCKING )
 	{
-		u_long winsockmode = 1;
-		iResult = ioctlsocket( m_socket, FIONBIO, &winsockmode );
-		if ( iResult == SOCKET_ERROR )
+		if ( !SetSocketBlockingMode( m_socket, eBlockingMode::NONBLOCKING ) )
 		{
-			g_devConsole->PrintError( Stringf( "Networking System: ioctlsocket failed with '%i'", WSAGetLastError() ) );
-			closesocket( m_socket );
+			g_devConsole->PrintError( Stringf( "Networking System: setting nonblocking mode failed with '%i'", GetLastSocketError() ) );
+			CloseSocket( m_socket );
 			return nullptr;
 		}
 	}
@@ -143,6 +140,6 @@ TCPSocket* TCPClient::ConnectAndCreateSocket( const std::string& host, int port
 //-----------------------------------------------------------------------------------------------
 void TCPClient::Disconnect()
 {
-	closesocket( m_socket );
+	CloseSocket( m_socket );
 	m_socket = INVALID_SOCKET;
 }
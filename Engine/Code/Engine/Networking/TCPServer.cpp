@@ -3,6 +3,7 @@
 #include "Engine/Core/DevConsole.hpp"
 #include "Engine/Core/StringUtils.hpp"
 
+#include <cstring>
 #include <string>
 
 
@@ -10,7 +11,6 @@
 TCPServer::TCPServer( eBlockingMode mode )
 	: m_blockingMode( mode )
 {
-	FD_ZERO( &m_listenSet );
 }
 
 
@@ -38,16 +38,14 @@ bool TCPServer::Bind( int port )
 	m_listenSocket = socket( addrInfoOut->ai_family, addrInfoOut->ai_socktype, addrInfoOut->ai_protocol );
 	if ( m_listenSocket == INVALID_SOCKET )
 	{
-		g_devConsole->PrintError( Stringf( "Networking System: socket creation failed with '%i'", WSAGetLastError() ) );
+		g_devConsole->PrintError( Stringf( "Networking System: socket creation failed with '%i'", GetLastSocketError() ) );
 		freeaddrinfo( addrInfoOut );
 		return false;
 	}
 
-	unsigned long blockingMode = 1;
-	iResult = ioctlsocket( m_listenSocket, FIONBIO, &blockingMode );
-	if ( iResult == SOCKET_ERROR )
+	if ( !SetSocketBlockingMode( m_listenSocket, eBlockingMode::NONBLOCKING ) )
 	{
-		g_devConsole->PrintError( Stringf( "Networking System: ioctlsocket failed with '%i'", WSAGetLastError() ) );
+		g_devConsole->PrintError( Stringf( "Networking System: setting nonblocking mode failed with '%i'", GetLastSocketError() ) );
 		freeaddrinfo( addrInfoOut );
 		return false;
 	}
@@ -55,7 +53,7 @@ bool TCPServer::Bind( int port )
 	iResult = bind( m_listenSocket, addrInfoOut->ai_addr, (int)addrInfoOut->ai_addrlen );
 	if ( iResult == SOCKET_ERROR )
 	{
-		g_devConsole->PrintError( Stringf( "Networking System: bind failed with '%i'", WSAGetLastError() ) );
+		g_devConsole->PrintError( Stringf( "Networking System: bind failed with '%i'", GetLastSocketError() ) );
 		freeaddrinfo( addrInfoOut );
 		return false;
 	}
@@ -72,7 +70,7 @@ bool TCPServer::StartListening()
 	int iResult = listen( m_listenSocket, SOMAXCONN );
 	if ( iResult == SOCKET_ERROR )
 	{
-		g_devConsole->PrintError( Stringf( "Networking System: listen failed with '%i'", WSAGetLastError() ) );
+		g_devConsole->PrintError( Stringf( "Networking System: listen failed with '%i'", GetLastSocketError() ) );
 		return false;
 	}
 
@@ -88,10 +86,10 @@ bool TCPServer::StopListening()
 
 	if ( m_listenSocket != INVALID_SOCKET )
 	{
-		int iResult = closesocket( m_listenSocket );
+		int iResult = CloseSocket( m_listenSocket );
 		if ( iResult == SOCKET_ERROR )
 		{
-			g_devConsole->PrintError( Stringf( "Networking System: closesocket failed with '%i'", WSAGetLastError() ) );
+			g_devConsole->PrintError( Stringf( "Networking System: closesocket failed with '%i'", GetLastSocketError() ) );
 			return false;
 		}
 		m_listenSocket = INVALID_SOCKET;
@@ -105,29 +103,30 @@ bool TCPServer::StopListening()
 TCPSocket TCPServer::Accept()
 {
 	SOCKET socket = INVALID_SOCKET;
+	bool isConnectionWaiting = false;
 	if ( m_blockingMode == eBlockingMode::NONBLOCKING )
 	{
-		FD_ZERO( &m_listenSet );
-		FD_SET( m_listenSocket, &m_listenSet );
-		int iResult = select( 0, &m_listenSet, NULL, NULL, &m_timeval );
+		int iResult = IsSocketReadable( m_listenSocket );
 		if ( iResult == SOCKET_ERROR )
 		{
-			g_devConsole->PrintError( Stringf( "Networking System: select failed with '%i'", WSAGetLastError() ) );
+			g_devConsole->PrintError( Stringf( "Networking System: select failed with '%i'", GetLastSocketError() ) );
 			
-			closesocket( m_listenSocket );
+			CloseSocket( m_listenSocket );
 			return TCPSocket( INVALID_SOCKET );
 		}
+
+		isConnectionWaiting = iResult != 0;
 	}
 	
 	if ( m_blockingMode == eBlockingMode::BLOCKING
-		 || ( m_blockingMode == eBlockingMode::NONBLOCKING && FD_ISSET( m_listenSocket, &m_listenSet ) ) )
+		 || ( m_blockingMode == eBlockingMode::NONBLOCKING && isConnectionWaiting ) )
 	{
 		// Accept client connections
 		socket = accept( m_listenSocket, NULL, NULL );
 		if ( socket == INVALID_SOCKET )
 		{
-			g_devConsole->PrintError( Stringf( "Networking System: client socket accept failed with '%i'", WSAGetLastError() ) );
-			closesocket( m_listenSocket );
+			g_devConsole->PrintError( Stringf( "Networking System: client socket accept failed with '%i'", GetLastSocketError() ) );
+			CloseSocket( m_listenSocket );
 			return TCPSocket( INVALID_SOCKET );
 		}
 	}
@@ -26,8 +26,6 @@ public:
 
 private:
 	eBlockingMode m_blockingMode = eBlockingMode::INVALID;
-	FD_SET m_listenSet;
-	timeval m_timeval = {0l,0l};
 	SOCKET m_listenSocket = INVALID_SOCKET;
 
 	bool m_isListening = false;
@@ -2,8 +2,6 @@
 #include "Engine/Core/DevConsole.hpp"
 #include "Engine/Core/StringUtils.hpp"
 
-#include <array>
-
 
 //-----------------------------------------------------------------------------------------------
 TCPSocket::TCPSocket( SOCKET socket, eBlockingMode mode, size_t bufferSize )
@@ -11,7 +9,6 @@ TCPSocket::TCPSocket( SOCKET socket, eBlockingMode mode, size_t bufferSize )
 	, m_blockingMode( mode )
 	, m_bufferSize( bufferSize )
 {
-	FD_ZERO( &m_fdSet );
 	m_buffer = new char[m_bufferSize];
 }
 
@@ -22,7 +19,6 @@ TCPSocket::TCPSocket()
 	, m_blockingMode( eBlockingMode::BLOCKING )
 	, m_bufferSize( 256 )
 {
-	FD_ZERO( &m_fdSet );
 	m_buffer = new char[m_bufferSize];
 }
 
@@ -55,44 +51,33 @@ TCPSocket& TCPSocket::operator=( const TCPSocket& src )
 //-----------------------------------------------------------------------------------------------
 std::string TCPSocket::GetAddress()
 {
-	std::array<char, 128> addressStr;
-
-	sockaddr clientAddr;
-	int addrSize = sizeof( clientAddr );
-	int iResult = getpeername( m_socket, &clientAddr, &addrSize );
-	if ( iResult == SOCKET_ERROR )
-	{
-		g_devConsole->PrintError( Stringf( "Networking System: getpeername failed with '%i'", WSAGetLastError() ) );
-	}
-
-	DWORD outlen = (DWORD)addressStr.size();
-	iResult = WSAAddressToStringA( &clientAddr, addrSize, NULL, &addressStr[0], &outlen );
+	sockaddr_in clientAddr;
+	SocketAddressLength addrSize = sizeof( clientAddr );
+	int iResult = getpeername( m_socket, reinterpret_cast<sockaddr*>( &clientAddr ), &addrSize );
 	if ( iResult == SOCKET_ERROR )
 	{
-		g_devConsole->PrintError( Stringf( "Networking System: WSAAddressToStringA failed with '%i'", WSAGetLastError() ) );
+		g_devConsole->PrintError( Stringf( "Networking System: getpeername failed with '%i'", GetLastSocketError() ) );
 		return "";
 	}
 
-	// Is this safe?
-	addressStr[outlen - 1] = '\0';
-	return std::string( &addressStr[0] );
+	return GetSocketAddressString( clientAddr );
 }
 
 
 //-----------------------------------------------------------------------------------------------
 void TCPSocket::Send( const char* data, size_t length )
 {
-	int iResult = send( m_socket, data, (int)length, 0 );
+	int iResult = (int)send( m_socket, data, (int)length, SOCKET_SEND_FLAGS );
 	if ( iResult == SOCKET_ERROR )
 	{
-		g_devConsole->PrintError( Stringf( "Networking System: send failed with '%i'", WSAGetLastError() ) );
-		closesocket( m_socket );
+		g_devConsole->PrintError( Stringf( "Networking System: send failed with '%i'", GetLastSocketError() ) );
+		CloseSocket( m_socket );
 		return;
 	}
 	else if ( iResult < (int)length )
 	{
 		g_devConsole->PrintError( Stringf( "Requested '%i' bytes to be sent, but only '%i' were sent", (int)length, iResult ) );
-		closesocket( m_socket );
+		CloseSocket( m_socket );
 		return;
 	}
 }
@@ -101,18 +86,18 @@ void TCPSocket::Send( const char* data, size_t length )
 //-----------------------------------------------------------------------------------------------
 TCPData TCPSocket::Receive()
 {
-	int iResult = recv( m_socket, m_buffer, (int)m_bufferSize, 0 );
+	int iResult = (int)recv( m_socket, m_buffer, (int)m_bufferSize, 0 );
 	if ( iResult == SOCKET_ERROR )
 	{
-		int errorCode = WSAGetLastError();
-		if ( errorCode == WSAEWOULDBLOCK && m_blockingMode == eBlockingMode::NONBLOCKING )
+		int errorCode = GetLastSocketError();
+		if ( IsSocketWouldBlockError( errorCode ) && m_blockingMode == eBlockingMode::NONBLOCKING )
 		{
 			return TCPData( 9999999, nullptr, "" );
 		}
 		else
 		{
 			g_devConsole->PrintError( Stringf( "Networking System: recv failed with '%i'", errorCode ) );
-			closesocket( m_socket );
+			CloseSocket( m_socket );
 			return TCPData( 9999999, nullptr, "" );
 		}
 	}
@@ -125,7 +110,7 @@ TCPData TCPSocket::Receive()
 //-----------------------------------------------------------------------------------------------
 void TCPSocket::Close()
 {
-	closesocket( m_socket );
+	CloseSocket( m_socket );
 	m_socket = INVALID_SOCKET;
 }
 
@@ -135,16 +120,14 @@ bool TCPSocket::IsDataAvailable()
 {
 	if ( m_blockingMode == eBlockingMode::NONBLOCKING )
 	{
-		FD_ZERO( &m_fdSet );
-		FD_SET( m_socket, &m_fdSet );
-		int iResult = select( 0, &m_fdSet, NULL, NULL, &m_timeval );
+		int iResult = IsSocketReadable( m_socket );
 		if ( iResult == SOCKET_ERROR )
 		{
-			g_devConsole->PrintError( Stringf( "Networking System: select failed with '%i'", WSAGetLastError() ) );
-			closesocket( m_socket );
+			g_devConsole->PrintError( Stringf( "Networking System: select failed with '%i'", GetLastSocketError() ) );
+			CloseSocket( m_socket );
 			return false;
 		}
-		return FD_ISSET( m_socket, &m_fdSet );
+		return iResult != 0;
 	}
 	else
 	{
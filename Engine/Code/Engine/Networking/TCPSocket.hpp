@@ -62,9 +62,6 @@ private:
 	eBlockingMode m_blockingMode = eBlockingMode::INVALID;
 	SOCKET m_socket = INVALID_SOCKET;
 
-	FD_SET m_fdSet;
-	timeval m_timeval = {0l,0l};
-
 	size_t m_bufferSize = 0;
 	size_t m_receiveSize = 0;
 	char* m_buffer = nullptr;
@@ -0,0 +1,377 @@
+#include "Engine/Networking/UDPConnection.hpp"
+#include "Engine/Networking/UDPPacketPool.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <cmath>
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr uint32_t NO_RECEIVED_ID = 0xFFFFFFFF;
+
+
+//-----------------------------------------------------------------------------------------------
+// Signed distance from b to a, correct across wraparound as long as they are less than half the range apart
+static int GetSequenceDifference( uint16_t a, uint16_t b )
+{
+	return (int)(int16_t)(uint16_t)( a - b );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+ReliableUDPChannel::ReliableUDPChannel()
+{
+	receivedIds.fill( NO_RECEIVED_ID );
+	isMessageBuffered.fill( false );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void UDPConnection::QueueReliableMessage( const std::array<char, BUFFER_SIZE>& data, eUDPChannel channelType, int maxResendCount )
+{
+	QueuedReliableUDPMessage queuedMessage;
+	queuedMessage.data = data;
+
+	// A missing ordered message would stall every message after it, so those are resent until acked
+	queuedMessage.maxResendCount = channelType == eUDPChannel::RELIABLE_ORDERED ? -1 : maxResendCount;
+
+	ReliableUDPChannel& channel = GetChannel( channelType );
+	channel.queuedMessages.push_back( queuedMessage );
+	FillSendWindow( channel, channelType );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void UDPConnection::GetReliableMessagesToSend( double currentTime, std::vector<std::array<char, BUFFER_SIZE>>& out_messages )
+{
+	double resendSeconds = GetResendSeconds();
+
+	ReliableUDPChannel* channels[] = { &m_unorderedChannel, &m_orderedChannel };
+	for ( ReliableUDPChannel* channel : channels )
+	{
+		for ( uint16_t reliableId = channel->oldestUnackedId; reliableId != channel->nextSendId; ++reliableId )
+		{
+			PendingReliableUDPMessage& message = channel->pendingMessages[reliableId % RELIABLE_UDP_WINDOW_SIZE];
+			if ( !message.isValid
+				 || currentTime < message.nextSendTime )
+			{
+				continue;
+			}
+
+			if ( message.maxResendCount >= 0
+				 && message.numSends > message.maxResendCount )
+			{
+				message.isValid = false;
+				++m_numAbandoned;
+				continue;
+			}
+
+			if ( message.numSends > 0 )
+			{
+				++m_numResent;
+			}
+
+			// No backoff, an ordered message that waits longer holds up everything behind it
+			message.nextSendTime = currentTime + resendSeconds;
+			++message.numSends;
+
+			out_messages.push_back( message.data );
+		}
+
+		// Abandoned messages may have opened up room in the window
+		AdvanceOldestUnackedId( *channel );
+	}
+
+	FillSendWindow( m_unorderedChannel, eUDPChannel::RELIABLE_UNORDERED );
+	FillSendWindow( m_orderedChannel, eUDPChannel::RELIABLE_ORDERED );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void UDPConnection::StampOutgoingPacket( UDPMessageHeader& header, double currentTime )
+{
+	header.ack = m_newestReceivedSequenceNum;
+	header.ackBits = m_receivedAckBits;
+	header.hasAck = m_hasReceivedPacket ? 1 : 0;
+	m_needsAck = false;
+	m_numPacketsReceivedSinceAck = 0;
+
+	// Ack only datagrams aren't sequenced so they never need acking themselves
+	if ( header.id == (uint16_t)eMessasgeProtocolIds::ACK )
+	{
+		return;
+	}
+
+	header.sequenceNum = m_nextSequenceNum++;
+
+	SentUDPPacket& sentPacket = m_sentPackets[header.sequenceNum % SENT_UDP_PACKET_HISTORY_SIZE];
+	sentPacket.sendTime = currentTime;
+	sentPacket.sequenceNum = header.sequenceNum;
+	sentPacket.reliableId = header.reliableId;
+	sentPacket.channel = header.channel;
+	sentPacket.isValid = true;
+	sentPacket.isAcked = false;
+
+	++m_numPacketsSent;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void UDPConnection::ReceivePacketHeader( const UDPMessageHeader& header, double currentTime )
+{
+	if ( header.hasAck != 0 )
+	{
+		AckSentPacket( header.ack, currentTime );
+		for ( int bitIdx = 0; bitIdx < NUM_UDP_ACK_BITS; ++bitIdx )
+		{
+			if ( ( header.ackBits & ( 1ull << bitIdx ) ) != 0 )
+			{
+				AckSentPacket( (uint16_t)( header.ack - 1 - bitIdx ), currentTime );
+			}
+		}
+	}
+
+	if ( header.id != (uint16_t)eMessasgeProtocolIds::ACK )
+	{
+		RecordReceivedPacket( header.sequenceNum );
+		m_needsAck = true;
+		++m_numPacketsReceivedSinceAck;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool UDPConnection::ReceiveReliableMessage( const UDPData& data, std::vector<UDPData>& out_deliveredMessages )
+{
+	const UDPMessageHeader* header = reinterpret_cast<const UDPMessageHeader*>( data.GetData() );
+	uint16_t reliableId = header->reliableId;
+	int slotIdx = reliableId % RELIABLE_UDP_WINDOW_SIZE;
+
+	ReliableUDPChannel& channel = GetChannel( header->channel );
+	if ( header->channel != eUDPChannel::RELIABLE_ORDERED )
+	{
+		// Anything older than the window was delivered long ago, the sender can't have it in flight anymore
+		if ( ( channel.hasReceivedMessage
+			   && GetSequenceDifference( channel.newestReceivedId, reliableId ) >= RELIABLE_UDP_WINDOW_SIZE )
+			 || channel.receivedIds[slotIdx] == (uint32_t)reliableId )
+		{
+			++m_numDuplicatesDropped;
+			return false;
+		}
+
+		channel.receivedIds[slotIdx] = reliableId;
+		if ( !channel.hasReceivedMessage
+			 || GetSequenceDifference( reliableId, channel.newestReceivedId ) > 0 )
+		{
+			channel.newestReceivedId = reliableId;
+			channel.hasReceivedMessage = true;
+		}
+
+		out_deliveredMessages.push_back( data );
+		return true;
+	}
+
+	int distanceAhead = GetSequenceDifference( reliableId, channel.nextDeliverId );
+	if ( distanceAhead < 0
+		 || distanceAhead >= RELIABLE_UDP_WINDOW_SIZE
+		 || channel.isMessageBuffered[slotIdx] )
+	{
+		++m_numDuplicatesDropped;
+		return false;
+	}
+
+	channel.bufferedMessages[slotIdx] = data;
+	channel.isMessageBuffered[slotIdx] = true;
+
+	// Deliver everything that is now contiguous
+	int nextSlotIdx = channel.nextDeliverId % RELIABLE_UDP_WINDOW_SIZE;
+	while ( channel.isMessageBuffered[nextSlotIdx] )
+	{
+		out_deliveredMessages.push_back( channel.bufferedMessages[nextSlotIdx] );
+		channel.bufferedMessages[nextSlotIdx] = UDPData();
+		channel.isMessageBuffered[nextSlotIdx] = false;
+
+		++channel.nextDeliverId;
+		nextSlotIdx = channel.nextDeliverId % RELIABLE_UDP_WINDOW_SIZE;
+	}
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void UDPConnection::ReleaseBufferedMessages( UDPPacketPool& packetPool )
+{
+	for ( int slotIdx = 0; slotIdx < RELIABLE_UDP_WINDOW_SIZE; ++slotIdx )
+	{
+		if ( m_orderedChannel.isMessageBuffered[slotIdx] )
+		{
+			packetPool.Release( m_orderedChannel.bufferedMessages[slotIdx].GetData() );
+			m_orderedChannel.bufferedMessages[slotIdx] = UDPData();
+			m_orderedChannel.isMessageBuffered[slotIdx] = false;
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+double UDPConnection::GetResendSeconds() const
+{
+	if ( !m_hasRoundTripSample )
+	{
+		return INITIAL_UDP_RESEND_SECONDS;
+	}
+
+	// RFC 6298 retransmission timeout, with a frame of slack since each end only reads acks once a frame
+	double resendSeconds = m_smoothedRoundTripSeconds + 4.0 * m_roundTripVariationSeconds + UDP_RESEND_FRAME_MARGIN_SECONDS;
+	return Min( Max( resendSeconds, MIN_UDP_RESEND_SECONDS ), MAX_UDP_RESEND_SECONDS );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+UDPConnectionStats UDPConnection::GetStats() const
+{
+	UDPConnectionStats stats;
+	stats.roundTripSeconds = (float)m_smoothedRoundTripSeconds;
+	stats.jitterSeconds = (float)m_roundTripVariationSeconds;
+	stats.resendSeconds = (float)GetResendSeconds();
+	stats.numPacketsSent = m_numPacketsSent;
+	stats.numPacketsAcked = m_numPacketsAcked;
+	stats.numResent = m_numResent;
+	stats.numAbandoned = m_numAbandoned;
+	stats.numDuplicatesDropped = m_numDuplicatesDropped;
+
+	const ReliableUDPChannel* channels[] = { &m_unorderedChannel, &m_orderedChannel };
+	for ( const ReliableUDPChannel* channel : channels )
+	{
+		for ( const PendingReliableUDPMessage& message : channel->pendingMessages )
+		{
+			stats.numReliableInFlight += message.isValid ? 1 : 0;
+		}
+
+		stats.numReliableQueued += (int)channel->queuedMessages.size();
+	}
+
+	return stats;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void UDPConnection::RecordReceivedPacket( uint16_t sequenceNum )
+{
+	if ( !m_hasReceivedPacket )
+	{
+		m_newestReceivedSequenceNum = sequenceNum;
+		m_receivedAckBits = 0;
+		m_hasReceivedPacket = true;
+		return;
+	}
+
+	int distanceAhead = GetSequenceDifference( sequenceNum, m_newestReceivedSequenceNum );
+	if ( distanceAhead > 0 )
+	{
+		// Slide the bitfield forward, the previous newest becomes bit distanceAhead - 1
+		if ( distanceAhead > NUM_UDP_ACK_BITS )
+		{
+			m_receivedAckBits = 0;
+		}
+		else
+		{
+			// Split the shift in two so a full 64 bit shift never happens
+			m_receivedAckBits = ( ( m_receivedAckBits << 1 ) | 1 ) << ( distanceAhead - 1 );
+		}
+
+		m_newestReceivedSequenceNum = sequenceNum;
+	}
+	else if ( distanceAhead < 0
+			  && -distanceAhead <= NUM_UDP_ACK_BITS )
+	{
+		m_receivedAckBits |= 1ull << ( -distanceAhead - 1 );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void UDPConnection::AckSentPacket( uint16_t sequenceNum, double currentTime )
+{
+	SentUDPPacket& sentPacket = m_sentPackets[sequenceNum % SENT_UDP_PACKET_HISTORY_SIZE];
+	if ( !sentPacket.isValid
+		 || sentPacket.isAcked
+		 || sentPacket.sequenceNum != sequenceNum )
+	{
+		return;
+	}
+
+	sentPacket.isAcked = true;
+	++m_numPacketsAcked;
+
+	// Every resend goes out in a new packet, so an ack always matches the send it is timed against
+	AddRoundTripSample( currentTime - sentPacket.sendTime );
+
+	if ( sentPacket.channel == eUDPChannel::UNRELIABLE )
+	{
+		return;
+	}
+
+	ReliableUDPChannel& channel = GetChannel( sentPacket.channel );
+	PendingReliableUDPMessage& message = channel.pendingMessages[sentPacket.reliableId % RELIABLE_UDP_WINDOW_SIZE];
+	if ( message.isValid
+		 && message.reliableId == sentPacket.reliableId )
+	{
+		message.isValid = false;
+		AdvanceOldestUnackedId( channel );
+		FillSendWindow( channel, sentPacket.channel );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void UDPConnection::AddRoundTripSample( double roundTripSeconds )
+{
+	if ( !m_hasRoundTripSample )
+	{
+		m_smoothedRoundTripSeconds = roundTripSeconds;
+		m_roundTripVariationSeconds = roundTripSeconds * 0.5;
+		m_hasRoundTripSample = true;
+		return;
+	}
+
+	m_roundTripVariationSeconds = 0.75 * m_roundTripVariationSeconds + 0.25 * fabs( m_smoothedRoundTripSeconds - roundTripSeconds );
+	m_smoothedRoundTripSeconds = 0.875 * m_smoothedRoundTripSeconds + 0.125 * roundTripSeconds;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void UDPConnection::FillSendWindow( ReliableUDPChannel& channel, eUDPChannel channelType )
+{
+	while ( !channel.queuedMessages.empty()
+			&& GetSequenceDifference( channel.nextSendId, channel.oldestUnackedId ) < RELIABLE_UDP_WINDOW_SIZE )
+	{
+		const QueuedReliableUDPMessage& queuedMessage = channel.queuedMessages.front();
+
+		uint16_t reliableId = channel.nextSendId++;
+		PendingReliableUDPMessage& message = channel.pendingMessages[reliableId % RELIABLE_UDP_WINDOW_SIZE];
+		message.data = queuedMessage.data;
+		message.nextSendTime = 0.0;
+		message.numSends = 0;
+		message.maxResendCount = queuedMessage.maxResendCount;
+		message.reliableId = reliableId;
+		message.isValid = true;
+
+		UDPMessageHeader* header = reinterpret_cast<UDPMessageHeader*>( &message.data[0] );
+		header->reliableId = reliableId;
+		header->channel = channelType;
+
+		channel.queuedMessages.pop_front();
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void UDPConnection::AdvanceOldestUnackedId( ReliableUDPChannel& channel )
+{
+	while ( channel.oldestUnackedId != channel.nextSendId
+			&& !channel.pendingMessages[channel.oldestUnackedId % RELIABLE_UDP_WINDOW_SIZE].isValid )
+	{
+		++channel.oldestUnackedId;
+	}
+}
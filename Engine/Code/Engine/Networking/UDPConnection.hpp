@@ -0,0 +1,169 @@
+#pragma once
+#include "Engine/Networking/MessageProtocols.hpp"
+#include "Engine/Networking/UDPTransport.hpp"
+
+#include <array>
+#include <deque>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------------------------
+class UDPPacketPool;
+
+
+//-----------------------------------------------------------------------------------------------
+// Reliable messages a channel can have unacked at once, which is also how far back the receiver has to remember
+constexpr int RELIABLE_UDP_WINDOW_SIZE = 128;
+
+// Sent packets remembered for matching acks, has to cover more than the ack bitfield
+constexpr int SENT_UDP_PACKET_HISTORY_SIZE = 256;
+constexpr int NUM_UDP_ACK_BITS = 64;
+
+// Resend timer limits, the initial time is used until the first round trip has been measured
+constexpr double INITIAL_UDP_RESEND_SECONDS = 0.2;
+constexpr double MIN_UDP_RESEND_SECONDS = 0.03;
+constexpr double MAX_UDP_RESEND_SECONDS = 2.0;
+constexpr double UDP_RESEND_FRAME_MARGIN_SECONDS = 1.0 / 60.0;
+
+
+//-----------------------------------------------------------------------------------------------
+struct SentUDPPacket
+{
+public:
+	double sendTime = 0.0;
+	uint16_t sequenceNum = 0;
+	uint16_t reliableId = 0;
+	eUDPChannel channel = eUDPChannel::UNRELIABLE;
+	bool isValid = false;
+	bool isAcked = false;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+struct PendingReliableUDPMessage
+{
+public:
+	std::array<char, BUFFER_SIZE> data;
+	double nextSendTime = 0.0;
+	int numSends = 0;
+	int maxResendCount = -1;		// Negative resends until acked
+	uint16_t reliableId = 0;
+	bool isValid = false;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+struct QueuedReliableUDPMessage
+{
+public:
+	std::array<char, BUFFER_SIZE> data;
+	int maxResendCount = -1;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Send and receive state for one reliable channel. Both sides index their windows by reliableId % RELIABLE_UDP_WINDOW_SIZE,
+// the sender never has more than a window of messages in flight so slots can't be reused while still needed.
+struct ReliableUDPChannel
+{
+public:
+	// Sending
+	std::array<PendingReliableUDPMessage, RELIABLE_UDP_WINDOW_SIZE> pendingMessages;
+	std::deque<QueuedReliableUDPMessage> queuedMessages;		// Waiting for room in the window
+	uint16_t nextSendId = 0;
+	uint16_t oldestUnackedId = 0;
+
+	// Receiving unordered
+	std::array<uint32_t, RELIABLE_UDP_WINDOW_SIZE> receivedIds;
+	uint16_t newestReceivedId = 0;
+	bool hasReceivedMessage = false;
+
+	// Receiving ordered
+	std::array<UDPData, RELIABLE_UDP_WINDOW_SIZE> bufferedMessages;
+	std::array<bool, RELIABLE_UDP_WINDOW_SIZE> isMessageBuffered;
+	uint16_t nextDeliverId = 0;
+
+public:
+	ReliableUDPChannel();
+};
+
+
+//-----------------------------------------------------------------------------------------------
+struct UDPConnectionStats
+{
+public:
+	float roundTripSeconds = 0.f;		// Smoothed
+	float jitterSeconds = 0.f;			// Smoothed round trip variation
+	float resendSeconds = 0.f;
+	int numReliableInFlight = 0;
+	int numReliableQueued = 0;
+	int numPacketsSent = 0;
+	int numPacketsAcked = 0;
+	int numResent = 0;
+	int numAbandoned = 0;				// Unordered messages that ran out of resends
+	int numDuplicatesDropped = 0;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Reliability for the datagrams exchanged with one distant port. Every DATA, BATCH and ACK datagram carries a
+// packet sequence number plus the newest sequence received and a bitfield of the 64 before it, so acks ride along
+// with normal traffic. A burst long enough to push unreported packets out of the bitfield asks for an ack right away. A reliable message is acked when any packet carrying it is, and resent on a timer derived
+// from the measured round trip and jitter.
+class UDPConnection
+{
+public:
+	UDPConnection() = default;
+	~UDPConnection() = default;
+
+	UDPConnection( const UDPConnection& other ) = delete;
+	UDPConnection& operator=( const UDPConnection& other ) = delete;
+
+	// Sending
+	void	QueueReliableMessage( const std::array<char, BUFFER_SIZE>& data, eUDPChannel channel, int maxResendCount );
+	void	GetReliableMessagesToSend( double currentTime, std::vector<std::array<char, BUFFER_SIZE>>& out_messages );
+	void	StampOutgoingPacket( UDPMessageHeader& header, double currentTime );
+	bool	NeedsAck() const											{ return m_needsAck; }
+	bool	NeedsImmediateAck() const									{ return m_numPacketsReceivedSinceAck >= NUM_UDP_ACK_BITS; }
+
+	// Receiving
+	void	ReceivePacketHeader( const UDPMessageHeader& header, double currentTime );
+	// Returns true if the message's packet was kept, either in out_deliveredMessages or buffered until earlier ordered messages arrive
+	bool	ReceiveReliableMessage( const UDPData& data, std::vector<UDPData>& out_deliveredMessages );
+	void	ReleaseBufferedMessages( UDPPacketPool& packetPool );
+
+	double	GetResendSeconds() const;
+	UDPConnectionStats GetStats() const;
+
+private:
+	ReliableUDPChannel& GetChannel( eUDPChannel channel )				{ return channel == eUDPChannel::RELIABLE_ORDERED ? m_orderedChannel : m_unorderedChannel; }
+
+	void	RecordReceivedPacket( uint16_t sequenceNum );
+	void	AckSentPacket( uint16_t sequenceNum, double currentTime );
+	void	AddRoundTripSample( double roundTripSeconds );
+	void	FillSendWindow( ReliableUDPChannel& channel, eUDPChannel channelType );
+	void	AdvanceOldestUnackedId( ReliableUDPChannel& channel );
+
+private:
+	ReliableUDPChannel m_unorderedChannel;
+	ReliableUDPChannel m_orderedChannel;
+
+	std::array<SentUDPPacket, SENT_UDP_PACKET_HISTORY_SIZE> m_sentPackets;
+	uint16_t m_nextSequenceNum = 0;
+
+	uint16_t m_newestReceivedSequenceNum = 0;
+	uint64_t m_receivedAckBits = 0;
+	int m_numPacketsReceivedSinceAck = 0;
+	bool m_hasReceivedPacket = false;
+	bool m_needsAck = false;
+
+	bool m_hasRoundTripSample = false;
+	double m_smoothedRoundTripSeconds = 0.0;
+	double m_roundTripVariationSeconds = 0.0;
+
+	int m_numPacketsSent = 0;
+	int m_numPacketsAcked = 0;
+	int m_numResent = 0;
+	int m_numAbandoned = 0;
+	int m_numDuplicatesDropped = 0;
+};
@@ -0,0 +1,102 @@
+#include "Engine/Networking/UDPPacketPool.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr uint32_t INVALID_PACKET_IDX = 0xFFFFFFFF;
+
+
+//-----------------------------------------------------------------------------------------------
+UDPPacketPool::UDPPacketPool( int numPackets, int packetSize )
+	: m_numPackets( numPackets )
+	, m_packetSize( packetSize )
+{
+	GUARANTEE_OR_DIE( numPackets > 0 && packetSize > 0, "UDPPacketPool needs at least one packet with a positive size" );
+
+	m_packetData = new char[(size_t)numPackets * (size_t)packetSize];
+	m_nextFreePacketIndices = new std::atomic<uint32_t>[numPackets];
+
+	for ( int packetIdx = 0; packetIdx < numPackets - 1; ++packetIdx )
+	{
+		m_nextFreePacketIndices[packetIdx].store( (uint32_t)packetIdx + 1, std::memory_order_relaxed );
+	}
+	m_nextFreePacketIndices[numPackets - 1].store( INVALID_PACKET_IDX, std::memory_order_relaxed );
+
+	m_freeListHead.store( PackHead( 0, 0 ) );
+	m_numFreePackets.store( numPackets );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+UDPPacketPool::~UDPPacketPool()
+{
+	delete[] m_packetData;
+	m_packetData = nullptr;
+
+	delete[] m_nextFreePacketIndices;
+	m_nextFreePacketIndices = nullptr;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+char* UDPPacketPool::Acquire()
+{
+	uint64_t head = m_freeListHead.load( std::memory_order_acquire );
+	while ( true )
+	{
+		uint32_t packetIdx = GetHeadPacketIdx( head );
+		if ( packetIdx == INVALID_PACKET_IDX )
+		{
+			return nullptr;
+		}
+
+		// If another thread pops this packet first the tag changes and the exchange fails, so a stale next index is never used
+		uint32_t nextPacketIdx = m_nextFreePacketIndices[packetIdx].load( std::memory_order_relaxed );
+		uint64_t newHead = PackHead( nextPacketIdx, GetHeadTag( head ) + 1 );
+		if ( m_freeListHead.compare_exchange_weak( head, newHead, std::memory_order_acquire, std::memory_order_acquire ) )
+		{
+			m_numFreePackets.fetch_sub( 1, std::memory_order_relaxed );
+			return m_packetData + (size_t)packetIdx * (size_t)m_packetSize;
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void UDPPacketPool::Release( char* packet )
+{
+	if ( packet == nullptr )
+	{
+		return;
+	}
+
+	GUARANTEE_OR_DIE( OwnsPacket( packet ), "Tried to release a packet that doesn't belong to this UDPPacketPool" );
+
+	uint32_t packetIdx = (uint32_t)( ( packet - m_packetData ) / m_packetSize );
+
+	uint64_t head = m_freeListHead.load( std::memory_order_relaxed );
+	while ( true )
+	{
+		m_nextFreePacketIndices[packetIdx].store( GetHeadPacketIdx( head ), std::memory_order_relaxed );
+
+		uint64_t newHead = PackHead( packetIdx, GetHeadTag( head ) );
+		if ( m_freeListHead.compare_exchange_weak( head, newHead, std::memory_order_release, std::memory_order_relaxed ) )
+		{
+			m_numFreePackets.fetch_add( 1, std::memory_order_relaxed );
+			return;
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool UDPPacketPool::OwnsPacket( const char* packet ) const
+{
+	if ( packet < m_packetData 
+		 || packet >= m_packetData + (size_t)m_numPackets * (size_t)m_packetSize )
+	{
+		return false;
+	}
+
+	return ( packet - m_packetData ) % m_packetSize == 0;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+
+//-----------------------------------------------------------------------------------------------
+// Fixed set of preallocated packet buffers shared between the UDP reader threads and the main thread.
+// Acquire and Release are lock free (a tagged free list), so any thread can take or return a packet
+// without blocking, and nothing is allocated after construction.
+class UDPPacketPool
+{
+public:
+	UDPPacketPool( int numPackets, int packetSize );
+	~UDPPacketPool();
+
+	UDPPacketPool( const UDPPacketPool& other ) = delete;
+	UDPPacketPool& operator=( const UDPPacketPool& other ) = delete;
+
+	// Returns nullptr when every packet is in use
+	char*	Acquire();
+	void	Release( char* packet );
+
+	bool	OwnsPacket( const char* packet ) const;
+	int		GetPacketSize() const								{ return m_packetSize; }
+	int		GetNumPackets() const								{ return m_numPackets; }
+	int		GetNumFreePackets() const							{ return m_numFreePackets.load( std::memory_order_relaxed ); }
+
+private:
+	static uint64_t	PackHead( uint32_t packetIdx, uint32_t tag )	{ return ( (uint64_t)tag << 32 ) | (uint64_t)packetIdx; }
+	static uint32_t	GetHeadPacketIdx( uint64_t head )				{ return (uint32_t)( head & 0xFFFFFFFF ); }
+	static uint32_t	GetHeadTag( uint64_t head )						{ return (uint32_t)( head >> 32 ); }
+
+private:
+	char* m_packetData = nullptr;
+	int m_numPackets = 0;
+	int m_packetSize = 0;
+
+	// Free list links, each free packet stores the index of the next free packet
+	std::atomic<uint32_t>* m_nextFreePacketIndices = nullptr;
+
+	// Index of the first free packet plus a tag that changes on every pop to avoid ABA problems
+	std::atomic<uint64_t> m_freeListHead;
+	std::atomic<int> m_numFreePackets;
+};
@@ -1,6 +1,7 @@
 #include "Engine/Networking/UDPSocket.hpp"
 #include "Engine/Core/DevConsole.hpp"
 
+#include <cstring>
 #include <iostream>
 
 
@@ -14,13 +15,13 @@ UDPSocket::UDPSocket( const std::string& host, int distantSendToPort )
 	}
 	
 	m_toAddress.sin_family = AF_INET;
-	m_toAddress.sin_port = htons((u_short)distantSendToPort);
+	m_toAddress.sin_port = htons( (unsigned short)distantSendToPort );
 	m_toAddress.sin_addr.s_addr = inet_addr( hostAddr.c_str() );
 
 	m_socket = socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
 	if ( m_socket == INVALID_SOCKET )
 	{
-		LOG_ERROR( "Socket instantiate failed '%i'", WSAGetLastError() );
+		LOG_ERROR( "Socket instantiate failed '%i'", GetLastSocketError() );
 	}
 }
 
@@ -46,13 +47,13 @@ void UDPSocket::Bind( int localBindPort )
 	m_localBindPort = localBindPort;
 
 	m_bindAddress.sin_family = AF_INET;
-	m_bindAddress.sin_port = htons( (u_short)localBindPort );
+	m_bindAddress.sin_port = htons( (unsigned short)localBindPort );
 	m_bindAddress.sin_addr.s_addr = htonl( INADDR_ANY );
 
-	int result = bind( m_socket, (SOCKADDR*)&m_bindAddress, sizeof( m_bindAddress ) );
+	int result = bind( m_socket, reinterpret_cast<sockaddr*>( &m_bindAddress ), sizeof( m_bindAddress ) );
 	if ( result != 0 )
 	{
-		LOG_ERROR( "Bind failed with '%i'", WSAGetLastError() );
+		LOG_ERROR( "Bind failed with '%i'", GetLastSocketError() );
 	} 
 }
 
@@ -62,10 +63,10 @@ void UDPSocket::Close()
 {
 	if ( m_socket != INVALID_SOCKET )
 	{
-		int result = closesocket( m_socket );
+		int result = CloseSocket( m_socket );
 		if ( result == SOCKET_ERROR )
 		{
-			LOG_ERROR( "Socket instantiate failed with '%i'", WSAGetLastError() );
+			LOG_ERROR( "Socket instantiate failed with '%i'", GetLastSocketError() );
 		}
 
 		m_socket = INVALID_SOCKET;
@@ -74,13 +75,19 @@ void UDPSocket::Close()
 
 
 //-----------------------------------------------------------------------------------------------
-//int UDPSocket::Send( const char* data, size_t length )
 int UDPSocket::Send( size_t length ) 
 {
-	int bytesSent = sendto( m_socket, &m_sendBuffer[0], (int)length, 0, reinterpret_cast<SOCKADDR*>( &m_toAddress ), sizeof( m_toAddress ) );
+	return Send( &m_sendBuffer[0], length );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int UDPSocket::Send( const char* data, size_t length )
+{
+	int bytesSent = (int)sendto( m_socket, data, (int)length, 0, reinterpret_cast<sockaddr*>( &m_toAddress ), sizeof( m_toAddress ) );
 	if ( bytesSent == SOCKET_ERROR )
 	{
-		LOG_ERROR( "Send to failed with '%i'", WSAGetLastError() );
+		LOG_ERROR( "Send to failed with '%i'", GetLastSocketError() );
 	}
 	else if ( bytesSent < (int)length )
 	{
@@ -95,29 +102,83 @@ int UDPSocket::Send( size_t length )
 
 
 //-----------------------------------------------------------------------------------------------
-UDPData UDPSocket::Receive()
+int UDPSocket::SendBatch( const UDPDatagramView* datagrams, int numDatagrams, int& out_numSendCalls )
+{
+#if defined( __linux__ )
+	out_numSendCalls = 0;
+
+	mmsghdr messages[MAX_UDP_DATAGRAMS_PER_SEND_CALL];
+	iovec messageData[MAX_UDP_DATAGRAMS_PER_SEND_CALL];
+
+	int numSent = 0;
+	int numAttempted = 0;
+	while ( numAttempted < numDatagrams )
+	{
+		int numInCall = numDatagrams - numAttempted;
+		if ( numInCall > MAX_UDP_DATAGRAMS_PER_SEND_CALL )
+		{
+			numInCall = MAX_UDP_DATAGRAMS_PER_SEND_CALL;
+		}
+
+		for ( int messageIdx = 0; messageIdx < numInCall; ++messageIdx )
+		{
+			const UDPDatagramView& datagram = datagrams[numAttempted + messageIdx];
+			messageData[messageIdx].iov_base = const_cast<char*>( datagram.data );
+			messageData[messageIdx].iov_len = datagram.length;
+
+			memset( &messages[messageIdx], 0, sizeof( messages[messageIdx] ) );
+			messages[messageIdx].msg_hdr.msg_name = &m_toAddress;
+			messages[messageIdx].msg_hdr.msg_namelen = sizeof( m_toAddress );
+			messages[messageIdx].msg_hdr.msg_iov = &messageData[messageIdx];
+			messages[messageIdx].msg_hdr.msg_iovlen = 1;
+		}
+
+		++out_numSendCalls;
+		int numSentInCall = sendmmsg( m_socket, messages, (unsigned int)numInCall, 0 );
+		if ( numSentInCall <= 0 )
+		{
+			// The call stops at the first datagram that fails, skip it like a failed sendto and carry on with the rest
+			LOG_ERROR( "Send batch failed with '%i'", GetLastSocketError() );
+			numAttempted += 1;
+			continue;
+		}
+
+		numSent += numSentInCall;
+		numAttempted += numSentInCall;
+	}
+
+	return numSent;
+#else
+	// Winsock has no multi datagram send, one sendto each
+	return UDPTransport::SendBatch( datagrams, numDatagrams, out_numSendCalls );
+#endif
+}
+
+
+//-----------------------------------------------------------------------------------------------
+UDPData UDPSocket::Receive( char* receiveBuffer, size_t bufferSize )
 {
 	sockaddr_in fromAddress;
-	int fromAddrLength = sizeof( fromAddress );
+	SocketAddressLength fromAddrLength = sizeof( fromAddress );
 
-	int iResult = recvfrom( m_socket, &m_receiveBuffer[0], (int)m_receiveBuffer.size(), 0, reinterpret_cast<SOCKADDR*>( &fromAddress ), &fromAddrLength );
+	int iResult = (int)recvfrom( m_socket, receiveBuffer, (int)bufferSize, 0, reinterpret_cast<sockaddr*>( &fromAddress ), &fromAddrLength );
 	if ( iResult == SOCKET_ERROR )
 	{
-		//LOG_ERROR( "Receive from failed with '%i'", WSAGetLastError() );
+		//LOG_ERROR( "Receive from failed with '%i'", GetLastSocketError() );
 		return UDPData();
 	}
 
-	if ( iResult > BUFFER_SIZE - 1 )
+	if ( iResult > (int)bufferSize - 1 )
 	{
 		LOG_ERROR( "Receive from received too much data for buffer" );
 		return UDPData();
 	}
 	else
 	{
-		m_receiveBuffer[iResult] = '\0';
+		receiveBuffer[iResult] = '\0';
 	}
 	
 	std::string fromAddressStr = std::string( inet_ntoa( fromAddress.sin_addr ) );
 	
-	return UDPData( iResult, &m_receiveBuffer[0], fromAddressStr, (int)ntohs( fromAddress.sin_port ) );
+	return UDPData( iResult, receiveBuffer, fromAddressStr, (int)ntohs( fromAddress.sin_port ) );
 }
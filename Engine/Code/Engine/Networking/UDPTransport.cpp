@@ -0,0 +1,22 @@
+#include "Engine/Networking/UDPTransport.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+int UDPTransport::SendBatch( const UDPDatagramView* datagrams, int numDatagrams, int& out_numSendCalls )
+{
+	out_numSendCalls = 0;
+
+	int numSent = 0;
+	for ( int datagramIdx = 0; datagramIdx < numDatagrams; ++datagramIdx )
+	{
+		const UDPDatagramView& datagram = datagrams[datagramIdx];
+
+		++out_numSendCalls;
+		if ( Send( datagram.data, datagram.length ) == (int)datagram.length )
+		{
+			++numSent;
+		}
+	}
+
+	return numSent;
+}
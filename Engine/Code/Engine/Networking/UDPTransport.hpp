@@ -0,0 +1,82 @@
+#pragma once
+#include "Engine/Networking/MessageProtocols.hpp"
+
+#include <string>
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr int BUFFER_SIZE = 512;
+
+
+//-----------------------------------------------------------------------------------------------
+// A received datagram. The data points into a packet owned by whoever received it (the NetworkingSystem's
+// packet pool for game traffic), so copies of a UDPData are views and are only valid until the message
+// has been processed and cleared.
+class UDPData
+{
+public:
+	UDPData() = default;
+	UDPData( size_t length, char* dataPtr, const std::string& fromAddress, int fromPort )
+		: m_length( length )
+		, m_data( dataPtr )
+		, m_fromAddress( fromAddress )
+		, m_fromPort( fromPort )
+	{
+	}
+
+	~UDPData() = default;
+
+	size_t		GetLength() const				{ return m_length; }
+	char*		GetData() const					{ return m_data; }
+	const char* GetPayload() const				{ return m_data + sizeof( UDPMessageHeader ); }
+
+	std::string GetFromAddress() const			{ return m_fromAddress; }
+	std::string GetFromIPAddress() const		{ return m_fromAddress; }
+	int			GetFromPort() const				{ return m_fromPort; }
+
+	bool		HasBeenProcessed()				{ return m_hasBeenProcessed; }
+	void		Process()						{ m_hasBeenProcessed = true; }
+
+	void		SetFromPort( int port )			{ m_fromPort = port; }
+
+	int			GetNumFramesUnprocessed() const	{ return m_numFramesUnprocessed; }
+	void		IncrementFramesUnprocessed()	{ ++m_numFramesUnprocessed; }
+
+private:
+	size_t m_length = 0;
+	char* m_data = nullptr;
+	std::string m_fromAddress;
+	int m_fromPort = -1;
+	bool m_hasBeenProcessed = false;
+	int m_numFramesUnprocessed = 0;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// One datagram of a batch to send, the data is owned by the caller
+struct UDPDatagramView
+{
+public:
+	const char* data = nullptr;
+	size_t length = 0;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Where NetworkingSystem sends and receives datagrams, a real socket or an in-process LoopbackUDPNetwork
+class UDPTransport
+{
+public:
+	virtual ~UDPTransport() = default;
+
+	virtual void	Bind( int localBindPort ) = 0;
+	virtual void	Close() = 0;
+	virtual int		Send( const char* data, size_t length ) = 0;
+	// Sends the datagrams in order and returns how many went out, a failed one doesn't stop the rest.
+	// The default sends them one at a time, transports that can hand the OS several per call override it.
+	virtual int		SendBatch( const UDPDatagramView* datagrams, int numDatagrams, int& out_numSendCalls );
+	// Receives the next datagram directly into receiveBuffer, which must outlive the returned UDPData
+	virtual UDPData	Receive( char* receiveBuffer, size_t bufferSize ) = 0;
+
+	virtual int		GetReceivePort() const = 0;
+};
@@ -74,6 +74,13 @@ void GPUMesh::UpdateIndices( uint indexCount, const uint* indices )
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void GPUMesh::UpdateIndices( uint indexCount, const uint16_t* indices )
+{
+	m_indices->Update( indexCount, indices );
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void GPUMesh::UpdateIndices( const std::vector<uint>& indices )
 {
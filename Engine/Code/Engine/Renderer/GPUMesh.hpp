@@ -30,6 +30,25 @@ public:
 		UpdateIndices( indices );
 	}
 
+	// Builds the buffers straight from existing memory, e.g. a memory mapped mesh file
+	template <typename VERTEX_TYPE, typename INDEX_TYPE>
+	GPUMesh( RenderContext* context, uint vertexCount, const VERTEX_TYPE* vertices, uint indexCount, const INDEX_TYPE* indices )
+	{
+		m_context = context;
+		m_vertices = new VertexBuffer( context, MEMORY_HINT_DYNAMIC, sizeof( VERTEX_TYPE ), VERTEX_TYPE::LAYOUT );
+		m_indices = new IndexBuffer( context, MEMORY_HINT_DYNAMIC );
+
+		if ( vertexCount > 0 )
+		{
+			UpdateVertices( vertexCount, vertices );
+		}
+
+		if ( indexCount > 0 )
+		{
+			UpdateIndices( indexCount, indices );
+		}
+	}
+
 	GPUMesh( RenderContext* context, const CPUMesh& cpuMesh);
 
 	void SetFromCPUMesh( const CPUMesh& cpuMesh );
@@ -37,11 +56,12 @@ public:
 	// Set up buffers
 	void UpdateVertices( uint vertexCount, const void* vertexData, uint vertexStride, const BufferAttribute* layout );
 	void UpdateIndices( uint indexCount, const uint* indices );
+	void UpdateIndices( uint indexCount, const uint16_t* indices );
 	void UpdateIndices( const std::vector<uint>& indices );
 
 	// helper templates
 	template <typename VERTEX_TYPE>
-	void UpdateVertices( const std::vector<VERTEX_TYPE> vertices )
+	void UpdateVertices( const std::vector<VERTEX_TYPE>& vertices )
 	{
 		if ( vertices.empty() )
 		{
@@ -17,6 +17,15 @@ void IndexBuffer::Update( uint indexCount, const uint* indices )
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void IndexBuffer::Update( uint indexCount, const uint16_t* indices )
+{
+	size_t dataByteSize = indexCount * sizeof( uint16_t );
+	size_t elementSize = sizeof( uint16_t );
+	RenderBuffer::Update( indices, dataByteSize, elementSize );
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void IndexBuffer::Update( const std::vector<uint>& indices )
 {
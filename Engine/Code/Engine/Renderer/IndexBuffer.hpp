@@ -13,6 +13,7 @@ public:
 	IndexBuffer( RenderContext* owner, eRenderMemoryHint memHint );
 
 	void Update( uint indexCount, const uint* indices );
+	void Update( uint indexCount, const uint16_t* indices );
 	void Update( const std::vector<uint>& indices ); // helper, calls one above
 
 };
\ No newline at end of file
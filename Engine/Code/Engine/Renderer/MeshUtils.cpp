@@ -1208,7 +1208,7 @@ void AppendVertsForObjMeshFromFile( std::vector<Vertex_PCUTBN>& vertices,
 	}
 
 	bool fileHadNormals = false;
-	ObjLoader::LoadFromFile( vertices, objFileName, fileHadNormals );
+	ObjLoader::LoadFromFile( vertices, objFileName, fileHadNormals, options.numParseThreads );
 
 	if ( options.invertVs )
 	{
@@ -112,6 +112,7 @@ struct MeshImportOptions
 	bool generateNormals = false;		// Generate normals for the surface if they weren't in the file
 	bool generateTangents = false;		// Generate tangents for the surface if they weren't in the file
 	bool clean = false;					// Convert a vertex array to an index vertex array by removing duplicates
+	int numParseThreads = 1;			// Large files are split up and parsed on this many threads
 };
 
 void AppendVertsForObjMeshFromFile( std::vector<Vertex_PCUTBN>& vertices,
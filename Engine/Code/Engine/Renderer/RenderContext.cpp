@@ -791,7 +791,8 @@ void RenderContext::BindIndexBuffer( IndexBuffer* ibo )
 	}
 	m_lastIBOHandle = iboHandle;
 
-	m_context->IASetIndexBuffer( iboHandle, DXGI_FORMAT_R32_UINT, 0 );
+	DXGI_FORMAT indexFormat = ibo->m_elementByteSize == sizeof( uint16_t ) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+	m_context->IASetIndexBuffer( iboHandle, indexFormat, 0 );
 }
 
 
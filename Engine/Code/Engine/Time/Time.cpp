@@ -6,6 +6,14 @@
 #include "Engine/Time/Time.hpp"
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
+#include <timeapi.h>
+
+#pragma comment( lib, "Winmm.lib" )
+
+
+//-----------------------------------------------------------------------------------------------
+// With a 1ms timer resolution Sleep can still wake about a millisecond late
+constexpr double SLEEP_YIELD_MARGIN_SECONDS = 0.0015;
 
 
 //-----------------------------------------------------------------------------------------------
@@ -32,3 +40,35 @@ double GetCurrentTimeSeconds()
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void SleepUntilTimeSeconds( double targetTimeSeconds )
+{
+	double secondsRemaining = targetTimeSeconds - GetCurrentTimeSeconds();
+	while ( secondsRemaining > 0.0 )
+	{
+		if ( secondsRemaining > SLEEP_YIELD_MARGIN_SECONDS )
+		{
+			Sleep( (DWORD)( ( secondsRemaining - SLEEP_YIELD_MARGIN_SECONDS ) * 1000.0 ) );
+		}
+		else
+		{
+			SwitchToThread();
+		}
+
+		secondsRemaining = targetTimeSeconds - GetCurrentTimeSeconds();
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void BeginHighResolutionSleep()
+{
+	timeBeginPeriod( 1 );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EndHighResolutionSleep()
+{
+	timeEndPeriod( 1 );
+}
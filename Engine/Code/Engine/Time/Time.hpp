@@ -7,3 +7,10 @@
 //-----------------------------------------------------------------------------------------------
 double GetCurrentTimeSeconds();
 
+// Sleeps until GetCurrentTimeSeconds() reaches targetTimeSeconds, the last moment is spent yielding instead
+// of sleeping since an OS sleep can overshoot by a whole scheduler tick
+void SleepUntilTimeSeconds( double targetTimeSeconds );
+
+// Raises the OS timer resolution so short sleeps wake close to on time, every Begin needs a matching End
+void BeginHighResolutionSleep();
+void EndHighResolutionSleep();
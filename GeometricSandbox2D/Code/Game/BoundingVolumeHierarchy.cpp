@@ -0,0 +1,313 @@
+#include "Game/BoundingVolumeHierarchy.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Renderer/MeshUtils.hpp"
+#include "Game/GameCommon.hpp"
+
+#include <algorithm>
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr int NUM_SAH_BINS = 12;
+
+
+//-----------------------------------------------------------------------------------------------
+static AABB2 GetUnionOfBounds( const AABB2& boundsA, const AABB2& boundsB )
+{
+	return AABB2( Vec2( Min( boundsA.mins.x, boundsB.mins.x ), Min( boundsA.mins.y, boundsB.mins.y ) ),
+				  Vec2( Max( boundsA.maxs.x, boundsB.maxs.x ), Max( boundsA.maxs.y, boundsB.maxs.y ) ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// The 2D version of surface area, the chance a random ray hits the box grows with it
+static float GetHalfPerimeter( const AABB2& bounds )
+{
+	return ( bounds.maxs.x - bounds.mins.x ) + ( bounds.maxs.y - bounds.mins.y );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static float GetAxisValue( const Vec2& vec, int axis )
+{
+	return axis == 0 ? vec.x : vec.y;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void BoundingVolumeHierarchy::Build( const std::vector<Entity*>& entities, int numActiveEntities )
+{
+	m_nodes.clear();
+	m_entityIds.clear();
+	m_entityBounds.clear();
+	m_entityCenters.clear();
+
+	for ( int entityIdx = 0; entityIdx < numActiveEntities; ++entityIdx )
+	{
+		Entity* const& entity = entities[entityIdx];
+		if ( entity == nullptr )
+		{
+			continue;
+		}
+
+		AABB2 entityBounds = GetEntityBounds( *entity );
+		m_entityIds.push_back( entity->GetId() );
+		m_entityBounds.push_back( entityBounds );
+		m_entityCenters.push_back( entityBounds.GetCenter() );
+	}
+
+	if ( m_entityIds.empty() )
+	{
+		return;
+	}
+
+	m_nodes.reserve( m_entityIds.size() * 2 );
+	BuildNode( 0, (int)m_entityIds.size(), 0 );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void BoundingVolumeHierarchy::Refit( const std::vector<Entity*>& entities )
+{
+	for ( int leafEntityIdx = 0; leafEntityIdx < (int)m_entityIds.size(); ++leafEntityIdx )
+	{
+		m_entityBounds[leafEntityIdx] = GetEntityBounds( *entities[m_entityIds[leafEntityIdx]] );
+	}
+
+	// Children always come after their parent, so walking backwards refits them first
+	for ( int nodeIdx = (int)m_nodes.size() - 1; nodeIdx >= 0; --nodeIdx )
+	{
+		BVHNode& node = m_nodes[nodeIdx];
+		if ( node.IsLeaf() )
+		{
+			node.bounds = GetBoundsOfEntities( node.secondChildOrFirstEntityIdx, node.numEntities );
+			continue;
+		}
+
+		node.bounds = GetUnionOfBounds( m_nodes[nodeIdx + 1].bounds, m_nodes[node.secondChildOrFirstEntityIdx].bounds );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void BoundingVolumeHierarchy::DebugRender( std::vector<Vertex_PCU>& vertices ) const
+{
+	Rgba8 interiorColor = Rgba8::MAGENTA;
+	interiorColor.a = 100;
+
+	Rgba8 leafColor = Rgba8::YELLOW;
+	leafColor.a = 150;
+
+	for ( int nodeIdx = 0; nodeIdx < (int)m_nodes.size(); ++nodeIdx )
+	{
+		const BVHNode& node = m_nodes[nodeIdx];
+		AppendVertsForAABB2Outline( vertices, node.bounds, node.IsLeaf() ? leafColor : interiorColor, g_debugLineThickness );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void BoundingVolumeHierarchy::DebugRenderRaycast( std::vector<Vertex_PCU>& vertices, const Vec2& rayStart, const Vec2& rayForwardNormal, float rayMaxLength ) const
+{
+	Rgba8 highlightColor = Rgba8::ORANGE;
+	highlightColor.a = 100;
+
+	Vec2 rayInverseForward = GetRayInverseForward( rayForwardNormal );
+
+	for ( int nodeIdx = 0; nodeIdx < (int)m_nodes.size(); ++nodeIdx )
+	{
+		const BVHNode& node = m_nodes[nodeIdx];
+		if ( node.IsLeaf()
+			 && GetRayEntryDistance( node.bounds, rayStart, rayInverseForward, rayMaxLength ) >= 0.f )
+		{
+			AppendVertsForAABB2D( vertices, node.bounds, highlightColor );
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+float BoundingVolumeHierarchy::GetRayEntryDistance( const AABB2& bounds, const Vec2& rayStart, const Vec2& rayInverseForward, float maxDist )
+{
+	float xDist0 = ( bounds.mins.x - rayStart.x ) * rayInverseForward.x;
+	float xDist1 = ( bounds.maxs.x - rayStart.x ) * rayInverseForward.x;
+	float yDist0 = ( bounds.mins.y - rayStart.y ) * rayInverseForward.y;
+	float yDist1 = ( bounds.maxs.y - rayStart.y ) * rayInverseForward.y;
+
+	float entryDist = Max( Max( Min( xDist0, xDist1 ), Min( yDist0, yDist1 ) ), 0.f );
+	float exitDist = Min( Min( Max( xDist0, xDist1 ), Max( yDist0, yDist1 ) ), maxDist );
+
+	return entryDist <= exitDist ? entryDist : -1.f;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+Vec2 BoundingVolumeHierarchy::GetRayInverseForward( const Vec2& rayForwardNormal )
+{
+	// A huge value instead of infinity for axis aligned rays, so a start on the box edge gives 0 instead of NaN
+	return Vec2( rayForwardNormal.x == 0.f ? 1e30f : 1.f / rayForwardNormal.x,
+				 rayForwardNormal.y == 0.f ? 1e30f : 1.f / rayForwardNormal.y );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int BoundingVolumeHierarchy::GetRayPacketHitMask( const AABB2& bounds, const RayPacket& packet )
+{
+	__m128 xDist0 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( bounds.mins.x ), packet.startX ), packet.inverseForwardX );
+	__m128 xDist1 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( bounds.maxs.x ), packet.startX ), packet.inverseForwardX );
+	__m128 yDist0 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( bounds.mins.y ), packet.startY ), packet.inverseForwardY );
+	__m128 yDist1 = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( bounds.maxs.y ), packet.startY ), packet.inverseForwardY );
+
+	__m128 entryDist = _mm_max_ps( _mm_max_ps( _mm_min_ps( xDist0, xDist1 ), _mm_min_ps( yDist0, yDist1 ) ), _mm_setzero_ps() );
+	__m128 exitDist = _mm_min_ps( _mm_min_ps( _mm_max_ps( xDist0, xDist1 ), _mm_max_ps( yDist0, yDist1 ) ), packet.maxDist );
+
+	return _mm_movemask_ps( _mm_cmple_ps( entryDist, exitDist ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int BoundingVolumeHierarchy::BuildNode( int firstEntityIdx, int numEntities, int depth )
+{
+	int nodeIdx = (int)m_nodes.size();
+	m_nodes.push_back( BVHNode() );
+	m_nodes[nodeIdx].bounds = GetBoundsOfEntities( firstEntityIdx, numEntities );
+
+	AABB2 centerBounds( m_entityCenters[firstEntityIdx], m_entityCenters[firstEntityIdx] );
+	for ( int entityIdx = firstEntityIdx + 1; entityIdx < firstEntityIdx + numEntities; ++entityIdx )
+	{
+		centerBounds.StretchToIncludePoint( m_entityCenters[entityIdx] );
+	}
+
+	// Bin the centers along each axis and keep the split with the lowest surface area heuristic cost
+	int bestAxis = -1;
+	int bestSplitBin = -1;
+	float bestCost = 0.f;
+	if ( numEntities > MAX_ENTITIES_PER_BVH_LEAF
+		 && depth < MAX_BVH_DEPTH )
+	{
+		for ( int axis = 0; axis < 2; ++axis )
+		{
+			float minCenter = GetAxisValue( centerBounds.mins, axis );
+			float centerExtent = GetAxisValue( centerBounds.maxs, axis ) - minCenter;
+			if ( centerExtent <= 0.f )
+			{
+				continue;
+			}
+
+			int binCounts[NUM_SAH_BINS] = {};
+			AABB2 binBounds[NUM_SAH_BINS];
+			float binsPerUnit = (float)NUM_SAH_BINS / centerExtent;
+			for ( int entityIdx = firstEntityIdx; entityIdx < firstEntityIdx + numEntities; ++entityIdx )
+			{
+				int binIdx = Min( (int)( ( GetAxisValue( m_entityCenters[entityIdx], axis ) - minCenter ) * binsPerUnit ), NUM_SAH_BINS - 1 );
+				binBounds[binIdx] = binCounts[binIdx] == 0 ? m_entityBounds[entityIdx] : GetUnionOfBounds( binBounds[binIdx], m_entityBounds[entityIdx] );
+				++binCounts[binIdx];
+			}
+
+			// Sweep from the right first so the left sweep can price each split as it goes
+			float rightCosts[NUM_SAH_BINS] = {};
+			AABB2 rightBounds;
+			int rightCount = 0;
+			for ( int binIdx = NUM_SAH_BINS - 1; binIdx > 0; --binIdx )
+			{
+				if ( binCounts[binIdx] > 0 )
+				{
+					rightBounds = rightCount == 0 ? binBounds[binIdx] : GetUnionOfBounds( rightBounds, binBounds[binIdx] );
+					rightCount += binCounts[binIdx];
+				}
+
+				rightCosts[binIdx] = rightCount == 0 ? -1.f : (float)rightCount * GetHalfPerimeter( rightBounds );
+			}
+
+			AABB2 leftBounds;
+			int leftCount = 0;
+			for ( int splitBin = 1; splitBin < NUM_SAH_BINS; ++splitBin )
+			{
+				if ( binCounts[splitBin - 1] > 0 )
+				{
+					leftBounds = leftCount == 0 ? binBounds[splitBin - 1] : GetUnionOfBounds( leftBounds, binBounds[splitBin - 1] );
+					leftCount += binCounts[splitBin - 1];
+				}
+
+				if ( leftCount == 0
+					 || rightCosts[splitBin] < 0.f )
+				{
+					continue;
+				}
+
+				float cost = (float)leftCount * GetHalfPerimeter( leftBounds ) + rightCosts[splitBin];
+				if ( bestAxis == -1
+					 || cost < bestCost )
+				{
+					bestAxis = axis;
+					bestSplitBin = splitBin;
+					bestCost = cost;
+				}
+			}
+		}
+	}
+
+	// Too few entities, too deep, or every center is in the same spot
+	if ( bestAxis == -1 )
+	{
+		m_nodes[nodeIdx].secondChildOrFirstEntityIdx = firstEntityIdx;
+		m_nodes[nodeIdx].numEntities = numEntities;
+		return nodeIdx;
+	}
+
+	// Partition the entities in place, centers in lower bins go first
+	float minCenter = GetAxisValue( centerBounds.mins, bestAxis );
+	float binsPerUnit = (float)NUM_SAH_BINS / ( GetAxisValue( centerBounds.maxs, bestAxis ) - minCenter );
+	int lowIdx = firstEntityIdx;
+	int highIdx = firstEntityIdx + numEntities - 1;
+	while ( lowIdx <= highIdx )
+	{
+		int binIdx = Min( (int)( ( GetAxisValue( m_entityCenters[lowIdx], bestAxis ) - minCenter ) * binsPerUnit ), NUM_SAH_BINS - 1 );
+		if ( binIdx < bestSplitBin )
+		{
+			++lowIdx;
+			continue;
+		}
+
+		std::swap( m_entityIds[lowIdx], m_entityIds[highIdx] );
+		std::swap( m_entityBounds[lowIdx], m_entityBounds[highIdx] );
+		std::swap( m_entityCenters[lowIdx], m_entityCenters[highIdx] );
+		--highIdx;
+	}
+
+	int numLowEntities = lowIdx - firstEntityIdx;
+	m_nodes[nodeIdx].splitAxis = bestAxis;
+
+	BuildNode( firstEntityIdx, numLowEntities, depth + 1 );
+	int secondChildIdx = BuildNode( lowIdx, numEntities - numLowEntities, depth + 1 );
+	m_nodes[nodeIdx].secondChildOrFirstEntityIdx = secondChildIdx;
+
+	return nodeIdx;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+AABB2 BoundingVolumeHierarchy::GetBoundsOfEntities( int firstEntityIdx, int numEntities ) const
+{
+	AABB2 bounds = m_entityBounds[firstEntityIdx];
+	for ( int entityIdx = firstEntityIdx + 1; entityIdx < firstEntityIdx + numEntities; ++entityIdx )
+	{
+		bounds = GetUnionOfBounds( bounds, m_entityBounds[entityIdx] );
+	}
+
+	return bounds;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+AABB2 BoundingVolumeHierarchy::GetEntityBounds( const Entity& entity )
+{
+	std::vector<Vec2> points = entity.GetConvexPolygon().GetPoints();
+
+	AABB2 bounds( points[0], points[0] );
+	for ( int pointIdx = 1; pointIdx < (int)points.size(); ++pointIdx )
+	{
+		bounds.StretchToIncludePoint( points[pointIdx] );
+	}
+
+	return bounds;
+}
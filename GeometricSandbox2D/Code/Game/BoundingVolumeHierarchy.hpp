@@ -0,0 +1,80 @@
+#pragma once
+#include "Engine/Math/AABB2.hpp"
+#include "Game/Entity.hpp"
+
+#include <vector>
+#include <xmmintrin.h>
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr int MAX_ENTITIES_PER_BVH_LEAF = 4;
+constexpr int MAX_BVH_DEPTH = 48;					// Deeper nodes are forced into leaves, bounds the traversal stacks
+constexpr int BVH_TRAVERSAL_STACK_SIZE = MAX_BVH_DEPTH + 2;
+constexpr int RAY_PACKET_SIZE = 4;
+
+
+//-----------------------------------------------------------------------------------------------
+struct BVHNode
+{
+public:
+	AABB2 bounds;
+	int secondChildOrFirstEntityIdx = -1;			// The first child is always the next node
+	int numEntities = 0;							// 0 for interior nodes
+	int splitAxis = 0;								// 0 for x, 1 for y, the second child holds the higher centers
+
+public:
+	bool IsLeaf() const																{ return numEntities > 0; }
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Four rays in SSE lanes, lanes with a negative maxDist are finished and never hit anything
+struct RayPacket
+{
+public:
+	__m128 startX;
+	__m128 startY;
+	__m128 inverseForwardX;
+	__m128 inverseForwardY;
+	__m128 maxDist;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Flattened tree over the active entities' bounding boxes, split by the surface area heuristic.
+// Nodes are stored depth first, so every node comes before its children.
+class BoundingVolumeHierarchy
+{
+public:
+	BoundingVolumeHierarchy() = default;
+	~BoundingVolumeHierarchy() = default;
+
+	void Build( const std::vector<Entity*>& entities, int numActiveEntities );
+	// Refits the boxes of the same entities after they move, rotate or scale, without changing the tree
+	void Refit( const std::vector<Entity*>& entities );
+
+	void DebugRender( std::vector<Vertex_PCU>& vertices ) const;
+	void DebugRenderRaycast( std::vector<Vertex_PCU>& vertices, const Vec2& rayStart, const Vec2& rayForwardNormal, float rayMaxLength ) const;
+
+	bool IsEmpty() const															{ return m_nodes.empty(); }
+	const BVHNode& GetNode( int nodeIdx ) const										{ return m_nodes[nodeIdx]; }
+	EntityId GetLeafEntityId( int leafEntityIdx ) const								{ return m_entityIds[leafEntityIdx]; }
+
+	// Distance along the ray to where it enters the box, -1 if it misses within maxDist
+	static float GetRayEntryDistance( const AABB2& bounds, const Vec2& rayStart, const Vec2& rayInverseForward, float maxDist );
+	static Vec2 GetRayInverseForward( const Vec2& rayForwardNormal );
+	// Bit per lane of the rays that enter the box within their maxDist
+	static int GetRayPacketHitMask( const AABB2& bounds, const RayPacket& packet );
+
+private:
+	int BuildNode( int firstEntityIdx, int numEntities, int depth );
+	AABB2 GetBoundsOfEntities( int firstEntityIdx, int numEntities ) const;
+
+	static AABB2 GetEntityBounds( const Entity& entity );
+
+private:
+	std::vector<BVHNode>	m_nodes;
+	std::vector<EntityId>	m_entityIds;			// In leaf order
+	std::vector<AABB2>		m_entityBounds;			// Parallel with m_entityIds
+	std::vector<Vec2>		m_entityCenters;		// Parallel with m_entityIds, only used while building
+};
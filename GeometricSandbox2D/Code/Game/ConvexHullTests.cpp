@@ -0,0 +1,223 @@
+#include "Game/ConvexHullTests.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/ConvexHull2D.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Polygon2.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Time/Time.hpp"
+
+#include <vector>
+
+
+//-----------------------------------------------------------------------------------------------
+static bool IsPointInsidePlanes( const std::vector<Plane2D>& planes, const Vec2& point )
+{
+	for ( int planeIdx = 0; planeIdx < (int)planes.size(); ++planeIdx )
+	{
+		if ( planes[planeIdx].IsPointInFront( point ) )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// ConvexHull2D::GetRayIntersectionResult before it went SSE, kept to check the new version against
+static RayConvexHullIntersectionResult GetLegacyRayIntersectionResult( const std::vector<Plane2D>& planes, const Vec2& rayStartPos, const Vec2& rayForwardNormal )
+{
+	float entryPointDist = -9999999.f;
+	Vec2 furthestEntryPointAlongRay( rayStartPos );
+	Vec2 surfaceNormalOfIntersectionPlane = Vec2::ZERO;
+
+	for ( int planeIdx = 0; planeIdx < (int)planes.size(); ++planeIdx )
+	{
+		Plane2D const& boundingPlane = planes[planeIdx];
+		if ( DotProduct2D( rayForwardNormal, boundingPlane.normal ) > 0.f )
+		{
+			continue;
+		}
+
+		Vec2 intersectionPoint = GetRayIntersectionPointWithPlane2D( rayStartPos, rayForwardNormal, boundingPlane );
+		if ( IsNearlyEqual( intersectionPoint, rayStartPos ) )
+		{
+			continue;
+		}
+
+		if ( !IsPointInsidePlanes( planes, intersectionPoint + ( rayForwardNormal * .0001f ) ) )
+		{
+			continue;
+		}
+
+		float distToIntersectionPoint = GetDistanceSquared2D( rayStartPos, intersectionPoint );
+		if ( distToIntersectionPoint > entryPointDist )
+		{
+			entryPointDist = distToIntersectionPoint;
+			furthestEntryPointAlongRay = intersectionPoint;
+			surfaceNormalOfIntersectionPlane = boundingPlane.normal;
+		}
+	}
+
+	// Callers used to treat getting the start back as a miss
+	bool didImpact = !IsNearlyEqual( furthestEntryPointAlongRay, rayStartPos );
+	return RayConvexHullIntersectionResult( didImpact, GetDistance2D( rayStartPos, furthestEntryPointAlongRay ), furthestEntryPointAlongRay, surfaceNormalOfIntersectionPlane );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Rays passing this close to a corner can hit or miss depending on rounding
+static bool IsRaySkimmingCorner( const Polygon2& polygon, const Vec2& rayStartPos, const Vec2& rayForwardNormal )
+{
+	std::vector<Vec2> points = polygon.GetPoints();
+	for ( int pointIdx = 0; pointIdx < (int)points.size(); ++pointIdx )
+	{
+		Vec2 dispToPoint = points[pointIdx] - rayStartPos;
+		float distFromRay = dispToPoint.x * rayForwardNormal.y - dispToPoint.y * rayForwardNormal.x;
+		if ( DotProduct2D( dispToPoint, rayForwardNormal ) > 0.f
+			 && distFromRay < .001f
+			 && distFromRay > -.001f )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Same shape as the convex raycast map spawns, a ring of 3 to 12 points around the center
+static Polygon2 MakeRandomConvexPolygon( RandomNumberGenerator& rng, const Vec2& center, float radius )
+{
+	std::vector<Vec2> points;
+	float startDegrees = rng.RollRandomFloatInRange( 0.f, 360.f );
+	for ( int curDegrees = 0; curDegrees < 360; curDegrees += rng.RollRandomIntInRange( 30, 140 ) )
+	{
+		points.push_back( center + Vec2::MakeFromPolarDegrees( startDegrees + (float)curDegrees, radius ) );
+	}
+
+	return Polygon2( points );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void ConvexHullTests::RunTests()
+{
+	RandomNumberGenerator rng;
+	rng.Reset( 48 );
+
+	int numHits = 0;
+	for ( int hullNum = 0; hullNum < 250; ++hullNum )
+	{
+		Vec2 center( rng.RollRandomFloatInRange( 0.f, 16.f ), rng.RollRandomFloatInRange( 0.f, 9.f ) );
+		float radius = rng.RollRandomFloatInRange( .1f, 1.2f );
+		Polygon2 polygon = MakeRandomConvexPolygon( rng, center, radius );
+		if ( polygon.GetVertexCount() < 3 )
+		{
+			continue;
+		}
+
+		ConvexHull2D convexHull = polygon.GenerateConvexHull();
+		const std::vector<Plane2D>& planes = convexHull.GetBoundingPlanes();
+
+		for ( int rayNum = 0; rayNum < 200; ++rayNum )
+		{
+			Vec2 startPos = center + rng.RollRandomDirection2D() * rng.RollRandomFloatInRange( 0.f, radius * 4.f );
+			Vec2 forwardNormal = rng.RollRandomDirection2D();
+
+			RayConvexHullIntersectionResult result = convexHull.GetRayIntersectionResult( startPos, forwardNormal );
+
+			// Starts too close to an edge, or rays skimming a corner, are where the old version's fudge factors decide
+			if ( GetDistance2D( polygon.GetClosestPointOnEdge( startPos ), startPos ) < .001f
+				 || IsRaySkimmingCorner( polygon, startPos, forwardNormal ) )
+			{
+				continue;
+			}
+
+			if ( IsPointInsidePlanes( planes, startPos ) )
+			{
+				GUARANTEE_OR_DIE( result.didImpact && result.impactDist == 0.f, "Ray starting inside a convex hull must hit at its start" );
+				continue;
+			}
+
+			RayConvexHullIntersectionResult legacyResult = GetLegacyRayIntersectionResult( planes, startPos, forwardNormal );
+			GUARANTEE_OR_DIE( result.didImpact == legacyResult.didImpact, "Ray versus convex hull hit doesn't match the plane by plane version" );
+			if ( !result.didImpact )
+			{
+				continue;
+			}
+
+			++numHits;
+			GUARANTEE_OR_DIE( IsNearlyEqual( result.impactDist, GetDistance2D( startPos, result.intersectionPoint ), .001f ), "Ray versus convex hull impact distance doesn't reach the impact point" );
+			GUARANTEE_OR_DIE( IsNearlyEqual( result.intersectionPoint, legacyResult.intersectionPoint, .001f ), "Ray versus convex hull impact point doesn't match the plane by plane version" );
+			GUARANTEE_OR_DIE( DotProduct2D( result.surfaceNormal, forwardNormal ) <= 0.f, "Ray versus convex hull surface normal faces away from the ray" );
+		}
+
+		// Starting right on an edge used to be indistinguishable from a miss
+		Vec2 edgeStart;
+		Vec2 edgeEnd;
+		polygon.GetEdge( 0, &edgeStart, &edgeEnd );
+		Vec2 edgeMidpoint = ( edgeStart + edgeEnd ) * .5f;
+		RayConvexHullIntersectionResult edgeResult = convexHull.GetRayIntersectionResult( edgeMidpoint, ( center - edgeMidpoint ).GetNormalized() );
+		GUARANTEE_OR_DIE( edgeResult.didImpact && edgeResult.impactDist < .0001f, "Ray starting on a convex hull edge heading in must hit" );
+	}
+
+	GUARANTEE_OR_DIE( numHits > 0, "Ray versus convex hull tests never hit anything" );
+
+	g_devConsole->PrintString( Stringf( "Ray versus convex hull tests passed, %i hits match the plane by plane version", numHits ), Rgba8::GREEN );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void ConvexHullTests::RunBenchmark( int numHulls, int numRaysPerHull )
+{
+	RandomNumberGenerator rng;
+	rng.Reset( 48 );
+
+	std::vector<ConvexHull2D> convexHulls;
+	for ( int hullNum = 0; hullNum < numHulls; ++hullNum )
+	{
+		Vec2 center( rng.RollRandomFloatInRange( 0.f, 16.f ), rng.RollRandomFloatInRange( 0.f, 9.f ) );
+		convexHulls.push_back( MakeRandomConvexPolygon( rng, center, rng.RollRandomFloatInRange( .1f, 1.2f ) ).GenerateConvexHull() );
+	}
+
+	std::vector<Vec2> startPositions;
+	std::vector<Vec2> forwardNormals;
+	for ( int rayNum = 0; rayNum < numRaysPerHull; ++rayNum )
+	{
+		startPositions.push_back( Vec2( rng.RollRandomFloatInRange( 0.f, 16.f ), rng.RollRandomFloatInRange( 0.f, 9.f ) ) );
+		forwardNormals.push_back( rng.RollRandomDirection2D() );
+	}
+
+	int numLegacyHits = 0;
+	double timeBeforeLegacy = GetCurrentTimeSeconds();
+	for ( int hullIdx = 0; hullIdx < numHulls; ++hullIdx )
+	{
+		const std::vector<Plane2D>& planes = convexHulls[hullIdx].GetBoundingPlanes();
+		for ( int rayIdx = 0; rayIdx < numRaysPerHull; ++rayIdx )
+		{
+			numLegacyHits += GetLegacyRayIntersectionResult( planes, startPositions[rayIdx], forwardNormals[rayIdx] ).didImpact ? 1 : 0;
+		}
+	}
+	double legacySeconds = GetCurrentTimeSeconds() - timeBeforeLegacy;
+
+	int numHits = 0;
+	double timeBefore = GetCurrentTimeSeconds();
+	for ( int hullIdx = 0; hullIdx < numHulls; ++hullIdx )
+	{
+		for ( int rayIdx = 0; rayIdx < numRaysPerHull; ++rayIdx )
+		{
+			numHits += convexHulls[hullIdx].GetRayIntersectionResult( startPositions[rayIdx], forwardNormals[rayIdx] ).didImpact ? 1 : 0;
+		}
+	}
+	double seconds = GetCurrentTimeSeconds() - timeBefore;
+
+	// Hit counts differ by the rays starting inside a hull, the old version reported those as misses
+	double numRays = (double)numHulls * (double)numRaysPerHull;
+	g_devConsole->PrintString( Stringf( "Ray versus convex hull: plane by plane %.2f Mrays/s (%i hits), SSE %.2f Mrays/s (%i hits), %.1fx",
+										numRays / legacySeconds / 1000000.0, numLegacyHits, numRays / seconds / 1000000.0, numHits, legacySeconds / seconds ), Rgba8::GREEN );
+}
@@ -0,0 +1,8 @@
+#pragma once
+class ConvexHullTests
+{
+public:
+	// Compares the SSE ray versus hull test to the old plane by plane version on random hulls and rays
+	static void RunTests();
+	static void RunBenchmark( int numHulls, int numRaysPerHull );
+};
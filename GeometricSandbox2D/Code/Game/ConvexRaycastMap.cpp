@@ -14,14 +14,18 @@
 
 #include "Game/GameCommon.hpp"
 #include "Game/Game.hpp"
+#include "Game/BoundingVolumeHierarchy.hpp"
 #include "Game/SymmetricQuadTree.hpp"
 
+#include <algorithm>
+
 
 //-----------------------------------------------------------------------------------------------
 ConvexRaycastMap::ConvexRaycastMap( const std::string& name )
 	: Map( name )
 {
 	m_symmetricQuadTree = new SymmetricQuadTree( AABB2( 0.f, 0.f, g_windowWidth, g_windowHeight ), 3 );
+	m_boundingVolumeHierarchy = new BoundingVolumeHierarchy();
 
 	AddEntitySet( NUM_ENTITIES_PER_SET );
 }
@@ -31,6 +35,7 @@ ConvexRaycastMap::ConvexRaycastMap( const std::string& name )
 ConvexRaycastMap::~ConvexRaycastMap()
 {
 	PTR_SAFE_DELETE( m_symmetricQuadTree );
+	PTR_SAFE_DELETE( m_boundingVolumeHierarchy );
 }
 
 
@@ -39,6 +44,7 @@ void ConvexRaycastMap::Reset()
 {
 	m_draggedEntity = nullptr;
 	m_symmetricQuadTree->RemoveEntitiesAboveId( -1 );
+	m_isBVHStructureStale = true;
 	m_numActiveEntities = 0;
 	m_numTotalEntities = 0;
 	Map::Reset();
@@ -59,6 +65,11 @@ void ConvexRaycastMap::Update( float deltaSeconds )
 	UpdateVisibleRaycast();
 	UpdateInvisibleRaycasts();
 
+	if ( m_broadphaseCheckType == eBroadphaseCheckType::BVH )
+	{
+		UpdateBoundingVolumeHierarchy();
+	}
+
 	m_numRaycastImpacts = 0;
 	m_curRayNum = 0;
 	double timeBeforeRaycasts = GetCurrentTimeSeconds();
@@ -111,8 +122,16 @@ void ConvexRaycastMap::DebugRender() const
 		entity->DebugRender( vertices );
 	}
 
-	m_symmetricQuadTree->DebugRender( vertices );
-	m_symmetricQuadTree->DebugRenderRaycast( vertices, m_visibleRaycastStartPos, m_visibleRaycastForwardVector, m_visibleRaycastResult.maxDist );
+	if ( m_broadphaseCheckType == eBroadphaseCheckType::BVH )
+	{
+		m_boundingVolumeHierarchy->DebugRender( vertices );
+		m_boundingVolumeHierarchy->DebugRenderRaycast( vertices, m_visibleRaycastStartPos, m_visibleRaycastForwardVector, m_visibleRaycastResult.maxDist );
+	}
+	else
+	{
+		m_symmetricQuadTree->DebugRender( vertices );
+		m_symmetricQuadTree->DebugRenderRaycast( vertices, m_visibleRaycastStartPos, m_visibleRaycastForwardVector, m_visibleRaycastResult.maxDist );
+	}
 
 	g_renderer->BindDiffuseTexture( nullptr );
 	g_renderer->DrawVertexArray( vertices );
@@ -128,6 +147,7 @@ void ConvexRaycastMap::AddEntitySet( int numNewEntites )
 		// Add the new entities to the quad tree, add 1 since the constructor is max exclusive
 		std::vector<Entity*> entitiesToAddToQuadTree( &m_entities[m_numActiveEntities], &m_entities[m_numActiveEntities+ numNewEntites - 1] + 1 );
 		m_symmetricQuadTree->AddEntities( entitiesToAddToQuadTree );
+		m_isBVHStructureStale = true;
 
 		m_numActiveEntities += numNewEntites;
 
@@ -139,6 +159,7 @@ void ConvexRaycastMap::AddEntitySet( int numNewEntites )
 	// Add the new entities to the quad tree, add 1 since the constructor is max exclusive
 	std::vector<Entity*> entitiesToAddToQuadTree( &m_entities[m_numActiveEntities], &m_entities[m_numActiveEntities + numNewEntites - 1] + 1 );
 	m_symmetricQuadTree->AddEntities( entitiesToAddToQuadTree );
+	m_isBVHStructureStale = true;
 	
 	m_numActiveEntities += numNewEntites;
 
@@ -152,6 +173,8 @@ void ConvexRaycastMap::AddEntitySet( int numNewEntites )
 //-----------------------------------------------------------------------------------------------
 void ConvexRaycastMap::RemoveEntitySet( int numEntitesToRemove )
 {
+	m_isBVHStructureStale = true;
+
 	if ( m_numActiveEntities - numEntitesToRemove < 1 )
 	{
 		m_symmetricQuadTree->RemoveEntitiesAboveId( 0 );
@@ -231,6 +254,10 @@ RaycastResult ConvexRaycastMap::Raycast( const Vec2& startPos, const Vec2& forwa
 	{
 		return RaycastWithQuadTree( startPos, forwardNormal, maxDist );
 	}
+	else if ( m_broadphaseCheckType == eBroadphaseCheckType::BVH )
+	{
+		return RaycastWithBVH( startPos, forwardNormal, maxDist );
+	}
 
 	RaycastResult closestResult;
 	closestResult.startPos = startPos;
@@ -277,13 +304,12 @@ RaycastResult ConvexRaycastMap::Raycast( const Vec2& startPos, const Vec2& forwa
 		}
 
 		RayConvexHullIntersectionResult entityRaycastResult = entity->GetRayConvexHullIntersectionResult( startPos, forwardNormal );
-		// Returns start position if no intersection occurs
-		if ( IsNearlyEqual( entityRaycastResult.intersectionPoint, startPos ) )
+		if ( !entityRaycastResult.didImpact )
 		{
 			continue;
 		}
 
-		float impactDist = GetDistance2D( startPos, entityRaycastResult.intersectionPoint );
+		float impactDist = entityRaycastResult.impactDist;
 		if ( impactDist < closestResult.impactDist )
 		{
 			// We found an entity
@@ -359,13 +385,12 @@ RaycastResult ConvexRaycastMap::RaycastWithQuadTree( const Vec2& startPos, const
 		}
 
 		RayConvexHullIntersectionResult entityRaycastResult = entity->GetRayConvexHullIntersectionResult( startPos, forwardNormal );
-		// Returns start position if no intersection occurs
-		if ( IsNearlyEqual( entityRaycastResult.intersectionPoint, startPos ) )
+		if ( !entityRaycastResult.didImpact )
 		{
 			continue;
 		}
 
-		float impactDist = GetDistance2D( startPos, entityRaycastResult.intersectionPoint );
+		float impactDist = entityRaycastResult.impactDist;
 		if ( impactDist < closestResult.impactDist )
 		{
 			// We found an entity
@@ -387,6 +412,441 @@ RaycastResult ConvexRaycastMap::RaycastWithQuadTree( const Vec2& startPos, const
 }
 
 
+//-----------------------------------------------------------------------------------------------
+RaycastResult ConvexRaycastMap::RaycastWithBVH( const Vec2& startPos, const Vec2& forwardNormal, float maxDist )
+{
+	RaycastResult closestResult;
+	closestResult.startPos = startPos;
+	closestResult.forwardNormal = forwardNormal;
+	closestResult.maxDist = maxDist;
+	closestResult.impactDist = maxDist;
+	closestResult.impactPos = startPos + ( forwardNormal * maxDist );
+
+	if ( m_boundingVolumeHierarchy->IsEmpty() )
+	{
+		return closestResult;
+	}
+
+	Vec2 inverseForward = BoundingVolumeHierarchy::GetRayInverseForward( forwardNormal );
+	float rootEntryDist = BoundingVolumeHierarchy::GetRayEntryDistance( m_boundingVolumeHierarchy->GetNode( 0 ).bounds, startPos, inverseForward, maxDist );
+	if ( rootEntryDist < 0.f )
+	{
+		return closestResult;
+	}
+
+	// Nearer child is always visited first, the farther one waits on the stack with its entry distance
+	// so it can be skipped once something closer has been hit
+	int nodeStack[BVH_TRAVERSAL_STACK_SIZE];
+	float nodeEntryDistStack[BVH_TRAVERSAL_STACK_SIZE];
+	nodeStack[0] = 0;
+	nodeEntryDistStack[0] = rootEntryDist;
+	int stackSize = 1;
+
+	while ( stackSize > 0 )
+	{
+		--stackSize;
+		if ( nodeEntryDistStack[stackSize] > closestResult.impactDist )
+		{
+			continue;
+		}
+
+		int nodeIdx = nodeStack[stackSize];
+		const BVHNode& node = m_boundingVolumeHierarchy->GetNode( nodeIdx );
+		if ( node.IsLeaf() )
+		{
+			for ( int leafEntityIdx = node.secondChildOrFirstEntityIdx; leafEntityIdx < node.secondChildOrFirstEntityIdx + node.numEntities; ++leafEntityIdx )
+			{
+				Entity* const& entity = m_entities[m_boundingVolumeHierarchy->GetLeafEntityId( leafEntityIdx )];
+				if ( UpdateClosestImpactWithEntity( entity, closestResult ) )
+				{
+					++m_numRaycastImpacts;
+					return closestResult;
+				}
+			}
+
+			continue;
+		}
+
+		int nearChildIdx = nodeIdx + 1;
+		int farChildIdx = node.secondChildOrFirstEntityIdx;
+		float nearEntryDist = BoundingVolumeHierarchy::GetRayEntryDistance( m_boundingVolumeHierarchy->GetNode( nearChildIdx ).bounds, startPos, inverseForward, closestResult.impactDist );
+		float farEntryDist = BoundingVolumeHierarchy::GetRayEntryDistance( m_boundingVolumeHierarchy->GetNode( farChildIdx ).bounds, startPos, inverseForward, closestResult.impactDist );
+		if ( farEntryDist >= 0.f
+			 && ( nearEntryDist < 0.f || farEntryDist < nearEntryDist ) )
+		{
+			std::swap( nearChildIdx, farChildIdx );
+			std::swap( nearEntryDist, farEntryDist );
+		}
+
+		if ( farEntryDist >= 0.f )
+		{
+			nodeStack[stackSize] = farChildIdx;
+			nodeEntryDistStack[stackSize] = farEntryDist;
+			++stackSize;
+		}
+
+		if ( nearEntryDist >= 0.f )
+		{
+			nodeStack[stackSize] = nearChildIdx;
+			nodeEntryDistStack[stackSize] = nearEntryDist;
+			++stackSize;
+		}
+	}
+
+	if ( closestResult.didImpact )
+	{
+		++m_numRaycastImpacts;
+	}
+
+	return closestResult;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void ConvexRaycastMap::RaycastBatch( const Ray* rays, int numRays, RaycastResult* out_results )
+{
+	if ( m_broadphaseCheckType != eBroadphaseCheckType::BVH )
+	{
+		for ( int rayIdx = 0; rayIdx < numRays; ++rayIdx )
+		{
+			out_results[rayIdx] = Raycast( rays[rayIdx].startPos, rays[rayIdx].forwardNormal, rays[rayIdx].maxDist );
+		}
+
+		return;
+	}
+
+	// Packets only pay off when their rays visit the same nodes, so group rays heading into the same
+	// quadrant from nearby starts. The ray index rides in the low bits to recover the order afterwards.
+	m_batchRaySortKeys.resize( numRays );
+	for ( int rayIdx = 0; rayIdx < numRays; ++rayIdx )
+	{
+		const Ray& ray = rays[rayIdx];
+		uint64_t quadrant = ( ray.forwardNormal.x < 0.f ? 1 : 0 ) | ( ray.forwardNormal.y < 0.f ? 2 : 0 );
+		uint64_t cellX = (uint64_t)ClampMinMaxInt( (int)ray.startPos.x, 0, 255 );
+		uint64_t cellY = (uint64_t)ClampMinMaxInt( (int)ray.startPos.y, 0, 255 );
+
+		m_batchRaySortKeys[rayIdx] = ( ( ( quadrant << 16 ) | ( cellY << 8 ) | cellX ) << 32 ) | (uint64_t)rayIdx;
+	}
+
+	std::sort( m_batchRaySortKeys.begin(), m_batchRaySortKeys.end() );
+
+	for ( int firstKeyIdx = 0; firstKeyIdx < numRays; firstKeyIdx += RAY_PACKET_SIZE )
+	{
+		int packetRayIndices[RAY_PACKET_SIZE];
+		int numPacketRays = Min( RAY_PACKET_SIZE, numRays - firstKeyIdx );
+		for ( int laneIdx = 0; laneIdx < numPacketRays; ++laneIdx )
+		{
+			packetRayIndices[laneIdx] = (int)( m_batchRaySortKeys[firstKeyIdx + laneIdx] & 0xFFFFFFFF );
+		}
+
+		RaycastPacketWithBVH( rays, packetRayIndices, numPacketRays, out_results );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void ConvexRaycastMap::RaycastPacketWithBVH( const Ray* rays, const int* rayIndices, int numRays, RaycastResult* out_results )
+{
+	// Unused lanes get a negative max distance so they never hit a box
+	alignas( 16 ) float startXs[RAY_PACKET_SIZE] = {};
+	alignas( 16 ) float startYs[RAY_PACKET_SIZE] = {};
+	alignas( 16 ) float inverseForwardXs[RAY_PACKET_SIZE] = { 1.f, 1.f, 1.f, 1.f };
+	alignas( 16 ) float inverseForwardYs[RAY_PACKET_SIZE] = { 1.f, 1.f, 1.f, 1.f };
+	alignas( 16 ) float maxDists[RAY_PACKET_SIZE] = { -1.f, -1.f, -1.f, -1.f };
+
+	RaycastResult* laneResults[RAY_PACKET_SIZE] = {};
+	for ( int laneIdx = 0; laneIdx < numRays; ++laneIdx )
+	{
+		const Ray& ray = rays[rayIndices[laneIdx]];
+
+		laneResults[laneIdx] = &out_results[rayIndices[laneIdx]];
+		RaycastResult& result = *laneResults[laneIdx];
+		result = RaycastResult();
+		result.startPos = ray.startPos;
+		result.forwardNormal = ray.forwardNormal;
+		result.maxDist = ray.maxDist;
+		result.impactDist = ray.maxDist;
+		result.impactPos = ray.startPos + ( ray.forwardNormal * ray.maxDist );
+
+		Vec2 inverseForward = BoundingVolumeHierarchy::GetRayInverseForward( ray.forwardNormal );
+		startXs[laneIdx] = ray.startPos.x;
+		startYs[laneIdx] = ray.startPos.y;
+		inverseForwardXs[laneIdx] = inverseForward.x;
+		inverseForwardYs[laneIdx] = inverseForward.y;
+		maxDists[laneIdx] = ray.maxDist;
+	}
+
+	m_curRayNum += numRays;
+
+	if ( m_boundingVolumeHierarchy->IsEmpty() )
+	{
+		return;
+	}
+
+	RayPacket packet;
+	packet.startX = _mm_load_ps( startXs );
+	packet.startY = _mm_load_ps( startYs );
+	packet.inverseForwardX = _mm_load_ps( inverseForwardXs );
+	packet.inverseForwardY = _mm_load_ps( inverseForwardYs );
+	packet.maxDist = _mm_load_ps( maxDists );
+
+	// Boxes are tested when popped against every lane's closest hit so far, so a node is skipped
+	// as soon as no lane could still find something closer in it
+	int nodeStack[BVH_TRAVERSAL_STACK_SIZE];
+	nodeStack[0] = 0;
+	int stackSize = 1;
+
+	while ( stackSize > 0 )
+	{
+		--stackSize;
+		int nodeIdx = nodeStack[stackSize];
+		const BVHNode& node = m_boundingVolumeHierarchy->GetNode( nodeIdx );
+
+		int laneHitMask = BoundingVolumeHierarchy::GetRayPacketHitMask( node.bounds, packet );
+		if ( laneHitMask == 0 )
+		{
+			continue;
+		}
+
+		if ( node.IsLeaf() )
+		{
+			for ( int laneIdx = 0; laneIdx < numRays; ++laneIdx )
+			{
+				if ( ( laneHitMask & ( 1 << laneIdx ) ) == 0 )
+				{
+					continue;
+				}
+
+				RaycastResult& result = *laneResults[laneIdx];
+				for ( int leafEntityIdx = node.secondChildOrFirstEntityIdx; leafEntityIdx < node.secondChildOrFirstEntityIdx + node.numEntities; ++leafEntityIdx )
+				{
+					Entity* const& entity = m_entities[m_boundingVolumeHierarchy->GetLeafEntityId( leafEntityIdx )];
+					if ( UpdateClosestImpactWithEntity( entity, result ) )
+					{
+						// Started inside, nothing can be closer so retire the lane
+						result.impactDist = -1.f;
+						break;
+					}
+				}
+
+				maxDists[laneIdx] = result.impactDist;
+				if ( result.impactDist < 0.f )
+				{
+					result.impactDist = 0.f;
+				}
+			}
+
+			packet.maxDist = _mm_load_ps( maxDists );
+			continue;
+		}
+
+		// Order the children for the first lane still hitting, rays in a packet mostly head the same way
+		int leadLaneIdx = 0;
+		while ( ( laneHitMask & ( 1 << leadLaneIdx ) ) == 0 )
+		{
+			++leadLaneIdx;
+		}
+
+		float leadInverseForward = node.splitAxis == 0 ? inverseForwardXs[leadLaneIdx] : inverseForwardYs[leadLaneIdx];
+		int nearChildIdx = nodeIdx + 1;
+		int farChildIdx = node.secondChildOrFirstEntityIdx;
+		if ( leadInverseForward < 0.f )
+		{
+			std::swap( nearChildIdx, farChildIdx );
+		}
+
+		nodeStack[stackSize++] = farChildIdx;
+		nodeStack[stackSize++] = nearChildIdx;
+	}
+
+	for ( int laneIdx = 0; laneIdx < numRays; ++laneIdx )
+	{
+		if ( laneResults[laneIdx]->didImpact )
+		{
+			++m_numRaycastImpacts;
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the ray starts inside the entity, nothing can be closer than that
+bool ConvexRaycastMap::UpdateClosestImpactWithEntity( Entity* entity, RaycastResult& closestResult )
+{
+	entity->SetLastRayCollisionDetectedNum( m_curRayNum );
+	entity->MarkAsCollisionTested();
+
+	const Vec2& startPos = closestResult.startPos;
+	const Vec2& forwardNormal = closestResult.forwardNormal;
+
+	if ( entity->IsPositionInside( startPos ) )
+	{
+		closestResult.didImpact = true;
+		closestResult.impactDist = 0.f;
+		closestResult.impactEntity = entity;
+		closestResult.impactFraction = 0.f;
+		closestResult.impactPos = startPos;
+		closestResult.impactSurfaceNormal = -forwardNormal;
+
+		return true;
+	}
+
+	// Check narrow phase
+	if ( m_narrowphaseCheckType == eNarrowphaseCheckType::BOUNDING_DISC )
+	{
+		if ( !DoLineSegmentAndDiscOverlap2D( startPos, forwardNormal, closestResult.maxDist, entity->GetPosition(), entity->GetPhysicsRadius() ) )
+		{
+			return false;
+		}
+	}
+
+	RayConvexHullIntersectionResult entityRaycastResult = entity->GetRayConvexHullIntersectionResult( startPos, forwardNormal );
+	if ( !entityRaycastResult.didImpact )
+	{
+		return false;
+	}
+
+	float impactDist = entityRaycastResult.impactDist;
+	if ( impactDist < closestResult.impactDist )
+	{
+		closestResult.didImpact = true;
+		closestResult.impactDist = impactDist;
+		closestResult.impactEntity = entity;
+		closestResult.impactFraction = impactDist / closestResult.maxDist;
+		closestResult.impactPos = entityRaycastResult.intersectionPoint;
+		closestResult.impactSurfaceNormal = entityRaycastResult.surfaceNormal;
+	}
+
+	return false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void ConvexRaycastMap::UpdateBoundingVolumeHierarchy()
+{
+	if ( m_isBVHStructureStale )
+	{
+		m_boundingVolumeHierarchy->Build( m_entities, m_numActiveEntities );
+		m_isBVHStructureStale = false;
+		m_areBVHBoundsStale = false;
+		return;
+	}
+
+	if ( m_areBVHBoundsStale )
+	{
+		m_boundingVolumeHierarchy->Refit( m_entities );
+		m_areBVHBoundsStale = false;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void ConvexRaycastMap::SetNumActiveEntities( int numActiveEntities )
+{
+	if ( numActiveEntities > m_numActiveEntities )
+	{
+		AddEntitySet( numActiveEntities - m_numActiveEntities );
+	}
+	else if ( numActiveEntities < m_numActiveEntities )
+	{
+		RemoveEntitySet( m_numActiveEntities - numActiveEntities );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void ConvexRaycastMap::RunBroadphaseBenchmark( int maxEntities, int numRays, int numIterations )
+{
+	constexpr int NUM_BENCHMARK_MODES = 4;
+	const eBroadphaseCheckType modeBroadphaseTypes[NUM_BENCHMARK_MODES] = { eBroadphaseCheckType::NONE, eBroadphaseCheckType::QUAD_TREE, eBroadphaseCheckType::BVH, eBroadphaseCheckType::BVH };
+	const bool isModeBatched[NUM_BENCHMARK_MODES] = { false, false, false, true };
+
+	int originalNumActiveEntities = m_numActiveEntities;
+	eBroadphaseCheckType originalBroadphaseCheckType = m_broadphaseCheckType;
+
+	// Same rays for every scene, rolled the same way as UpdateInvisibleRaycasts
+	RandomNumberGenerator rng;
+	rng.Reset( 47 );
+
+	std::vector<Ray> rays( numRays );
+	for ( int rayIdx = 0; rayIdx < numRays; ++rayIdx )
+	{
+		rays[rayIdx].startPos = Vec2( rng.RollRandomFloatInRange( 0.f, g_windowWidth ), rng.RollRandomFloatInRange( 0.f, g_windowHeight ) );
+		rays[rayIdx].forwardNormal = Vec2( 1.f, 0.f ).GetRotatedDegrees( rng.RollRandomFloatInRange( 0.f, 360.f ) );
+		rays[rayIdx].maxDist = rng.RollRandomFloatInRange( 1.f, 10.f );
+	}
+
+	std::vector<RaycastResult> expectedResults( numRays );
+	std::vector<RaycastResult> results( numRays );
+
+	g_devConsole->PrintString( Stringf( "Broadphase benchmark: %i rays, average ms of %i iterations", numRays, numIterations ), Rgba8::GREEN );
+
+	int totalMismatches = 0;
+	for ( int numEntities = 8; numEntities <= maxEntities; numEntities *= 2 )
+	{
+		SetNumActiveEntities( numEntities );
+
+		double timeBeforeBuild = GetCurrentTimeSeconds();
+		UpdateBoundingVolumeHierarchy();
+		double buildMs = ( GetCurrentTimeSeconds() - timeBeforeBuild ) * 1000.0;
+
+		double modeMs[NUM_BENCHMARK_MODES] = {};
+		int modeMismatches[NUM_BENCHMARK_MODES] = {};
+		for ( int modeIdx = 0; modeIdx < NUM_BENCHMARK_MODES; ++modeIdx )
+		{
+			m_broadphaseCheckType = modeBroadphaseTypes[modeIdx];
+			std::vector<RaycastResult>& modeResults = modeIdx == 0 ? expectedResults : results;
+
+			double timeBeforeRaycasts = GetCurrentTimeSeconds();
+			for ( int iterationNum = 0; iterationNum < numIterations; ++iterationNum )
+			{
+				if ( isModeBatched[modeIdx] )
+				{
+					RaycastBatch( rays.data(), numRays, modeResults.data() );
+					continue;
+				}
+
+				for ( int rayIdx = 0; rayIdx < numRays; ++rayIdx )
+				{
+					modeResults[rayIdx] = Raycast( rays[rayIdx].startPos, rays[rayIdx].forwardNormal, rays[rayIdx].maxDist );
+				}
+			}
+
+			modeMs[modeIdx] = ( GetCurrentTimeSeconds() - timeBeforeRaycasts ) * 1000.0 / (double)numIterations;
+
+			if ( modeIdx == 0 )
+			{
+				continue;
+			}
+
+			for ( int rayIdx = 0; rayIdx < numRays; ++rayIdx )
+			{
+				if ( modeResults[rayIdx].didImpact != expectedResults[rayIdx].didImpact
+					 || !IsNearlyEqual( modeResults[rayIdx].impactDist, expectedResults[rayIdx].impactDist, .001f ) )
+				{
+					++modeMismatches[modeIdx];
+				}
+			}
+
+			totalMismatches += modeMismatches[modeIdx];
+		}
+
+		int numMismatches = modeMismatches[1] + modeMismatches[2] + modeMismatches[3];
+		g_devConsole->PrintString( Stringf( "%5i entities: none %8.3f, quad tree %8.3f, bvh %8.3f, bvh batch %8.3f, bvh build %.3f, mismatches %i/%i/%i",
+											numEntities, modeMs[0], modeMs[1], modeMs[2], modeMs[3], buildMs, modeMismatches[1], modeMismatches[2], modeMismatches[3] ),
+								   numMismatches == 0 ? Rgba8::GREEN : Rgba8::RED );
+	}
+
+	SetNumActiveEntities( originalNumActiveEntities );
+	m_broadphaseCheckType = originalBroadphaseCheckType;
+
+	if ( totalMismatches > 0 )
+	{
+		g_devConsole->PrintError( Stringf( "Broadphase benchmark found %i raycasts that differ from brute force", totalMismatches ) );
+	}
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void ConvexRaycastMap::UpdateFromKeyboard( float deltaSeconds )
 {
@@ -409,6 +869,9 @@ void ConvexRaycastMap::UpdateFromKeyboard( float deltaSeconds )
 		if ( m_draggedEntity != nullptr )
 		{
 			m_symmetricQuadTree->AddEntity( m_draggedEntity );
+
+			// Refitting while dragging can leave big overlapping boxes, rebuild once it lands
+			m_isBVHStructureStale = true;
 		}
 
 		m_draggedEntity = nullptr;
@@ -442,6 +905,7 @@ void ConvexRaycastMap::UpdateFromKeyboard( float deltaSeconds )
 
 		entityToRotate->RotateAboutPoint2D( -180.f * deltaSeconds, g_game->GetMouseWorldPosition() );
 		m_symmetricQuadTree->RemoveEntity( entityToRotate->GetId() );
+		m_areBVHBoundsStale = true;
 
 		if ( m_draggedEntity == nullptr )
 		{
@@ -463,6 +927,7 @@ void ConvexRaycastMap::UpdateFromKeyboard( float deltaSeconds )
 
 		entityToRotate->RotateAboutPoint2D( 180.f * deltaSeconds, g_game->GetMouseWorldPosition() );
 		m_symmetricQuadTree->RemoveEntity( entityToRotate->GetId() );
+		m_areBVHBoundsStale = true;
 
 		if ( m_draggedEntity == nullptr )
 		{
@@ -485,6 +950,7 @@ void ConvexRaycastMap::UpdateFromKeyboard( float deltaSeconds )
 
 		entityToScale->ScaleAboutPoint2D( 1.f + .25f * deltaSeconds, g_game->GetMouseWorldPosition() );
 		m_symmetricQuadTree->RemoveEntity( entityToScale->GetId() );
+		m_areBVHBoundsStale = true;
 		
 		if ( m_draggedEntity == nullptr )
 		{
@@ -506,6 +972,7 @@ void ConvexRaycastMap::UpdateFromKeyboard( float deltaSeconds )
 
 		entityToScale->ScaleAboutPoint2D( 1.f - .25f * deltaSeconds, g_game->GetMouseWorldPosition() );
 		m_symmetricQuadTree->RemoveEntity( entityToScale->GetId() );
+		m_areBVHBoundsStale = true;
 		
 		if ( m_draggedEntity == nullptr )
 		{
@@ -593,6 +1060,7 @@ void ConvexRaycastMap::UpdateDraggedEntity()
 	if ( m_draggedEntity != nullptr )
 	{
 		m_draggedEntity->UpdatePosition( g_game->GetMouseWorldPosition() + m_mouseOffsetFromCenterOfDraggedEntity );
+		m_areBVHBoundsStale = true;
 	}
 }
 
@@ -660,6 +1128,19 @@ void ConvexRaycastMap::UpdateInvisibleRaycasts()
 //-----------------------------------------------------------------------------------------------
 void ConvexRaycastMap::PerformInvisibleRaycasts()
 {
+	if ( m_broadphaseCheckType == eBroadphaseCheckType::BVH )
+	{
+		m_invisibleRayResults.resize( m_invisibleRays.size() );
+		RaycastBatch( m_invisibleRays.data(), (int)m_invisibleRays.size(), m_invisibleRayResults.data() );
+
+		for ( int raycastIdx = 0; raycastIdx < (int)m_invisibleRayResults.size(); ++raycastIdx )
+		{
+			m_dummyVal = m_invisibleRayResults[raycastIdx].impactDist;
+		}
+
+		return;
+	}
+
 	for ( int raycastIdx = 0; raycastIdx < (int)m_invisibleRays.size(); ++raycastIdx )
 	{
 		RaycastResult result =  Raycast( m_invisibleRays[raycastIdx].startPos, m_invisibleRays[raycastIdx].forwardNormal, m_invisibleRays[raycastIdx].maxDist );
@@ -1147,6 +1628,7 @@ bool ConvexRaycastMap::ReadConvexPolysChunk( BufferParser& bufferParser )
 	// Reload entities from chunk
 	m_symmetricQuadTree->RemoveEntitiesAboveId( -1 );
 	m_symmetricQuadTree->AddEntities( chunkEntities );
+	m_isBVHStructureStale = true;
 
 	PTR_VECTOR_SAFE_DELETE( m_entities );
 
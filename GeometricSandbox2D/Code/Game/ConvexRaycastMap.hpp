@@ -5,6 +5,7 @@
 //-----------------------------------------------------------------------------------------------
 class BufferParser;
 class BufferWriter;
+class BoundingVolumeHierarchy;
 class SymmetricQuadTree;
 
 
@@ -39,6 +40,13 @@ public:
 	void SaveConvexSceneToFile( const std::string& fileName );
 	void LoadConvexSceneFromFile( const std::string& fileName );
 
+	// Raycasts in packets of RAY_PACKET_SIZE through the BVH, other broadphase types fall back to one ray at a time
+	void RaycastBatch( const Ray* rays, int numRays, RaycastResult* out_results );
+
+	// Times the invisible raycast workload for every broadphase type, doubling the active entities from 8 up to maxEntities.
+	// Results are checked against the brute force raycast, then the map is put back how it was.
+	void RunBroadphaseBenchmark( int maxEntities, int numRays, int numIterations );
+
 private:
 	void UpdateFromKeyboard( float deltaSeconds );
 	void UpdateHighlightedEntity();
@@ -60,6 +68,12 @@ private:
 
 	virtual RaycastResult Raycast( const Vec2& startPos, const Vec2& forwardNormal, float maxDist ) override;
 	RaycastResult RaycastWithQuadTree( const Vec2& startPos, const Vec2& forwardNormal, float maxDist );
+	RaycastResult RaycastWithBVH( const Vec2& startPos, const Vec2& forwardNormal, float maxDist );
+	void RaycastPacketWithBVH( const Ray* rays, const int* rayIndices, int numRays, RaycastResult* out_results );
+	bool UpdateClosestImpactWithEntity( Entity* entity, RaycastResult& closestResult );
+
+	void UpdateBoundingVolumeHierarchy();
+	void SetNumActiveEntities( int numActiveEntities );
 
 	// File save/load
 	bool WriteFileHeaderToBuffer( BufferWriter& bufferWriter );
@@ -96,5 +110,11 @@ private:
 
 	SymmetricQuadTree* m_symmetricQuadTree;
 
+	BoundingVolumeHierarchy* m_boundingVolumeHierarchy = nullptr;
+	bool m_isBVHStructureStale = true;				// Entities were added or removed, rebuild
+	bool m_areBVHBoundsStale = false;				// Entities moved, rotated or scaled, refit
+
 	std::vector<Ray> m_invisibleRays;
+	std::vector<RaycastResult> m_invisibleRayResults;
+	std::vector<uint64_t> m_batchRaySortKeys;		// Reused by RaycastBatch
 };
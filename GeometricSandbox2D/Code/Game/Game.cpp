@@ -27,6 +27,7 @@
 #include "Game/Entity.hpp"
 #include "Game/World.hpp"
 #include "Game/BufferTests.hpp"
+#include "Game/ConvexHullTests.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
@@ -81,6 +82,8 @@ void Game::Startup()
 
 	g_eventSystem->RegisterMethodEvent( "save_ghcs_file", "Usage: save_ghcs_file name=<name of file relative to Run/Data> Save the current convex scene as a .ghcs file.", eUsageLocation::EVERYWHERE, this, &Game::SaveConvexSceneToFile );
 	g_eventSystem->RegisterMethodEvent( "load_ghcs_file", "Usage: load_ghcs_file name=<name of file relative to Run/Data> Load a convex scene from a .ghcs file. ", eUsageLocation::EVERYWHERE, this, &Game::LoadConvexSceneFromFile );
+	g_eventSystem->RegisterMethodEvent( "benchmark_convex_hull", "Usage: benchmark_convex_hull numHulls=256 numRaysPerHull=4096 Check the ray versus convex hull test against the old plane by plane version on seeded rays, then time both.", eUsageLocation::DEV_CONSOLE, this, &Game::RunConvexHullBenchmark );
+	g_eventSystem->RegisterMethodEvent( "benchmark_broadphase", "Usage: benchmark_broadphase maxEntities=8192 numRays=1024 numIterations=4 Time raycasts for each broadphase type with 8 up to maxEntities convex objects.", eUsageLocation::DEV_CONSOLE, this, &Game::RunBroadphaseBenchmark );
 
 	g_devConsole->PrintString( "Game Started", Rgba8::GREEN );
 }
@@ -515,3 +518,38 @@ void Game::LoadConvexSceneFromFile( EventArgs* args )
 
 	m_world->LoadConvexSceneFromFile( fileName );
 }
+
+
+//-----------------------------------------------------------------------------------------------
+void Game::RunBroadphaseBenchmark( EventArgs* args )
+{
+	int maxEntities = args->GetValue( "maxEntities", 8192 );
+	int numRays = args->GetValue( "numRays", 1024 );
+	int numIterations = args->GetValue( "numIterations", 4 );
+	if ( maxEntities < 8
+		 || numRays < 1
+		 || numIterations < 1 )
+	{
+		g_devConsole->PrintError( "maxEntities must be at least 8, numRays and numIterations at least 1" );
+		return;
+	}
+
+	m_world->RunBroadphaseBenchmark( maxEntities, numRays, numIterations );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Game::RunConvexHullBenchmark( EventArgs* args )
+{
+	int numHulls = args->GetValue( "numHulls", 256 );
+	int numRaysPerHull = args->GetValue( "numRaysPerHull", 4096 );
+	if ( numHulls < 1
+		 || numRaysPerHull < 1 )
+	{
+		g_devConsole->PrintError( "numHulls and numRaysPerHull must be at least 1" );
+		return;
+	}
+
+	ConvexHullTests::RunTests();
+	ConvexHullTests::RunBenchmark( numHulls, numRaysPerHull );
+}
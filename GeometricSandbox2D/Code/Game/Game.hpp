@@ -62,6 +62,8 @@ public:
 	// Commands
 	void SaveConvexSceneToFile( EventArgs* args );
 	void LoadConvexSceneFromFile( EventArgs* args );
+	void RunBroadphaseBenchmark( EventArgs* args );
+	void RunConvexHullBenchmark( EventArgs* args );
 
 public:
 	RandomNumberGenerator* m_rng = nullptr;
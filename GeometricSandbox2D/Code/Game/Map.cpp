@@ -140,7 +140,8 @@ void Map::CycleBroadphaseCheck()
 	switch ( m_broadphaseCheckType )
 	{
 		case eBroadphaseCheckType::NONE: m_broadphaseCheckType = eBroadphaseCheckType::QUAD_TREE; return;
-		case eBroadphaseCheckType::QUAD_TREE: m_broadphaseCheckType = eBroadphaseCheckType::NONE; return;
+		case eBroadphaseCheckType::QUAD_TREE: m_broadphaseCheckType = eBroadphaseCheckType::BVH; return;
+		case eBroadphaseCheckType::BVH: m_broadphaseCheckType = eBroadphaseCheckType::NONE; return;
 	}
 }
 
@@ -163,6 +164,7 @@ std::string Map::GetBroadphaseCheckTypeStr() const
 	{
 		case eBroadphaseCheckType::NONE: return "None";;
 		case eBroadphaseCheckType::QUAD_TREE: return "Quad Tree";
+		case eBroadphaseCheckType::BVH: return "BVH";
 	}
 
 	return "None";
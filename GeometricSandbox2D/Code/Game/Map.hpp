@@ -14,7 +14,8 @@ class Polygon2;
 enum class eBroadphaseCheckType
 {
 	NONE,
-	QUAD_TREE
+	QUAD_TREE,
+	BVH
 };
 
 
@@ -240,3 +240,16 @@ void World::LoadConvexSceneFromFile( const std::string& fileName )
 
 	( (ConvexRaycastMap*)m_curMap )->LoadConvexSceneFromFile( fileName );
 }
+
+
+//-----------------------------------------------------------------------------------------------
+void World::RunBroadphaseBenchmark( int maxEntities, int numRays, int numIterations )
+{
+	if ( m_curMap->GetName() != "ConvexRaycast" )
+	{
+		g_devConsole->PrintError( Stringf( "Cannot run broadphase benchmark on map of type: '%s'", m_curMap->GetName().c_str() ) );
+		return;
+	}
+
+	( (ConvexRaycastMap*)m_curMap )->RunBroadphaseBenchmark( maxEntities, numRays, numIterations );
+}
@@ -48,6 +48,7 @@ public:
 
 	void SaveConvexSceneToFile( const std::string& fileName );
 	void LoadConvexSceneFromFile( const std::string& fileName );
+	void RunBroadphaseBenchmark( int maxEntities, int numRays, int numIterations );
 
 private:
 	Map* GetLoadedMapByName( const std::string& mapName );
@@ -18,6 +18,9 @@
 #include "Engine/Time/Clock.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/Game.hpp"
+#include "Game/FlowFieldTest.hpp"
+#include "Game/MapGenerationTest.hpp"
+#include "Game/MapRaycastTest.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
@@ -75,6 +78,10 @@ void App::Startup()
 	g_game->Startup();
 
 	g_eventSystem->RegisterEvent( "Quit", "Quit the game.", eUsageLocation::EVERYWHERE, QuitGame );
+	g_eventSystem->RegisterEvent( "test_map_generation", "Generate seeded maps and check them against the old generator. numSeeds=1000 firstSeed=0", eUsageLocation::DEV_CONSOLE, MapGenerationTest::RunMapGenerationTest );
+	g_eventSystem->RegisterEvent( "test_raycast", "Check raycasts against the old fixed step marching. numRays=100000 seed=0", eUsageLocation::DEV_CONSOLE, MapRaycastTest::RunRaycastTest );
+	g_eventSystem->RegisterEvent( "benchmark_raycast", "Time NPC tank raycasts against the old fixed step marching. numTanks=128 numFrames=600 seed=0", eUsageLocation::DEV_CONSOLE, MapRaycastTest::RunRaycastBenchmark );
+	g_eventSystem->RegisterEvent( "test_flow_field", "Check that flow fields lead to their goal from every reachable tile. numSeeds=100 numGoalsPerMap=8 firstSeed=0", eUsageLocation::DEV_CONSOLE, FlowFieldTest::RunFlowFieldTest );
 }
 
 
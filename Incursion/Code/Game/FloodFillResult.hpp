@@ -7,6 +7,6 @@ struct FloodFillResult
 {
 public:
 	bool				m_isExitReachable = false;
-	std::vector<bool>	m_tilesProcessed;
 	std::vector<bool>	m_tilesReachable;
+	std::vector<int>	m_tileDistances;		// Steps from the start tile, -1 if unreachable
 };
@@ -0,0 +1,208 @@
+#include "Game/FlowField.hpp"
+#include "Game/GameCommon.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+// Orthogonal steps first so ties in the breadth first search settle on straight lines
+static const IntVec2 s_stepDirections[8] = { IntVec2( 0, 1 ), IntVec2( 1, 0 ), IntVec2( 0, -1 ), IntVec2( -1, 0 ),
+											 IntVec2( 1, 1 ), IntVec2( 1, -1 ), IntVec2( -1, -1 ), IntVec2( -1, 1 ) };
+
+
+//-----------------------------------------------------------------------------------------------
+void FlowField::Initialize( const IntVec2& dimensions, const std::vector<bool>& tilesSolid )
+{
+	m_dimensions = dimensions;
+	m_tilesSolid = tilesSolid;
+	m_goalTileIndex = -1;
+
+	int numTiles = dimensions.x * dimensions.y;
+	m_tileDistances.assign( numTiles, -1 );
+	m_nextTileIndices.assign( numTiles, -1 );
+	m_openTileIndices.reserve( numTiles );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool FlowField::SetGoalTile( const IntVec2& goalTileCoords )
+{
+	int goalTileIndex = GetTileIndexFromCoords( goalTileCoords );
+	if ( goalTileIndex == m_goalTileIndex )
+	{
+		return false;
+	}
+
+	m_goalTileIndex = goalTileIndex;
+	Rebuild();
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void FlowField::ClearGoal()
+{
+	m_goalTileIndex = -1;
+	m_tileDistances.assign( m_tileDistances.size(), -1 );
+	m_nextTileIndices.assign( m_nextTileIndices.size(), -1 );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int FlowField::GetDistanceToGoal( const IntVec2& tileCoords ) const
+{
+	int tileIndex = GetTileIndexFromCoords( tileCoords );
+	if ( tileIndex == -1 )
+	{
+		return -1;
+	}
+
+	return m_tileDistances[tileIndex];
+}
+
+
+//-----------------------------------------------------------------------------------------------
+IntVec2 FlowField::GetNextTileCoords( const IntVec2& tileCoords ) const
+{
+	int tileIndex = GetTileIndexFromCoords( tileCoords );
+	if ( tileIndex == -1
+		 || m_nextTileIndices[tileIndex] == -1 )
+	{
+		return tileCoords;
+	}
+
+	return GetTileCoordsFromIndex( m_nextTileIndices[tileIndex] );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+Vec2 FlowField::GetSteeringDirection( const Vec2& position ) const
+{
+	int tileIndex = GetTileIndexFromCoords( IntVec2( (int)position.x, (int)position.y ) );
+	if ( tileIndex == -1
+		 || m_nextTileIndices[tileIndex] == -1 )
+	{
+		return Vec2::ZERO;
+	}
+
+	IntVec2 nextTileCoords = GetTileCoordsFromIndex( m_nextTileIndices[tileIndex] );
+	Vec2 nextTileCenter( ( (float)nextTileCoords.x + .5f ) * TILE_SIZE, ( (float)nextTileCoords.y + .5f ) * TILE_SIZE );
+	return ( nextTileCenter - position ).GetNormalized();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Breadth first out from the goal, then every tile picks the neighbor one step closer that lies
+// nearest the straight line to the goal
+void FlowField::Rebuild()
+{
+	++m_numRebuilds;
+	m_tileDistances.assign( m_tileDistances.size(), -1 );
+	m_nextTileIndices.assign( m_nextTileIndices.size(), -1 );
+
+	if ( m_goalTileIndex == -1
+		 || m_tilesSolid[m_goalTileIndex] )
+	{
+		return;
+	}
+
+	m_openTileIndices.clear();
+	m_openTileIndices.push_back( m_goalTileIndex );
+	m_tileDistances[m_goalTileIndex] = 0;
+
+	for ( int openIndex = 0; openIndex < (int)m_openTileIndices.size(); ++openIndex )
+	{
+		int tileIndex = m_openTileIndices[openIndex];
+		IntVec2 tileCoords = GetTileCoordsFromIndex( tileIndex );
+
+		for ( int stepIndex = 0; stepIndex < 8; ++stepIndex )
+		{
+			// Steps are symmetric, so a tile that can step here can be reached from here
+			if ( !CanStep( tileIndex, s_stepDirections[stepIndex] ) )
+			{
+				continue;
+			}
+
+			int neighborIndex = GetTileIndexFromCoords( tileCoords + s_stepDirections[stepIndex] );
+			if ( m_tileDistances[neighborIndex] != -1 )
+			{
+				continue;
+			}
+
+			m_tileDistances[neighborIndex] = m_tileDistances[tileIndex] + 1;
+			m_openTileIndices.push_back( neighborIndex );
+		}
+	}
+
+	IntVec2 goalTileCoords = GetTileCoordsFromIndex( m_goalTileIndex );
+	for ( int openIndex = 1; openIndex < (int)m_openTileIndices.size(); ++openIndex )
+	{
+		int tileIndex = m_openTileIndices[openIndex];
+		IntVec2 tileCoords = GetTileCoordsFromIndex( tileIndex );
+
+		int bestNeighborIndex = -1;
+		int bestNeighborDistanceSquared = 0;
+		for ( int stepIndex = 0; stepIndex < 8; ++stepIndex )
+		{
+			if ( !CanStep( tileIndex, s_stepDirections[stepIndex] ) )
+			{
+				continue;
+			}
+
+			IntVec2 neighborCoords = tileCoords + s_stepDirections[stepIndex];
+			int neighborIndex = GetTileIndexFromCoords( neighborCoords );
+			if ( m_tileDistances[neighborIndex] != m_tileDistances[tileIndex] - 1 )
+			{
+				continue;
+			}
+
+			int neighborDistanceSquared = ( goalTileCoords - neighborCoords ).GetLengthSquared();
+			if ( bestNeighborIndex == -1
+				 || neighborDistanceSquared < bestNeighborDistanceSquared )
+			{
+				bestNeighborIndex = neighborIndex;
+				bestNeighborDistanceSquared = neighborDistanceSquared;
+			}
+		}
+
+		m_nextTileIndices[tileIndex] = bestNeighborIndex;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool FlowField::CanStep( int tileIndex, const IntVec2& step ) const
+{
+	IntVec2 tileCoords = GetTileCoordsFromIndex( tileIndex );
+	int destinationIndex = GetTileIndexFromCoords( tileCoords + step );
+	if ( destinationIndex == -1
+		 || m_tilesSolid[destinationIndex] )
+	{
+		return false;
+	}
+
+	if ( step.x == 0
+		 || step.y == 0 )
+	{
+		return true;
+	}
+
+	// Diagonals need both tiles they pass between open, or a tank would clip the corner
+	int horizontalIndex = GetTileIndexFromCoords( tileCoords + IntVec2( step.x, 0 ) );
+	int verticalIndex = GetTileIndexFromCoords( tileCoords + IntVec2( 0, step.y ) );
+	return !m_tilesSolid[horizontalIndex]
+		&& !m_tilesSolid[verticalIndex];
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int FlowField::GetTileIndexFromCoords( const IntVec2& tileCoords ) const
+{
+	if ( tileCoords.x < 0
+		 || tileCoords.x > m_dimensions.x - 1
+		 || tileCoords.y < 0
+		 || tileCoords.y > m_dimensions.y - 1 )
+	{
+		return -1;
+	}
+
+	return tileCoords.x + tileCoords.y * m_dimensions.x;
+}
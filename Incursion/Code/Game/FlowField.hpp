@@ -0,0 +1,46 @@
+#pragma once
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+
+#include <vector>
+
+
+//-----------------------------------------------------------------------------------------------
+// Steps from every tile to one goal tile, shared by everything heading for that goal. Moves can be
+// diagonal but never cut the corner of a solid tile.
+class FlowField
+{
+public:
+	void			Initialize( const IntVec2& dimensions, const std::vector<bool>& tilesSolid );
+
+	// Only rebuilds when the goal moves to a different tile, returns true if it did
+	bool			SetGoalTile( const IntVec2& goalTileCoords );
+	void			ClearGoal();
+
+	bool			HasGoal() const											{ return m_goalTileIndex != -1; }
+	IntVec2			GetGoalTileCoords() const								{ return GetTileCoordsFromIndex( m_goalTileIndex ); }
+	int				GetNumRebuilds() const									{ return m_numRebuilds; }
+
+	// -1 if the tile can't reach the goal or there is no goal
+	int				GetDistanceToGoal( const IntVec2& tileCoords ) const;
+	// Returns the tile's own coords at the goal and on tiles that can't reach it
+	IntVec2			GetNextTileCoords( const IntVec2& tileCoords ) const;
+	// Unit vector toward the center of the next tile on the way to the goal, zero if there isn't one
+	Vec2			GetSteeringDirection( const Vec2& position ) const;
+
+private:
+	void			Rebuild();
+	bool			CanStep( int tileIndex, const IntVec2& step ) const;
+	int				GetTileIndexFromCoords( const IntVec2& tileCoords ) const;
+	IntVec2			GetTileCoordsFromIndex( int tileIndex ) const			{ return IntVec2( tileIndex % m_dimensions.x, tileIndex / m_dimensions.x ); }
+
+private:
+	IntVec2				m_dimensions = IntVec2( 0, 0 );
+	std::vector<bool>	m_tilesSolid;
+	int					m_goalTileIndex = -1;
+	int					m_numRebuilds = 0;
+
+	std::vector<int>	m_tileDistances;			// Steps to the goal, -1 if unreachable
+	std::vector<int>	m_nextTileIndices;			// -1 at the goal and on unreachable tiles
+	std::vector<int>	m_openTileIndices;			// Kept between rebuilds to avoid reallocating
+};
@@ -0,0 +1,167 @@
+#include "Game/FlowFieldTest.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/NamedProperties.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Time/Time.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Game.hpp"
+#include "Game/World.hpp"
+#include "Game/Map.hpp"
+#include "Game/SeededMapTestFixture.hpp"
+
+#include <cstdlib>
+
+
+//-----------------------------------------------------------------------------------------------
+// How far a simulated tank moves along the steering direction each step
+constexpr float FLOW_FIELD_TEST_STEP_SIZE = .05f;
+
+
+//-----------------------------------------------------------------------------------------------
+bool FlowFieldTest::RunFlowFieldTest( EventArgs* args )
+{
+	int numSeeds = args->GetValue( "numSeeds", 100 );
+	int numGoalsPerMap = args->GetValue( "numGoalsPerMap", 8 );
+	int firstSeed = args->GetValue( "firstSeed", 0 );
+
+	SeededMapTestFixture fixture;
+
+	int numFields = 0;
+	int numReachabilityMismatches = 0;
+	int numBadTiles = 0;
+	int numExtraRebuilds = 0;
+	double rebuildSeconds = 0.0;
+
+	for ( int mapIndex = 0; mapIndex < NUM_MAPS; ++mapIndex )
+	{
+		for ( int seed = firstSeed; seed < firstSeed + numSeeds; ++seed )
+		{
+			Map& map = fixture.GenerateMap( mapIndex, seed );
+
+			FlowField& flowField = map.m_playerFlowField;
+			for ( int goalIndex = 0; goalIndex < numGoalsPerMap; ++goalIndex )
+			{
+				// The player's start first, then anywhere the player could walk to
+				IntVec2 goalTileCoords( (int)PLAYER_START_X, (int)PLAYER_START_Y );
+				while ( goalIndex > 0 )
+				{
+					goalTileCoords = IntVec2( g_game->m_rng->RollRandomIntInRange( 1, map.m_width - 2 ), g_game->m_rng->RollRandomIntInRange( 1, map.m_height - 2 ) );
+					if ( map.m_floodFillResult.m_tilesReachable[map.GetTileIndexFromTileCoords( goalTileCoords )] )
+					{
+						break;
+					}
+				}
+
+				double startTime = GetCurrentTimeSeconds();
+				flowField.SetGoalTile( goalTileCoords );
+				rebuildSeconds += GetCurrentTimeSeconds() - startTime;
+				++numFields;
+
+				// Staying on the same tile mustn't rebuild
+				int numRebuilds = flowField.GetNumRebuilds();
+				flowField.SetGoalTile( goalTileCoords );
+				numExtraRebuilds += flowField.GetNumRebuilds() - numRebuilds;
+
+				// Every tile the player can reach can reach the player, whichever tile the player is on
+				for ( int tileIndex = 0; tileIndex < (int)map.m_tiles.size(); ++tileIndex )
+				{
+					bool isReachable = flowField.GetDistanceToGoal( map.m_tiles[tileIndex].m_tileCoords ) != -1;
+					if ( isReachable != map.m_floodFillResult.m_tilesReachable[tileIndex] )
+					{
+						++numReachabilityMismatches;
+						break;
+					}
+				}
+
+				numBadTiles += CheckFlowFieldLeadsToGoal( map, flowField );
+			}
+		}
+	}
+
+	g_devConsole->PrintString( Stringf( "Built %i flow fields, %.1f us per rebuild", numFields, rebuildSeconds * 1000000.0 / (double)numFields ) );
+
+	if ( numReachabilityMismatches > 0
+		 || numBadTiles > 0
+		 || numExtraRebuilds > 0 )
+	{
+		g_devConsole->PrintError( Stringf( "FAIL: %i fields disagree with the map's flood fill, %i tiles don't lead to the goal, %i rebuilds without the goal moving",
+										   numReachabilityMismatches, numBadTiles, numExtraRebuilds ) );
+		return false;
+	}
+
+	g_devConsole->PrintString( "PASS: every reachable tile's field leads to the goal", Rgba8::GREEN );
+	return false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Walks the next tiles from each reachable tile, which must get one step closer each time through open
+// tiles without cutting corners. Then moves a point from the tile's center along the steering direction
+// in small steps, which must reach the goal without ever entering a solid tile.
+int FlowFieldTest::CheckFlowFieldLeadsToGoal( Map& map, const FlowField& flowField )
+{
+	IntVec2 goalTileCoords = flowField.GetGoalTileCoords();
+
+	int numBadTiles = 0;
+	for ( int tileIndex = 0; tileIndex < (int)map.m_tiles.size(); ++tileIndex )
+	{
+		IntVec2 tileCoords = map.m_tiles[tileIndex].m_tileCoords;
+		int distanceToGoal = flowField.GetDistanceToGoal( tileCoords );
+		if ( distanceToGoal == -1 )
+		{
+			continue;
+		}
+
+		bool leadsToGoal = true;
+		IntVec2 curTileCoords = tileCoords;
+		for ( int stepIndex = 0; stepIndex < distanceToGoal; ++stepIndex )
+		{
+			IntVec2 nextTileCoords = flowField.GetNextTileCoords( curTileCoords );
+			IntVec2 step = nextTileCoords - curTileCoords;
+			if ( abs( step.x ) + abs( step.y ) == 0
+				 || abs( step.x ) > 1
+				 || abs( step.y ) > 1
+				 || flowField.GetDistanceToGoal( nextTileCoords ) != flowField.GetDistanceToGoal( curTileCoords ) - 1
+				 || map.IsTileSolid( map.m_tiles[map.GetTileIndexFromTileCoords( nextTileCoords )] )
+				 || map.IsTileSolid( map.m_tiles[map.GetTileIndexFromTileCoords( curTileCoords + IntVec2( step.x, 0 ) )] )
+				 || map.IsTileSolid( map.m_tiles[map.GetTileIndexFromTileCoords( curTileCoords + IntVec2( 0, step.y ) )] ) )
+			{
+				leadsToGoal = false;
+				break;
+			}
+
+			curTileCoords = nextTileCoords;
+		}
+
+		leadsToGoal = leadsToGoal && curTileCoords == goalTileCoords;
+
+		Vec2 position( ( (float)tileCoords.x + .5f ) * TILE_SIZE, ( (float)tileCoords.y + .5f ) * TILE_SIZE );
+		int maxSteps = (int)( (float)( distanceToGoal + 1 ) * 1.5f * TILE_SIZE / FLOW_FIELD_TEST_STEP_SIZE );
+		for ( int stepIndex = 0; leadsToGoal && stepIndex < maxSteps; ++stepIndex )
+		{
+			IntVec2 positionTileCoords( (int)position.x, (int)position.y );
+			if ( positionTileCoords == goalTileCoords )
+			{
+				break;
+			}
+
+			Vec2 steeringDirection = flowField.GetSteeringDirection( position );
+			position += steeringDirection * FLOW_FIELD_TEST_STEP_SIZE;
+			if ( steeringDirection == Vec2::ZERO
+				 || map.IsPointInSolid( position ) )
+			{
+				leadsToGoal = false;
+			}
+		}
+
+		if ( !leadsToGoal
+			 || IntVec2( (int)position.x, (int)position.y ) != goalTileCoords )
+		{
+			++numBadTiles;
+		}
+	}
+
+	return numBadTiles;
+}
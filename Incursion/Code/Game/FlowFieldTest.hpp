@@ -0,0 +1,22 @@
+#pragma once
+#include "Engine/Core/EngineCommon.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+class Map;
+class FlowField;
+
+
+//-----------------------------------------------------------------------------------------------
+// Builds flow fields on seeded maps generated without a world or renderer and follows them from
+// every reachable tile
+class FlowFieldTest
+{
+public:
+	// Dev console, "test_flow_field numSeeds=100 numGoalsPerMap=8 firstSeed=0"
+	static bool RunFlowFieldTest( EventArgs* args );
+
+private:
+	// Returns the number of tiles whose field doesn't lead to the goal
+	static int	CheckFlowFieldLeadsToGoal( Map& map, const FlowField& flowField );
+};
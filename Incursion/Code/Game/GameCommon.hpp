@@ -63,6 +63,7 @@ constexpr float TANK_MAX_CHASE_RANGE = 10.f;
 constexpr float TANK_SHOT_ANGLE_RANGE_DEGREES = 5.f;
 constexpr float TANK_CHASE_ANGLE_RANGE_DEGREES = 45.f;
 constexpr float TANK_SHOT_COOLDOWN = 1.7f;
+constexpr int   TANK_MAX_INVESTIGATE_TILE_DISTANCE = 20;
 
 constexpr int   TURRET_MAX_HEALTH = 3;
 constexpr float TURRET_PHYSICS_RADIUS = .37f;
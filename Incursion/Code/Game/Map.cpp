@@ -1,4 +1,5 @@
 #include "Game/Map.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Math/Vec2.hpp"
 #include "Engine/Math/AABB2.hpp"
@@ -21,6 +22,9 @@
 #include "Game/Bullet.hpp"
 #include "Game/Explosion.hpp"
 
+#include <climits>
+#include <deque>
+
 
 //-----------------------------------------------------------------------------------------------
 Map::Map( int id, World* world, const MapDefinition& mapDefinition )
@@ -36,6 +40,14 @@ Map::Map( int id, World* world, const MapDefinition& mapDefinition )
 }
 
 
+//-----------------------------------------------------------------------------------------------
+Map::Map( const IntVec2& dimensions )
+	: m_width( dimensions.x )
+	, m_height( dimensions.y )
+{
+}
+
+
 //-----------------------------------------------------------------------------------------------
 Map::~Map()
 {
@@ -58,6 +70,7 @@ Map::~Map()
 //-----------------------------------------------------------------------------------------------
 void Map::Update( float deltaSeconds )
 {
+	UpdatePlayerFlowField();
 	UpdateEntities( deltaSeconds );
 	if ( CheckForWin() )
 	{
@@ -71,6 +84,25 @@ void Map::Update( float deltaSeconds )
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void Map::UpdatePlayerFlowField()
+{
+	if ( m_player == nullptr
+		 || m_player->IsDead() )
+	{
+		if ( m_playerFlowField.HasGoal() )
+		{
+			m_playerFlowField.ClearGoal();
+		}
+
+		return;
+	}
+
+	Vec2 playerPosition = m_player->GetPosition();
+	m_playerFlowField.SetGoalTile( IntVec2( (int)playerPosition.x, (int)playerPosition.y ) );
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void Map::UpdateEntities( float deltaSeconds )
 {
@@ -651,36 +683,36 @@ bool Map::DoesTileBlockVision( const Tile& tile )
 
 
 //-----------------------------------------------------------------------------------------------
-RaycastImpact Map::Raycast( const Vec2& start, const Vec2& forwardDirection, float maxDistance, float stepSize )
+RaycastImpact Map::Raycast( const Vec2& start, const Vec2& forwardDirection, float maxDistance )
 {
-	for ( float raycastStep = 0; raycastStep < maxDistance; raycastStep += stepSize )
-	{
-		Vec2 raycastPos = start + ( forwardDirection * raycastStep );
+	return RaycastAgainstTiles( start, forwardDirection, maxDistance, false );
+}
 
-		if ( IsPointInSolid( raycastPos ) )
-		{
-			return RaycastImpact( true, raycastPos );
-		}
-	}
 
-	return RaycastImpact( false, start + ( forwardDirection * maxDistance ) );
+//-----------------------------------------------------------------------------------------------
+RaycastImpact Map::VisionRaycast( const Vec2& start, const Vec2& forwardDirection, float maxDistance )
+{
+	return RaycastAgainstTiles( start, forwardDirection, maxDistance, true );
 }
 
 
 //-----------------------------------------------------------------------------------------------
-RaycastImpact Map::VisionRaycast( const Vec2& start, const Vec2& forwardDirection, float maxDistance, float stepSize /*= 0.01f */ )
+void Map::RaycastMany( const Vec2& start, int numRays, const Vec2* forwardDirections, const float* maxDistances, RaycastImpact* out_impacts )
 {
-	for ( float raycastStep = 0; raycastStep < maxDistance; raycastStep += stepSize )
-	{
-		Vec2 raycastPos = start + ( forwardDirection * raycastStep );
+	// Every ray leaves from the same tile, so it only needs to be looked up once
+	IntVec2 startTileCoords( (int)start.x, (int)start.y );
+	bool isStartBlocked = DoesTileStopRaycast( startTileCoords, false );
 
-		if ( IsPointInVisionBlockingSolid( raycastPos ) )
+	for ( int rayIndex = 0; rayIndex < numRays; ++rayIndex )
+	{
+		if ( isStartBlocked )
 		{
-			return RaycastImpact( true, raycastPos );
+			out_impacts[rayIndex] = RaycastImpact( true, start, 0.f, -forwardDirections[rayIndex] );
+			continue;
 		}
-	}
 
-	return RaycastImpact( false, start + ( forwardDirection * maxDistance ) );
+		out_impacts[rayIndex] = TraverseTilesFromStartTile( start, startTileCoords, forwardDirections[rayIndex], maxDistances[rayIndex], false );
+	}
 }
 
 
@@ -696,25 +728,127 @@ bool Map::HasLineOfSight( const Entity& source, const Entity& target )
 }
 
 
+//-----------------------------------------------------------------------------------------------
+RaycastImpact Map::RaycastAgainstTiles( const Vec2& start, const Vec2& forwardDirection, float maxDistance, bool onlyVisionBlockingTiles )
+{
+	IntVec2 startTileCoords( (int)start.x, (int)start.y );
+	if ( DoesTileStopRaycast( startTileCoords, onlyVisionBlockingTiles ) )
+	{
+		return RaycastImpact( true, start, 0.f, -forwardDirection );
+	}
+
+	return TraverseTilesFromStartTile( start, startTileCoords, forwardDirection, maxDistance, onlyVisionBlockingTiles );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Amanatides-Woo traversal, steps into whichever of the next vertical or horizontal tile edges the ray
+// reaches first so every tile along the ray is checked exactly once
+RaycastImpact Map::TraverseTilesFromStartTile( const Vec2& start, const IntVec2& startTileCoords, const Vec2& forwardDirection, float maxDistance, bool onlyVisionBlockingTiles )
+{
+	// How far along the ray to move 1 tile in x, essentially infinity if the ray doesn't move in x
+	float xDeltaDistAlongRay = 99999999.f;
+	if ( !IsNearlyEqual( forwardDirection.x, 0.f, .000001f ) )
+	{
+		xDeltaDistAlongRay = TILE_SIZE / fabsf( forwardDirection.x );
+	}
+
+	int tileStepDirX = (int)SignFloat( forwardDirection.x );
+	int offsetToLeadingEdgeX = ( tileStepDirX + 1 ) / 2;
+	float distToNextXCrossing = fabsf( (float)( startTileCoords.x + offsetToLeadingEdgeX ) - start.x ) * xDeltaDistAlongRay;
+
+	// Same again for y
+	float yDeltaDistAlongRay = 99999999.f;
+	if ( !IsNearlyEqual( forwardDirection.y, 0.f, .000001f ) )
+	{
+		yDeltaDistAlongRay = TILE_SIZE / fabsf( forwardDirection.y );
+	}
+
+	int tileStepDirY = (int)SignFloat( forwardDirection.y );
+	int offsetToLeadingEdgeY = ( tileStepDirY + 1 ) / 2;
+	float distToNextYCrossing = fabsf( (float)( startTileCoords.y + offsetToLeadingEdgeY ) - start.y ) * yDeltaDistAlongRay;
+
+	IntVec2 tileCoords = startTileCoords;
+	while ( distToNextXCrossing <= maxDistance
+			|| distToNextYCrossing <= maxDistance )
+	{
+		if ( distToNextXCrossing < distToNextYCrossing )
+		{
+			tileCoords.x += tileStepDirX;
+			if ( DoesTileStopRaycast( tileCoords, onlyVisionBlockingTiles ) )
+			{
+				return RaycastImpact( true, start + ( forwardDirection * distToNextXCrossing ), distToNextXCrossing, Vec2( (float)-tileStepDirX, 0.f ) );
+			}
+
+			distToNextXCrossing += xDeltaDistAlongRay;
+		}
+		else
+		{
+			tileCoords.y += tileStepDirY;
+			if ( DoesTileStopRaycast( tileCoords, onlyVisionBlockingTiles ) )
+			{
+				return RaycastImpact( true, start + ( forwardDirection * distToNextYCrossing ), distToNextYCrossing, Vec2( 0.f, (float)-tileStepDirY ) );
+			}
+
+			distToNextYCrossing += yDeltaDistAlongRay;
+		}
+	}
+
+	return RaycastImpact( false, start + ( forwardDirection * maxDistance ), maxDistance );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool Map::DoesTileStopRaycast( const IntVec2& tileCoords, bool onlyVisionBlockingTiles )
+{
+	// Anything off the map blocks, same as IsPointInSolid
+	int tileIndex = GetTileIndexFromTileCoords( tileCoords );
+	if ( tileIndex < 0 )
+	{
+		return true;
+	}
+
+	const Tile& tile = m_tiles[tileIndex];
+	return onlyVisionBlockingTiles ? DoesTileBlockVision( tile ) : IsTileSolid( tile );
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void Map::PopulateTiles( const MapDefinition& mapDefinition )
 {
-	FloodFillResult result;
-	while ( !result.m_isExitReachable )
-	{
-		m_tiles.clear();
-		CreateInitialTiles( mapDefinition.m_defaultTileType );
-		DrawBorder( mapDefinition.m_edgeTileType );
-		DeployWorms( mapDefinition.m_tileWorms );
-		ClearStartSafeZone( mapDefinition.m_startTileType, mapDefinition.m_shieldTileType );
-		ClearEndSafeZone( mapDefinition.m_exitTileType, mapDefinition.m_shieldTileType );
-		AddExitPoint();
-		BuildSurroundingTileVector();
-		result = FloodFillMap( Vec2( PLAYER_START_X, PLAYER_START_Y ) );
-	} 
+	CreateInitialTiles( mapDefinition.m_defaultTileType );
+	DrawBorder( mapDefinition.m_edgeTileType );
+	DeployWorms( mapDefinition.m_tileWorms );
+	ClearStartSafeZone( mapDefinition.m_startTileType, mapDefinition.m_shieldTileType );
+	ClearEndSafeZone( mapDefinition.m_exitTileType, mapDefinition.m_shieldTileType );
+	AddExitPoint();
+	BuildSurroundingTileVector();
+
+	m_floodFillResult = FloodFillMap( Vec2( PLAYER_START_X, PLAYER_START_Y ) );
+	while ( !m_floodFillResult.m_isExitReachable )
+	{
+		// Dig the exit's pocket out to the closest reachable tile instead of regenerating the whole map
+		bool wasConnected = ConnectExitToReachableTiles( mapDefinition.m_defaultTileType );
+		GUARANTEE_OR_DIE( wasConnected, "Map generation couldn't connect the exit to the start" );
+
+		m_floodFillResult = FloodFillMap( Vec2( PLAYER_START_X, PLAYER_START_Y ) );
+	}
 
-	m_floodFillResult = result;
 	FillInUnreachableTiles( mapDefinition.m_edgeTileType );
+	InitializePlayerFlowField();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Map::InitializePlayerFlowField()
+{
+	std::vector<bool> tilesSolid( m_tiles.size(), false );
+	for ( int tileIndex = 0; tileIndex < (int)m_tiles.size(); ++tileIndex )
+	{
+		tilesSolid[tileIndex] = IsTileSolid( m_tiles[tileIndex] );
+	}
+
+	m_playerFlowField.Initialize( IntVec2( m_width, m_height ), tilesSolid );
 }
 
 
@@ -877,83 +1011,141 @@ void Map::FillInUnreachableTiles( TileType fillType )
 
 
 //-----------------------------------------------------------------------------------------------
-FloodFillResult Map::FloodFillMap( const Vec2& startPos )
+// Carves the fewest solid tiles needed to join the exit to a tile the last flood fill reached.
+// Open tiles are free to walk through, so this is a 0-1 breadth first search out from the exit.
+bool Map::ConnectExitToReachableTiles( TileType carveTileType )
 {
-	FloodFillResult result;
-	result.m_tilesProcessed.reserve( (int)m_tiles.size() );
-	result.m_tilesReachable.reserve( (int)m_tiles.size() );
-
-	for ( int tileCount = 0; tileCount < (int)m_tiles.size(); ++tileCount )
+	int numTiles = (int)m_tiles.size();
+	int exitIndex = GetTileIndexFromWorldCoords( m_exitPosition );
+	if ( exitIndex < 0
+		 || exitIndex > numTiles - 1 )
 	{
-		result.m_tilesProcessed.push_back( false );
-		result.m_tilesReachable.push_back( false );
+		return false;
 	}
 
-	int startIndex = GetTileIndexFromWorldCoords( startPos );
-	// Return false for all data if start position is outside map or solid
-	if ( startIndex < 0
-		 || startIndex >( int )m_tiles.size() - 1
-		 || IsTileSolid(m_tiles[startIndex]) )
-	{
-		return result;
-	}
+	std::vector<int> numTilesToCarve( numTiles, INT_MAX );
+	std::vector<int> previousTileIndices( numTiles, -1 );
+	std::deque<int> openTileIndices;
 
-	// Seed flood fill with our starting tile
-	result.m_tilesReachable[startIndex] = true;
+	numTilesToCarve[exitIndex] = 0;
+	openTileIndices.push_back( exitIndex );
 
-	bool changesWereMade = true;
-	while ( changesWereMade )
+	const IntVec2 cardinalDirections[4] = { IntVec2( 0, 1 ), IntVec2( 1, 0 ), IntVec2( 0, -1 ), IntVec2( -1, 0 ) };
+	while ( !openTileIndices.empty() )
 	{
-		changesWereMade = false;
+		int tileIndex = openTileIndices.front();
+		openTileIndices.pop_front();
 
-		for ( int tileIndex = 0; tileIndex < (int)m_tiles.size(); ++tileIndex )
+		if ( m_floodFillResult.m_tilesReachable[tileIndex] )
 		{
-			const Tile& tile = m_tiles[ tileIndex ];
-			if ( result.m_tilesProcessed[ tileIndex ]
-				 || !result.m_tilesReachable[ tileIndex ] )
+			for ( int carveIndex = tileIndex; carveIndex != -1; carveIndex = previousTileIndices[carveIndex] )
 			{
-				continue;
+				if ( IsTileSolid( m_tiles[carveIndex] ) )
+				{
+					m_tiles[carveIndex].m_tileType = carveTileType;
+				}
 			}
 
-			Vec2 worldCoords( GetWorldCoordsFromTile( tile ) );
+			return true;
+		}
 
-			if ( tile.m_tileType == TILE_TYPE_EXIT )
+		const IntVec2& tileCoords = m_tiles[tileIndex].m_tileCoords;
+		for ( int directionIndex = 0; directionIndex < 4; ++directionIndex )
+		{
+			IntVec2 neighborCoords = tileCoords + cardinalDirections[directionIndex];
+
+			// Never dig through the border
+			if ( neighborCoords.x < 1 || neighborCoords.x > m_width - 2
+				 || neighborCoords.y < 1 || neighborCoords.y > m_height - 2 )
 			{
-				result.m_isExitReachable = true;
+				continue;
 			}
 
-			Tile* northTile = GetTileFromWorldCoords( worldCoords + m_surroundingTilePositions[(int)SurroundingTiles::NORTH] );
-			SetFloodFillDataForTile( northTile, result );
-
-			Tile* southTile = GetTileFromWorldCoords( worldCoords + m_surroundingTilePositions[(int)SurroundingTiles::SOUTH] );
-			SetFloodFillDataForTile( southTile, result );
-
-			Tile* eastTile = GetTileFromWorldCoords( worldCoords + m_surroundingTilePositions[(int)SurroundingTiles::EAST] );
-			SetFloodFillDataForTile( eastTile, result );
-
-			Tile* westTile = GetTileFromWorldCoords( worldCoords + m_surroundingTilePositions[(int)SurroundingTiles::WEST] );
-			SetFloodFillDataForTile( westTile, result );
+			int neighborIndex = GetTileIndexFromTileCoords( neighborCoords );
+			bool isNeighborSolid = IsTileSolid( m_tiles[neighborIndex] );
+			int neighborNumTilesToCarve = numTilesToCarve[tileIndex] + ( isNeighborSolid ? 1 : 0 );
+			if ( neighborNumTilesToCarve >= numTilesToCarve[neighborIndex] )
+			{
+				continue;
+			}
 
-			result.m_tilesProcessed[tileIndex] = true;
-			changesWereMade = true;
+			numTilesToCarve[neighborIndex] = neighborNumTilesToCarve;
+			previousTileIndices[neighborIndex] = tileIndex;
+			if ( isNeighborSolid )
+			{
+				openTileIndices.push_back( neighborIndex );
+			}
+			else
+			{
+				openTileIndices.push_front( neighborIndex );
+			}
 		}
 	}
 
-	return result;
+	return false;
 }
 
 
 //-----------------------------------------------------------------------------------------------
-void Map::SetFloodFillDataForTile( Tile* tile, FloodFillResult& result )
+// Breadth first from the start tile, so every tile is visited once and tiles come off the queue
+// in order of distance
+FloodFillResult Map::FloodFillMap( const Vec2& startPos )
 {
-	if ( tile != nullptr )
+	int numTiles = (int)m_tiles.size();
+
+	FloodFillResult result;
+	result.m_tilesReachable.resize( numTiles, false );
+	result.m_tileDistances.resize( numTiles, -1 );
+
+	int startIndex = GetTileIndexFromWorldCoords( startPos );
+	// Return false for all data if start position is outside map or solid
+	if ( startIndex < 0
+		 || startIndex > numTiles - 1
+		 || IsTileSolid( m_tiles[startIndex] ) )
+	{
+		return result;
+	}
+
+	// Seed flood fill with our starting tile
+	std::vector<int> openTileIndices;
+	openTileIndices.reserve( numTiles );
+	openTileIndices.push_back( startIndex );
+	result.m_tilesReachable[startIndex] = true;
+	result.m_tileDistances[startIndex] = 0;
+
+	const IntVec2 cardinalDirections[4] = { IntVec2( 0, 1 ), IntVec2( 0, -1 ), IntVec2( 1, 0 ), IntVec2( -1, 0 ) };
+	for ( int openIndex = 0; openIndex < (int)openTileIndices.size(); ++openIndex )
 	{
-		int tileIndex = GetTileIndexFromTileCoords( tile->m_tileCoords );
-		if ( !IsTileSolid( *tile ) )
+		int tileIndex = openTileIndices[openIndex];
+		const Tile& tile = m_tiles[tileIndex];
+		if ( tile.m_tileType == TILE_TYPE_EXIT )
 		{
-			result.m_tilesReachable[tileIndex] = true;
+			result.m_isExitReachable = true;
+		}
+
+		for ( int directionIndex = 0; directionIndex < 4; ++directionIndex )
+		{
+			IntVec2 neighborCoords = tile.m_tileCoords + cardinalDirections[directionIndex];
+			if ( neighborCoords.x < 0 || neighborCoords.x > m_width - 1
+				 || neighborCoords.y < 0 || neighborCoords.y > m_height - 1 )
+			{
+				continue;
+			}
+
+			int neighborIndex = GetTileIndexFromTileCoords( neighborCoords );
+			if ( result.m_tilesReachable[neighborIndex]
+				 || IsTileSolid( m_tiles[neighborIndex] ) )
+			{
+				continue;
+			}
+
+			result.m_tilesReachable[neighborIndex] = true;
+			result.m_tileDistances[neighborIndex] = result.m_tileDistances[tileIndex] + 1;
+			openTileIndices.push_back( neighborIndex );
 		}
 	}
+
+	return result;
 }
 
 
@@ -2,6 +2,7 @@
 #include "Engine/Math/Vec2.hpp"
 #include "Game/Tile.hpp"
 #include "Game/FloodFillResult.hpp"
+#include "Game/FlowField.hpp"
 #include "Game/Entity.hpp"
 
 #include <vector>
@@ -35,6 +36,11 @@ enum class SurroundingTiles
 //-----------------------------------------------------------------------------------------------
 class Map
 {
+	friend class FlowFieldTest;
+	friend class MapGenerationTest;
+	friend class MapRaycastTest;
+	friend class SeededMapTestFixture;
+
 public:
 	Map( int id, World* world, const MapDefinition& mapDefinition );
 	~Map();
@@ -46,6 +52,7 @@ public:
 	void			DebugRender() const;
 
 	int				GetId()													{ return m_id; }
+	const FlowField& GetPlayerFlowField() const								{ return m_playerFlowField; }
 	Entity*			GetPlayer()												{ return (Entity*)m_player; }   // Return as entity for now since only generic entity information is required and 
 																											// callers shouldn't need to include Player.hpp (if specifics are needed this will be updated)
 
@@ -59,11 +66,17 @@ public:
 	void			LoadMap();
 	void			UnloadMap();
 
-	RaycastImpact	Raycast( const Vec2& start, const Vec2& forwardDirection, float maxDistance, float stepSize = 0.01f );
-	RaycastImpact	VisionRaycast( const Vec2& start, const Vec2& forwardDirection, float maxDistance, float stepSize = 0.01f );
+	// Walk the grid one tile crossing at a time, impacts are exact points on the edge of the first blocking tile
+	RaycastImpact	Raycast( const Vec2& start, const Vec2& forwardDirection, float maxDistance );
+	RaycastImpact	VisionRaycast( const Vec2& start, const Vec2& forwardDirection, float maxDistance );
+	// Solid tile raycasts that all start at the same point, like a tank's whiskers
+	void			RaycastMany( const Vec2& start, int numRays, const Vec2* forwardDirections, const float* maxDistances, RaycastImpact* out_impacts );
 	bool			HasLineOfSight( const Entity& source, const Entity& target );
 
 private:
+	// Tiles only, for generating maps without a world or renderer
+	explicit Map( const IntVec2& dimensions );
+
 	// Map building
 	void			PopulateTiles( const MapDefinition& mapDefinition );
 	void			CreateInitialTiles( TileType defaultTileype );
@@ -75,9 +88,10 @@ private:
 	void			AddExitPoint();
 	void			BuildSurroundingTileVector();
 	void			FillInUnreachableTiles( TileType fillType );
+	bool			ConnectExitToReachableTiles( TileType carveTileType );
+	void			InitializePlayerFlowField();
 
 	FloodFillResult FloodFillMap( const Vec2& startPos );
-	void			SetFloodFillDataForTile( Tile* tile, FloodFillResult& result );
 
 	// Spawning
 	void			PopulateEnemySpawnLocations( const MapEntityDefinition& mapEntityDefinition );
@@ -88,6 +102,11 @@ private:
 
 	void			DeleteGarbageEntities();
 
+	// Raycasting
+	RaycastImpact	RaycastAgainstTiles( const Vec2& start, const Vec2& forwardDirection, float maxDistance, bool onlyVisionBlockingTiles );
+	RaycastImpact	TraverseTilesFromStartTile( const Vec2& start, const IntVec2& startTileCoords, const Vec2& forwardDirection, float maxDistance, bool onlyVisionBlockingTiles );
+	bool			DoesTileStopRaycast( const IntVec2& tileCoords, bool onlyVisionBlockingTiles );
+
 	// Tile helpers
 	int				GetTileIndexFromTileCoords( int xCoord, int yCoord );
 	int				GetTileIndexFromTileCoords( const IntVec2& coords );
@@ -97,6 +116,7 @@ private:
 	const Vec2		GetWorldCoordsFromTile( const Tile& tile );
 
 	// Update
+	void			UpdatePlayerFlowField();
 	void			UpdateEntities( float deltaSeconds );
 	bool			CheckForWin();
 
@@ -146,4 +166,7 @@ private:
 	std::vector<Tile>	m_tiles;
 	std::vector<Vec2>	m_surroundingTilePositions;
 	FloodFillResult     m_floodFillResult;
+
+	// Steering toward the player for every NPC, rebuilt only when the player changes tile
+	FlowField			m_playerFlowField;
 };
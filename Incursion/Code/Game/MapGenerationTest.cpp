@@ -0,0 +1,188 @@
+#include "Game/MapGenerationTest.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/NamedProperties.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Time/Time.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Game.hpp"
+#include "Game/World.hpp"
+#include "Game/Map.hpp"
+#include "Game/MapDefinition.hpp"
+#include "Game/SeededMapTestFixture.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+bool MapGenerationTest::RunMapGenerationTest( EventArgs* args )
+{
+	int numSeeds = args->GetValue( "numSeeds", 1000 );
+	int firstSeed = args->GetValue( "firstSeed", 0 );
+
+	SeededMapTestFixture fixture;
+
+	int numMapsGenerated = 0;
+	int numExitsUnreachable = 0;
+	int numFloodFillMismatches = 0;
+	int numTileMismatches = 0;
+	int numRepairedMaps = 0;
+	int numLegacyRetries = 0;
+	double seconds = 0.0;
+	double legacySeconds = 0.0;
+
+	for ( int mapIndex = 0; mapIndex < NUM_MAPS; ++mapIndex )
+	{
+		for ( int seed = firstSeed; seed < firstSeed + numSeeds; ++seed )
+		{
+			// Built by hand rather than with GenerateMap so only PopulateTiles is timed
+			MapDefinition mapDefinition = fixture.CreateMapDefinition( mapIndex, seed );
+			Map map( mapDefinition.m_dimensions );
+
+			double startTime = GetCurrentTimeSeconds();
+			map.PopulateTiles( mapDefinition );
+			seconds += GetCurrentTimeSeconds() - startTime;
+			++numMapsGenerated;
+
+			int exitIndex = map.GetTileIndexFromWorldCoords( map.m_exitPosition );
+			if ( !map.m_floodFillResult.m_isExitReachable
+				 || map.m_floodFillResult.m_tileDistances[exitIndex] < 0 )
+			{
+				++numExitsUnreachable;
+			}
+
+			// The single pass fill has to agree with the old sweep on the finished map
+			FloodFillResult legacyResult = LegacyFloodFillMap( map, Vec2( PLAYER_START_X, PLAYER_START_Y ) );
+			if ( legacyResult.m_tilesReachable != map.m_floodFillResult.m_tilesReachable
+				 || legacyResult.m_isExitReachable != map.m_floodFillResult.m_isExitReachable )
+			{
+				++numFloodFillMismatches;
+			}
+
+			MapDefinition legacyMapDefinition = fixture.CreateMapDefinition( mapIndex, seed );
+			Map legacyMap( legacyMapDefinition.m_dimensions );
+
+			startTime = GetCurrentTimeSeconds();
+			int numLegacyAttempts = LegacyPopulateTiles( legacyMap, legacyMapDefinition );
+			legacySeconds += GetCurrentTimeSeconds() - startTime;
+
+			// A map the old generator had to throw away is repaired in place now, so only first tries can match
+			if ( numLegacyAttempts > 1 )
+			{
+				++numRepairedMaps;
+				numLegacyRetries += numLegacyAttempts - 1;
+				continue;
+			}
+
+			for ( int tileIndex = 0; tileIndex < (int)map.m_tiles.size(); ++tileIndex )
+			{
+				if ( map.m_tiles[tileIndex].m_tileType != legacyMap.m_tiles[tileIndex].m_tileType )
+				{
+					++numTileMismatches;
+					break;
+				}
+			}
+		}
+	}
+
+	g_devConsole->PrintString( Stringf( "Generated %i maps for seeds %i to %i", numMapsGenerated, firstSeed, firstSeed + numSeeds - 1 ) );
+	g_devConsole->PrintString( Stringf( "Repaired %i maps the old generator regenerated %i times", numRepairedMaps, numLegacyRetries ) );
+	g_devConsole->PrintString( Stringf( "Generation took %.1f ms, old generator took %.1f ms", seconds * 1000.0, legacySeconds * 1000.0 ) );
+
+	if ( numExitsUnreachable > 0
+		 || numFloodFillMismatches > 0
+		 || numTileMismatches > 0 )
+	{
+		g_devConsole->PrintError( Stringf( "FAIL: %i unreachable exits, %i flood fill mismatches, %i maps differ from the old generator",
+										   numExitsUnreachable, numFloodFillMismatches, numTileMismatches ) );
+		return false;
+	}
+
+	g_devConsole->PrintString( "PASS: every exit reachable and every first try map matches the old generator", Rgba8::GREEN );
+	return false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// The old flood fill, sweeps the whole grid until a sweep finds nothing new
+FloodFillResult MapGenerationTest::LegacyFloodFillMap( Map& map, const Vec2& startPos )
+{
+	std::vector<bool> tilesProcessed( map.m_tiles.size(), false );
+
+	FloodFillResult result;
+	result.m_tilesReachable.resize( map.m_tiles.size(), false );
+
+	int startIndex = map.GetTileIndexFromWorldCoords( startPos );
+	if ( startIndex < 0
+		 || startIndex > (int)map.m_tiles.size() - 1
+		 || map.IsTileSolid( map.m_tiles[startIndex] ) )
+	{
+		return result;
+	}
+
+	result.m_tilesReachable[startIndex] = true;
+
+	const SurroundingTiles cardinalTiles[4] = { SurroundingTiles::NORTH, SurroundingTiles::SOUTH, SurroundingTiles::EAST, SurroundingTiles::WEST };
+
+	bool changesWereMade = true;
+	while ( changesWereMade )
+	{
+		changesWereMade = false;
+
+		for ( int tileIndex = 0; tileIndex < (int)map.m_tiles.size(); ++tileIndex )
+		{
+			const Tile& tile = map.m_tiles[tileIndex];
+			if ( tilesProcessed[tileIndex]
+				 || !result.m_tilesReachable[tileIndex] )
+			{
+				continue;
+			}
+
+			if ( tile.m_tileType == TILE_TYPE_EXIT )
+			{
+				result.m_isExitReachable = true;
+			}
+
+			Vec2 worldCoords( map.GetWorldCoordsFromTile( tile ) );
+			for ( int directionIndex = 0; directionIndex < 4; ++directionIndex )
+			{
+				Tile* neighborTile = map.GetTileFromWorldCoords( worldCoords + map.m_surroundingTilePositions[(int)cardinalTiles[directionIndex]] );
+				if ( neighborTile != nullptr
+					 && !map.IsTileSolid( *neighborTile ) )
+				{
+					result.m_tilesReachable[map.GetTileIndexFromTileCoords( neighborTile->m_tileCoords )] = true;
+				}
+			}
+
+			tilesProcessed[tileIndex] = true;
+			changesWereMade = true;
+		}
+	}
+
+	return result;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// The old generator, throws the whole map away until the exit is reachable. Returns the number of tries.
+int MapGenerationTest::LegacyPopulateTiles( Map& map, const MapDefinition& mapDefinition )
+{
+	map.BuildSurroundingTileVector();
+
+	int numAttempts = 0;
+	FloodFillResult result;
+	while ( !result.m_isExitReachable )
+	{
+		map.m_tiles.clear();
+		map.CreateInitialTiles( mapDefinition.m_defaultTileType );
+		map.DrawBorder( mapDefinition.m_edgeTileType );
+		map.DeployWorms( mapDefinition.m_tileWorms );
+		map.ClearStartSafeZone( mapDefinition.m_startTileType, mapDefinition.m_shieldTileType );
+		map.ClearEndSafeZone( mapDefinition.m_exitTileType, mapDefinition.m_shieldTileType );
+		map.AddExitPoint();
+		result = LegacyFloodFillMap( map, Vec2( PLAYER_START_X, PLAYER_START_Y ) );
+		++numAttempts;
+	}
+
+	map.m_floodFillResult = result;
+	map.FillInUnreachableTiles( mapDefinition.m_edgeTileType );
+	return numAttempts;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "Engine/Core/EngineCommon.hpp"
+#include "Game/FloodFillResult.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+class Map;
+struct MapDefinition;
+struct Vec2;
+
+
+//-----------------------------------------------------------------------------------------------
+// Generates seeded maps without a world or renderer and checks them against the generator that
+// swept the whole grid until the fill stopped changing and threw the map away until the exit was reachable
+class MapGenerationTest
+{
+public:
+	// Dev console, "test_map_generation numSeeds=1000 firstSeed=0"
+	static bool RunMapGenerationTest( EventArgs* args );
+
+private:
+	static FloodFillResult	LegacyFloodFillMap( Map& map, const Vec2& startPos );
+	static int				LegacyPopulateTiles( Map& map, const MapDefinition& mapDefinition );
+};
@@ -0,0 +1,277 @@
+#include "Game/MapRaycastTest.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/NamedProperties.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Time/Time.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Game.hpp"
+#include "Game/World.hpp"
+#include "Game/Map.hpp"
+#include "Game/SeededMapTestFixture.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+// The step size every caller used to march with
+constexpr float LEGACY_RAYCAST_STEP_SIZE = 0.01f;
+
+// Marching adds up thousands of float steps, so allow a little drift on top of one step
+constexpr float RAYCAST_IMPACT_TOLERANCE = LEGACY_RAYCAST_STEP_SIZE + 0.002f;
+
+
+//-----------------------------------------------------------------------------------------------
+bool MapRaycastTest::RunRaycastTest( EventArgs* args )
+{
+	int numRays = args->GetValue( "numRays", 100000 );
+	int seed = args->GetValue( "seed", 0 );
+
+	SeededMapTestFixture fixture;
+
+	int numRaysCast = 0;
+	int numImpacts = 0;
+	int numCornerClips = 0;
+	int numImpactMismatches = 0;
+	int numBadNormals = 0;
+	int numBatchMismatches = 0;
+
+	for ( int mapIndex = 0; mapIndex < NUM_MAPS; ++mapIndex )
+	{
+		Map& map = fixture.GenerateMap( mapIndex, seed );
+
+		for ( int rayIndex = 0; rayIndex < numRays; ++rayIndex )
+		{
+			Vec2 start( g_game->m_rng->RollRandomFloatInRange( 0.f, (float)map.m_width ), g_game->m_rng->RollRandomFloatInRange( 0.f, (float)map.m_height ) );
+			Vec2 forwardDirection = g_game->m_rng->RollRandomDirection2D();
+			float maxDistance = g_game->m_rng->RollRandomFloatInRange( 0.f, TANK_MAX_CHASE_RANGE );
+			bool onlyVisionBlockingTiles = g_game->m_rng->RollPercentChance( .5f );
+
+			RaycastImpact impact = onlyVisionBlockingTiles ? map.VisionRaycast( start, forwardDirection, maxDistance ) : map.Raycast( start, forwardDirection, maxDistance );
+			RaycastImpact legacyImpact = LegacyRaycast( map, start, forwardDirection, maxDistance, onlyVisionBlockingTiles );
+			++numRaysCast;
+
+			if ( impact.m_didImpact )
+			{
+				++numImpacts;
+
+				// Normals face back against the ray, and the tile behind the normal really blocks
+				if ( DotProduct2D( impact.m_impactSurfaceNormal, forwardDirection ) >= 0.f
+					 || !map.DoesTileStopRaycast( GetImpactTileCoords( impact ), onlyVisionBlockingTiles ) )
+				{
+					++numBadNormals;
+				}
+			}
+
+			float impactDistanceDifference = legacyImpact.m_impactDistance - impact.m_impactDistance;
+			if ( impact.m_didImpact == legacyImpact.m_didImpact
+				 && fabsf( impactDistanceDifference ) <= RAYCAST_IMPACT_TOLERANCE )
+			{
+				continue;
+			}
+
+			// Marching can step right over the corner of a tile, or stop just short of a tile at the very end
+			if ( impact.m_didImpact
+				 && ( impactDistanceDifference > 0.f || !legacyImpact.m_didImpact ) )
+			{
+				if ( IsCornerClip( impact, forwardDirection ) )
+				{
+					++numCornerClips;
+					continue;
+				}
+
+				if ( !legacyImpact.m_didImpact
+					 && impact.m_impactDistance > maxDistance - RAYCAST_IMPACT_TOLERANCE )
+				{
+					continue;
+				}
+			}
+
+			++numImpactMismatches;
+		}
+
+		// A batch has to give the same impacts as casting each ray on its own
+		for ( int rayIndex = 0; rayIndex < numRays / 3; ++rayIndex )
+		{
+			Vec2 start( g_game->m_rng->RollRandomFloatInRange( 0.f, (float)map.m_width ), g_game->m_rng->RollRandomFloatInRange( 0.f, (float)map.m_height ) );
+			float orientationDegrees = g_game->m_rng->RollRandomFloatInRange( 0.f, 360.f );
+			const Vec2 whiskerDirections[3] = { Vec2::MakeFromPolarDegrees( orientationDegrees ),
+												Vec2::MakeFromPolarDegrees( orientationDegrees + TANK_SIDE_WHISKER_ANGLE_DEGREES ),
+												Vec2::MakeFromPolarDegrees( orientationDegrees - TANK_SIDE_WHISKER_ANGLE_DEGREES ) };
+			const float whiskerLengths[3] = { TANK_MIDDLE_WHISKER_LENGTH, TANK_SIDE_WHISKER_LENGTH, TANK_SIDE_WHISKER_LENGTH };
+
+			RaycastImpact whiskerImpacts[3];
+			map.RaycastMany( start, 3, whiskerDirections, whiskerLengths, whiskerImpacts );
+			for ( int whiskerIndex = 0; whiskerIndex < 3; ++whiskerIndex )
+			{
+				RaycastImpact impact = map.Raycast( start, whiskerDirections[whiskerIndex], whiskerLengths[whiskerIndex] );
+				if ( impact.m_didImpact != whiskerImpacts[whiskerIndex].m_didImpact
+					 || impact.m_impactDistance != whiskerImpacts[whiskerIndex].m_impactDistance )
+				{
+					++numBatchMismatches;
+				}
+			}
+		}
+	}
+
+	g_devConsole->PrintString( Stringf( "Cast %i rays, %i impacts, %i corners the old marching stepped over", numRaysCast, numImpacts, numCornerClips ) );
+
+	if ( numImpactMismatches > 0
+		 || numBadNormals > 0
+		 || numBatchMismatches > 0 )
+	{
+		g_devConsole->PrintError( Stringf( "FAIL: %i impacts differ from the old marching, %i bad normals, %i batched rays differ",
+										   numImpactMismatches, numBadNormals, numBatchMismatches ) );
+		return false;
+	}
+
+	g_devConsole->PrintString( Stringf( "PASS: every impact within %.3f of the old marching", RAYCAST_IMPACT_TOLERANCE ), Rgba8::GREEN );
+	return false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Each tank update casts its whisker fan and, with the player in range, a line of sight check
+bool MapRaycastTest::RunRaycastBenchmark( EventArgs* args )
+{
+	int numTanks = args->GetValue( "numTanks", 128 );
+	int numFrames = args->GetValue( "numFrames", 600 );
+	int seed = args->GetValue( "seed", 0 );
+
+	// The biggest map
+	SeededMapTestFixture fixture;
+	Map& map = fixture.GenerateMap( NUM_MAPS - 1, seed );
+
+	std::vector<Vec2> tankPositions;
+	std::vector<float> tankOrientations;
+	while ( (int)tankPositions.size() < numTanks )
+	{
+		Vec2 position( g_game->m_rng->RollRandomFloatInRange( 0.f, (float)map.m_width ), g_game->m_rng->RollRandomFloatInRange( 0.f, (float)map.m_height ) );
+		if ( !map.IsPointInSolid( position ) )
+		{
+			tankPositions.push_back( position );
+			tankOrientations.push_back( g_game->m_rng->RollRandomFloatInRange( 0.f, 360.f ) );
+		}
+	}
+
+	const Vec2 playerPosition( PLAYER_START_X, PLAYER_START_Y );
+	const float whiskerLengths[3] = { TANK_MIDDLE_WHISKER_LENGTH, TANK_SIDE_WHISKER_LENGTH, TANK_SIDE_WHISKER_LENGTH };
+
+	int numRays = 0;
+	int numImpacts = 0;
+	double startTime = GetCurrentTimeSeconds();
+	for ( int frameIndex = 0; frameIndex < numFrames; ++frameIndex )
+	{
+		for ( int tankIndex = 0; tankIndex < numTanks; ++tankIndex )
+		{
+			const Vec2& tankPosition = tankPositions[tankIndex];
+			float orientationDegrees = tankOrientations[tankIndex] + (float)frameIndex;
+
+			float distanceToPlayer = GetDistance2D( tankPosition, playerPosition );
+			if ( distanceToPlayer < TANK_MAX_CHASE_RANGE )
+			{
+				RaycastImpact impact = map.VisionRaycast( tankPosition, GetNormalizedDirectionFromAToB( tankPosition, playerPosition ), distanceToPlayer );
+				numImpacts += impact.m_didImpact ? 1 : 0;
+				++numRays;
+			}
+
+			const Vec2 whiskerDirections[3] = { Vec2::MakeFromPolarDegrees( orientationDegrees ),
+												Vec2::MakeFromPolarDegrees( orientationDegrees + TANK_SIDE_WHISKER_ANGLE_DEGREES ),
+												Vec2::MakeFromPolarDegrees( orientationDegrees - TANK_SIDE_WHISKER_ANGLE_DEGREES ) };
+			RaycastImpact whiskerImpacts[3];
+			map.RaycastMany( tankPosition, 3, whiskerDirections, whiskerLengths, whiskerImpacts );
+			numImpacts += ( whiskerImpacts[0].m_didImpact ? 1 : 0 ) + ( whiskerImpacts[1].m_didImpact ? 1 : 0 ) + ( whiskerImpacts[2].m_didImpact ? 1 : 0 );
+			numRays += 3;
+		}
+	}
+	double seconds = GetCurrentTimeSeconds() - startTime;
+
+	int numLegacyImpacts = 0;
+	startTime = GetCurrentTimeSeconds();
+	for ( int frameIndex = 0; frameIndex < numFrames; ++frameIndex )
+	{
+		for ( int tankIndex = 0; tankIndex < numTanks; ++tankIndex )
+		{
+			const Vec2& tankPosition = tankPositions[tankIndex];
+			float orientationDegrees = tankOrientations[tankIndex] + (float)frameIndex;
+
+			float distanceToPlayer = GetDistance2D( tankPosition, playerPosition );
+			if ( distanceToPlayer < TANK_MAX_CHASE_RANGE )
+			{
+				RaycastImpact impact = LegacyRaycast( map, tankPosition, GetNormalizedDirectionFromAToB( tankPosition, playerPosition ), distanceToPlayer, true );
+				numLegacyImpacts += impact.m_didImpact ? 1 : 0;
+			}
+
+			for ( int whiskerIndex = 0; whiskerIndex < 3; ++whiskerIndex )
+			{
+				float whiskerOrientationDegrees = orientationDegrees + ( whiskerIndex == 0 ? 0.f : ( whiskerIndex == 1 ? TANK_SIDE_WHISKER_ANGLE_DEGREES : -TANK_SIDE_WHISKER_ANGLE_DEGREES ) );
+				RaycastImpact impact = LegacyRaycast( map, tankPosition, Vec2::MakeFromPolarDegrees( whiskerOrientationDegrees ), whiskerLengths[whiskerIndex], false );
+				numLegacyImpacts += impact.m_didImpact ? 1 : 0;
+			}
+		}
+	}
+	double legacySeconds = GetCurrentTimeSeconds() - startTime;
+
+	g_devConsole->PrintString( Stringf( "%i tanks for %i frames, %i rays, %i impacts (old marching %i)", numTanks, numFrames, numRays, numImpacts, numLegacyImpacts ) );
+	g_devConsole->PrintString( Stringf( "Grid traversal: %.1f ms, %.0f rays per second", seconds * 1000.0, (double)numRays / seconds ) );
+	g_devConsole->PrintString( Stringf( "Old marching:   %.1f ms, %.0f rays per second", legacySeconds * 1000.0, (double)numRays / legacySeconds ) );
+	return false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// The old raycast, samples the ray every LEGACY_RAYCAST_STEP_SIZE and stops at the first blocked sample
+RaycastImpact MapRaycastTest::LegacyRaycast( Map& map, const Vec2& start, const Vec2& forwardDirection, float maxDistance, bool onlyVisionBlockingTiles )
+{
+	for ( float raycastStep = 0; raycastStep < maxDistance; raycastStep += LEGACY_RAYCAST_STEP_SIZE )
+	{
+		Vec2 raycastPos = start + ( forwardDirection * raycastStep );
+
+		bool isBlocked = onlyVisionBlockingTiles ? map.IsPointInVisionBlockingSolid( raycastPos ) : map.IsPointInSolid( raycastPos );
+		if ( isBlocked )
+		{
+			return RaycastImpact( true, raycastPos, raycastStep );
+		}
+	}
+
+	return RaycastImpact( false, start + ( forwardDirection * maxDistance ), maxDistance );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// True if the ray crosses the tile it hit in less than one marching step, so sampling could skip it
+bool MapRaycastTest::IsCornerClip( const RaycastImpact& impact, const Vec2& forwardDirection )
+{
+	IntVec2 tileCoords = GetImpactTileCoords( impact );
+
+	// Distance along the ray to each far edge of the tile
+	float distanceToExitX = 99999999.f;
+	if ( forwardDirection.x != 0.f )
+	{
+		float exitX = forwardDirection.x > 0.f ? (float)tileCoords.x + TILE_SIZE : (float)tileCoords.x;
+		distanceToExitX = ( exitX - impact.m_impactPosition.x ) / forwardDirection.x;
+	}
+
+	float distanceToExitY = 99999999.f;
+	if ( forwardDirection.y != 0.f )
+	{
+		float exitY = forwardDirection.y > 0.f ? (float)tileCoords.y + TILE_SIZE : (float)tileCoords.y;
+		distanceToExitY = ( exitY - impact.m_impactPosition.y ) / forwardDirection.y;
+	}
+
+	return Min( distanceToExitX, distanceToExitY ) < RAYCAST_IMPACT_TOLERANCE;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// The impact sits on the tile's edge, so step back across the normal to find which tile was hit.
+// A ray starting inside a blocking tile reports that tile.
+IntVec2 MapRaycastTest::GetImpactTileCoords( const RaycastImpact& impact )
+{
+	Vec2 insideTile = impact.m_impactPosition;
+	if ( impact.m_impactDistance > 0.f )
+	{
+		insideTile -= impact.m_impactSurfaceNormal * ( TILE_SIZE * .5f );
+	}
+
+	return IntVec2( (int)floorf( insideTile.x ), (int)floorf( insideTile.y ) );
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Game/RaycastImpact.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+class Map;
+struct Vec2;
+
+
+//-----------------------------------------------------------------------------------------------
+// Checks Map's grid traversal raycasts against the fixed step marching they replaced, on seeded maps
+// generated without a world or renderer
+class MapRaycastTest
+{
+public:
+	// Dev console, "test_raycast numRays=100000 seed=0"
+	static bool RunRaycastTest( EventArgs* args );
+
+	// Dev console, "benchmark_raycast numTanks=128 numFrames=600 seed=0"
+	static bool RunRaycastBenchmark( EventArgs* args );
+
+private:
+	static RaycastImpact	LegacyRaycast( Map& map, const Vec2& start, const Vec2& forwardDirection, float maxDistance, bool onlyVisionBlockingTiles );
+	static bool				IsCornerClip( const RaycastImpact& impact, const Vec2& forwardDirection );
+	static IntVec2			GetImpactTileCoords( const RaycastImpact& impact );
+};
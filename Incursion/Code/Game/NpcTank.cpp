@@ -55,7 +55,7 @@ void NpcTank::Update( float deltaSeconds )
 			ChaseTarget();
 			break;
 		case TankAIState::INVESTIGATE:
-			InvestigateTargetLastLocation();
+			InvestigateTarget();
 			break;
 	}
 
@@ -71,7 +71,15 @@ void NpcTank::Update( float deltaSeconds )
 		m_velocity = Vec2::MakeFromPolarDegrees( m_goalOrientation ) * TANK_MAX_SPEED;
 	}
 
-	AdjustForWalls();
+	// The flow field already steers around walls, so only feel for them otherwise
+	if ( m_aiState == TankAIState::INVESTIGATE )
+	{
+		m_middleWhisker = m_leftWhisker = m_rightWhisker = RaycastImpact( false, m_position );
+	}
+	else
+	{
+		AdjustForWalls();
+	}
 	
 	Entity::Update( deltaSeconds );
 
@@ -205,13 +213,12 @@ void NpcTank::ChaseTarget()
 	}
 
 	m_isMoving = IsPointInForwardSector2D( target->GetPosition(), m_position, m_orientationDegrees, TANK_CHASE_ANGLE_RANGE_DEGREES * 2.f, TANK_MAX_CHASE_RANGE );
-
-	m_targetLastLocation = target->GetPosition();
 }
 
 
 //-----------------------------------------------------------------------------------------------
-void NpcTank::InvestigateTargetLastLocation()
+// Follows the map's shared flow field toward the player, which already routes around walls
+void NpcTank::InvestigateTarget()
 {
 	Entity* target = m_map->GetPlayer();
 
@@ -221,16 +228,21 @@ void NpcTank::InvestigateTargetLastLocation()
 		return;
 	}
 
-	if (target->IsDead() 
-		|| GetDistance2D( m_position, m_targetLastLocation ) < .1f )
+	const FlowField& flowField = m_map->GetPlayerFlowField();
+	int distanceToTarget = flowField.GetDistanceToGoal( IntVec2( (int)m_position.x, (int)m_position.y ) );
+	if ( target->IsDead()
+		 || distanceToTarget == -1
+		 || distanceToTarget > TANK_MAX_INVESTIGATE_TILE_DISTANCE )
 	{
 		m_aiState = TankAIState::WANDER;
 		return;
 	}
 
-	Vec2 displacementToTarget = m_targetLastLocation - m_position;
-	float angleDisplacementToTargetDegrees = displacementToTarget.GetOrientationDegrees();
-	m_goalOrientation = angleDisplacementToTargetDegrees;
+	Vec2 steeringDirection = flowField.GetSteeringDirection( m_position );
+	if ( steeringDirection != Vec2::ZERO )
+	{
+		m_goalOrientation = steeringDirection.GetOrientationDegrees();
+	}
 
 	m_isMoving = true;
 }
@@ -239,9 +251,16 @@ void NpcTank::InvestigateTargetLastLocation()
 //-----------------------------------------------------------------------------------------------
 void NpcTank::AdjustForWalls()
 {
-	m_middleWhisker = m_map->Raycast( m_position, GetForwardVector(), TANK_MIDDLE_WHISKER_LENGTH );
-	m_leftWhisker = m_map->Raycast( m_position, Vec2::MakeFromPolarDegrees( m_orientationDegrees + TANK_SIDE_WHISKER_ANGLE_DEGREES ), TANK_SIDE_WHISKER_LENGTH );
-	m_rightWhisker = m_map->Raycast( m_position, Vec2::MakeFromPolarDegrees( m_orientationDegrees - TANK_SIDE_WHISKER_ANGLE_DEGREES ), TANK_SIDE_WHISKER_LENGTH );
+	const Vec2 whiskerDirections[3] = { GetForwardVector(),
+										Vec2::MakeFromPolarDegrees( m_orientationDegrees + TANK_SIDE_WHISKER_ANGLE_DEGREES ),
+										Vec2::MakeFromPolarDegrees( m_orientationDegrees - TANK_SIDE_WHISKER_ANGLE_DEGREES ) };
+	const float whiskerLengths[3] = { TANK_MIDDLE_WHISKER_LENGTH, TANK_SIDE_WHISKER_LENGTH, TANK_SIDE_WHISKER_LENGTH };
+
+	RaycastImpact whiskerImpacts[3];
+	m_map->RaycastMany( m_position, 3, whiskerDirections, whiskerLengths, whiskerImpacts );
+	m_middleWhisker = whiskerImpacts[0];
+	m_leftWhisker = whiskerImpacts[1];
+	m_rightWhisker = whiskerImpacts[2];
 	
 	if ( m_middleWhisker.m_didImpact )
 	{
@@ -38,7 +38,7 @@ private:
 	void PopulateVertexes();
 	void Wander( float deltaSeconds );
 	void ChaseTarget();
-	void InvestigateTargetLastLocation();
+	void InvestigateTarget();
 	void AdjustForWalls();
 
 private:
@@ -46,7 +46,6 @@ private:
 	TankAIState		m_aiState = TankAIState::WANDER;
 	float			m_wanderDirectionChangeCooldown = 0.f;
 	float			m_shotCooldown = 0.f;
-	Vec2			m_targetLastLocation = Vec2::ZERO;
 
 	// Physics
 	float			m_goalOrientation = 0.f;
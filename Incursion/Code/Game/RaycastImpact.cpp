@@ -2,8 +2,10 @@
 
 
 //-----------------------------------------------------------------------------------------------
-RaycastImpact::RaycastImpact( bool didImpact, const Vec2& impactPosition )
+RaycastImpact::RaycastImpact( bool didImpact, const Vec2& impactPosition, float impactDistance, const Vec2& impactSurfaceNormal )
 	: m_didImpact( didImpact )
 	, m_impactPosition( impactPosition )
+	, m_impactDistance( impactDistance )
+	, m_impactSurfaceNormal( impactSurfaceNormal )
 {
 }
@@ -8,8 +8,10 @@ struct RaycastImpact
 public:
 	bool m_didImpact = false;
 	Vec2 m_impactPosition = Vec2::ZERO;
+	float m_impactDistance = 0.f;
+	Vec2 m_impactSurfaceNormal = Vec2::ZERO;
 
 public:
 	RaycastImpact() {} // Do nothing default constructor
-	explicit RaycastImpact( bool didImpact, const Vec2& impactPosition );
+	explicit RaycastImpact( bool didImpact, const Vec2& impactPosition, float impactDistance = 0.f, const Vec2& impactSurfaceNormal = Vec2::ZERO );
 };
@@ -0,0 +1,46 @@
+#include "Game/SeededMapTestFixture.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Game.hpp"
+#include "Game/World.hpp"
+#include "Game/Map.hpp"
+#include "Game/MapDefinition.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+SeededMapTestFixture::SeededMapTestFixture()
+	: m_savedRng( *g_game->m_rng )
+{
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Don't disturb the rolls of the game in progress
+//-----------------------------------------------------------------------------------------------
+SeededMapTestFixture::~SeededMapTestFixture()
+{
+	PTR_SAFE_DELETE( m_map );
+
+	*g_game->m_rng = m_savedRng;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+MapDefinition SeededMapTestFixture::CreateMapDefinition( int mapIndex, int seed )
+{
+	g_game->m_rng->Reset( (unsigned int)seed );
+	return World::CreateMapDefinition( mapIndex );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+Map& SeededMapTestFixture::GenerateMap( int mapIndex, int seed )
+{
+	PTR_SAFE_DELETE( m_map );
+
+	MapDefinition mapDefinition = CreateMapDefinition( mapIndex, seed );
+	m_map = new Map( mapDefinition.m_dimensions );
+	m_map->PopulateTiles( mapDefinition );
+
+	return *m_map;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "Engine/Math/RandomNumberGenerator.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+class Map;
+struct MapDefinition;
+
+
+//-----------------------------------------------------------------------------------------------
+// Shared setup for the dev console map tests. Generates maps from a seed without a world or renderer,
+// and puts the game's rng back the way it was when the fixture goes out of scope.
+class SeededMapTestFixture
+{
+public:
+	SeededMapTestFixture();
+	~SeededMapTestFixture();
+
+	SeededMapTestFixture( const SeededMapTestFixture& other ) = delete;
+	SeededMapTestFixture& operator=( const SeededMapTestFixture& other ) = delete;
+
+	// Reseeds the game's rng, everything rolled afterwards follows from the seed
+	MapDefinition	CreateMapDefinition( int mapIndex, int seed );
+
+	// Replaces the previously generated map, which is owned by the fixture
+	Map&			GenerateMap( int mapIndex, int seed );
+
+private:
+	RandomNumberGenerator m_savedRng;
+	Map* m_map = nullptr;
+};
@@ -1,4 +1,5 @@
 #include "Game/World.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Game/Game.hpp"
 #include "Game/Map.hpp"
@@ -75,40 +76,56 @@ void World::GenerateMaps()
 	m_maps.clear();
 	m_curMap = nullptr;
 
-	// Map 1
-	std::vector<TileWorm> tileWorms1
+	// Each definition rolls its entity counts right before its map is built
+	for ( int mapIndex = 0; mapIndex < NUM_MAPS; ++mapIndex )
 	{
-		TileWorm( TILE_TYPE_MUD, MAP1_MUD_WORM_COUNT, MAP1_MUD_WORM_LENGTH ),
-		TileWorm( TILE_TYPE_STONE, MAP1_STONE1_WORM_COUNT, MAP1_STONE1_WORM_LENGTH ),
-		TileWorm( TILE_TYPE_STONE, MAP1_STONE2_WORM_COUNT, MAP1_STONE2_WORM_LENGTH )
-	};
+		BuildNewMap( CreateMapDefinition( mapIndex ) );
+	}
+}
 
-	MapEntityDefinition map1EntityDef;
-	map1EntityDef.m_numNPCTanks = g_game->m_rng->RollRandomIntInRange( MAP1_MIN_TANK_COUNT, MAP1_MAX_TANK_COUNT );
-	map1EntityDef.m_numNPCTurrets = g_game->m_rng->RollRandomIntInRange( MAP1_MIN_TURRET_COUNT, MAP1_MAX_TURRET_COUNT );
-	map1EntityDef.m_numBoulders = g_game->m_rng->RollRandomIntInRange( MAP1_MIN_BOULDER_COUNT, MAP1_MAX_BOULDER_COUNT );
 
-	MapDefinition mapDef1( IntVec2( MAP1_WIDTH, MAP1_HEIGHT ), TILE_TYPE_GRASS, TILE_TYPE_STONE, TILE_TYPE_GRASS, TILE_TYPE_GRASS, TILE_TYPE_STONE, tileWorms1, map1EntityDef );
-	BuildNewMap( mapDef1 );
+//-----------------------------------------------------------------------------------------------
+MapDefinition World::CreateMapDefinition( int mapIndex )
+{
+	GUARANTEE_OR_DIE( mapIndex >= 0 && mapIndex < NUM_MAPS, "Tried to create a definition for a map that doesn't exist" );
 
-	// Map 2
-	std::vector<TileWorm> tileWorms2
+	if ( mapIndex == 0 )
 	{
-		TileWorm( TILE_TYPE_WET_SAND, MAP2_WET_SAND_WORM_COUNT, MAP2_WET_SAND_WORM_LENGTH ),
-		TileWorm( TILE_TYPE_CONCRETE, MAP2_CONCRETE_WORM_COUNT, MAP2_CONCRETE_WORM_LENGTH ),
-		TileWorm( TILE_TYPE_WATER, MAP2_WATER1_WORM_COUNT, MAP2_WATER1_WORM_LENGTH ),
-		TileWorm( TILE_TYPE_WATER, MAP2_WATER2_WORM_COUNT, MAP2_WATER2_WORM_LENGTH )
-	};
-
-	MapEntityDefinition map2EntityDef;
-	map2EntityDef.m_numNPCTanks = g_game->m_rng->RollRandomIntInRange( MAP2_MIN_TANK_COUNT, MAP2_MAX_TANK_COUNT );
-	map2EntityDef.m_numNPCTurrets = g_game->m_rng->RollRandomIntInRange( MAP2_MIN_TURRET_COUNT, MAP2_MAX_TURRET_COUNT );
-	map2EntityDef.m_numBoulders = g_game->m_rng->RollRandomIntInRange( MAP2_MIN_BOULDER_COUNT, MAP2_MAX_BOULDER_COUNT );
+		std::vector<TileWorm> tileWorms1
+		{
+			TileWorm( TILE_TYPE_MUD, MAP1_MUD_WORM_COUNT, MAP1_MUD_WORM_LENGTH ),
+			TileWorm( TILE_TYPE_STONE, MAP1_STONE1_WORM_COUNT, MAP1_STONE1_WORM_LENGTH ),
+			TileWorm( TILE_TYPE_STONE, MAP1_STONE2_WORM_COUNT, MAP1_STONE2_WORM_LENGTH )
+		};
+
+		MapEntityDefinition map1EntityDef;
+		map1EntityDef.m_numNPCTanks = g_game->m_rng->RollRandomIntInRange( MAP1_MIN_TANK_COUNT, MAP1_MAX_TANK_COUNT );
+		map1EntityDef.m_numNPCTurrets = g_game->m_rng->RollRandomIntInRange( MAP1_MIN_TURRET_COUNT, MAP1_MAX_TURRET_COUNT );
+		map1EntityDef.m_numBoulders = g_game->m_rng->RollRandomIntInRange( MAP1_MIN_BOULDER_COUNT, MAP1_MAX_BOULDER_COUNT );
+
+		MapDefinition mapDef1( IntVec2( MAP1_WIDTH, MAP1_HEIGHT ), TILE_TYPE_GRASS, TILE_TYPE_STONE, TILE_TYPE_GRASS, TILE_TYPE_GRASS, TILE_TYPE_STONE, tileWorms1, map1EntityDef );
+		return mapDef1;
+	}
 
-	MapDefinition mapDef2( IntVec2( MAP2_WIDTH, MAP2_HEIGHT ), TILE_TYPE_SAND, TILE_TYPE_WATER, TILE_TYPE_SAND, TILE_TYPE_SAND, TILE_TYPE_CONCRETE, tileWorms2, map2EntityDef );
-	BuildNewMap( mapDef2 );
+	if ( mapIndex == 1 )
+	{
+		std::vector<TileWorm> tileWorms2
+		{
+			TileWorm( TILE_TYPE_WET_SAND, MAP2_WET_SAND_WORM_COUNT, MAP2_WET_SAND_WORM_LENGTH ),
+			TileWorm( TILE_TYPE_CONCRETE, MAP2_CONCRETE_WORM_COUNT, MAP2_CONCRETE_WORM_LENGTH ),
+			TileWorm( TILE_TYPE_WATER, MAP2_WATER1_WORM_COUNT, MAP2_WATER1_WORM_LENGTH ),
+			TileWorm( TILE_TYPE_WATER, MAP2_WATER2_WORM_COUNT, MAP2_WATER2_WORM_LENGTH )
+		};
+
+		MapEntityDefinition map2EntityDef;
+		map2EntityDef.m_numNPCTanks = g_game->m_rng->RollRandomIntInRange( MAP2_MIN_TANK_COUNT, MAP2_MAX_TANK_COUNT );
+		map2EntityDef.m_numNPCTurrets = g_game->m_rng->RollRandomIntInRange( MAP2_MIN_TURRET_COUNT, MAP2_MAX_TURRET_COUNT );
+		map2EntityDef.m_numBoulders = g_game->m_rng->RollRandomIntInRange( MAP2_MIN_BOULDER_COUNT, MAP2_MAX_BOULDER_COUNT );
+
+		MapDefinition mapDef2( IntVec2( MAP2_WIDTH, MAP2_HEIGHT ), TILE_TYPE_SAND, TILE_TYPE_WATER, TILE_TYPE_SAND, TILE_TYPE_SAND, TILE_TYPE_CONCRETE, tileWorms2, map2EntityDef );
+		return mapDef2;
+	}
 
-	// Map 3
 	std::vector<TileWorm> tileWorms3
 	{
 		TileWorm( TILE_TYPE_WOOD, MAP3_WOOD1_WORM_COUNT, MAP3_WOOD1_WORM_LENGTH ),
@@ -121,7 +138,7 @@ void World::GenerateMaps()
 	map3EntityDef.m_numBoulders = g_game->m_rng->RollRandomIntInRange( MAP3_MIN_BOULDER_COUNT, MAP3_MAX_BOULDER_COUNT );
 
 	MapDefinition mapDef3( IntVec2( MAP3_WIDTH, MAP3_HEIGHT ), TILE_TYPE_PURPLE_BRICK, TILE_TYPE_WOOD, TILE_TYPE_PURPLE_BRICK, TILE_TYPE_PURPLE_BRICK, TILE_TYPE_WOOD, tileWorms3, map3EntityDef );
-	BuildNewMap( mapDef3 );
+	return mapDef3;
 }
 
 
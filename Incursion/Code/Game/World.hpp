@@ -8,6 +8,10 @@ class Player;
 struct MapDefinition;
 
 
+//-----------------------------------------------------------------------------------------------
+constexpr int NUM_MAPS = 3;
+
+
 //-----------------------------------------------------------------------------------------------
 class World
 {
@@ -26,6 +30,9 @@ public:
 
 	Player* GetPlayer() const;
 
+	// Rolls the map's entity counts with the game's rng
+	static MapDefinition CreateMapDefinition( int mapIndex );
+
 private:
 	void BuildNewMap( const MapDefinition& mapDefinition );
 
@@ -14,6 +14,7 @@
 #include "Engine/Core/FileUtils.hpp"
 #include "Engine/Core/Image.hpp"
 #include "Engine/Core/NamedStrings.hpp"
+#include "Engine/Core/ObjLoader.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/TextBox.hpp"
 #include "Engine/Core/TWSMUtils.hpp"
@@ -64,7 +65,9 @@ void Game::Startup()
 
 	g_eventSystem->RegisterMethodEvent( "load_obj_file", "Usage: load_obj_file path=<filepath relative to Run/Data/>", eUsageLocation::DEV_CONSOLE, this, &Game::LoadObjFile );
 	g_eventSystem->RegisterMethodEvent( "load_twsm_file", "Usage: load_twsm_file path=<filepath relative to Run/Data/>", eUsageLocation::DEV_CONSOLE, this, &Game::LoadTWSMFile );
-	g_eventSystem->RegisterMethodEvent( "save_twsm_file", "Usage: save_twsm_file path=<filepath relative to Run/Data/>", eUsageLocation::DEV_CONSOLE, this, &Game::SaveTWSMFile );
+	g_eventSystem->RegisterMethodEvent( "save_twsm_file", "Usage: save_twsm_file path=<filepath relative to Run/Data/> quantize=<bool>", eUsageLocation::DEV_CONSOLE, this, &Game::SaveTWSMFile );
+	g_eventSystem->RegisterMethodEvent( "benchmark_clean_mesh", "Usage: benchmark_clean_mesh folder=<folder relative to Run/Data/> epsilon=NUMBER. Time welding every obj in the folder", eUsageLocation::DEV_CONSOLE, this, &Game::BenchmarkCleanMesh );
+	g_eventSystem->RegisterMethodEvent( "test_obj_parse_threads", "Usage: test_obj_parse_threads numThreads=NUMBER. Check that an obj with malformed lines loads the same on 1 and numThreads threads", eUsageLocation::DEV_CONSOLE, this, &Game::TestObjParseThreads );
 	//g_eventSystem->DeRegisterObject( this );
 
 	g_inputSystem->PushMouseOptions( CURSOR_RELATIVE, false, true );
@@ -900,6 +903,7 @@ void Game::LoadObjFile( EventArgs* args )
 
 	m_cpuMesh = new CPUMesh( vertices, indices );
 	m_gpuMesh = new GPUMesh( g_renderer, vertices, indices );
+	m_twsmFilePath.clear();
 	m_meshTransform.SetPosition( Vec3( 0.f, 0.f, -2.f ) );
 }
 
@@ -930,7 +934,8 @@ void Game::LoadTWSMFile( EventArgs* args )
 		return;
 	}
 
-	CPUMesh* newMesh = LoadTWSMFileIntoCPUMesh( "Data/" + modelPath );
+	// Vertices go from the mapped file straight to the GPU, the cpu copy is only built if the mesh gets saved
+	GPUMesh* newMesh = LoadTWSMFileIntoGPUMesh( g_renderer, "Data/" + modelPath );
 	if ( newMesh == nullptr )
 	{
 		return;
@@ -939,8 +944,8 @@ void Game::LoadTWSMFile( EventArgs* args )
 	PTR_SAFE_DELETE( m_cpuMesh );
 	PTR_SAFE_DELETE( m_gpuMesh );
 	
-	m_cpuMesh = newMesh;
-	m_gpuMesh = new GPUMesh( g_renderer, *m_cpuMesh );
+	m_gpuMesh = newMesh;
+	m_twsmFilePath = "Data/" + modelPath;
 }
 
 
@@ -970,5 +975,139 @@ void Game::SaveTWSMFile( EventArgs* args )
 		return;
 	}
 
-	SaveMeshAsTWSMFile( *m_cpuMesh, "Data/" + modelPath );
+	TWSMSaveOptions saveOptions;
+	saveOptions.quantizeVertices = args->GetValue( "quantize", false );
+
+	if ( m_cpuMesh == nullptr
+		 && !m_twsmFilePath.empty() )
+	{
+		m_cpuMesh = LoadTWSMFileIntoCPUMesh( m_twsmFilePath );
+	}
+
+	if ( m_cpuMesh == nullptr )
+	{
+		g_devConsole->PrintError( "No mesh loaded to save" );
+		return;
+	}
+
+	SaveMeshAsTWSMFile( *m_cpuMesh, "Data/" + modelPath, saveOptions );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Game::BenchmarkCleanMesh( EventArgs* args )
+{
+	std::string folderPath = "Data/" + args->GetValue( "folder", "Models" );
+	float positionEpsilon = args->GetValue( "epsilon", .0001f );
+
+	Strings objFiles = GetFileNamesInFolder( folderPath, "*.obj" );
+	if ( objFiles.empty() )
+	{
+		g_devConsole->PrintError( Stringf( "No obj files found in '%s'", folderPath.c_str() ) );
+		return;
+	}
+
+	MeshImportOptions importOptions;
+	importOptions.generateNormals = true;
+	importOptions.generateTangents = true;
+
+	double totalSeconds = 0.0;
+	for ( int fileIdx = 0; fileIdx < (int)objFiles.size(); ++fileIdx )
+	{
+		std::vector<Vertex_PCUTBN> vertices;
+		std::vector<uint> indices;
+		AppendVertsForObjMeshFromFile( vertices, folderPath + "/" + objFiles[fileIdx], importOptions );
+
+		int numVerticesBefore = (int)vertices.size();
+
+		double startTime = GetCurrentTimeSeconds();
+		ObjLoader::CleanMesh( vertices, indices, positionEpsilon );
+		double elapsedSeconds = GetCurrentTimeSeconds() - startTime;
+		totalSeconds += elapsedSeconds;
+
+		g_devConsole->PrintString( Stringf( "%s: %d verts welded to %d in %.3f ms", 
+											objFiles[fileIdx].c_str(),
+											numVerticesBefore,
+											(int)vertices.size(),
+											elapsedSeconds * 1000.0 ) );
+	}
+
+	g_devConsole->PrintString( Stringf( "Cleaned %d meshes in %.3f ms", (int)objFiles.size(), totalSeconds * 1000.0 ), Rgba8::GREEN );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Game::TestObjParseThreads( EventArgs* args )
+{
+	int numThreads = args->GetValue( "numThreads", 4 );
+	std::string testFilePath = "Data/ObjParseThreadsTest.obj";
+
+	// The loader only splits off a section per megabyte, so write enough for every thread to get one.
+	// Relative face indices make each section depend on the v/vt/vn counts of the sections before it,
+	// and the lines every so often are ones that must not change those counts, or add to them consistently.
+	std::string objText;
+	int triangleNum = 0;
+	while ( objText.size() < (size_t)numThreads * 1024 * 1024 )
+	{
+		if ( triangleNum % 100 == 0 )
+		{
+			objText += "vt 0.25\n";
+			objText += "vt 0.1 0.2 0.3 0.4\n";
+			objText += "vtx 0.5 0.5\n";
+			objText += "vnx 0 1 0\n";
+			objText += "v\n";
+		}
+
+		for ( int vertNum = 0; vertNum < 3; ++vertNum )
+		{
+			float value = (float)( triangleNum * 3 + vertNum );
+			objText += Stringf( "v %.2f %.2f %.2f\n", value, value * .5f, -value );
+			objText += Stringf( "vt %.4f %.4f\n", fmodf( value * .001f, 1.f ), fmodf( value * .003f, 1.f ) );
+			objText += Stringf( "vn %.4f %.4f %.4f\n", fmodf( value * .01f, 1.f ), 1.f, 0.f );
+		}
+
+		objText += "f -3/-3/-3 -2/-2/-2 -1/-1/-1\n";
+		++triangleNum;
+	}
+
+	if ( !WriteBufferToFile( testFilePath, (byte*)objText.data(), (uint32_t)objText.size() ) )
+	{
+		g_devConsole->PrintError( Stringf( "Couldn't write '%s'", testFilePath.c_str() ) );
+		return;
+	}
+
+	std::vector<Vertex_PCUTBN> serialVertices;
+	std::vector<Vertex_PCUTBN> parallelVertices;
+	bool fileHadNormals = false;
+	ObjLoader::LoadFromFile( serialVertices, testFilePath, fileHadNormals, 1 );
+	ObjLoader::LoadFromFile( parallelVertices, testFilePath, fileHadNormals, numThreads );
+	remove( testFilePath.c_str() );
+
+	if ( serialVertices.size() != parallelVertices.size() )
+	{
+		g_devConsole->PrintError( Stringf( "Obj parse thread test failed: %d verts on 1 thread, %d on %d threads", 
+										   (int)serialVertices.size(), (int)parallelVertices.size(), numThreads ) );
+		return;
+	}
+
+	int numMismatches = 0;
+	for ( int vertIdx = 0; vertIdx < (int)serialVertices.size(); ++vertIdx )
+	{
+		const Vertex_PCUTBN& serialVertex = serialVertices[vertIdx];
+		const Vertex_PCUTBN& parallelVertex = parallelVertices[vertIdx];
+		if ( serialVertex.position != parallelVertex.position
+			 || serialVertex.uvTexCoords != parallelVertex.uvTexCoords
+			 || serialVertex.normal != parallelVertex.normal )
+		{
+			++numMismatches;
+		}
+	}
+
+	if ( numMismatches > 0 )
+	{
+		g_devConsole->PrintError( Stringf( "Obj parse thread test failed: %d of %d verts differ between 1 and %d threads", numMismatches, (int)serialVertices.size(), numThreads ) );
+		return;
+	}
+
+	g_devConsole->PrintString( Stringf( "Obj parse thread test passed: %d triangles load the same on 1 and %d threads", triangleNum, numThreads ), Rgba8::GREEN );
 }
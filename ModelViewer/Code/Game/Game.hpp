@@ -125,6 +125,8 @@ public:
 	void		LoadObjFile( EventArgs* args );
 	void		LoadTWSMFile( EventArgs* args );
 	void		SaveTWSMFile( EventArgs* args );
+	void		BenchmarkCleanMesh( EventArgs* args );
+	void		TestObjParseThreads( EventArgs* args );
 	
 public:
 	RandomNumberGenerator* m_rng = nullptr;
@@ -192,8 +194,9 @@ private:
 	Camera* m_uiCamera = nullptr;
 	
 	// Meshes
-	CPUMesh* m_cpuMesh = nullptr;
+	CPUMesh* m_cpuMesh = nullptr;						// Null when the mesh came from a twsm file, loaded on demand for saving
 	GPUMesh* m_gpuMesh = nullptr;
+	std::string m_twsmFilePath;
 	Transform m_meshTransform;
 	
 	Rgba8 m_ambientColor = Rgba8::WHITE;
@@ -0,0 +1,11 @@
+#include "Game/Block.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+void Block::SetType( unsigned char type )
+{
+	m_type = type;
+
+	// Keep any per-block bits and replace only the ones owned by the definition
+	m_bitFlags = (unsigned char)( ( m_bitFlags & ~BLOCK_DEFINITION_BITS_MASK ) | BlockDefinition::s_definitions[type].GetBits() );
+}
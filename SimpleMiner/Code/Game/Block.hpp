@@ -1,10 +1,27 @@
 #pragma once
+#include "Game/BlockDefinition.hpp"
+
+
 //-----------------------------------------------------------------------------------------------
+// Per-block state is kept to 2 bytes, the definition bits are copied in when the type changes
+// so hot loops can test a block without touching the definition table at all
 class Block
 {
 public:
-	void SetType( unsigned char type )		{ m_type = type; }
+	void SetType( unsigned char type );
+
+	unsigned char			GetType() const											{ return m_type; }
+	const BlockDefinition&	GetDefinition() const									{ return BlockDefinition::GetDefinition( m_type ); }
+
+	bool IsVisible() const															{ return ( m_bitFlags & BLOCK_BIT_IS_VISIBLE ) != 0; }
+	bool IsSolid() const															{ return ( m_bitFlags & BLOCK_BIT_IS_SOLID ) != 0; }
+	bool IsOpaque() const															{ return ( m_bitFlags & BLOCK_BIT_IS_OPAQUE ) != 0; }
+
+	bool IsBitSet( unsigned char bit ) const										{ return ( m_bitFlags & bit ) != 0; }
+	void SetBit( unsigned char bit )												{ m_bitFlags |= bit; }
+	void ClearBit( unsigned char bit )												{ m_bitFlags &= ~bit; }
 
 private:
 	unsigned char m_type = 0;
+	unsigned char m_bitFlags = 0;
 };
@@ -1,21 +1,91 @@
 #include "Game/BlockDefinition.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Renderer/SpriteSheet.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
-std::vector<BlockDefinition> BlockDefinition::s_blockDefs;
+BlockDefinition BlockDefinition::s_definitions[MAX_BLOCK_DEFINITIONS];
+std::string BlockDefinition::s_names[MAX_BLOCK_DEFINITIONS];
+int BlockDefinition::s_numDefinitions = 0;
 
 
 //-----------------------------------------------------------------------------------------------
-BlockDefinition::BlockDefinition( const std::string& name )
-	: m_name( name )
+static AABB2 GetSpriteUVs( const SpriteSheet& spriteSheet, const IntVec2& spriteCoords )
 {
-	AddToVector( *this );
+	AABB2 uvs;
+	spriteSheet.GetSpriteUVs( uvs.mins, uvs.maxs, spriteCoords );
+	return uvs;
 }
 
 
 //-----------------------------------------------------------------------------------------------
-void BlockDefinition::AddToVector( const BlockDefinition& blockDef )
+void BlockDefinition::LoadDefinitionsFromXml( const char* filePath, const SpriteSheet& spriteSheet )
 {
-	s_blockDefs.push_back( blockDef );
+	XmlDocument doc;
+	XmlError loadError = doc.LoadFile( filePath );
+	if ( loadError != tinyxml2::XML_SUCCESS )
+	{
+		ERROR_AND_DIE( Stringf( "The blocks xml file '%s' could not be opened.", filePath ) );
+	}
+
+	for ( int typeIdx = 0; typeIdx < MAX_BLOCK_DEFINITIONS; ++typeIdx )
+	{
+		s_definitions[typeIdx] = BlockDefinition();
+		s_names[typeIdx].clear();
+	}
+	s_numDefinitions = 0;
+
+	// Block types are assigned in file order, so the first definition (air) becomes type 0
+	XmlElement* root = doc.RootElement();
+	XmlElement* element = root->FirstChildElement();
+	while ( element )
+	{
+		GUARANTEE_OR_DIE( s_numDefinitions < MAX_BLOCK_DEFINITIONS, Stringf( "'%s' defines more than %d blocks", filePath, MAX_BLOCK_DEFINITIONS ) );
+
+		unsigned char type = (unsigned char)s_numDefinitions;
+		s_names[type] = ParseXmlAttribute( *element, "name", "" );
+		GUARANTEE_OR_DIE( s_names[type] != "", "Block did not have a name attribute" );
+
+		s_definitions[type] = BlockDefinition( *element, spriteSheet, type );
+		++s_numDefinitions;
+
+		element = element->NextSiblingElement();
+	}
 }
 
+
+//-----------------------------------------------------------------------------------------------
+bool BlockDefinition::GetTypeFromName( const std::string& name, unsigned char& out_type )
+{
+	for ( int typeIdx = 0; typeIdx < s_numDefinitions; ++typeIdx )
+	{
+		if ( s_names[typeIdx] == name )
+		{
+			out_type = (unsigned char)typeIdx;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+BlockDefinition::BlockDefinition( const XmlElement& blockDefElem, const SpriteSheet& spriteSheet, unsigned char type )
+	: m_type( type )
+{
+	if ( ParseXmlAttribute( blockDefElem, "isVisible", true ) )		{ m_bits |= BLOCK_BIT_IS_VISIBLE; }
+	if ( ParseXmlAttribute( blockDefElem, "isSolid", false ) )		{ m_bits |= BLOCK_BIT_IS_SOLID; }
+	if ( ParseXmlAttribute( blockDefElem, "isOpaque", true ) )		{ m_bits |= BLOCK_BIT_IS_OPAQUE; }
+
+	// Side and bottom fall back to the top sprite so single texture blocks only need one attribute
+	IntVec2 topCoords = ParseXmlAttribute( blockDefElem, "topSpriteCoords", IntVec2::ZERO );
+	IntVec2 sideCoords = ParseXmlAttribute( blockDefElem, "sideSpriteCoords", topCoords );
+	IntVec2 bottomCoords = ParseXmlAttribute( blockDefElem, "bottomSpriteCoords", topCoords );
+
+	m_uvTop = GetSpriteUVs( spriteSheet, topCoords );
+	m_uvSide = GetSpriteUVs( spriteSheet, sideCoords );
+	m_uvBottom = GetSpriteUVs( spriteSheet, bottomCoords );
+}
@@ -1,30 +1,68 @@
 #pragma once
-#include "Engine/Math/Vec2.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Math/AABB2.hpp"
 
 #include <string>
-#include <vector>
 
 
 //-----------------------------------------------------------------------------------------------
+class SpriteSheet;
+
+
+//-----------------------------------------------------------------------------------------------
+constexpr int MAX_BLOCK_DEFINITIONS = 256;
+
+
+//-----------------------------------------------------------------------------------------------
+// Flags that come from a block's definition, copied into each Block when its type is set
+enum eBlockDefinitionBit : unsigned char
+{
+	BLOCK_BIT_IS_VISIBLE	= BIT_FLAG( 0 ),
+	BLOCK_BIT_IS_SOLID		= BIT_FLAG( 1 ),
+	BLOCK_BIT_IS_OPAQUE		= BIT_FLAG( 2 ),
+};
+typedef unsigned char eBlockDefinitionBits;
+
+constexpr eBlockDefinitionBits BLOCK_DEFINITION_BITS_MASK = BLOCK_BIT_IS_VISIBLE | BLOCK_BIT_IS_SOLID | BLOCK_BIT_IS_OPAQUE;
+
+
+//-----------------------------------------------------------------------------------------------
+// Flyweight shared by every block of a type, indexed directly by Block::m_type.
+// Only the data the mesher needs lives in the table entries, names are kept in a separate array
+// so the whole table stays small enough to remain cache resident while building chunks.
 class BlockDefinition
 {
 public:
-	BlockDefinition( const std::string& name );
+	BlockDefinition() = default;
+	explicit BlockDefinition( const XmlElement& blockDefElem, const SpriteSheet& spriteSheet, unsigned char type );
 
-private:
-	// TEMP
-	void AddToVector( const BlockDefinition& blockDef );
+	unsigned char			GetType() const											{ return m_type; }
+	const std::string&		GetName() const											{ return s_names[m_type]; }
+	eBlockDefinitionBits	GetBits() const											{ return m_bits; }
 
-private:
-	std::string m_name;
+	bool					IsVisible() const										{ return ( m_bits & BLOCK_BIT_IS_VISIBLE ) != 0; }
+	bool					IsSolid() const											{ return ( m_bits & BLOCK_BIT_IS_SOLID ) != 0; }
+	bool					IsOpaque() const										{ return ( m_bits & BLOCK_BIT_IS_OPAQUE ) != 0; }
 
-	bool m_isVisible = true;
-	bool m_isSolid = false;
-	bool m_isOpaque = true;
+	const AABB2&			GetTopUVs() const										{ return m_uvTop; }
+	const AABB2&			GetSideUVs() const										{ return m_uvSide; }
+	const AABB2&			GetBottomUVs() const									{ return m_uvBottom; }
 
-	Vec2 m_uvTop;
-	Vec2 m_uvSide;
-	Vec2 m_uvBottom;
+	static void						LoadDefinitionsFromXml( const char* filePath, const SpriteSheet& spriteSheet );
+	static const BlockDefinition&	GetDefinition( unsigned char type )				{ return s_definitions[type]; }
+	static bool						GetTypeFromName( const std::string& name, unsigned char& out_type );
+
+public:
+	static BlockDefinition	s_definitions[MAX_BLOCK_DEFINITIONS];
+	static std::string		s_names[MAX_BLOCK_DEFINITIONS];
+	static int				s_numDefinitions;
+
+private:
+	unsigned char			m_type = 0;
+	eBlockDefinitionBits	m_bits = 0;
 
-	static std::vector<BlockDefinition> s_blockDefs;
+	AABB2 m_uvTop = AABB2::ONE_BY_ONE;
+	AABB2 m_uvSide = AABB2::ONE_BY_ONE;
+	AABB2 m_uvBottom = AABB2::ONE_BY_ONE;
 };
@@ -28,6 +28,16 @@ Chunk::~Chunk()
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void Chunk::Update()
+{
+	if ( m_isMeshDirty )
+	{
+		RebuildMesh();
+	}
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void Chunk::Render() const
 {
@@ -42,10 +52,32 @@ void Chunk::DebugRender() const
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void Chunk::SetBlockType( int blockIdx, unsigned char type )
+{
+	m_blocks[blockIdx].SetType( type );
+	m_isMeshDirty = true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+Vec3 Chunk::GetBlockWorldMins( int blockIdx ) const
+{
+	int localX = blockIdx % CHUNK_WIDTH;
+	int localY = ( blockIdx / CHUNK_WIDTH ) % CHUNK_LENGTH;
+	int localZ = blockIdx / NUM_BLOCKS_IN_CHUNK_LAYER;
+
+	return Vec3( (float)( m_worldCoords.x * CHUNK_WIDTH + localX ),
+				 (float)( m_worldCoords.y * CHUNK_LENGTH + localY ),
+				 (float)localZ );
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void Chunk::RebuildMesh()
 {
 	m_vertices.clear();
+	m_isMeshDirty = false;
 
 	for ( int blockIdx = 0; blockIdx < NUM_BLOCKS_IN_CHUNK; ++blockIdx )
 	{
@@ -57,9 +89,17 @@ void Chunk::RebuildMesh()
 //-----------------------------------------------------------------------------------------------
 void Chunk::PushBlockFaces( int blockIdx )
 {
+	const Block& block = m_blocks[blockIdx];
+	if ( !block.IsVisible() )
+	{
+		return;
+	}
+
+	const AABB2& bottomUVs = block.GetDefinition().GetBottomUVs();
+
 	// Bottom
-	m_vertices.emplace_back( Vec3( 0.f, 0.f, 0.f ), Rgba8::WHITE, Vec2::ZERO );
-	m_vertices.emplace_back( Vec3( 0.f, 1.f, 0.f ), Rgba8::WHITE, Vec2::ZERO_TO_ONE );
-	m_vertices.emplace_back( Vec3( 1.f, 1.f, 0.f ), Rgba8::WHITE, Vec2::ONE );
-	m_vertices.emplace_back( Vec3( 1.f, 0.f, 0.f ), Rgba8::WHITE, Vec2::ONE_ZERO );
+	m_vertices.emplace_back( Vec3( 0.f, 0.f, 0.f ), Rgba8::WHITE, bottomUVs.mins );
+	m_vertices.emplace_back( Vec3( 0.f, 1.f, 0.f ), Rgba8::WHITE, Vec2( bottomUVs.mins.x, bottomUVs.maxs.y ) );
+	m_vertices.emplace_back( Vec3( 1.f, 1.f, 0.f ), Rgba8::WHITE, bottomUVs.maxs );
+	m_vertices.emplace_back( Vec3( 1.f, 0.f, 0.f ), Rgba8::WHITE, Vec2( bottomUVs.maxs.x, bottomUVs.mins.y ) );
 }
@@ -13,9 +13,18 @@ public:
 	Chunk( const IntVec2& worldCoords, const AABB3& worldBounds );
 	~Chunk();
 
+	void Update();
 	void Render() const;
 	void DebugRender() const;
 
+	const IntVec2&	GetWorldCoords() const											{ return m_worldCoords; }
+	const Block&	GetBlock( int blockIdx ) const									{ return m_blocks[blockIdx]; }
+	void			SetBlockType( int blockIdx, unsigned char type );
+
+	Vec3			GetBlockWorldMins( int blockIdx ) const;
+
+	static int		GetBlockIndex( int localX, int localY, int localZ )				{ return localX + ( localY * CHUNK_WIDTH ) + ( localZ * NUM_BLOCKS_IN_CHUNK_LAYER ); }
+
 private:
 	void RebuildMesh();
 	void PushBlockFaces( int blockIdx );
@@ -27,4 +36,5 @@ private:
 	AABB3 m_worldBounds;
 
 	std::vector<Vertex_PCU> m_vertices;
+	bool m_isMeshDirty = false;
 };
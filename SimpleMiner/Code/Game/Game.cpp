@@ -30,9 +30,14 @@
 #include "Engine/Time/Time.hpp"
 
 #include "Game/GameCommon.hpp"
+#include "Game/BlockDefinition.hpp"
 #include "Game/World.hpp"
 
 
+//-----------------------------------------------------------------------------------------------
+SpriteSheet* g_tileSpriteSheet = nullptr;
+
+
 //-----------------------------------------------------------------------------------------------
 static float s_mouseSensitivityMultiplier = 1.f;
 static Vec3 s_ambientLightColor = Vec3( 1.f, 1.f, 1.f );
@@ -61,6 +66,7 @@ void Game::Startup()
 
 	g_eventSystem->RegisterEvent( "set_mouse_sensitivity", "Usage: set_mouse_sensitivity multiplier=NUMBER. Set the multiplier for mouse sensitivity.", eUsageLocation::DEV_CONSOLE, SetMouseSensitivity );
 	g_eventSystem->RegisterEvent( "light_set_ambient_color", "Usage: light_set_ambient_color color=r,g,b", eUsageLocation::DEV_CONSOLE, SetAmbientLightColor );
+	g_eventSystem->RegisterMethodEvent( "benchmark_raycasts", "Usage: benchmark_raycasts count=NUMBER maxDist=NUMBER. Time a batch of random raycasts through the world.", eUsageLocation::DEV_CONSOLE, this, &Game::BenchmarkRaycasts );
 
 	g_inputSystem->PushMouseOptions( CURSOR_RELATIVE, false, true );
 		
@@ -68,7 +74,6 @@ void Game::Startup()
 
 	m_gameClock = new Clock();
 	g_renderer->Setup( m_gameClock );
-	m_world = new World();
 
 	EnableDebugRendering();
 
@@ -77,6 +82,8 @@ void Game::Startup()
 
 	LoadAssets();
 
+	m_world = new World();
+
 	g_devConsole->PrintString( "Game Started", Rgba8::GREEN );
 }
 
@@ -141,6 +148,7 @@ void Game::InitializeMeshes()
 void Game::Shutdown()
 {
 	g_inputSystem->PushMouseOptions( CURSOR_ABSOLUTE, true, false );
+	g_eventSystem->DeRegisterObject( this );
 		
 	// Clean up member variables
 	PTR_SAFE_DELETE( m_testMaterial );
@@ -149,6 +157,7 @@ void Game::Shutdown()
 	PTR_SAFE_DELETE( m_cubeMesh );
 	PTR_SAFE_DELETE( m_sphereMesh );
 	PTR_SAFE_DELETE( m_world );
+	PTR_SAFE_DELETE( g_tileSpriteSheet );
 	PTR_SAFE_DELETE( m_gameClock );
 	PTR_SAFE_DELETE( m_rng );
 	PTR_SAFE_DELETE( m_debugInfoTextBox );
@@ -172,6 +181,10 @@ void Game::Update()
 		UpdateFromKeyboard();
 	}
 
+	UpdateBlockPicking();
+
+	m_world->Update( (float)m_gameClock->GetLastDeltaSeconds() );
+
 	UpdateDebugUI();
 
 	DebugAddWorldBasis( Mat44::IDENTITY, 0.f, DEBUG_RENDER_ALWAYS );
@@ -264,6 +277,46 @@ void Game::UpdateCameraTransform( float deltaSeconds )
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void Game::UpdateBlockPicking()
+{
+	Transform cameraTransform = m_worldCamera->GetTransform();
+	RaycastResult result = m_world->Raycast( cameraTransform.GetPosition(), cameraTransform.GetForwardVector(), BLOCK_PICKING_DIST );
+	if ( !result.didImpact )
+	{
+		return;
+	}
+
+	Vec3 impactBlockMins = result.impactChunk->GetBlockWorldMins( result.impactBlockIdx );
+	DebugAddWorldWireBounds( AABB3( impactBlockMins, impactBlockMins + Vec3( BLOCK_SIZE, BLOCK_SIZE, BLOCK_SIZE ) ), Rgba8::YELLOW );
+	DebugAddWorldArrow( result.impactPos, result.impactPos + result.impactSurfaceNormal * .5f, Rgba8::CYAN );
+
+	if ( g_devConsole->IsOpen() )
+	{
+		return;
+	}
+
+	Vec3 impactBlockCenter = impactBlockMins + Vec3( .5f * BLOCK_SIZE, .5f * BLOCK_SIZE, .5f * BLOCK_SIZE );
+
+	// Dig
+	if ( g_inputSystem->WasKeyJustPressed( MOUSE_LBUTTON ) )
+	{
+		m_world->SetBlockTypeAtWorldPosition( impactBlockCenter, 0 );
+	}
+
+	// Place against the face that was hit, there's no face when the camera is inside a solid block
+	if ( g_inputSystem->WasKeyJustPressed( MOUSE_RBUTTON )
+		 && result.impactSurfaceNormal != Vec3::ZERO )
+	{
+		unsigned char blockType = 0;
+		if ( BlockDefinition::GetTypeFromName( "Dirt", blockType ) )
+		{
+			m_world->SetBlockTypeAtWorldPosition( impactBlockCenter + result.impactSurfaceNormal * BLOCK_SIZE, blockType );
+		}
+	}
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void Game::UpdateDebugUI()
 {
@@ -391,10 +444,25 @@ void Game::LoadAssets()
 
 	m_testSound = g_audioSystem->CreateOrGetSound( "Data/Audio/TestSound.mp3" );
 
+	g_tileSpriteSheet = new SpriteSheet( *(g_renderer->CreateOrGetTextureFromFile( "Data/Images/Terrain_32x32.png" )), IntVec2( 32, 32 ) );
+
+	LoadBlocksFromXml();
+
 	g_devConsole->PrintString( "Assets Loaded", Rgba8::GREEN );
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void Game::LoadBlocksFromXml()
+{
+	g_devConsole->PrintString( "Loading Blocks..." );
+
+	BlockDefinition::LoadDefinitionsFromXml( "Data/Gameplay/BlockDefs.xml", *g_tileSpriteSheet );
+
+	g_devConsole->PrintString( Stringf( "%d Blocks Loaded", BlockDefinition::s_numDefinitions ), Rgba8::GREEN );
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void Game::AddScreenShakeIntensity(float intensity)
 {
@@ -428,6 +496,76 @@ bool Game::SetMouseSensitivity( EventArgs* args )
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void Game::BenchmarkRaycasts( EventArgs* args )
+{
+	int rayCount = args->GetValue( "count", 1000000 );
+	float maxDist = args->GetValue( "maxDist", 32.f );
+
+	if ( rayCount <= 0 )
+	{
+		return;
+	}
+
+	// Rays start in air anywhere inside the generated chunks and point in a random direction,
+	// rays starting inside solid blocks would stop at distance 0 and measure nothing
+	std::vector<RaycastQuery> queries;
+	queries.resize( rayCount );
+	for ( int rayIdx = 0; rayIdx < rayCount; ++rayIdx )
+	{
+		RaycastQuery& query = queries[rayIdx];
+		int numStartTries = 0;
+		do
+		{
+			query.startPos = Vec3( m_rng->RollRandomFloatInRange( 0.f, (float)CHUNK_WIDTH ),
+								   m_rng->RollRandomFloatInRange( 0.f, (float)CHUNK_LENGTH ),
+								   m_rng->RollRandomFloatInRange( 0.f, (float)CHUNK_HEIGHT ) );
+			++numStartTries;
+		} while ( m_world->IsBlockSolidAtWorldPosition( query.startPos )
+				  && numStartTries < 1000 );
+
+		if ( m_world->IsBlockSolidAtWorldPosition( query.startPos ) )
+		{
+			g_devConsole->PrintError( "benchmark_raycasts couldn't find an air block to start rays in" );
+			return;
+		}
+
+		Vec3 direction;
+		do 
+		{
+			direction = Vec3( m_rng->RollRandomFloatInRange( -1.f, 1.f ),
+							  m_rng->RollRandomFloatInRange( -1.f, 1.f ),
+							  m_rng->RollRandomFloatInRange( -1.f, 1.f ) );
+		} while ( direction.GetLengthSquared() < .0001f );
+
+		query.forwardNormal = direction.GetNormalized();
+		query.maxDist = maxDist;
+	}
+
+	std::vector<RaycastResult> results;
+	results.reserve( rayCount );
+
+	double startTime = GetCurrentTimeSeconds();
+	m_world->RaycastBatch( queries, results );
+	double elapsedSeconds = GetCurrentTimeSeconds() - startTime;
+
+	int numImpacts = 0;
+	for ( int resultIdx = 0; resultIdx < (int)results.size(); ++resultIdx )
+	{
+		if ( results[resultIdx].didImpact )
+		{
+			++numImpacts;
+		}
+	}
+
+	g_devConsole->PrintString( Stringf( "%d raycasts in %.2f ms ( %.0f rays/sec ), %d impacts", 
+										rayCount,
+										elapsedSeconds * 1000.0,
+										(double)rayCount / elapsedSeconds,
+										numImpacts ), Rgba8::GREEN );
+}
+
+
 //-----------------------------------------------------------------------------------------------
 bool Game::SetAmbientLightColor( EventArgs* args )
 {
@@ -57,17 +57,21 @@ public:
 
 private:
 	void LoadAssets();
+	void LoadBlocksFromXml();
 
 	void InitializeCameras();
 	void InitializeMeshes();
 
 	void UpdateFromKeyboard();
 	void UpdateCameraTransform( float deltaSeconds );
+	void UpdateBlockPicking();
 	void UpdateDebugUI();
 
 	void UpdateCameras();
 	void TranslateCameraFPS( const Vec3& relativeTranslation );
 
+	void BenchmarkRaycasts( EventArgs* args );
+
 private:
 	Clock* m_gameClock = nullptr;
 
@@ -46,7 +46,10 @@ constexpr float BLOCK_SIZE = 1.f;
 constexpr int CHUNK_WIDTH = 16;
 constexpr int CHUNK_LENGTH = 16;
 constexpr int CHUNK_HEIGHT = 128;
-constexpr int NUM_BLOCKS_IN_CHUNK = CHUNK_WIDTH * CHUNK_LENGTH * CHUNK_HEIGHT;
+constexpr int NUM_BLOCKS_IN_CHUNK_LAYER = CHUNK_WIDTH * CHUNK_LENGTH;
+constexpr int NUM_BLOCKS_IN_CHUNK = NUM_BLOCKS_IN_CHUNK_LAYER * CHUNK_HEIGHT;
+
+constexpr float BLOCK_PICKING_DIST = 8.f;
 
 constexpr float MAX_CAMERA_SHAKE_DIST = 5.f;
 constexpr float SCREEN_SHAKE_ABLATION_PER_SECOND = 1.f;
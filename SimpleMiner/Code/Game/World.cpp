@@ -1,8 +1,25 @@
 #include "Game/World.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
 #include "Game/GameCommon.hpp"
 
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------------------------
+static bool IsBlockSolid( const Chunk* chunk, int localX, int localY, int localZ )
+{
+	if ( chunk == nullptr
+		 || localZ < 0
+		 || localZ >= CHUNK_HEIGHT )
+	{
+		return false;
+	}
+
+	return chunk->GetBlock( Chunk::GetBlockIndex( localX, localY, localZ ) ).IsSolid();
+}
+
 
 //-----------------------------------------------------------------------------------------------
 World::World()
@@ -20,6 +37,12 @@ World::~World()
 //-----------------------------------------------------------------------------------------------
 void World::Update( float deltaSeconds )
 {
+	UNUSED( deltaSeconds );
+
+	for ( int chunkIdx = 0; chunkIdx < (int)m_chunks.size(); ++chunkIdx )
+	{
+		m_chunks[chunkIdx].Update();
+	}
 }
 
 
@@ -41,3 +64,231 @@ void World::DebugRender() const
 		m_chunks[chunkIdx].DebugRender();
 	}
 }
+
+
+//-----------------------------------------------------------------------------------------------
+// 3D grid traversal (Amanatides-Woo), the same approach as the 2D wall raycast in Doomenstein.
+// Block coords are tracked relative to the current chunk so a chunk lookup is only done when the
+// ray steps across a chunk boundary, never per block.
+//-----------------------------------------------------------------------------------------------
+RaycastResult World::Raycast( const Vec3& startPos, const Vec3& forwardNormal, float maxDist ) const
+{
+	RaycastResult result;
+	result.startPos = startPos;
+	result.forwardNormal = forwardNormal;
+	result.maxDist = maxDist;
+
+	int blockZ = (int)floorf( startPos.z );
+
+	IntVec2 chunkCoords = GetChunkCoordsForWorldPosition( startPos );
+	int localX = (int)floorf( startPos.x ) - ( chunkCoords.x * CHUNK_WIDTH );
+	int localY = (int)floorf( startPos.y ) - ( chunkCoords.y * CHUNK_LENGTH );
+	const Chunk* chunk = GetChunkAtCoords( chunkCoords );
+
+	// Check if starting block is solid
+	if ( IsBlockSolid( chunk, localX, localY, blockZ ) )
+	{
+		result.didImpact = true;
+		result.impactFraction = 0.f;
+		result.impactDist = 0.f;
+		result.impactPos = startPos;
+		// No face was crossed, so leave the normal zero rather than give a face to place against
+		result.impactSurfaceNormal = Vec3::ZERO;
+		result.impactChunk = chunk;
+		result.impactBlockIdx = Chunk::GetBlockIndex( localX, localY, blockZ );
+
+		return result;
+	}
+
+	// How far along the ray do you have to go to move 1 unit along each axis of the grid
+	// if ray doesn't move along an axis this value is essentially infinity
+	float xDeltaDistAlongRay = 99999999.f;
+	if ( !IsNearlyEqual( forwardNormal.x, 0.f, .000001f ) )
+	{
+		xDeltaDistAlongRay = 1.f / fabsf( forwardNormal.x );
+	}
+
+	float yDeltaDistAlongRay = 99999999.f;
+	if ( !IsNearlyEqual( forwardNormal.y, 0.f, .000001f ) )
+	{
+		yDeltaDistAlongRay = 1.f / fabsf( forwardNormal.y );
+	}
+
+	float zDeltaDistAlongRay = 99999999.f;
+	if ( !IsNearlyEqual( forwardNormal.z, 0.f, .000001f ) )
+	{
+		zDeltaDistAlongRay = 1.f / fabsf( forwardNormal.z );
+	}
+
+	// +1 or -1 to indicate which direction the steps will take
+	int blockStepDirX = (int)SignFloat( forwardNormal.x );
+	int blockStepDirY = (int)SignFloat( forwardNormal.y );
+	int blockStepDirZ = (int)SignFloat( forwardNormal.z );
+
+	// Distance along the ray to the first grid plane crossed on each axis, measured from the
+	// leading edge of the starting block depending on which way the ray faces
+	float firstCrossingX = (float)( ( chunkCoords.x * CHUNK_WIDTH ) + localX + ( ( blockStepDirX + 1 ) / 2 ) );
+	float firstCrossingY = (float)( ( chunkCoords.y * CHUNK_LENGTH ) + localY + ( ( blockStepDirY + 1 ) / 2 ) );
+	float firstCrossingZ = (float)( blockZ + ( ( blockStepDirZ + 1 ) / 2 ) );
+
+	float dOfNextXCrossing = fabsf( firstCrossingX - startPos.x ) * xDeltaDistAlongRay;
+	float dOfNextYCrossing = fabsf( firstCrossingY - startPos.y ) * yDeltaDistAlongRay;
+	float dOfNextZCrossing = fabsf( firstCrossingZ - startPos.z ) * zDeltaDistAlongRay;
+
+	// Perform raycast
+	while ( dOfNextXCrossing <= maxDist
+			|| dOfNextYCrossing <= maxDist
+			|| dOfNextZCrossing <= maxDist )
+	{
+		float impactDist = 0.f;
+		Vec3 impactSurfaceNormal;
+
+		// We'll cross X plane next
+		if ( dOfNextXCrossing < dOfNextYCrossing
+			 && dOfNextXCrossing < dOfNextZCrossing )
+		{
+			impactDist = dOfNextXCrossing;
+			impactSurfaceNormal = Vec3( (float)-blockStepDirX, 0.f, 0.f );
+			dOfNextXCrossing += xDeltaDistAlongRay;
+
+			localX += blockStepDirX;
+			if ( localX < 0
+				 || localX >= CHUNK_WIDTH )
+			{
+				localX -= blockStepDirX * CHUNK_WIDTH;
+				chunkCoords.x += blockStepDirX;
+				chunk = GetChunkAtCoords( chunkCoords );
+			}
+		}
+		// We'll cross Y plane next
+		else if ( dOfNextYCrossing < dOfNextZCrossing )
+		{
+			impactDist = dOfNextYCrossing;
+			impactSurfaceNormal = Vec3( 0.f, (float)-blockStepDirY, 0.f );
+			dOfNextYCrossing += yDeltaDistAlongRay;
+
+			localY += blockStepDirY;
+			if ( localY < 0
+				 || localY >= CHUNK_LENGTH )
+			{
+				localY -= blockStepDirY * CHUNK_LENGTH;
+				chunkCoords.y += blockStepDirY;
+				chunk = GetChunkAtCoords( chunkCoords );
+			}
+		}
+		// We'll cross Z plane next
+		else
+		{
+			impactDist = dOfNextZCrossing;
+			impactSurfaceNormal = Vec3( 0.f, 0.f, (float)-blockStepDirZ );
+			dOfNextZCrossing += zDeltaDistAlongRay;
+
+			blockZ += blockStepDirZ;
+
+			// Left the top or bottom of the world and can't come back
+			if ( ( blockZ < 0 && blockStepDirZ < 0 )
+				 || ( blockZ >= CHUNK_HEIGHT && blockStepDirZ > 0 ) )
+			{
+				break;
+			}
+		}
+
+		if ( impactDist > maxDist )
+		{
+			break;
+		}
+
+		// Hit a solid block
+		if ( IsBlockSolid( chunk, localX, localY, blockZ ) )
+		{
+			result.didImpact = true;
+			result.impactFraction = impactDist / maxDist;
+			result.impactPos = startPos + ( forwardNormal * impactDist );
+			result.impactDist = impactDist;
+			result.impactSurfaceNormal = impactSurfaceNormal;
+			result.impactChunk = chunk;
+			result.impactBlockIdx = Chunk::GetBlockIndex( localX, localY, blockZ );
+			break;
+		}
+	}
+
+	return result;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void World::RaycastBatch( const std::vector<RaycastQuery>& queries, std::vector<RaycastResult>& out_results ) const
+{
+	out_results.resize( queries.size() );
+
+	for ( int queryIdx = 0; queryIdx < (int)queries.size(); ++queryIdx )
+	{
+		const RaycastQuery& query = queries[queryIdx];
+		out_results[queryIdx] = Raycast( query.startPos, query.forwardNormal, query.maxDist );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+const Chunk* World::GetChunkAtCoords( const IntVec2& chunkCoords ) const
+{
+	for ( int chunkIdx = 0; chunkIdx < (int)m_chunks.size(); ++chunkIdx )
+	{
+		if ( m_chunks[chunkIdx].GetWorldCoords() == chunkCoords )
+		{
+			return &m_chunks[chunkIdx];
+		}
+	}
+
+	return nullptr;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+Chunk* World::GetChunkAtCoords( const IntVec2& chunkCoords )
+{
+	return const_cast<Chunk*>( static_cast<const World*>( this )->GetChunkAtCoords( chunkCoords ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool World::SetBlockTypeAtWorldPosition( const Vec3& worldPos, unsigned char type )
+{
+	int blockZ = (int)floorf( worldPos.z );
+	if ( blockZ < 0
+		 || blockZ >= CHUNK_HEIGHT )
+	{
+		return false;
+	}
+
+	IntVec2 chunkCoords = GetChunkCoordsForWorldPosition( worldPos );
+	Chunk* chunk = GetChunkAtCoords( chunkCoords );
+	if ( chunk == nullptr )
+	{
+		return false;
+	}
+
+	int localX = (int)floorf( worldPos.x ) - ( chunkCoords.x * CHUNK_WIDTH );
+	int localY = (int)floorf( worldPos.y ) - ( chunkCoords.y * CHUNK_LENGTH );
+
+	chunk->SetBlockType( Chunk::GetBlockIndex( localX, localY, blockZ ), type );
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool World::IsBlockSolidAtWorldPosition( const Vec3& worldPos ) const
+{
+	IntVec2 chunkCoords = GetChunkCoordsForWorldPosition( worldPos );
+	int localX = (int)floorf( worldPos.x ) - ( chunkCoords.x * CHUNK_WIDTH );
+	int localY = (int)floorf( worldPos.y ) - ( chunkCoords.y * CHUNK_LENGTH );
+
+	return IsBlockSolid( GetChunkAtCoords( chunkCoords ), localX, localY, (int)floorf( worldPos.z ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+IntVec2 World::GetChunkCoordsForWorldPosition( const Vec3& worldPos )
+{
+	return IntVec2( (int)floorf( worldPos.x / (float)CHUNK_WIDTH ), (int)floorf( worldPos.y / (float)CHUNK_LENGTH ) );
+}
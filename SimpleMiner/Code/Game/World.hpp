@@ -1,10 +1,38 @@
 #pragma once
 #include "Game/Chunk.hpp"
+#include "Engine/Math/Vec3.hpp"
 
 #include <string>
 #include <vector>
 
 
+//-----------------------------------------------------------------------------------------------
+struct RaycastQuery
+{
+	Vec3 startPos;
+	Vec3 forwardNormal;
+	float maxDist = 0.f;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+struct RaycastResult
+{
+	Vec3 startPos;
+	Vec3 forwardNormal;
+	float maxDist = 0.f;
+	bool didImpact = false;
+	Vec3 impactPos;
+	float impactFraction = 0.f;
+	float impactDist = 0.f;
+	Vec3 impactSurfaceNormal;								// Zero when the ray started inside a solid block
+
+	// The block that was hit, identified by its owning chunk and index within that chunk
+	const Chunk* impactChunk = nullptr;
+	int impactBlockIdx = -1;
+};
+
+
 //-----------------------------------------------------------------------------------------------
 class World
 {
@@ -16,6 +44,16 @@ public:
 	void Render() const;
 	void DebugRender() const;
 
+	RaycastResult	Raycast( const Vec3& startPos, const Vec3& forwardNormal, float maxDist ) const;
+	void			RaycastBatch( const std::vector<RaycastQuery>& queries, std::vector<RaycastResult>& out_results ) const;
+
+	const Chunk*	GetChunkAtCoords( const IntVec2& chunkCoords ) const;
+	Chunk*			GetChunkAtCoords( const IntVec2& chunkCoords );
+	bool			SetBlockTypeAtWorldPosition( const Vec3& worldPos, unsigned char type );
+	bool			IsBlockSolidAtWorldPosition( const Vec3& worldPos ) const;
+
+	static IntVec2	GetChunkCoordsForWorldPosition( const Vec3& worldPos );
+
 private:
 	std::vector<Chunk> m_chunks;
 };